@@ -3,17 +3,15 @@
 layout (location = 0) in vec3 inPosition;
 layout (location = 1) in vec3 inNormal;
 
+// world matrix of the instance, read from the instance buffer at binding 1
+layout (location = 2) in mat4 inInstanceModel;
+
 layout (set = 0, binding = 0) uniform PerSceneData 
 {
 	mat4 viewMatrix;
 	mat4 projectionMatrix;
 } sceneData;
 
-layout (set = 3, binding = 0) uniform PerObjDataDynamic
-{
-	mat4 modelMatrix;
-} objData;
-
 layout (location = 0) out vec3 outNormal;
 layout (location = 1) out vec3 outPosition;
 
@@ -24,11 +22,11 @@ out gl_PerVertex
 
 void main() 
 {
-	mat3 normalMatrix = transpose(inverse(mat3(objData.modelMatrix)));
+	mat3 normalMatrix = transpose(inverse(mat3(inInstanceModel)));
 	vec3 normal = normalize(normalMatrix * inNormal);
 
 	outNormal   = normal;
-	outPosition = (objData.modelMatrix * vec4(inPosition.xyz, 1.0)).xyz;
+	outPosition = (inInstanceModel * vec4(inPosition.xyz, 1.0)).xyz;
 
-	gl_Position = sceneData.projectionMatrix * sceneData.viewMatrix * objData.modelMatrix * vec4(inPosition.xyz, 1.0);
+	gl_Position = sceneData.projectionMatrix * sceneData.viewMatrix * inInstanceModel * vec4(inPosition.xyz, 1.0);
 }
@@ -3,6 +3,7 @@
 #include "utils/code_gen_utils.h"
 
 #include <iomanip>
+#include <unordered_set>
 
 namespace Meow
 {
@@ -33,6 +34,7 @@ namespace Meow
     {
         output_source_file << "#include \"register_all.h\"\n\n";
         output_source_file << "#include \"core/reflect/type_descriptor_builder.hpp\"\n";
+        output_source_file << "#include \"function/object/component_type_info.h\"\n";
 
         for (const auto& include_relative_path : include_relative_paths)
         {
@@ -86,6 +88,50 @@ namespace Meow
             output_source_file << ";\n";
         }
 
+        // Classes derived from Component, directly or through another reflectable component, get dense type ids in
+        // parse order
+
+        std::vector<std::string>        component_class_names;
+        std::unordered_set<std::string> component_class_name_set = {"Component"};
+
+        bool is_changed = true;
+        while (is_changed)
+        {
+            is_changed = false;
+            for (const auto& class_result : class_results)
+            {
+                if (component_class_name_set.count(class_result.class_name))
+                    continue;
+
+                for (const auto& base_class_name : class_result.base_class_names)
+                {
+                    if (component_class_name_set.count(base_class_name))
+                    {
+                        component_class_name_set.insert(class_result.class_name);
+                        is_changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        for (const auto& class_result : class_results)
+        {
+            if (component_class_name_set.count(class_result.class_name))
+                component_class_names.push_back(class_result.class_name);
+        }
+
+        if (!component_class_names.empty())
+            output_source_file << std::endl;
+
+        for (const auto& component_class_name : component_class_names)
+        {
+            output_source_file << "\t\t" << "ComponentTypeRegistry::instance().Register<" << component_class_name
+                               << ">(" << std::quoted(component_class_name) << ");\n";
+        }
+
+        GenerateComponentTypeIDHeaderFile(component_class_names);
+
         output_source_file << '\t' << "}" << std::endl;
         output_source_file << std::endl;
 
@@ -181,4 +227,51 @@ namespace Meow
                       << output_path.string() + "/" + gen_header_file_name + ".gen.h" << std::endl;
         }
     }
-} // namespace Meow
\ No newline at end of file
+
+    void CodeGenerator::GenerateComponentTypeIDHeaderFile(const std::vector<std::string>& component_class_names)
+    {
+        std::stringstream gen_header_stream;
+
+        gen_header_stream << "#pragma once" << std::endl;
+        gen_header_stream << std::endl;
+        gen_header_stream << "#include \"function/object/component_type_id.h\"" << std::endl;
+        gen_header_stream << std::endl;
+        gen_header_stream << "#include <cstdint>" << std::endl;
+        gen_header_stream << std::endl;
+        gen_header_stream << "namespace Meow" << std::endl;
+        gen_header_stream << "{" << std::endl;
+
+        for (const auto& component_class_name : component_class_names)
+        {
+            gen_header_stream << "    class " << component_class_name << ";" << std::endl;
+        }
+
+        for (std::size_t i = 0; i < component_class_names.size(); ++i)
+        {
+            gen_header_stream << std::endl;
+            gen_header_stream << "    template<>" << std::endl;
+            gen_header_stream << "    struct GeneratedComponentTypeID<" << component_class_names[i] << ">" << std::endl;
+            gen_header_stream << "    {" << std::endl;
+            gen_header_stream << "        static constexpr uint32_t value = " << i << ";" << std::endl;
+            gen_header_stream << "    };" << std::endl;
+        }
+
+        gen_header_stream << std::endl;
+        gen_header_stream << "    inline constexpr uint32_t k_generated_component_type_count = "
+                          << component_class_names.size() << ";" << std::endl;
+        gen_header_stream << "} // namespace Meow" << std::endl;
+
+        std::string   gen_header_path = output_path.string() + "/component_type_id.gen.h";
+        std::ofstream output_header_file(gen_header_path);
+        if (output_header_file.is_open())
+        {
+            output_header_file << gen_header_stream.str();
+            output_header_file.close();
+            std::cout << "[CodeGenerator] Generated: " << gen_header_path << std::endl;
+        }
+        else
+        {
+            std::cerr << "[CodeGenerator] Fail to write: " << gen_header_path << std::endl;
+        }
+    }
+} // namespace Meow
@@ -7,6 +7,7 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace fs = std::filesystem;
 
@@ -26,6 +27,8 @@ namespace Meow
     private:
         void GenerateEnumReflHeaderFile(const EnumParseResult& enum_result);
 
+        void GenerateComponentTypeIDHeaderFile(const std::vector<std::string>& component_class_names);
+
         bool              is_recording = false;
         fs::path          src_path;
         fs::path          output_path;
@@ -11,6 +11,7 @@ namespace Meow
     struct ClassParseResult
     {
         std::string                    class_name;
+        std::vector<std::string>       base_class_names;
         std::vector<FieldParseResult>  field_results;
         std::vector<MethodParseResult> method_results;
     };
@@ -133,6 +133,29 @@ namespace Meow
         ClassParseResult class_result;
         class_result.class_name = class_name;
 
+        // direct base classes, used to find component types
+        clang_visitChildren(
+            class_cursor,
+            [](CXCursor c, CXCursor parent, CXClientData client_data) {
+                if (clang_getCursorKind(c) == CXCursor_CXXBaseSpecifier)
+                {
+                    ClassParseResult* class_result = static_cast<ClassParseResult*>(client_data);
+
+                    std::string base_class_name =
+                        CodeGenUtils::to_string(clang_getTypeSpelling(clang_getCursorType(c)));
+
+                    // strip namespaces
+                    std::size_t namespace_pos = base_class_name.rfind("::");
+                    if (namespace_pos != std::string::npos)
+                        base_class_name = base_class_name.substr(namespace_pos + 2);
+
+                    class_result->base_class_names.push_back(base_class_name);
+                }
+
+                return CXChildVisit_Continue;
+            },
+            &class_result);
+
         clang_visitChildren(
             class_cursor,
             [](CXCursor c, CXCursor parent, CXClientData client_data) {
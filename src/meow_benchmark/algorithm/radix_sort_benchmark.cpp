@@ -0,0 +1,73 @@
+#include "benchmark.h"
+
+#include "meow_runtime/core/algorithm/radix_sort.h"
+
+#include <format>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    constexpr uint32_t k_iteration_count = 10;
+} // namespace
+
+MEOW_BENCHMARK(RadixSortDrawKeys)
+{
+    constexpr uint32_t k_key_count = 100000;
+
+    // keys laid out like render queue keys: few pipelines and materials, many meshes, random depth in the low bits
+    std::mt19937                            random(0);
+    std::uniform_int_distribution<uint32_t> pipeline_distribution(0, 2);
+    std::uniform_int_distribution<uint32_t> material_distribution(0, 15);
+    std::uniform_int_distribution<uint32_t> mesh_distribution(0, 999);
+    std::uniform_int_distribution<uint32_t> depth_distribution(0, (1u << 24) - 1);
+
+    std::vector<uint64_t> unsorted_keys(k_key_count);
+    for (uint64_t& key : unsorted_keys)
+    {
+        key = static_cast<uint64_t>(pipeline_distribution(random)) << 52 |
+              static_cast<uint64_t>(material_distribution(random)) << 40 |
+              static_cast<uint64_t>(mesh_distribution(random)) << 24 | depth_distribution(random);
+    }
+
+    std::vector<std::pair<uint64_t, uint32_t>> pairs;
+    double std_sort_milliseconds = MeasureMilliseconds(k_iteration_count, [&]() {
+        pairs.clear();
+        for (uint32_t i = 0; i < k_key_count; ++i)
+        {
+            pairs.emplace_back(unsorted_keys[i], i);
+        }
+        std::sort(pairs.begin(), pairs.end());
+    });
+
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> values;
+    std::vector<uint64_t> scratch_keys;
+    std::vector<uint32_t> scratch_values;
+    double                radix_sort_milliseconds = MeasureMilliseconds(k_iteration_count, [&]() {
+        keys = unsorted_keys;
+        values.resize(k_key_count);
+        for (uint32_t i = 0; i < k_key_count; ++i)
+        {
+            values[i] = i;
+        }
+        RadixSort(keys, values, scratch_keys, scratch_values);
+    });
+
+    bool is_same_order = true;
+    for (uint32_t i = 0; i < k_key_count; ++i)
+    {
+        is_same_order = is_same_order && pairs[i].second == values[i];
+    }
+
+    std::cout << std::format("\n100k draw sort keys with their indices\n");
+    std::cout << std::format("{:>14} {:>12.3f} ms\n", "std::sort", std_sort_milliseconds);
+    std::cout << std::format("{:>14} {:>12.3f} ms, {}\n",
+                             "radix sort",
+                             radix_sort_milliseconds,
+                             is_same_order ? "same order" : "ORDER DIFFERS");
+}
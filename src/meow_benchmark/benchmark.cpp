@@ -0,0 +1,44 @@
+#include "benchmark.h"
+
+#include <format>
+#include <iostream>
+#include <thread>
+
+namespace Meow
+{
+    namespace
+    {
+        uint32_t g_max_thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    } // namespace
+
+    std::vector<uint32_t> GetBenchmarkThreadCounts()
+    {
+        std::vector<uint32_t> thread_counts;
+        for (uint32_t thread_count = 1; thread_count < g_max_thread_count; thread_count *= 2)
+        {
+            thread_counts.push_back(thread_count);
+        }
+        thread_counts.push_back(g_max_thread_count);
+
+        return thread_counts;
+    }
+
+    void SetBenchmarkMaxThreadCount(uint32_t thread_count) { g_max_thread_count = std::max(thread_count, 1u); }
+
+    void PrintScalingHeader(const std::string& title)
+    {
+        std::cout << std::format(
+            "\n{}\n{:>8} {:>12} {:>12} {:>9} {:>11}\n", title, "threads", "ms", "per second", "speedup", "efficiency");
+    }
+
+    void PrintScalingRow(uint32_t thread_count, double milliseconds, double single_thread_milliseconds)
+    {
+        double speedup = single_thread_milliseconds / milliseconds;
+        std::cout << std::format("{:>8} {:>12.3f} {:>12.1f} {:>8.2f}x {:>10.1f}%\n",
+                                 thread_count,
+                                 milliseconds,
+                                 1000.0 / milliseconds,
+                                 speedup,
+                                 speedup / thread_count * 100.0);
+    }
+} // namespace Meow
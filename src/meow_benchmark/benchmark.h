@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Meow
+{
+    using BenchmarkFunction = std::function<void()>;
+
+    /**
+     * @brief All benchmarks of the executable, filled during static initialization by MEOW_BENCHMARK.
+     */
+    class BenchmarkRegistry
+    {
+    public:
+        struct Entry
+        {
+            std::string       name;
+            BenchmarkFunction function;
+        };
+
+        static BenchmarkRegistry& instance()
+        {
+            static BenchmarkRegistry registry;
+            return registry;
+        }
+
+        void Register(const std::string& name, BenchmarkFunction function)
+        {
+            m_entries.push_back({name, std::move(function)});
+        }
+
+        const std::vector<Entry>& GetEntries() const { return m_entries; }
+
+    private:
+        BenchmarkRegistry() = default;
+
+        std::vector<Entry> m_entries;
+    };
+
+    struct BenchmarkRegistrar
+    {
+        BenchmarkRegistrar(const std::string& name, BenchmarkFunction function)
+        {
+            BenchmarkRegistry::instance().Register(name, std::move(function));
+        }
+    };
+
+    /**
+     * @brief Run func iteration_count times after one warm up run.
+     *
+     * @return Median duration in milliseconds.
+     */
+    template<typename Func>
+    double MeasureMilliseconds(uint32_t iteration_count, Func&& func)
+    {
+        func();
+
+        std::vector<double> durations;
+        durations.reserve(iteration_count);
+        for (uint32_t i = 0; i < iteration_count; ++i)
+        {
+            auto start = std::chrono::steady_clock::now();
+            func();
+            auto end = std::chrono::steady_clock::now();
+
+            durations.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+
+        std::sort(durations.begin(), durations.end());
+        return durations[durations.size() / 2];
+    }
+
+    /**
+     * @brief 1, 2, 4, ... up to the maximum thread count, which is always included.
+     */
+    std::vector<uint32_t> GetBenchmarkThreadCounts();
+
+    /**
+     * @brief Defaults to the number of hardware threads.
+     */
+    void SetBenchmarkMaxThreadCount(uint32_t thread_count);
+
+    /**
+     * @brief Print one row of a scaling table: thread count, duration, runs per second, speedup and parallel
+     * efficiency relative to the single thread duration.
+     */
+    void PrintScalingHeader(const std::string& title);
+    void PrintScalingRow(uint32_t thread_count, double milliseconds, double single_thread_milliseconds);
+} // namespace Meow
+
+#define MEOW_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define MEOW_BENCHMARK_CONCAT(a, b)      MEOW_BENCHMARK_CONCAT_IMPL(a, b)
+
+// define and register a benchmark function
+#define MEOW_BENCHMARK(name) \
+    static void name(); \
+    static ::Meow::BenchmarkRegistrar MEOW_BENCHMARK_CONCAT(name, _registrar)(#name, name); \
+    static void name()
@@ -0,0 +1,143 @@
+#include "benchmark.h"
+
+#include "meow_runtime/core/jobs/job_system.h"
+
+#include <atomic>
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    constexpr uint32_t k_iteration_count = 10;
+
+    /**
+     * @brief Measure func(job_system) for every benchmark thread count and print the scaling table.
+     */
+    template<typename Func>
+    void RunScaling(const std::string& title, Func&& func)
+    {
+        PrintScalingHeader(title);
+
+        double single_thread_milliseconds = 0.0;
+        for (uint32_t thread_count : GetBenchmarkThreadCounts())
+        {
+            JobSystem job_system(thread_count - 1);
+
+            double milliseconds = MeasureMilliseconds(k_iteration_count, [&]() { func(job_system); });
+            if (thread_count == 1)
+                single_thread_milliseconds = milliseconds;
+
+            PrintScalingRow(thread_count, milliseconds, single_thread_milliseconds);
+        }
+    }
+} // namespace
+
+/**
+ * @brief Compute bound loop, should scale close to linearly.
+ */
+MEOW_BENCHMARK(JobSystemParallelForCompute)
+{
+    constexpr uint32_t k_element_count = 1 << 20;
+    constexpr uint32_t k_grain_size    = 1024;
+
+    std::vector<float> values(k_element_count, 1.0f);
+
+    RunScaling("parallel_for, 1M elements, 64 sin/cos each", [&](JobSystem& job_system) {
+        job_system.ParallelFor(0, k_element_count, k_grain_size, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                float x = values[i];
+                for (int k = 0; k < 64; ++k)
+                {
+                    x = std::sin(x) + std::cos(x);
+                }
+                values[i] = x;
+            }
+        });
+    });
+}
+
+/**
+ * @brief Memory bound loop, scaling is limited by memory bandwidth.
+ */
+MEOW_BENCHMARK(JobSystemParallelForMemory)
+{
+    constexpr uint32_t k_element_count = 1 << 24;
+    constexpr uint32_t k_grain_size    = 16 * 1024;
+
+    std::vector<float> src(k_element_count, 1.0f);
+    std::vector<float> dst(k_element_count, 0.0f);
+
+    RunScaling("parallel_for, 16M elements, dst = src * 2 + dst", [&](JobSystem& job_system) {
+        job_system.ParallelFor(0, k_element_count, k_grain_size, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                dst[i] = src[i] * 2.0f + dst[i];
+            }
+        });
+    });
+}
+
+/**
+ * @brief Many tiny jobs, measures scheduling and stealing overhead.
+ */
+MEOW_BENCHMARK(JobSystemFineGrainedJobs)
+{
+    constexpr uint32_t k_job_count = 100000;
+
+    std::atomic<uint32_t> executed_count {0};
+
+    RunScaling("100k empty jobs scheduled from the main thread", [&](JobSystem& job_system) {
+        JobCounter counter;
+        for (uint32_t i = 0; i < k_job_count; ++i)
+        {
+            job_system.Schedule([&executed_count]() { executed_count.fetch_add(1, std::memory_order_relaxed); },
+                                &counter);
+        }
+        job_system.Wait(counter);
+    });
+}
+
+/**
+ * @brief Layers of jobs where every layer depends on the previous one, like a task graph of frame stages.
+ */
+MEOW_BENCHMARK(JobSystemTaskGraph)
+{
+    constexpr uint32_t k_layer_count    = 64;
+    constexpr uint32_t k_jobs_per_layer = 64;
+    constexpr uint32_t k_work_per_job   = 2000;
+
+    std::vector<float> values(k_layer_count * k_jobs_per_layer, 1.0f);
+
+    RunScaling("64 dependent layers of 64 jobs", [&](JobSystem& job_system) {
+        std::vector<std::unique_ptr<JobCounter>> counters;
+        for (uint32_t layer = 0; layer < k_layer_count; ++layer)
+        {
+            counters.push_back(std::make_unique<JobCounter>());
+
+            JobCounter* dependency = layer > 0 ? counters[layer - 1].get() : nullptr;
+            for (uint32_t job = 0; job < k_jobs_per_layer; ++job)
+            {
+                float& value = values[layer * k_jobs_per_layer + job];
+                job_system.Schedule(
+                    [&value]() {
+                        float x = value;
+                        for (uint32_t k = 0; k < k_work_per_job; ++k)
+                        {
+                            x = std::sqrt(x + 1.0f);
+                        }
+                        value = x;
+                    },
+                    counters[layer].get(),
+                    dependency);
+            }
+        }
+
+        job_system.Wait(*counters.back());
+    });
+}
@@ -0,0 +1,132 @@
+#include "benchmark.h"
+
+#include "meow_runtime/core/jobs/job_system.h"
+#include "meow_runtime/function/components/transform/transform_3d_component.hpp"
+#include "meow_runtime/function/global/runtime_context.h"
+#include "meow_runtime/function/level/level.h"
+
+#include <format>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    constexpr uint32_t k_iteration_count = 10;
+    constexpr uint32_t k_grain_size      = 1024;
+
+    class LifetimeComponent : public Component
+    {
+    public:
+        float remaining_seconds = 1.0f;
+    };
+
+    glm::vec3 SpawnPosition(uint32_t i)
+    {
+        return glm::vec3(static_cast<float>(i % 100), static_cast<float>(i / 100 % 100), 0.0f);
+    }
+
+    /**
+     * @brief One level per measured run, so that teardown is not measured.
+     */
+    std::vector<std::unique_ptr<Level>> CreateLevels()
+    {
+        std::vector<std::unique_ptr<Level>> levels;
+        for (uint32_t i = 0; i < k_iteration_count + 1; ++i)
+        {
+            levels.push_back(std::make_unique<Level>());
+        }
+        return levels;
+    }
+
+    void DestroyLevels(std::vector<std::unique_ptr<Level>>& levels)
+    {
+        levels.clear();
+        TimerSingleton::Get().Clear();
+    }
+
+    void RunImmediateSpawn(uint32_t object_count)
+    {
+        std::vector<std::unique_ptr<Level>> levels = CreateLevels();
+
+        uint32_t level_index  = 0;
+        double   milliseconds = MeasureMilliseconds(k_iteration_count, [&]() {
+            Level& level = *levels[level_index++];
+            for (uint32_t i = 0; i < object_count; ++i)
+            {
+                std::shared_ptr<GameObject> gameobject = level.GetGameObject(level.CreateObject())->shared_from_this();
+
+                Transform3DComponent transform;
+                transform.position = SpawnPosition(i);
+                TryAddComponent(gameobject, "Transform3DComponent", std::move(transform));
+                TryAddComponent(gameobject, "LifetimeComponent", LifetimeComponent {});
+
+                // object setup is full of scope timers, which would pile up without frames clearing them
+                if (i % 1024 == 0)
+                    TimerSingleton::Get().Clear();
+            }
+            TimerSingleton::Get().Clear();
+        });
+
+        DestroyLevels(levels);
+
+        std::cout << std::format("immediate CreateObject + TryAddComponent: {:.3f} ms\n", milliseconds);
+    }
+
+    void RunCommandBufferSpawn(uint32_t object_count)
+    {
+        PrintScalingHeader(
+            std::format("LevelCommandBuffer, {} objects recorded in parallel and played back", object_count));
+
+        double single_thread_milliseconds = 0.0;
+        for (uint32_t thread_count : GetBenchmarkThreadCounts())
+        {
+            g_runtime_context.job_system = std::make_shared<JobSystem>(thread_count - 1);
+
+            std::vector<std::unique_ptr<Level>> levels = CreateLevels();
+
+            uint32_t level_index  = 0;
+            double   milliseconds = MeasureMilliseconds(k_iteration_count, [&]() {
+                Level& level = *levels[level_index++];
+                g_runtime_context.job_system->ParallelFor(
+                    0, object_count, k_grain_size, [&level](uint32_t begin, uint32_t end) {
+                        LevelCommandBuffer& command_buffer = level.GetCommandBuffer();
+                        for (uint32_t i = begin; i < end; ++i)
+                        {
+                            LevelCommandBuffer::PendingObject gameobject = command_buffer.CreateObject();
+
+                            Transform3DComponent transform;
+                            transform.position = SpawnPosition(i);
+                            command_buffer.AddComponent(gameobject, "Transform3DComponent", std::move(transform));
+                            command_buffer.AddComponent(gameobject, "LifetimeComponent", LifetimeComponent {});
+                        }
+                    });
+                level.PlaybackCommandBuffers();
+                TimerSingleton::Get().Clear();
+            });
+
+            DestroyLevels(levels);
+
+            if (thread_count == 1)
+                single_thread_milliseconds = milliseconds;
+
+            PrintScalingRow(thread_count, milliseconds, single_thread_milliseconds);
+        }
+
+        g_runtime_context.job_system = nullptr;
+    }
+} // namespace
+
+MEOW_BENCHMARK(LevelSpawn10K)
+{
+    RunImmediateSpawn(10000);
+    RunCommandBufferSpawn(10000);
+}
+
+MEOW_BENCHMARK(LevelSpawn100K)
+{
+    RunImmediateSpawn(100000);
+    RunCommandBufferSpawn(100000);
+}
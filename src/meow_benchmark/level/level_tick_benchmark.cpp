@@ -0,0 +1,136 @@
+#include "benchmark.h"
+
+#include "meow_runtime/core/jobs/job_system.h"
+#include "meow_runtime/function/components/transform/transform_3d_component.hpp"
+#include "meow_runtime/function/global/runtime_context.h"
+#include "meow_runtime/function/level/level.h"
+
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    constexpr uint32_t k_iteration_count = 10;
+
+    /**
+     * @brief Moves its transform and every 16th object sends some energy to a neighbour through a deferred write.
+     */
+    class DriftComponent : public Component
+    {
+    public:
+        glm::vec3                 velocity = glm::vec3(0.0f);
+        float                     energy   = 1.0f;
+        std::weak_ptr<GameObject> neighbour;
+
+        void Tick(float dt) override
+        {
+            std::shared_ptr<GameObject> gameobject = m_parent_object.lock();
+
+            Transform3DComponent* transform = gameobject->GetComponent<Transform3DComponent>();
+            transform->position += velocity * dt * energy;
+            transform->rotation = glm::normalize(transform->rotation * glm::quat(1.0f, 0.0f, dt * 0.1f, 0.0f));
+            transform->MarkDirty();
+
+            energy *= 0.99f;
+
+            if (std::shared_ptr<GameObject> target = neighbour.lock())
+            {
+                float amount = std::sqrt(glm::dot(transform->position, transform->position)) * 0.001f;
+                ComponentStorage::DeferWrite([target, amount]() {
+                    target->GetComponent<DriftComponent>()->energy += amount;
+                });
+            }
+        }
+    };
+
+    std::vector<std::shared_ptr<GameObject>> PopulateLevel(Level& level, uint32_t object_count)
+    {
+        std::vector<std::shared_ptr<GameObject>> gameobjects;
+        gameobjects.reserve(object_count);
+
+        for (uint32_t i = 0; i < object_count; ++i)
+        {
+            std::shared_ptr<GameObject> gameobject = level.GetGameObject(level.CreateObject())->shared_from_this();
+
+            Transform3DComponent transform;
+            transform.position = glm::vec3(static_cast<float>(i % 100), static_cast<float>(i / 100 % 100), 0.0f);
+            TryAddComponent(gameobject, "Transform3DComponent", std::move(transform));
+
+            DriftComponent drift;
+            drift.velocity = glm::vec3(1.0f, static_cast<float>(i % 7) * 0.1f, 0.5f);
+            if (i % 16 == 15)
+                drift.neighbour = gameobjects[i - 15];
+            TryAddComponent(gameobject, "DriftComponent", std::move(drift));
+
+            gameobjects.push_back(gameobject);
+
+            // setup is full of scope timers, which would pile up without frames clearing them
+            if (i % 1024 == 0)
+                TimerSingleton::Get().Clear();
+        }
+
+        TimerSingleton::Get().Clear();
+        return gameobjects;
+    }
+
+    double Checksum(const std::vector<std::shared_ptr<GameObject>>& gameobjects)
+    {
+        double checksum = 0.0;
+        for (const std::shared_ptr<GameObject>& gameobject : gameobjects)
+        {
+            const glm::vec3& position = gameobject->GetComponent<Transform3DComponent>()->position;
+            checksum += position.x + position.y + position.z + gameobject->GetComponent<DriftComponent>()->energy;
+        }
+
+        return checksum;
+    }
+
+    void RunLevelTick(uint32_t object_count)
+    {
+        PrintScalingHeader(std::format("Level::Tick, {} objects, per second is ticks per second", object_count));
+
+        double single_thread_milliseconds = 0.0;
+        double single_thread_checksum     = 0.0;
+        for (uint32_t thread_count : GetBenchmarkThreadCounts())
+        {
+            g_runtime_context.job_system = std::make_shared<JobSystem>(thread_count - 1);
+
+            double milliseconds = 0.0;
+            double checksum     = 0.0;
+            {
+                Level level;
+                std::vector<std::shared_ptr<GameObject>> gameobjects = PopulateLevel(level, object_count);
+
+                milliseconds = MeasureMilliseconds(k_iteration_count, [&level]() {
+                    level.Tick(1.0f / 60.0f);
+                    TimerSingleton::Get().Clear();
+                });
+                checksum = Checksum(gameobjects);
+            }
+
+            if (thread_count == 1)
+            {
+                single_thread_milliseconds = milliseconds;
+                single_thread_checksum     = checksum;
+            }
+
+            PrintScalingRow(thread_count, milliseconds, single_thread_milliseconds);
+            if (checksum != single_thread_checksum)
+                std::cout << std::format(
+                    "    result differs from single thread: {} != {}\n", checksum, single_thread_checksum);
+        }
+
+        g_runtime_context.job_system = nullptr;
+    }
+} // namespace
+
+MEOW_BENCHMARK(LevelTick10K) { RunLevelTick(10000); }
+
+MEOW_BENCHMARK(LevelTick100K) { RunLevelTick(100000); }
+
+MEOW_BENCHMARK(LevelTick1M) { RunLevelTick(1000000); }
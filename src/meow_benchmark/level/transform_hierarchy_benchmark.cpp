@@ -0,0 +1,104 @@
+#include "benchmark.h"
+
+#include "meow_runtime/function/components/transform/transform_3d_component.hpp"
+#include "meow_runtime/function/level/level.h"
+
+#include <format>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    constexpr uint32_t k_iteration_count = 10;
+    constexpr uint32_t k_children_count  = 9;
+
+    /**
+     * @brief Roots with k_children_count children each, like props attached to their buildings.
+     *
+     * @return Transforms of the roots.
+     */
+    std::vector<GameObjectHandle> PopulateLevel(Level& level, uint32_t object_count)
+    {
+        std::vector<GameObjectHandle> roots;
+
+        GameObjectHandle root_handle;
+        for (uint32_t i = 0; i < object_count; ++i)
+        {
+            GameObjectHandle            handle     = level.CreateObject();
+            std::shared_ptr<GameObject> gameobject = level.GetGameObject(handle)->shared_from_this();
+
+            Transform3DComponent transform;
+            transform.position = glm::vec3(static_cast<float>(i % 100), static_cast<float>(i / 100 % 100), 0.0f);
+            TryAddComponent(gameobject, "Transform3DComponent", std::move(transform));
+
+            if (i % (k_children_count + 1) == 0)
+            {
+                root_handle = handle;
+                roots.push_back(handle);
+            }
+            else
+            {
+                gameobject->GetComponent<Transform3DComponent>()->SetParent(
+                    level.GetGameObject(root_handle)->GetComponent<Transform3DComponent>());
+            }
+
+            if (i % 1024 == 0)
+                TimerSingleton::Get().Clear();
+        }
+
+        level.GetTransformHierarchy().Update(level);
+        TimerSingleton::Get().Clear();
+        return roots;
+    }
+
+    /**
+     * @brief Mark every stride-th root dirty, then update the hierarchy.
+     */
+    double MeasureUpdate(Level& level, const std::vector<GameObjectHandle>& roots, uint32_t stride)
+    {
+        return MeasureMilliseconds(k_iteration_count, [&level, &roots, stride]() {
+            if (stride > 0)
+            {
+                for (uint32_t i = 0; i < roots.size(); i += stride)
+                {
+                    level.GetGameObject(roots[i])->GetComponent<Transform3DComponent>()->MarkDirty();
+                }
+            }
+
+            level.GetTransformHierarchy().Update(level);
+            TimerSingleton::Get().Clear();
+        });
+    }
+} // namespace
+
+MEOW_BENCHMARK(TransformHierarchyUpdate)
+{
+    constexpr uint32_t k_object_count = 100000;
+
+    Level                         level;
+    std::vector<GameObjectHandle> roots = PopulateLevel(level, k_object_count);
+
+    std::cout << std::format("\nTransformHierarchy::Update, {} objects in subtrees of {}\n",
+                             k_object_count,
+                             k_children_count + 1);
+
+    const uint32_t strides[] = {0, 100, 10, 1};
+    for (uint32_t stride : strides)
+    {
+        for (TransformUpdateMode mode : {TransformUpdateMode::PerObject, TransformUpdateMode::Batched})
+        {
+            level.GetTransformHierarchy().SetUpdateMode(mode);
+
+            double   milliseconds  = MeasureUpdate(level, roots, stride);
+            uint32_t updated_count = level.GetTransformHierarchy().GetLastUpdateCount();
+            std::cout << std::format("{:>14} {:>10} {:>12.3f} ms, {} world matrices\n",
+                                     stride == 0 ? "static" : std::format("1/{} dirty", stride),
+                                     mode == TransformUpdateMode::Batched ? "batched" : "per object",
+                                     milliseconds,
+                                     updated_count);
+        }
+    }
+}
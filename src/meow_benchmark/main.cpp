@@ -0,0 +1,46 @@
+#include "benchmark.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Meow;
+
+/**
+ * @brief Run all registered benchmarks, or only those whose name contains one of the arguments.
+ *
+ * --max-threads=N limits the thread counts benchmarks scale up to.
+ */
+int main(int argc, char** argv)
+{
+    const std::string max_threads_option = "--max-threads=";
+
+    std::vector<std::string> filters;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument.starts_with(max_threads_option))
+            SetBenchmarkMaxThreadCount(static_cast<uint32_t>(std::stoul(argument.substr(max_threads_option.size()))));
+        else
+            filters.push_back(argument);
+    }
+
+    for (const BenchmarkRegistry::Entry& entry : BenchmarkRegistry::instance().GetEntries())
+    {
+        bool selected = filters.empty();
+        for (const std::string& filter : filters)
+        {
+            if (entry.name.find(filter) != std::string::npos)
+                selected = true;
+        }
+
+        if (!selected)
+            continue;
+
+        std::cout << "=== " << entry.name << " ===" << std::endl;
+        entry.function();
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "benchmark.h"
+
+#include "meow_runtime/core/math/dynamic_bounding_box_tree.h"
+
+#include <format>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    constexpr uint32_t k_iteration_count = 10;
+} // namespace
+
+MEOW_BENCHMARK(BoundingBoxTree)
+{
+    // a large open level, the camera sees a small part of it
+    constexpr uint32_t k_box_count   = 100000;
+    constexpr float    k_level_size  = 4000.0f;
+    constexpr float    k_move_ratio  = 0.1f;
+    constexpr float    k_move_length = 0.1f;
+
+    Frustum frustum;
+    frustum.updatePlanes(
+        glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+
+    std::mt19937                          random(0);
+    std::uniform_real_distribution<float> position(-k_level_size * 0.5f, k_level_size * 0.5f);
+    std::uniform_real_distribution<float> height(0.0f, 50.0f);
+    std::uniform_real_distribution<float> offset(-k_move_length, k_move_length);
+
+    std::vector<BoundingBox> boxes;
+    BoundingBoxSoA           boxes_soa;
+    DynamicBoundingBoxTree   tree;
+    std::vector<uint32_t>    proxies;
+    boxes.reserve(k_box_count);
+    boxes_soa.Reserve(k_box_count);
+    proxies.reserve(k_box_count);
+    for (uint32_t i = 0; i < k_box_count; ++i)
+    {
+        glm::vec3 center(position(random), height(random), position(random));
+        boxes.emplace_back(center - glm::vec3(1.0f), center + glm::vec3(1.0f));
+        boxes_soa.Push(boxes.back());
+        proxies.push_back(tree.Insert(boxes.back(), i));
+    }
+
+    std::vector<uint8_t> visibility(k_box_count);
+    double linear_milliseconds = MeasureMilliseconds(k_iteration_count, [&frustum, &boxes_soa, &visibility]() {
+        frustum.CullBoundingBoxes(boxes_soa, visibility.data());
+    });
+
+    uint32_t visible_count = 0;
+    for (uint8_t visible : visibility)
+    {
+        visible_count += visible;
+    }
+
+    // the tree only narrows down the candidates, intersecting boxes are tested one by one afterwards
+    std::vector<uint32_t> inside;
+    std::vector<uint32_t> intersecting;
+    BoundingBoxSoA        intersecting_soa;
+    std::vector<uint8_t>  intersecting_visibility;
+    double                tree_milliseconds = MeasureMilliseconds(k_iteration_count, [&]() {
+        inside.clear();
+        intersecting.clear();
+        tree.QueryFrustum(frustum, inside, intersecting);
+
+        intersecting_soa.Clear();
+        for (uint32_t index : intersecting)
+        {
+            intersecting_soa.Push(boxes[index]);
+        }
+        intersecting_visibility.resize(intersecting.size());
+        frustum.CullBoundingBoxes(intersecting_soa, intersecting_visibility.data());
+    });
+
+    uint32_t tree_visible_count = static_cast<uint32_t>(inside.size());
+    for (uint8_t visible : intersecting_visibility)
+    {
+        tree_visible_count += visible;
+    }
+
+    std::cout << std::format("\n{} boxes in a {} m level, {} visible\n", k_box_count, k_level_size, visible_count);
+    std::cout << std::format("{:>22} {:>12.3f} ms\n", "linear batched cull", linear_milliseconds);
+    std::cout << std::format("{:>22} {:>12.3f} ms, speedup {:.2f}x, {} inside, {} intersecting{}\n",
+                             "tree query and cull",
+                             tree_milliseconds,
+                             linear_milliseconds / tree_milliseconds,
+                             inside.size(),
+                             intersecting.size(),
+                             tree_visible_count == visible_count ? "" : ", visible count differs");
+
+    // every frame some objects move a little, most stay within their enlarged leaf
+    uint32_t reinsert_count    = 0;
+    uint32_t move_count        = static_cast<uint32_t>(k_box_count * k_move_ratio);
+    double   move_milliseconds = MeasureMilliseconds(k_iteration_count, [&]() {
+        for (uint32_t i = 0; i < move_count; ++i)
+        {
+            uint32_t  index = random() % k_box_count;
+            glm::vec3 delta(offset(random), 0.0f, offset(random));
+            boxes[index].min += delta;
+            boxes[index].max += delta;
+            reinsert_count += tree.Move(proxies[index], boxes[index]);
+        }
+    });
+
+    std::cout << std::format("{:>22} {:>12.3f} ms, {} reinserted, height {}\n",
+                             std::format("move {} boxes", move_count),
+                             move_milliseconds,
+                             reinsert_count / (k_iteration_count + 1),
+                             tree.GetHeight());
+}
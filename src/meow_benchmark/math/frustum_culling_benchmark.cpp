@@ -0,0 +1,80 @@
+#include "benchmark.h"
+
+#include "meow_runtime/core/math/frustum.h"
+
+#include <format>
+#include <iostream>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    constexpr uint32_t k_iteration_count = 10;
+} // namespace
+
+MEOW_BENCHMARK(FrustumCulling)
+{
+    constexpr uint32_t k_box_count = 100000;
+
+    Frustum frustum;
+    frustum.updatePlanes(
+        glm::vec3(0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+
+    // a grid in front of and behind the camera, about a quarter of it visible
+    std::vector<BoundingBox> boxes;
+    BoundingBoxSoA           boxes_soa;
+    boxes.reserve(k_box_count);
+    boxes_soa.Reserve(k_box_count);
+    for (uint32_t i = 0; i < k_box_count; ++i)
+    {
+        glm::vec3 center(static_cast<float>(i % 100) * 4.0f - 200.0f,
+                         static_cast<float>(i / 100 % 10) * 4.0f - 20.0f,
+                         static_cast<float>(i / 1000) * 8.0f - 400.0f);
+        boxes.emplace_back(center - glm::vec3(1.0f), center + glm::vec3(1.0f));
+        boxes_soa.Push(boxes.back());
+    }
+
+    std::vector<uint8_t> visibility(k_box_count);
+    double per_object_milliseconds = MeasureMilliseconds(k_iteration_count, [&frustum, &boxes, &visibility]() {
+        for (uint32_t i = 0; i < boxes.size(); ++i)
+        {
+            visibility[i] = frustum.checkIfInside(&boxes[i]);
+        }
+    });
+    std::vector<uint8_t> expected = visibility;
+
+    std::cout << std::format(
+        "\n{} boxes against a frustum, CPU supports {}\n", k_box_count, GetSimdLevelName(GetSimdLevel()));
+    std::cout << std::format("{:>14} {:>12.3f} ms\n", "per object", per_object_milliseconds);
+
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2})
+    {
+        if (level > GetSimdLevel())
+            continue;
+
+        double milliseconds = MeasureMilliseconds(k_iteration_count, [&frustum, &boxes_soa, &visibility, level]() {
+            frustum.CullBoundingBoxes(boxes_soa, visibility.data(), level);
+        });
+
+        std::cout << std::format("{:>14} {:>12.3f} ms, speedup {:.2f}x{}\n",
+                                 std::format("batched {}", GetSimdLevelName(level)),
+                                 milliseconds,
+                                 per_object_milliseconds / milliseconds,
+                                 visibility == expected ? "" : ", result differs from per object");
+    }
+
+    // the boxes do not move, so after the first frame each one is resolved by its block or its last plane
+    std::vector<uint8_t> last_planes(k_box_count, Frustum::k_no_plane);
+    frustum.CullBoundingBoxes(boxes_soa, 0, k_box_count, visibility.data(), last_planes.data());
+
+    double milliseconds = MeasureMilliseconds(k_iteration_count, [&frustum, &boxes_soa, &visibility, &last_planes]() {
+        frustum.CullBoundingBoxes(boxes_soa, 0, k_box_count, visibility.data(), last_planes.data());
+    });
+
+    std::cout << std::format("{:>14} {:>12.3f} ms, speedup {:.2f}x{}\n",
+                             "temporal",
+                             milliseconds,
+                             per_object_milliseconds / milliseconds,
+                             visibility == expected ? "" : ", result differs from per object");
+}
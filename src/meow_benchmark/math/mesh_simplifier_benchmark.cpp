@@ -0,0 +1,128 @@
+#include "benchmark.h"
+
+#include "meow_runtime/core/jobs/job_system.h"
+#include "meow_runtime/core/math/mesh_simplifier.h"
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <limits>
+#include <numbers>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    constexpr uint32_t k_iteration_count = 3;
+
+    constexpr uint32_t k_ring_count    = 200;
+    constexpr uint32_t k_segment_count = 200;
+
+    // meshes of a model are simplified as independent jobs
+    constexpr uint32_t k_mesh_count = 16;
+
+    /**
+     * @brief A closed sphere with a bumpy surface, vertices are shared across the seam and at the poles.
+     */
+    void CreateSphere(std::vector<float>& positions, std::vector<uint32_t>& indices)
+    {
+        auto add_position = [&positions](float theta, float phi) {
+            float radius = 1.0f + 0.05f * std::sin(theta * 12.0f) * std::sin(phi * 9.0f);
+            positions.push_back(radius * std::sin(theta) * std::cos(phi));
+            positions.push_back(radius * std::cos(theta));
+            positions.push_back(radius * std::sin(theta) * std::sin(phi));
+        };
+
+        const float pi = std::numbers::pi_v<float>;
+
+        // north pole, the rings between the poles, south pole
+        add_position(0.0f, 0.0f);
+        for (uint32_t ring = 1; ring < k_ring_count; ++ring)
+        {
+            for (uint32_t segment = 0; segment < k_segment_count; ++segment)
+            {
+                add_position(pi * ring / k_ring_count, 2.0f * pi * segment / k_segment_count);
+            }
+        }
+        add_position(pi, 0.0f);
+
+        const uint32_t south_pole = static_cast<uint32_t>(positions.size() / 3 - 1);
+        auto get_index = [](uint32_t ring, uint32_t segment) {
+            return 1 + (ring - 1) * k_segment_count + segment % k_segment_count;
+        };
+
+        for (uint32_t segment = 0; segment < k_segment_count; ++segment)
+        {
+            uint32_t last_ring = k_ring_count - 1;
+            indices.insert(indices.end(), {0, get_index(1, segment + 1), get_index(1, segment)});
+            indices.insert(indices.end(),
+                           {south_pole, get_index(last_ring, segment), get_index(last_ring, segment + 1)});
+
+            for (uint32_t ring = 1; ring + 1 < k_ring_count; ++ring)
+            {
+                uint32_t a = get_index(ring, segment);
+                uint32_t b = get_index(ring, segment + 1);
+                uint32_t c = get_index(ring + 1, segment);
+                uint32_t d = get_index(ring + 1, segment + 1);
+                indices.insert(indices.end(), {a, b, d, a, d, c});
+            }
+        }
+    }
+} // namespace
+
+MEOW_BENCHMARK(MeshSimplifier)
+{
+    std::vector<float>    positions;
+    std::vector<uint32_t> indices;
+    CreateSphere(positions, indices);
+
+    std::cout << std::format("\nsphere of {} triangles, each level halves the one before\n", indices.size() / 3);
+
+    // the same chain of levels a model mesh builds at load
+    std::vector<uint32_t> level_indices = indices;
+    float                 total_error   = 0.0f;
+    for (uint32_t level = 1; level < 4; ++level)
+    {
+        std::vector<uint32_t> simplified;
+        float                 error        = 0.0f;
+        double                milliseconds = MeasureMilliseconds(k_iteration_count, [&]() {
+            simplified = SimplifyMesh(positions,
+                                      3,
+                                      level_indices,
+                                      static_cast<uint32_t>(level_indices.size() / 6 * 3),
+                                      std::numeric_limits<float>::max(),
+                                      &error);
+        });
+
+        total_error += error;
+        std::cout << std::format("{:>22} {:>12.3f} ms, {} triangles, error {:.5f}\n",
+                                 std::format("level {}", level),
+                                 milliseconds,
+                                 simplified.size() / 3,
+                                 total_error);
+
+        level_indices = std::move(simplified);
+    }
+
+    auto simplify_meshes = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            SimplifyMesh(positions, 3, indices, static_cast<uint32_t>(indices.size() / 6 * 3), 1.0f);
+        }
+    };
+
+    double milliseconds = MeasureMilliseconds(k_iteration_count, [&]() { simplify_meshes(0, k_mesh_count); });
+
+    JobSystem job_system;
+    double    parallel_milliseconds = MeasureMilliseconds(
+        k_iteration_count, [&]() { job_system.ParallelFor(0, k_mesh_count, 1, simplify_meshes); });
+
+    std::cout << std::format("{:>22} {:>12.3f} ms\n", std::format("{} meshes", k_mesh_count), milliseconds);
+    std::cout << std::format("{:>22} {:>12.3f} ms, speedup {:.2f}x\n",
+                             std::format("{} meshes on {} threads", k_mesh_count, job_system.GetThreadCount()),
+                             parallel_milliseconds,
+                             milliseconds / parallel_milliseconds);
+}
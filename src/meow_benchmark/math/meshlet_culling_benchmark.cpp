@@ -0,0 +1,121 @@
+#include "benchmark.h"
+
+#include "meow_runtime/core/math/meshlet.h"
+
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    constexpr uint32_t k_iteration_count = 10;
+
+    constexpr uint32_t k_ring_count    = 200;
+    constexpr uint32_t k_segment_count = 200;
+
+    constexpr uint32_t k_instance_count = 1000;
+
+    /**
+     * @brief A closed unit sphere whose triangles wind counter-clockwise seen from outside.
+     */
+    void CreateSphere(std::vector<float>& positions, std::vector<uint32_t>& indices)
+    {
+        const float pi = std::numbers::pi_v<float>;
+
+        positions.insert(positions.end(), {0.0f, 1.0f, 0.0f});
+        for (uint32_t ring = 1; ring < k_ring_count; ++ring)
+        {
+            for (uint32_t segment = 0; segment < k_segment_count; ++segment)
+            {
+                float theta = pi * ring / k_ring_count;
+                float phi   = 2.0f * pi * segment / k_segment_count;
+                positions.insert(positions.end(),
+                                 {std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)});
+            }
+        }
+        positions.insert(positions.end(), {0.0f, -1.0f, 0.0f});
+
+        const uint32_t south_pole = static_cast<uint32_t>(positions.size() / 3 - 1);
+        auto get_index = [](uint32_t ring, uint32_t segment) {
+            return 1 + (ring - 1) * k_segment_count + segment % k_segment_count;
+        };
+
+        for (uint32_t segment = 0; segment < k_segment_count; ++segment)
+        {
+            uint32_t last_ring = k_ring_count - 1;
+            indices.insert(indices.end(), {0, get_index(1, segment + 1), get_index(1, segment)});
+            indices.insert(indices.end(),
+                           {south_pole, get_index(last_ring, segment), get_index(last_ring, segment + 1)});
+
+            for (uint32_t ring = 1; ring + 1 < k_ring_count; ++ring)
+            {
+                uint32_t a = get_index(ring, segment);
+                uint32_t b = get_index(ring, segment + 1);
+                uint32_t c = get_index(ring + 1, segment);
+                uint32_t d = get_index(ring + 1, segment + 1);
+                indices.insert(indices.end(), {a, b, d, a, d, c});
+            }
+        }
+    }
+} // namespace
+
+MEOW_BENCHMARK(MeshletCulling)
+{
+    std::vector<float>    positions;
+    std::vector<uint32_t> indices;
+    CreateSphere(positions, indices);
+
+    std::vector<Meshlet> meshlets;
+    double               build_milliseconds =
+        MeasureMilliseconds(1, [&]() { meshlets = BuildMeshlets(positions, 3, indices); });
+
+    std::cout << std::format("\nsphere of {} triangles into {} meshlets\n", indices.size() / 3, meshlets.size());
+    std::cout << std::format("{:>22} {:>12.3f} ms\n", "build", build_milliseconds);
+
+    // instances spread in front of a camera at the origin looking down -z, some partly outside the frustum
+    Frustum frustum;
+    frustum.updatePlanes(glm::vec3(0.0f), glm::quat(0.0f, 0.0f, 1.0f, 0.0f), glm::radians(60.0f), 2.0f, 0.1f, 500.0f);
+
+    std::mt19937                          random(0);
+    std::uniform_real_distribution<float> x_distribution(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> z_distribution(-100.0f, -5.0f);
+    std::vector<glm::mat4>                world_matrices(k_instance_count, glm::mat4(1.0f));
+    for (glm::mat4& world_matrix : world_matrices)
+    {
+        world_matrix[3] = glm::vec4(x_distribution(random), 0.0f, z_distribution(random), 1.0f);
+    }
+
+    std::vector<uint8_t>    visibility(meshlets.size());
+    std::vector<IndexRange> ranges;
+    uint64_t                drawn_index_count = 0;
+    double                  milliseconds      = MeasureMilliseconds(k_iteration_count, [&]() {
+        ranges.clear();
+        drawn_index_count = 0;
+        for (const glm::mat4& world_matrix : world_matrices)
+        {
+            CullMeshlets(meshlets, GetMeshletCullParams(frustum, glm::vec3(0.0f), world_matrix), visibility.data());
+
+            uint32_t first_range = static_cast<uint32_t>(ranges.size());
+            uint32_t range_count = AppendVisibleIndexRanges(meshlets, visibility.data(), ranges);
+            for (uint32_t i = first_range; i < first_range + range_count; ++i)
+            {
+                drawn_index_count += ranges[i].index_count;
+            }
+        }
+    });
+
+    double meshlets_per_second = static_cast<double>(k_instance_count) * meshlets.size() / milliseconds * 1000.0;
+    std::cout << std::format("{:>22} {:>12.3f} ms, {:.1f} M meshlets/s\n",
+                             std::format("cull {} instances", k_instance_count),
+                             milliseconds,
+                             meshlets_per_second * 1e-6);
+    std::cout << std::format("{:>22} {:>12.1f} %, {} draws\n",
+                             "triangles drawn",
+                             100.0 * drawn_index_count / (static_cast<double>(indices.size()) * k_instance_count),
+                             ranges.size());
+}
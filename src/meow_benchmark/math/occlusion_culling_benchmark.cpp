@@ -0,0 +1,148 @@
+#include "benchmark.h"
+
+#include "meow_runtime/core/jobs/job_system.h"
+#include "meow_runtime/core/math/occlusion_buffer.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <atomic>
+#include <format>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    constexpr uint32_t k_iteration_count = 10;
+
+    constexpr uint32_t k_box_count = 100000;
+
+    /**
+     * @brief Append the 12 triangles of a box as an indexed triangle list of positions.
+     */
+    void AppendBox(const BoundingBox& box, std::vector<float>& positions, std::vector<uint32_t>& indices)
+    {
+        static constexpr uint32_t k_box_indices[36] = {0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1,
+                                                       2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3};
+
+        uint32_t first_index = static_cast<uint32_t>(positions.size() / 3);
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            positions.push_back(i & 1 ? box.max.x : box.min.x);
+            positions.push_back(i & 2 ? box.max.y : box.min.y);
+            positions.push_back(i & 4 ? box.max.z : box.min.z);
+        }
+
+        for (uint32_t index : k_box_indices)
+        {
+            indices.push_back(first_index + index);
+        }
+    }
+} // namespace
+
+MEOW_BENCHMARK(OcclusionCulling)
+{
+    // a street of buildings on both sides and across its end, with small objects scattered behind and between them
+    std::vector<float>    positions;
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        float z = -20.0f - static_cast<float>(i) * 24.0f;
+        AppendBox(BoundingBox(glm::vec3(-60.0f, 0.0f, z - 20.0f), glm::vec3(-8.0f, 30.0f, z)), positions, indices);
+        AppendBox(BoundingBox(glm::vec3(8.0f, 0.0f, z - 20.0f), glm::vec3(60.0f, 30.0f, z)), positions, indices);
+    }
+    AppendBox(BoundingBox(glm::vec3(-8.0f, 0.0f, -420.0f), glm::vec3(8.0f, 30.0f, -400.0f)), positions, indices);
+
+    std::mt19937                          random(0);
+    std::uniform_real_distribution<float> x_distribution(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> z_distribution(-500.0f, -5.0f);
+    std::vector<BoundingBox>              boxes;
+    boxes.reserve(k_box_count);
+    for (uint32_t i = 0; i < k_box_count; ++i)
+    {
+        glm::vec3 center(x_distribution(random), 1.0f, z_distribution(random));
+        boxes.emplace_back(center - glm::vec3(1.0f), center + glm::vec3(1.0f));
+    }
+
+    glm::mat4 view       = glm::lookAt(glm::vec3(0.0f, 2.0f, 0.0f), glm::vec3(0.0f, 2.0f, -1.0f), glm::vec3(0, 1, 0));
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 1000.0f);
+
+    OcclusionBuffer buffer;
+    auto            rasterize = [&](JobSystem* job_system, SimdLevel level) {
+        buffer.Clear(projection * view, 0.1f);
+        buffer.AddOccluder(positions, 3, indices, glm::mat4(1.0f));
+        buffer.Rasterize(job_system, level);
+    };
+
+    std::cout << std::format("\n{} occluder triangles into {}x{} pixels, CPU supports {}\n",
+                             indices.size() / 3,
+                             buffer.GetWidth(),
+                             buffer.GetHeight(),
+                             GetSimdLevelName(GetSimdLevel()));
+
+    double scalar_milliseconds = 0.0;
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2})
+    {
+        if (level > GetSimdLevel())
+            continue;
+
+        double milliseconds = MeasureMilliseconds(k_iteration_count, [&]() { rasterize(nullptr, level); });
+        if (level == SimdLevel::Scalar)
+            scalar_milliseconds = milliseconds;
+
+        std::cout << std::format("{:>22} {:>12.3f} ms, speedup {:.2f}x\n",
+                                 std::format("rasterize {}", GetSimdLevelName(level)),
+                                 milliseconds,
+                                 scalar_milliseconds / milliseconds);
+    }
+
+    JobSystem job_system;
+    double    parallel_milliseconds =
+        MeasureMilliseconds(k_iteration_count, [&]() { rasterize(&job_system, GetSimdLevel()); });
+
+    std::cout << std::format("{:>22} {:>12.3f} ms, speedup {:.2f}x\n",
+                             std::format("rasterize on {} threads", job_system.GetThreadCount()),
+                             parallel_milliseconds,
+                             scalar_milliseconds / parallel_milliseconds);
+
+    std::vector<uint8_t> visibility(k_box_count);
+    double               test_milliseconds = MeasureMilliseconds(k_iteration_count, [&]() {
+        for (uint32_t i = 0; i < k_box_count; ++i)
+        {
+            visibility[i] = !buffer.IsOccluded(boxes[i]);
+        }
+    });
+
+    uint32_t culled_count = 0;
+    for (uint8_t is_visible : visibility)
+    {
+        culled_count += !is_visible;
+    }
+
+    std::cout << std::format("{:>22} {:>12.3f} ms, {} of {} boxes culled\n",
+                             "test boxes",
+                             test_milliseconds,
+                             culled_count,
+                             k_box_count);
+
+    std::atomic<uint32_t> parallel_culled_count = 0;
+    double parallel_test_milliseconds           = MeasureMilliseconds(k_iteration_count, [&]() {
+        parallel_culled_count = 0;
+        job_system.ParallelFor(0, k_box_count, 1024, [&](uint32_t begin, uint32_t end) {
+            uint32_t count = 0;
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                count += buffer.IsOccluded(boxes[i]);
+            }
+            parallel_culled_count += count;
+        });
+    });
+
+    std::cout << std::format("{:>22} {:>12.3f} ms, speedup {:.2f}x{}\n",
+                             std::format("test on {} threads", job_system.GetThreadCount()),
+                             parallel_test_milliseconds,
+                             test_milliseconds / parallel_test_milliseconds,
+                             parallel_culled_count == culled_count ? "" : ", result differs from one thread");
+}
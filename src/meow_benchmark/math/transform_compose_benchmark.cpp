@@ -0,0 +1,76 @@
+#include "benchmark.h"
+
+#include "meow_runtime/core/math/transform_soa.h"
+#include "meow_runtime/function/components/transform/transform_3d_component.hpp"
+
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    constexpr uint32_t k_iteration_count = 10;
+
+    std::vector<Transform3DComponent> CreateTransforms(uint32_t count)
+    {
+        std::vector<Transform3DComponent> transforms(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            float t                = static_cast<float>(i);
+            transforms[i].position = glm::vec3(t * 0.5f, t * 0.25f, -t);
+            transforms[i].rotation = glm::normalize(glm::quat(1.0f, t * 0.01f, t * 0.02f, t * 0.03f));
+            transforms[i].scale    = glm::vec3(1.0f + t * 0.001f, 1.0f, 2.0f);
+        }
+
+        return transforms;
+    }
+} // namespace
+
+MEOW_BENCHMARK(TransformCompose)
+{
+    constexpr uint32_t k_transform_count = 100000;
+
+    std::vector<Transform3DComponent> transforms = CreateTransforms(k_transform_count);
+
+    TransformSoA transforms_soa;
+    transforms_soa.Reserve(k_transform_count);
+    for (const Transform3DComponent& transform : transforms)
+    {
+        transforms_soa.Push(transform.position, transform.rotation, transform.scale);
+    }
+
+    std::vector<glm::mat4> expected(k_transform_count);
+    double per_object_milliseconds = MeasureMilliseconds(k_iteration_count, [&transforms, &expected]() {
+        for (uint32_t i = 0; i < transforms.size(); ++i)
+        {
+            expected[i] = transforms[i].GetTransform();
+        }
+    });
+
+    std::cout << std::format("\n{} TRS matrices, CPU supports {}\n",
+                             k_transform_count,
+                             GetSimdLevelName(GetSimdLevel()));
+    std::cout << std::format("{:>14} {:>12.3f} ms\n", "per object", per_object_milliseconds);
+
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2})
+    {
+        if (level > GetSimdLevel())
+            continue;
+
+        std::vector<glm::mat4> matrices(k_transform_count);
+        double milliseconds = MeasureMilliseconds(k_iteration_count, [&transforms_soa, &matrices, level]() {
+            ComposeTransforms(transforms_soa, {}, matrices.data(), level);
+        });
+
+        bool is_identical =
+            std::memcmp(matrices.data(), expected.data(), k_transform_count * sizeof(glm::mat4)) == 0;
+        std::cout << std::format("{:>14} {:>12.3f} ms, speedup {:.2f}x{}\n",
+                                 std::format("SoA {}", GetSimdLevelName(level)),
+                                 milliseconds,
+                                 per_object_milliseconds / milliseconds,
+                                 is_identical ? "" : ", result differs from per object");
+    }
+}
@@ -0,0 +1,210 @@
+#include "benchmark.h"
+
+#include "meow_runtime/core/jobs/job_system.h"
+#include "meow_runtime/core/math/triangle_bvh.h"
+#include "meow_runtime/function/file/file_system.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <atomic>
+#include <format>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    constexpr uint32_t k_iteration_count = 5;
+    constexpr uint32_t k_ray_count       = 100000;
+
+    // brute force tests every triangle, so it only gets a sample of the rays
+    constexpr uint32_t k_brute_force_ray_count = 500;
+
+    /**
+     * @brief Load the positions of all meshes of a model in model space, as one triangle list.
+     */
+    bool LoadPositions(const std::string& file_path, std::vector<float>& positions, std::vector<uint32_t>& indices)
+    {
+        Assimp::Importer importer;
+        const aiScene*   scene = importer.ReadFile(file_path, aiProcess_Triangulate | aiProcess_PreTransformVertices);
+        if (!scene)
+            return false;
+
+        for (uint32_t i = 0; i < scene->mNumMeshes; ++i)
+        {
+            const aiMesh* mesh        = scene->mMeshes[i];
+            uint32_t      first_index = static_cast<uint32_t>(positions.size() / 3);
+            for (uint32_t j = 0; j < mesh->mNumVertices; ++j)
+            {
+                positions.push_back(mesh->mVertices[j].x);
+                positions.push_back(mesh->mVertices[j].y);
+                positions.push_back(mesh->mVertices[j].z);
+            }
+
+            for (uint32_t j = 0; j < mesh->mNumFaces; ++j)
+            {
+                const aiFace& face = mesh->mFaces[j];
+                if (face.mNumIndices != 3)
+                    continue;
+
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    indices.push_back(first_index + face.mIndices[k]);
+                }
+            }
+        }
+
+        return !indices.empty();
+    }
+
+    bool RaycastBruteForce(const std::vector<float>& positions, const std::vector<uint32_t>& indices, const Ray& ray)
+    {
+        auto get_position = [&positions, &indices](uint32_t index) {
+            return glm::vec3(
+                positions[indices[index] * 3], positions[indices[index] * 3 + 1], positions[indices[index] * 3 + 2]);
+        };
+
+        for (uint32_t i = 0; i < indices.size(); i += 3)
+        {
+            glm::vec3 v0    = get_position(i);
+            glm::vec3 edge1 = get_position(i + 1) - v0;
+            glm::vec3 edge2 = get_position(i + 2) - v0;
+
+            glm::vec3 p           = glm::cross(ray.direction, edge2);
+            float     determinant = glm::dot(edge1, p);
+            if (determinant == 0.0f)
+                continue;
+
+            glm::vec3 s = ray.origin - v0;
+            glm::vec3 q = glm::cross(s, edge1);
+            float     u = glm::dot(s, p) / determinant;
+            float     v = glm::dot(ray.direction, q) / determinant;
+            if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && glm::dot(edge2, q) / determinant > 0.0f)
+                return true;
+        }
+
+        return false;
+    }
+
+    void RunTriangleBVH(const std::string& file_path)
+    {
+        FileSystem file_system;
+        if (!file_system.Exists(file_path))
+        {
+            std::cout << std::format("\n{} not found, skipped\n", file_path);
+            return;
+        }
+
+        std::vector<float>    positions;
+        std::vector<uint32_t> indices;
+        if (!LoadPositions(file_system.GetAbsolutePath(file_path), positions, indices))
+        {
+            std::cout << std::format("\n{} has no triangles, skipped\n", file_path);
+            return;
+        }
+
+        uint32_t triangle_count = static_cast<uint32_t>(indices.size() / 3);
+        std::cout << std::format("\n{}, {} triangles\n", file_path, triangle_count);
+
+        TriangleBVH bvh;
+        double      build_milliseconds =
+            MeasureMilliseconds(k_iteration_count, [&]() { bvh.Build(positions, 3, indices); });
+
+        JobSystem job_system;
+        double    parallel_build_milliseconds =
+            MeasureMilliseconds(k_iteration_count, [&]() { bvh.Build(positions, 3, indices, &job_system); });
+
+        std::cout << std::format("{:>22} {:>12.3f} ms, {} nodes\n", "build", build_milliseconds, bvh.GetNodeCount());
+        std::cout << std::format("{:>22} {:>12.3f} ms, speedup {:.2f}x\n",
+                                 std::format("build on {} threads", job_system.GetThreadCount()),
+                                 parallel_build_milliseconds,
+                                 build_milliseconds / parallel_build_milliseconds);
+
+        // rays from a sphere around the model towards random points within its bounds, most of them hit
+        BoundingBox bounds = bvh.GetBounds();
+        glm::vec3   center = (bounds.min + bounds.max) * 0.5f;
+        glm::vec3   extent = (bounds.max - bounds.min) * 0.5f;
+        float       radius = glm::length(extent) * 2.0f;
+
+        std::mt19937                          random(0);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::vector<Ray>                      rays(k_ray_count);
+        for (Ray& ray : rays)
+        {
+            glm::vec3 origin_direction = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) + 1e-4f);
+            glm::vec3 target = center + extent * glm::vec3(unit(random), unit(random), unit(random)) * 0.5f;
+
+            ray.origin    = center + origin_direction * radius;
+            ray.direction = glm::normalize(target - ray.origin);
+        }
+
+        uint32_t brute_force_hit_count    = 0;
+        double   brute_force_milliseconds = MeasureMilliseconds(1, [&]() {
+            brute_force_hit_count = 0;
+            for (uint32_t i = 0; i < k_brute_force_ray_count; ++i)
+            {
+                brute_force_hit_count += RaycastBruteForce(positions, indices, rays[i]);
+            }
+        });
+
+        double brute_force_rays_per_second = k_brute_force_ray_count / brute_force_milliseconds * 1000.0;
+        std::cout << std::format("{:>22} {:>12.3f} Mrays/s\n", "brute force", brute_force_rays_per_second * 1e-6);
+
+        // any hit is enough to compare with brute force, which stops at the first hit
+        auto count_hits = [&bvh, &rays](uint32_t begin, uint32_t end, SimdLevel level) {
+            uint32_t hit_count = 0;
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                TriangleBVH::Hit hit;
+                hit_count += bvh.Raycast(rays[i], std::numeric_limits<float>::max(), hit, level);
+            }
+            return hit_count;
+        };
+
+        uint32_t hit_count = 0;
+        for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2})
+        {
+            if (level > GetSimdLevel())
+                continue;
+
+            double milliseconds = MeasureMilliseconds(
+                k_iteration_count, [&]() { hit_count = count_hits(0, k_ray_count, level); });
+
+            double rays_per_second = k_ray_count / milliseconds * 1000.0;
+            std::cout << std::format("{:>22} {:>12.3f} Mrays/s, speedup {:.1f}x, {:.1f}% hit{}\n",
+                                     std::format("bvh {}", GetSimdLevelName(level)),
+                                     rays_per_second * 1e-6,
+                                     rays_per_second / brute_force_rays_per_second,
+                                     100.0 * hit_count / k_ray_count,
+                                     count_hits(0, k_brute_force_ray_count, level) == brute_force_hit_count
+                                         ? ""
+                                         : ", hits differ from brute force");
+        }
+
+        // rays are independent, so they scale with the threads casting them
+        std::atomic<uint32_t> parallel_hit_count = 0;
+        double parallel_milliseconds = MeasureMilliseconds(k_iteration_count, [&]() {
+            parallel_hit_count = 0;
+            job_system.ParallelFor(0, k_ray_count, 1024, [&](uint32_t begin, uint32_t end) {
+                parallel_hit_count += count_hits(begin, end, GetSimdLevel());
+            });
+        });
+
+        std::cout << std::format("{:>22} {:>12.3f} Mrays/s{}\n",
+                                 std::format("bvh on {} threads", job_system.GetThreadCount()),
+                                 k_ray_count / parallel_milliseconds * 1e-3,
+                                 parallel_hit_count == hit_count ? "" : ", hits differ from one thread");
+    }
+} // namespace
+
+MEOW_BENCHMARK(TriangleBVHRaycast)
+{
+    RunTriangleBVH("builtin/models/nanosuit/nanosuit.obj");
+    RunTriangleBVH("builtin/models/backpack/backpack.obj");
+}
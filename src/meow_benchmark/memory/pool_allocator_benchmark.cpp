@@ -0,0 +1,72 @@
+#include "benchmark.h"
+
+#include "meow_runtime/core/memory/pool_allocator.h"
+
+#include <format>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace Meow;
+
+namespace
+{
+    constexpr uint32_t k_iteration_count = 10;
+
+    /**
+     * @brief Roughly the size of a game object.
+     */
+    struct Bullet
+    {
+        float    position[3] = {};
+        float    velocity[3] = {};
+        uint64_t id          = 0;
+        char     name[64]    = {};
+    };
+
+    /**
+     * @brief Each frame destroys a quarter of the live objects in a scattered pattern and spawns as many new ones,
+     * like a bullet heavy level.
+     */
+    template<typename Spawn>
+    double MeasureChurn(uint32_t live_count, uint32_t frame_count, Spawn&& spawn)
+    {
+        return MeasureMilliseconds(k_iteration_count, [&]() {
+            std::vector<std::shared_ptr<Bullet>> bullets(live_count);
+            for (uint32_t i = 0; i < live_count; ++i)
+            {
+                bullets[i] = spawn();
+            }
+
+            for (uint32_t frame = 0; frame < frame_count; ++frame)
+            {
+                for (uint32_t i = frame % 4; i < live_count; i += 4)
+                {
+                    bullets[i] = spawn();
+                }
+            }
+        });
+    }
+} // namespace
+
+MEOW_BENCHMARK(PoolAllocatorChurn)
+{
+    constexpr uint32_t k_live_count  = 100000;
+    constexpr uint32_t k_frame_count = 60;
+
+    double heap_milliseconds = MeasureChurn(k_live_count, k_frame_count, []() { return std::make_shared<Bullet>(); });
+
+    PoolAllocator& pool             = GetTypePool<Bullet>("Bullet");
+    double         pool_milliseconds = MeasureChurn(k_live_count, k_frame_count, [&pool]() {
+        return std::allocate_shared<Bullet>(PoolStdAllocator<Bullet>(pool));
+    });
+
+    PoolStat stat = pool.GetStat();
+    std::cout << std::format("\n100k live objects, 60 frames replacing a quarter of them\n");
+    std::cout << std::format("{:>14} {:>12.3f} ms\n", "make_shared", heap_milliseconds);
+    std::cout << std::format("{:>14} {:>12.3f} ms, peak {} blocks of {} bytes\n",
+                             "pooled",
+                             pool_milliseconds,
+                             stat.peak_blocks,
+                             stat.block_size);
+}
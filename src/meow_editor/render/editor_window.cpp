@@ -14,6 +14,8 @@
 #include <glm/gtc/random.hpp>
 #include <imgui.h>
 
+#include <array>
+
 namespace Meow
 {
     EditorWindow::EditorWindow(std::size_t id, GLFWwindow* glfw_window)
@@ -45,9 +47,9 @@ namespace Meow
             MEOW_ERROR("shared ptr is invalid!");
 #endif
 
-        auto main_camera_id = level_ptr->CreateObject();
-        level_ptr->SetMainCameraID(main_camera_id);
-        std::shared_ptr<GameObject> camera_go_ptr = level_ptr->GetGameObjectByID(main_camera_id).lock();
+        GameObjectHandle main_camera_handle = level_ptr->CreateObject();
+        level_ptr->SetMainCamera(main_camera_handle);
+        std::shared_ptr<GameObject> camera_go_ptr = level_ptr->GetGameObject(main_camera_handle)->shared_from_this();
 
 #ifdef MEOW_DEBUG
         if (!camera_go_ptr)
@@ -56,9 +58,9 @@ namespace Meow
 
         camera_go_ptr->SetName("Camera");
         std::shared_ptr<Transform3DComponent> camera_transform_comp_ptr =
-            TryAddComponent(camera_go_ptr, "Transform3DComponent", std::make_shared<Transform3DComponent>());
+            TryAddComponent(camera_go_ptr, "Transform3DComponent", Transform3DComponent());
         std::shared_ptr<Camera3DComponent> camera_comp_ptr =
-            TryAddComponent(camera_go_ptr, "Camera3DComponent", std::make_shared<Camera3DComponent>());
+            TryAddComponent(camera_go_ptr, "Camera3DComponent", Camera3DComponent());
 
 #ifdef MEOW_DEBUG
         if (!camera_transform_comp_ptr)
@@ -66,24 +68,24 @@ namespace Meow
         if (!camera_comp_ptr)
             MEOW_ERROR("shared ptr is invalid!");
 #endif
-        camera_transform_comp_ptr->position = glm::vec3(0.0f, 0.0f, -10.0f);
+        camera_transform_comp_ptr->SetPosition(glm::vec3(0.0f, 0.0f, -10.0f));
 
         camera_comp_ptr->camera_mode  = CameraMode::Free;
         camera_comp_ptr->aspect_ratio = (float)m_surface_data.extent.width / m_surface_data.extent.height;
 
-        UUID                        model_go_id  = level_ptr->CreateObject();
-        std::shared_ptr<GameObject> model_go_ptr = level_ptr->GetGameObjectByID(model_go_id).lock();
+        GameObjectHandle            model_go_handle = level_ptr->CreateObject();
+        std::shared_ptr<GameObject> model_go_ptr    = level_ptr->GetGameObject(model_go_handle)->shared_from_this();
 
 #ifdef MEOW_DEBUG
         if (!model_go_ptr)
             MEOW_ERROR("GameObject is invalid!");
 #endif
         model_go_ptr->SetName("Nanosuit");
-        TryAddComponent(model_go_ptr, "Transform3DComponent", std::make_shared<Transform3DComponent>());
+        TryAddComponent(model_go_ptr, "Transform3DComponent", Transform3DComponent());
         TryAddComponent(model_go_ptr,
                         "ModelComponent",
-                        std::make_shared<ModelComponent>("builtin/models/nanosuit/nanosuit.obj",
-                                                         m_render_pass_ptr->input_vertex_attributes));
+                        ModelComponent("builtin/models/nanosuit/nanosuit.obj",
+                                       m_render_pass_ptr->input_vertex_attributes));
     }
 
     EditorWindow::~EditorWindow()
@@ -98,11 +100,12 @@ namespace Meow
         m_imgui_pass            = nullptr;
         m_imgui_descriptor_pool = nullptr;
         m_per_frame_data.clear();
-        m_forward_pass         = nullptr;
-        m_deferred_pass        = nullptr;
-        m_descriptor_allocator = nullptr;
-        m_swapchain_data       = nullptr;
-        m_surface_data         = nullptr;
+        m_frame_timeline_semaphore = nullptr;
+        m_forward_pass             = nullptr;
+        m_deferred_pass            = nullptr;
+        m_descriptor_allocator     = nullptr;
+        m_swapchain_data           = nullptr;
+        m_surface_data             = nullptr;
     }
 
     void EditorWindow::Tick(float dt)
@@ -121,6 +124,10 @@ namespace Meow
         auto&                   render_finished_semaphore = per_frame_data.render_finished_semaphore;
         auto&                   in_flight_fence           = per_frame_data.in_flight_fence;
 
+        // the GPU may still draw the other frames in flight while this one is updated and recorded
+        WaitForFrame(per_frame_data);
+
+        m_render_pass_ptr->SetFrameIndex(m_current_frame_index);
         m_render_pass_ptr->UpdateUniformBuffer();
 
         // ------------------- render -------------------
@@ -136,6 +143,7 @@ namespace Meow
         assert(result == vk::Result::eSuccess);
         assert(m_current_image_index < m_swapchain_data.images.size());
 
+        cmd_buffer.reset();
         cmd_buffer.begin({});
         cmd_buffer.setViewport(0,
                                vk::Viewport(0.0f,
@@ -161,14 +169,30 @@ namespace Meow
         cmd_buffer.end();
 
         vk::PipelineStageFlags wait_destination_stage_mask(vk::PipelineStageFlagBits::eColorAttachmentOutput);
-        vk::SubmitInfo         submit_info(
-            *image_acquired_semaphore, wait_destination_stage_mask, *cmd_buffer, *render_finished_semaphore);
-        graphics_queue.submit(submit_info, *in_flight_fence);
+        if (g_runtime_context.render_system->IsTimelineSemaphoreEnabled())
+        {
+            per_frame_data.timeline_value = ++m_submitted_frame_count;
+
+            // the value for the binary semaphore is ignored
+            std::array<vk::Semaphore, 2> signal_semaphores = {*render_finished_semaphore, *m_frame_timeline_semaphore};
+            std::array<uint64_t, 2>      signal_values     = {0, per_frame_data.timeline_value};
+
+            vk::TimelineSemaphoreSubmitInfo timeline_submit_info({}, signal_values);
+            vk::SubmitInfo                  submit_info(*image_acquired_semaphore,
+                                                        wait_destination_stage_mask,
+                                                        *cmd_buffer,
+                                                        signal_semaphores,
+                                                        &timeline_submit_info);
+            graphics_queue.submit(submit_info);
+        }
+        else
+        {
+            logical_device.resetFences({*in_flight_fence});
 
-        while (vk::Result::eTimeout == logical_device.waitForFences({*in_flight_fence}, VK_TRUE, k_fence_timeout))
-            ;
-        cmd_buffer.reset();
-        logical_device.resetFences({*in_flight_fence});
+            vk::SubmitInfo submit_info(
+                *image_acquired_semaphore, wait_destination_stage_mask, *cmd_buffer, *render_finished_semaphore);
+            graphics_queue.submit(submit_info, *in_flight_fence);
+        }
 
         vk::PresentInfoKHR present_info(
             *render_finished_semaphore, *m_swapchain_data.swap_chain, m_current_image_index);
@@ -282,7 +306,38 @@ namespace Meow
                 vk::raii::Semaphore(logical_device, vk::SemaphoreCreateInfo());
             m_per_frame_data[i].render_finished_semaphore =
                 vk::raii::Semaphore(logical_device, vk::SemaphoreCreateInfo());
-            m_per_frame_data[i].in_flight_fence = vk::raii::Fence(logical_device, vk::FenceCreateInfo());
+            // signaled, so that the first wait for each frame returns at once
+            if (!g_runtime_context.render_system->IsTimelineSemaphoreEnabled())
+                m_per_frame_data[i].in_flight_fence =
+                    vk::raii::Fence(logical_device, vk::FenceCreateInfo(vk::FenceCreateFlagBits::eSignaled));
+        }
+
+        m_submitted_frame_count = 0;
+        if (g_runtime_context.render_system->IsTimelineSemaphoreEnabled())
+        {
+            vk::SemaphoreTypeCreateInfo semaphore_type_create_info(vk::SemaphoreType::eTimeline, 0);
+            m_frame_timeline_semaphore =
+                vk::raii::Semaphore(logical_device, vk::SemaphoreCreateInfo({}, &semaphore_type_create_info));
+        }
+    }
+
+    void EditorWindow::WaitForFrame(const PerFrameData& per_frame_data)
+    {
+        FUNCTION_TIMER();
+
+        const vk::raii::Device& logical_device = g_runtime_context.render_system->GetLogicalDevice();
+
+        if (g_runtime_context.render_system->IsTimelineSemaphoreEnabled())
+        {
+            vk::SemaphoreWaitInfo semaphore_wait_info({}, *m_frame_timeline_semaphore, per_frame_data.timeline_value);
+            while (vk::Result::eTimeout == logical_device.waitSemaphores(semaphore_wait_info, k_fence_timeout))
+                ;
+        }
+        else
+        {
+            while (vk::Result::eTimeout ==
+                   logical_device.waitForFences({*per_frame_data.in_flight_fence}, VK_TRUE, k_fence_timeout))
+                ;
         }
     }
 
@@ -433,8 +488,8 @@ namespace Meow
 
         // update aspect ratio
 
-        std::shared_ptr<Level>      level_ptr     = g_runtime_context.level_system->GetCurrentActiveLevel().lock();
-        std::shared_ptr<GameObject> camera_go_ptr = level_ptr->GetGameObjectByID(level_ptr->GetMainCameraID()).lock();
+        std::shared_ptr<Level> level_ptr     = g_runtime_context.level_system->GetCurrentActiveLevel().lock();
+        GameObject*            camera_go_ptr = level_ptr->GetGameObject(level_ptr->GetMainCamera());
 
         if (!camera_go_ptr)
             return;
@@ -77,8 +77,56 @@ namespace Meow
             ImGui::Text("%s", "Draw call");
             ImGui::NextColumn();
             ImGui::Text("%d", stat.draw_call);
+            ImGui::NextColumn();
+            ImGui::Text("%s", "Binds");
+            ImGui::NextColumn();
+            ImGui::Text("%u (%u redundant skipped)",
+                        stat.render_state_stat.bind_count,
+                        stat.render_state_stat.skipped_count);
             ImGui::Columns();
 
+            // zero when the pass has no per object uniforms
+            if (stat.uniform_stat.page_size > 0)
+            {
+                ImGui::Columns(2, "locations");
+                ImGui::Text("%s", "Uniform KB");
+                ImGui::NextColumn();
+                ImGui::Text("%.1f", stat.uniform_stat.used_bytes / 1024.0f);
+                ImGui::NextColumn();
+                ImGui::Text("%s", "Peak uniform KB");
+                ImGui::NextColumn();
+                ImGui::Text("%.1f", stat.uniform_stat.peak_bytes / 1024.0f);
+                ImGui::NextColumn();
+                ImGui::Text("%s", "Uniform pages");
+                ImGui::NextColumn();
+                ImGui::Text("%u / %u (peak per frame / total, %llu KB each)",
+                            stat.uniform_stat.peak_page_count,
+                            stat.uniform_stat.page_count,
+                            static_cast<unsigned long long>(stat.uniform_stat.page_size / 1024));
+                ImGui::Columns();
+            }
+
+            // zero when the pass does not cull on the GPU
+            if (stat.gpu_culling_stat.object_count > 0)
+            {
+                ImGui::Columns(2, "locations");
+                ImGui::Text("%s", "GPU culled objects");
+                ImGui::NextColumn();
+                ImGui::Text("%u / %u visible, %u meshes",
+                            stat.gpu_culling_stat.gpu_visible_count,
+                            stat.gpu_culling_stat.object_count,
+                            stat.gpu_culling_stat.group_count);
+#ifdef MEOW_DEBUG
+                ImGui::NextColumn();
+                ImGui::Text("%s", "CPU reference");
+                ImGui::NextColumn();
+                ImGui::Text("%u visible, %u meshes differ",
+                            stat.gpu_culling_stat.cpu_visible_count,
+                            stat.gpu_culling_stat.mismatch_count);
+#endif
+                ImGui::Columns();
+            }
+
             ImGui::TreePop();
         }
 
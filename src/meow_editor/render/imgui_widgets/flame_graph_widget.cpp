@@ -4,6 +4,9 @@
 
 #include <glm/gtx/color_space.hpp>
 
+#include <algorithm>
+#include <thread>
+
 namespace Meow
 {
     void FlameGraphWidget::Draw(const std::vector<ScopeTimeData>& scope_times,
@@ -67,12 +70,38 @@ namespace Meow
         ImGuiContext&     g     = *GImGui;
         const ImGuiStyle& style = g.Style;
 
+        // every thread gets its own lane, as tall as its deepest scope, in the order the threads first appear
+        std::vector<std::thread::id> lane_threads;
+        std::vector<int>             lane_max_depths;
+        auto                         get_lane = [&lane_threads](std::thread::id thread_id) {
+            return static_cast<size_t>(std::find(lane_threads.begin(), lane_threads.end(), thread_id) -
+                                       lane_threads.begin());
+        };
+        for (const auto& scope_time : scope_times)
+        {
+            size_t lane = get_lane(scope_time.thread_id);
+            if (lane == lane_threads.size())
+            {
+                lane_threads.push_back(scope_time.thread_id);
+                lane_max_depths.push_back(0);
+            }
+            lane_max_depths[lane] = std::max(lane_max_depths[lane], scope_time.depth);
+        }
+
+        std::vector<int> lane_first_rows(lane_threads.size());
+        int              row_count = 0;
+        for (size_t lane = 0; lane < lane_threads.size(); ++lane)
+        {
+            lane_first_rows[lane] = row_count;
+            row_count += lane_max_depths[lane] + 1;
+        }
+
         const auto   blockHeight = ImGui::GetTextLineHeight() + (style.FramePadding.y * 2);
         const ImVec2 label_size  = ImGui::CalcTextSize("Testing", NULL, true);
         if (graph_size.x == 0.0f)
             graph_size.x = ImGui::GetWindowWidth() - 2.0 * style.FramePadding.x;
         if (graph_size.y == 0.0f)
-            graph_size.y = label_size.y + (style.FramePadding.y * 3) + blockHeight * (max_depth + 1);
+            graph_size.y = label_size.y + (style.FramePadding.y * 3) + blockHeight * row_count;
 
         const ImRect frame_bb(window->DC.CursorPos, window->DC.CursorPos + graph_size);
         const ImRect inner_bb(frame_bb.Min + style.FramePadding, frame_bb.Max - style.FramePadding);
@@ -107,8 +136,12 @@ namespace Meow
         const ImU32 col_outline_base    = 0xFFFFFFFF;
         const ImU32 col_outline_hovered = 0xFFFFFFFF;
 
-        auto frame_time =
-            scope_times[scope_times.size() - 1].start + scope_times[scope_times.size() - 1].duration - global_start;
+        // scopes are uploaded when they end, but a worker thread may end after the last scope of the main thread
+        auto frame_time = std::chrono::microseconds(0);
+        for (const auto& scope_time : scope_times)
+        {
+            frame_time = std::max(frame_time, scope_time.start + scope_time.duration - global_start);
+        }
 
         float inner_width = inner_bb.Max.x - inner_bb.Min.x;
 
@@ -124,7 +157,10 @@ namespace Meow
             float start_x_percent = (double)start_time.count() / frame_time.count();
             float end_x_percent   = start_x_percent + (double)scope_time.duration.count() / frame_time.count();
 
-            float bottom_height = blockHeight * (max_depth - scope_time.depth + 1) - style.FramePadding.y;
+            size_t lane = get_lane(scope_time.thread_id);
+            int    row  = lane_first_rows[lane] + lane_max_depths[lane] - scope_time.depth;
+
+            float bottom_height = blockHeight * (row + 1) - style.FramePadding.y;
 
             auto pos0 = inner_bb.Min + ImVec2(start_x_percent * inner_width, bottom_height);
             auto pos1 = inner_bb.Min + ImVec2(end_x_percent * inner_width, bottom_height + blockHeight);
@@ -132,7 +168,15 @@ namespace Meow
             bool v_hovered = false;
             if (ImGui::IsMouseHoveringRect(pos0, pos1))
             {
-                ImGui::SetTooltip("%s: %8.4gms", scope_time.name.c_str(), (double)scope_time.duration.count() / 1000.0);
+                double milliseconds = (double)scope_time.duration.count() / 1000.0;
+                if (scope_time.item_count > 0)
+                    ImGui::SetTooltip("%s: %8.4gms, %u items, %8.4gms per 100k",
+                                      scope_time.name.c_str(),
+                                      milliseconds,
+                                      scope_time.item_count,
+                                      milliseconds * 100000.0 / scope_time.item_count);
+                else
+                    ImGui::SetTooltip("%s: %8.4gms", scope_time.name.c_str(), milliseconds);
                 v_hovered   = true;
                 any_hovered = v_hovered;
             }
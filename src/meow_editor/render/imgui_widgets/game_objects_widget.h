@@ -10,11 +10,11 @@ namespace Meow
     class GameObjectsWidget
     {
     public:
-        void Draw(const std::unordered_map<UUID, std::shared_ptr<GameObject>>& gameobject_map);
+        void Draw(const std::vector<std::shared_ptr<GameObject>>& gameobjects);
 
-        const UUID GetSelectedID() const { return m_selected_go_id; }
+        GameObjectHandle GetSelectedHandle() const { return m_selected_go_handle; }
 
     private:
-        UUID m_selected_go_id;
+        GameObjectHandle m_selected_go_handle;
     };
 } // namespace Meow
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "pool_statistics_widget.h"
+
+#include <imgui.h>
+
+namespace Meow
+{
+    void PoolStatisticsWidget::Draw(const std::vector<PoolStat>& stats)
+    {
+        ImGuiTreeNodeFlags flag = ImGuiTreeNodeFlags_DefaultOpen;
+
+        ImGui::PushID(&stats);
+
+        if (ImGui::TreeNodeEx("Memory Pools", flag))
+        {
+            ImGui::Columns(5, "locations");
+            ImGui::Text("%s", "Pool Name");
+            ImGui::NextColumn();
+            ImGui::Text("%s", "Block Size");
+            ImGui::NextColumn();
+            ImGui::Text("%s", "Used Blocks");
+            ImGui::NextColumn();
+            ImGui::Text("%s", "Peak Blocks");
+            ImGui::NextColumn();
+            ImGui::Text("%s", "Reserved KB");
+            ImGui::Columns();
+
+            ImGui::Separator();
+
+            for (const PoolStat& stat : stats)
+            {
+                ImGui::Columns(5, "locations");
+                ImGui::Text("%s", stat.name.c_str());
+                ImGui::NextColumn();
+                ImGui::Text("%zu", stat.block_size);
+                ImGui::NextColumn();
+                ImGui::Text("%zu / %zu", stat.used_blocks, stat.capacity_blocks);
+                ImGui::NextColumn();
+                ImGui::Text("%zu", stat.peak_blocks);
+                ImGui::NextColumn();
+                ImGui::Text("%zu", stat.allocated_bytes / 1024);
+                ImGui::Columns();
+            }
+
+            ImGui::TreePop();
+        }
+
+        ImGui::PopID();
+    }
+} // namespace Meow
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "meow_runtime/core/memory/pool_allocator.h"
+
+#include <vector>
+
+namespace Meow
+{
+    class PoolStatisticsWidget
+    {
+    public:
+        static void Draw(const std::vector<PoolStat>& stats);
+    };
+} // namespace Meow
\ No newline at end of file
@@ -165,7 +165,7 @@ namespace Meow
 
         VkQueryPoolCreateInfo query_pool_create_info = {.sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
                                                         .queryType          = VK_QUERY_TYPE_PIPELINE_STATISTICS,
-                                                        .queryCount         = 2,
+                                                        .queryCount         = 2 * k_max_frames_in_flight,
                                                         .pipelineStatistics = (1 << 11) - 1};
 
         query_pool = logical_device.createQueryPool(query_pool_create_info, nullptr);
@@ -186,10 +186,19 @@ namespace Meow
         // Debug
         if (m_query_enabled)
         {
-            for (int i = 0; i < 2; i++)
+            // the frame that wrote the queries of this frame index last time has finished on the GPU
+            if (m_is_query_written[m_frame_index])
             {
-                command_buffer.resetQueryPool(*query_pool, 0, 2);
+                for (int i = 1; i >= 0; i--)
+                {
+                    std::pair<vk::Result, std::vector<uint32_t>> query_results = query_pool.getResults<uint32_t>(
+                        m_frame_index * 2 + i, 1, sizeof(uint32_t) * 11, sizeof(uint32_t) * 11, {});
+
+                    g_editor_context.profile_system->UploadPipelineStat(m_pass_names[i], query_results.second);
+                }
             }
+
+            command_buffer.resetQueryPool(*query_pool, m_frame_index * 2, 2);
         }
 
         DeferredPass::Start(command_buffer, extent, current_image_index);
@@ -202,40 +211,38 @@ namespace Meow
         m_obj2attachment_mat.BindPipeline(command_buffer);
 
         if (m_query_enabled)
-            command_buffer.beginQuery(*query_pool, 0, {});
+            command_buffer.beginQuery(*query_pool, m_frame_index * 2, {});
 
         DrawObjOnly(command_buffer);
 
         if (m_query_enabled)
-            command_buffer.endQuery(*query_pool, 0);
+            command_buffer.endQuery(*query_pool, m_frame_index * 2);
 
         command_buffer.nextSubpass(vk::SubpassContents::eInline);
 
         m_quad_mat.BindPipeline(command_buffer);
 
         if (m_query_enabled)
-            command_buffer.beginQuery(*query_pool, 1, {});
+            command_buffer.beginQuery(*query_pool, m_frame_index * 2 + 1, {});
 
         DrawQuadOnly(command_buffer);
 
         if (m_query_enabled)
-            command_buffer.endQuery(*query_pool, 1);
+        {
+            command_buffer.endQuery(*query_pool, m_frame_index * 2 + 1);
+            m_is_query_written[m_frame_index] = true;
+        }
     }
 
     void EditorDeferredPass::AfterPresent()
     {
         FUNCTION_TIMER();
 
-        if (m_query_enabled)
-        {
-            for (int i = 1; i >= 0; i--)
-            {
-                std::pair<vk::Result, std::vector<uint32_t>> query_results =
-                    query_pool.getResults<uint32_t>(i, 1, sizeof(uint32_t) * 11, sizeof(uint32_t) * 11, {});
-
-                g_editor_context.profile_system->UploadPipelineStat(m_pass_names[i], query_results.second);
-            }
-        }
+        // only the object pass draws through the render queue, with per object uniforms
+        m_render_stat[0].uniform_stat      = m_dynamic_uniform_allocator.GetStat();
+        m_render_stat[0].render_state_stat = m_state_cache.GetStat();
+        if (m_is_gpu_culled)
+            m_render_stat[0].gpu_culling_stat = m_gpu_culling.GetStat();
 
         for (int i = 1; i >= 0; i--)
         {
@@ -250,6 +257,7 @@ namespace Meow
 
         swap(lhs.m_query_enabled, rhs.m_query_enabled);
         swap(lhs.query_pool, rhs.query_pool);
+        swap(lhs.m_is_query_written, rhs.m_is_query_written);
         swap(lhs.m_render_stat, rhs.m_render_stat);
     }
 } // namespace Meow
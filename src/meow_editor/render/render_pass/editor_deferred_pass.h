@@ -50,8 +50,10 @@ namespace Meow
         friend void swap(EditorDeferredPass& lhs, EditorDeferredPass& rhs);
 
     private:
-        bool                m_query_enabled = true;
-        vk::raii::QueryPool query_pool      = nullptr;
+        // two queries per frame in flight, read back k_max_frames_in_flight frames late without waiting for the GPU
+        bool                m_query_enabled                            = true;
+        vk::raii::QueryPool query_pool                                 = nullptr;
+        bool                m_is_query_written[k_max_frames_in_flight] = {};
 
         BuiltinRenderStat m_render_stat[2];
     };
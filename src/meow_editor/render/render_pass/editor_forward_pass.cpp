@@ -101,7 +101,7 @@ namespace Meow
 
         VkQueryPoolCreateInfo query_pool_create_info = {.sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
                                                         .queryType          = VK_QUERY_TYPE_PIPELINE_STATISTICS,
-                                                        .queryCount         = 1,
+                                                        .queryCount         = k_max_frames_in_flight,
                                                         .pipelineStatistics = (1 << 11) - 1};
 
         query_pool = logical_device.createQueryPool(query_pool_create_info, nullptr);
@@ -116,7 +116,18 @@ namespace Meow
                                   uint32_t                       current_image_index)
     {
         if (m_query_enabled)
-            command_buffer.resetQueryPool(*query_pool, 0, 1);
+        {
+            // the frame that wrote the query of this frame index last time has finished on the GPU
+            if (m_is_query_written[m_frame_index])
+            {
+                std::pair<vk::Result, std::vector<uint32_t>> query_results = query_pool.getResults<uint32_t>(
+                    m_frame_index, 1, sizeof(uint32_t) * 11, sizeof(uint32_t) * 11, {});
+
+                g_editor_context.profile_system->UploadPipelineStat(m_pass_name, query_results.second);
+            }
+
+            command_buffer.resetQueryPool(*query_pool, m_frame_index, 1);
+        }
 
         ForwardPass::Start(command_buffer, extent, current_image_index);
     }
@@ -128,27 +139,26 @@ namespace Meow
         m_forward_mat.BindPipeline(command_buffer);
 
         if (m_query_enabled)
-            command_buffer.beginQuery(*query_pool, 0, {});
+            command_buffer.beginQuery(*query_pool, m_frame_index, {});
 
         ForwardPass::DrawOnly(command_buffer);
 
         if (m_query_enabled)
-            command_buffer.endQuery(*query_pool, 0);
+        {
+            command_buffer.endQuery(*query_pool, m_frame_index);
+            m_is_query_written[m_frame_index] = true;
+        }
     }
 
     void EditorForwardPass::AfterPresent()
     {
         FUNCTION_TIMER();
 
-        if (m_query_enabled)
-        {
-            std::pair<vk::Result, std::vector<uint32_t>> query_results =
-                query_pool.getResults<uint32_t>(0, 1, sizeof(uint32_t) * 11, sizeof(uint32_t) * 11, {});
-
-            g_editor_context.profile_system->UploadPipelineStat(m_pass_name, query_results.second);
-        }
-
-        m_render_stat.draw_call = draw_call;
+        m_render_stat.draw_call    = draw_call;
+        m_render_stat.uniform_stat      = m_dynamic_uniform_allocator.GetStat();
+        m_render_stat.render_state_stat = m_state_cache.GetStat();
+        if (m_is_gpu_culled)
+            m_render_stat.gpu_culling_stat = m_gpu_culling.GetStat();
         g_editor_context.profile_system->UploadBuiltinRenderStat(m_pass_name, m_render_stat);
     }
 
@@ -158,6 +168,7 @@ namespace Meow
 
         swap(lhs.m_query_enabled, rhs.m_query_enabled);
         swap(lhs.query_pool, rhs.query_pool);
+        swap(lhs.m_is_query_written, rhs.m_is_query_written);
         swap(lhs.m_render_stat, rhs.m_render_stat);
     }
 } // namespace Meow
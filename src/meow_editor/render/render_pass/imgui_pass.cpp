@@ -3,8 +3,10 @@
 #include "pch.h"
 
 #include "global/editor_context.h"
+#include "meow_runtime/function/components/transform/transform_3d_component.hpp"
 #include "meow_runtime/function/global/runtime_context.h"
 #include "render/imgui_widgets/pipeline_statistics_widget.h"
+#include "render/imgui_widgets/pool_statistics_widget.h"
 
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_vulkan.h>
@@ -127,16 +129,14 @@ namespace Meow
             MEOW_ERROR("shared ptr is invalid!");
 #endif
 
-        const auto& all_gameobjects_map = level_ptr->GetAllGameObjects();
+        const auto& all_gameobjects = level_ptr->GetAllGameObjects();
 
         ImGui::ShowDemoWindow();
 
         ImGui::Begin("Demo");
-        const auto camera_id = level_ptr->GetMainCameraID();
-        auto       it        = all_gameobjects_map.find(camera_id);
-        if (it != all_gameobjects_map.end())
+        const auto camera_go_ptr = level_ptr->GetGameObject(level_ptr->GetMainCamera());
+        if (camera_go_ptr)
         {
-            const auto camera_go_ptr   = it->second;
             const auto camera_comp_ptr = camera_go_ptr->TryGetComponent<Camera3DComponent>("Camera3DComponent");
             if (camera_comp_ptr)
             {
@@ -167,15 +167,19 @@ namespace Meow
         ImGui::End();
 
         ImGui::Begin("GameObject");
-        m_gameobjects_widget.Draw(all_gameobjects_map);
+        m_gameobjects_widget.Draw(all_gameobjects);
         ImGui::End();
 
-        auto gameobject_ptr_iter = all_gameobjects_map.find(m_gameobjects_widget.GetSelectedID());
-        if (gameobject_ptr_iter != all_gameobjects_map.end())
+        GameObject* selected_go_ptr = level_ptr->GetGameObject(m_gameobjects_widget.GetSelectedHandle());
+        if (selected_go_ptr)
         {
             ImGui::Begin("Component");
-            m_components_widget.CreateGameObjectUI(gameobject_ptr_iter->second);
+            m_components_widget.CreateGameObjectUI(selected_go_ptr->shared_from_this());
             ImGui::End();
+
+            // the widget writes reflected fields directly, so the cached world matrix has to be refreshed
+            if (Transform3DComponent* transform_comp_ptr = selected_go_ptr->GetComponent<Transform3DComponent>())
+                transform_comp_ptr->MarkDirty();
         }
 
         ImGui::Begin("Statistics");
@@ -191,6 +195,8 @@ namespace Meow
         else
             ImGui::Text("Pipeline Statistics is disabled.");
 
+        PoolStatisticsWidget::Draw(PoolAllocatorRegistry::Get().GetStats());
+
         ImGui::End();
 
         RenderPass::Start(command_buffer, extent, current_image_index);
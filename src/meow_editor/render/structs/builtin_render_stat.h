@@ -1,6 +1,9 @@
 #pragma once
 
 #include "meow_runtime/core/base/bitmask.hpp"
+#include "meow_runtime/function/render/structs/frame_uniform_allocator.h"
+#include "meow_runtime/function/render/structs/gpu_culling.h"
+#include "meow_runtime/function/render/structs/render_state_cache.h"
 #include "meow_runtime/function/render/structs/shader.h"
 #include "meow_runtime/function/render/structs/vertex_attribute.h"
 
@@ -10,6 +13,10 @@ namespace Meow
     {
         int draw_call = 0;
 
+        FrameUniformAllocatorStat uniform_stat;
+        GpuCullingStat            gpu_culling_stat;
+        RenderStateStat           render_state_stat;
+
         std::vector<VertexAttributeMeta>            vertex_attribute_metas;
         std::unordered_map<std::string, BufferMeta> buffer_meta_map;
         std::unordered_map<std::string, ImageMeta>  image_meta_map;
@@ -24,6 +24,7 @@ namespace Meow
         void CreateSwapChian();
         void CreateDescriptorAllocator();
         void CreatePerFrameData();
+        void WaitForFrame(const PerFrameData& per_frame_data);
         void CreateRenderPass();
         void RecreateSwapChain();
         void RefreshRenderPass();
@@ -37,11 +38,14 @@ namespace Meow
         GameForwardPass  m_forward_pass    = nullptr;
         RenderPass*      m_render_pass_ptr = nullptr;
 
-        bool           m_framebuffer_resized  = false;
-        bool           m_iconified            = false;
-        const uint64_t k_fence_timeout        = 100000000;
-        const uint32_t k_max_frames_in_flight = 2;
-        uint32_t       m_current_frame_index  = 0;
-        uint32_t       m_current_image_index  = 0;
+        bool           m_framebuffer_resized   = false;
+        bool           m_iconified             = false;
+        const uint64_t k_fence_timeout         = 100000000;
+        uint32_t       m_current_frame_index   = 0;
+        uint32_t       m_current_image_index   = 0;
+        uint64_t       m_submitted_frame_count = 0;
+
+        // signaled with the number of submitted frames as each one finishes, when timeline semaphores are supported
+        vk::raii::Semaphore m_frame_timeline_semaphore = nullptr;
     };
 } // namespace Meow
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "radix_sort.h"
+
+#include "pch.h"
+
+#include <cstddef>
+
+namespace Meow
+{
+    void RadixSort(std::vector<uint64_t>& keys,
+                   std::vector<uint32_t>& values,
+                   std::vector<uint64_t>& scratch_keys,
+                   std::vector<uint32_t>& scratch_values)
+    {
+        constexpr uint32_t k_byte_count   = sizeof(uint64_t);
+        constexpr uint32_t k_bucket_count = 256;
+
+        const size_t count = keys.size();
+        if (count < 2)
+            return;
+
+        uint32_t histograms[k_byte_count][k_bucket_count] = {};
+        for (uint64_t key : keys)
+        {
+            for (uint32_t byte = 0; byte < k_byte_count; ++byte)
+            {
+                ++histograms[byte][(key >> (byte * 8)) & 0xFF];
+            }
+        }
+
+        scratch_keys.resize(count);
+        scratch_values.resize(count);
+
+        for (uint32_t byte = 0; byte < k_byte_count; ++byte)
+        {
+            uint32_t* histogram = histograms[byte];
+
+            // all keys in one bucket, this byte does not change the order
+            if (histogram[(keys[0] >> (byte * 8)) & 0xFF] == count)
+                continue;
+
+            uint32_t offset = 0;
+            for (uint32_t bucket = 0; bucket < k_bucket_count; ++bucket)
+            {
+                uint32_t bucket_size = histogram[bucket];
+                histogram[bucket]    = offset;
+                offset += bucket_size;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint32_t destination        = histogram[(keys[i] >> (byte * 8)) & 0xFF]++;
+                scratch_keys[destination]   = keys[i];
+                scratch_values[destination] = values[i];
+            }
+
+            keys.swap(scratch_keys);
+            values.swap(scratch_values);
+        }
+    }
+} // namespace Meow
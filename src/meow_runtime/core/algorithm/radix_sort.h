@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Sort keys in ascending order with a stable LSD radix sort, moving values along with their keys.
+     *
+     * The keys are sorted one byte at a time from the lowest, with one counting pass for all bytes up front. Bytes
+     * that are equal in all keys, like the high bits of sort keys whose fields are mostly zero, are skipped. Scratch
+     * holds the keys and values between passes and is only grown, so sorting every frame does not allocate.
+     */
+    void RadixSort(std::vector<uint64_t>& keys,
+                   std::vector<uint32_t>& values,
+                   std::vector<uint64_t>& scratch_keys,
+                   std::vector<uint32_t>& scratch_values);
+} // namespace Meow
@@ -0,0 +1,263 @@
+#include "job_system.h"
+
+#include "pch.h"
+
+namespace Meow
+{
+    struct Job
+    {
+        JobSystem::JobFunction function;
+        JobCounter*            counter = nullptr;
+    };
+
+    namespace
+    {
+        // thread index is only meaningful for the job system the thread belongs to
+        thread_local const JobSystem* t_job_system   = nullptr;
+        thread_local uint32_t         t_thread_index = 0;
+
+        uint32_t NextRandom()
+        {
+            thread_local uint32_t state =
+                static_cast<uint32_t>(std::hash<std::thread::id> {}(std::this_thread::get_id())) | 1u;
+
+            // xorshift32
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+    } // namespace
+
+    JobSystem::JobSystem(uint32_t worker_count)
+    {
+        t_job_system   = this;
+        t_thread_index = 0;
+
+        for (uint32_t i = 0; i < worker_count + 1; ++i)
+        {
+            m_deques.push_back(std::make_unique<WorkStealingDeque<Job*>>());
+        }
+
+        m_workers.reserve(worker_count);
+        for (uint32_t i = 1; i <= worker_count; ++i)
+        {
+            m_workers.emplace_back([this, i]() { WorkerLoop(i); });
+        }
+
+        MEOW_INFO("Job system started with {} worker threads.", worker_count);
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_is_stopping.store(true);
+        }
+        m_sleep_condition.notify_all();
+
+        for (std::thread& worker : m_workers)
+        {
+            worker.join();
+        }
+
+        // jobs that have never been started are dropped
+        Job* job = nullptr;
+        for (auto& deque : m_deques)
+        {
+            while (deque->Steal(job))
+                delete job;
+        }
+        for (Job* queued_job : m_injection_queue)
+        {
+            delete queued_job;
+        }
+
+        if (t_job_system == this)
+            t_job_system = nullptr;
+    }
+
+    uint32_t JobSystem::GetDefaultWorkerCount()
+    {
+        uint32_t hardware_thread_count = std::thread::hardware_concurrency();
+        return hardware_thread_count > 1 ? hardware_thread_count - 1 : 0;
+    }
+
+    uint32_t JobSystem::GetCurrentThreadIndex() const { return IsOwnThread() ? t_thread_index : 0; }
+
+    void JobSystem::Schedule(JobFunction function, JobCounter* counter, JobCounter* dependency)
+    {
+        Job* job = new Job {std::move(function), counter};
+
+        if (counter)
+            counter->m_value.fetch_add(1, std::memory_order_relaxed);
+
+        if (dependency && !dependency->IsDone())
+        {
+            std::lock_guard<std::mutex> lock(dependency->m_mutex);
+
+            // the counter only reaches zero while its mutex is held, so checking again here can not miss the release
+            if (!dependency->IsDone())
+            {
+                dependency->m_dependents.push_back(job);
+                return;
+            }
+        }
+
+        Enqueue(job);
+    }
+
+    void JobSystem::Wait(JobCounter& counter)
+    {
+        if (IsOwnThread())
+        {
+            while (!counter.IsDone())
+            {
+                if (!TryRunJob(t_thread_index))
+                    std::this_thread::yield();
+            }
+        }
+        else
+        {
+            while (!counter.IsDone())
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        // the thread finishing the last job may still hold the mutex, the counter can only be destroyed after that
+        std::lock_guard<std::mutex> lock(counter.m_mutex);
+    }
+
+    bool JobSystem::RunPendingJob() { return IsOwnThread() && TryRunJob(t_thread_index); }
+
+    void JobSystem::WorkerLoop(uint32_t thread_index)
+    {
+        t_job_system   = this;
+        t_thread_index = thread_index;
+
+        while (!m_is_stopping.load(std::memory_order_relaxed))
+        {
+            if (TryRunJob(thread_index))
+                continue;
+
+            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+            m_sleeping_worker_count.fetch_add(1);
+            m_sleep_condition.wait(lock, [this]() {
+                return m_is_stopping.load(std::memory_order_relaxed) || m_queued_job_count.load() > 0;
+            });
+            m_sleeping_worker_count.fetch_sub(1);
+        }
+
+        t_job_system = nullptr;
+    }
+
+    bool JobSystem::TryRunJob(uint32_t thread_index)
+    {
+        Job* job = nullptr;
+
+        if (m_deques[thread_index]->Pop(job))
+        {
+            Execute(job);
+            return true;
+        }
+
+        uint32_t deque_count = static_cast<uint32_t>(m_deques.size());
+        uint32_t victim      = NextRandom() % deque_count;
+        for (uint32_t i = 0; i < deque_count; ++i, victim = (victim + 1) % deque_count)
+        {
+            if (victim != thread_index && m_deques[victim]->Steal(job))
+            {
+                Execute(job);
+                return true;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_injection_mutex);
+            if (!m_injection_queue.empty())
+            {
+                job = m_injection_queue.front();
+                m_injection_queue.pop_front();
+            }
+        }
+
+        if (job)
+        {
+            Execute(job);
+            return true;
+        }
+
+        return false;
+    }
+
+    void JobSystem::Enqueue(Job* job)
+    {
+        if (IsOwnThread())
+        {
+            m_deques[t_thread_index]->Push(job);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(m_injection_mutex);
+            m_injection_queue.push_back(job);
+        }
+
+        m_queued_job_count.fetch_add(1);
+
+        if (m_sleeping_worker_count.load() > 0)
+        {
+            // a worker between checking the wait predicate and going to sleep holds the mutex, taking it here makes
+            // sure the notification is not lost
+            {
+                std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            }
+            m_sleep_condition.notify_one();
+        }
+    }
+
+    void JobSystem::Execute(Job* job)
+    {
+        m_queued_job_count.fetch_sub(1);
+
+        job->function();
+
+        if (job->counter)
+            Finish(job->counter);
+
+        delete job;
+    }
+
+    void JobSystem::Finish(JobCounter* counter)
+    {
+        int32_t value = counter->m_value.load(std::memory_order_relaxed);
+        while (true)
+        {
+            if (value != 1)
+            {
+                if (counter->m_value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel))
+                    return;
+                continue;
+            }
+
+            // last job, reach zero with the mutex held so no dependent can be added in between
+            std::vector<Job*> dependents;
+            {
+                std::lock_guard<std::mutex> lock(counter->m_mutex);
+                if (!counter->m_value.compare_exchange_strong(value, 0, std::memory_order_acq_rel))
+                    continue;
+
+                dependents.swap(counter->m_dependents);
+            }
+
+            // the counter may already be destroyed here
+            for (Job* dependent : dependents)
+            {
+                Enqueue(dependent);
+            }
+            return;
+        }
+    }
+
+    bool JobSystem::IsOwnThread() const { return t_job_system == this; }
+} // namespace Meow
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "core/base/non_copyable.h"
+#include "core/jobs/work_stealing_deque.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Meow
+{
+    class JobSystem;
+    struct Job;
+
+    /**
+     * @brief Number of unfinished jobs scheduled with this counter.
+     *
+     * Jobs scheduled with a counter as dependency only start after the counter reaches zero, which is how task graphs
+     * are built. A counter must outlive the jobs counting on it and must not be reused until it is done.
+     */
+    class JobCounter
+    {
+    public:
+        JobCounter() = default;
+
+        JobCounter(const JobCounter&)            = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        bool IsDone() const { return m_value.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<int32_t> m_value {0};
+
+        // jobs depending on this counter, released when it reaches zero
+        std::mutex        m_mutex;
+        std::vector<Job*> m_dependents;
+    };
+
+    /**
+     * @brief Work stealing job system.
+     *
+     * Every worker thread and the thread that creates the job system (thread index 0, usually the main thread) own a
+     * Chase-Lev deque. Jobs are pushed to the deque of the scheduling thread, idle threads steal from the others.
+     * Threads that are not part of the job system push to a shared injection queue.
+     *
+     * Wait never blocks a thread of the job system, it keeps executing jobs until the counter is done.
+     */
+    class JobSystem : public NonCopyable
+    {
+    public:
+        using JobFunction = std::function<void()>;
+
+        /**
+         * @param worker_count Number of worker threads besides the calling thread.
+         */
+        explicit JobSystem(uint32_t worker_count = GetDefaultWorkerCount());
+
+        ~JobSystem() override;
+
+        /**
+         * @brief One worker per hardware thread, minus the main thread.
+         */
+        static uint32_t GetDefaultWorkerCount();
+
+        uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+
+        /**
+         * @brief Worker threads plus the owner thread. Size per-thread buffers with this.
+         */
+        uint32_t GetThreadCount() const { return GetWorkerCount() + 1; }
+
+        /**
+         * @brief 0 for the owner thread, 1 to GetWorkerCount() for worker threads.
+         *
+         * Threads outside the job system also get 0, so per-thread buffers indexed by this must only be used from the
+         * owner thread and from jobs.
+         */
+        uint32_t GetCurrentThreadIndex() const;
+
+        /**
+         * @brief Schedule a job.
+         *
+         * @param counter Incremented now, decremented when the job has finished. May be nullptr.
+         * @param dependency The job does not start before this counter is done. May be nullptr.
+         */
+        void Schedule(JobFunction function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+        /**
+         * @brief Execute other jobs until counter is done.
+         */
+        void Wait(JobCounter& counter);
+
+        /**
+         * @brief Execute one pending job on the calling thread, for threads that wait on something other than a
+         * counter. Returns false if no job was found or the calling thread is not part of the job system.
+         */
+        bool RunPendingJob();
+
+        /**
+         * @brief Split [begin, end) into batches of grain_size indices and run func(batch_begin, batch_end) for each
+         * batch across all threads. The calling thread takes part and returns after all batches have finished.
+         */
+        template<typename Func>
+        void ParallelFor(uint32_t begin, uint32_t end, uint32_t grain_size, Func&& func)
+        {
+            if (begin >= end)
+                return;
+
+            grain_size           = std::max(grain_size, 1u);
+            uint32_t batch_count = (end - begin + grain_size - 1) / grain_size;
+
+            if (batch_count == 1 || m_workers.empty())
+            {
+                func(begin, end);
+                return;
+            }
+
+            JobCounter counter;
+            for (uint32_t batch = 1; batch < batch_count; ++batch)
+            {
+                uint32_t batch_begin = begin + batch * grain_size;
+                uint32_t batch_end   = std::min(batch_begin + grain_size, end);
+                Schedule([&func, batch_begin, batch_end]() { func(batch_begin, batch_end); }, &counter);
+            }
+
+            // the calling thread runs the first batch itself instead of waiting idle
+            func(begin, std::min(begin + grain_size, end));
+
+            Wait(counter);
+        }
+
+    private:
+        void WorkerLoop(uint32_t thread_index);
+
+        /**
+         * @brief Pop a job from the own deque, then steal from others, then take from the injection queue.
+         */
+        bool TryRunJob(uint32_t thread_index);
+
+        void Enqueue(Job* job);
+        void Execute(Job* job);
+        void Finish(JobCounter* counter);
+
+        bool IsOwnThread() const;
+
+        std::vector<std::unique_ptr<WorkStealingDeque<Job*>>> m_deques;
+        std::vector<std::thread>                              m_workers;
+
+        std::mutex       m_injection_mutex;
+        std::deque<Job*> m_injection_queue;
+
+        std::atomic<int32_t>    m_queued_job_count {0};
+        std::atomic<int32_t>    m_sleeping_worker_count {0};
+        std::mutex              m_sleep_mutex;
+        std::condition_variable m_sleep_condition;
+        std::atomic<bool>       m_is_stopping {false};
+    };
+} // namespace Meow
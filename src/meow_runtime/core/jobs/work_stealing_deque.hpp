@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Lock-free Chase-Lev work stealing deque.
+     *
+     * Only the owner thread may call Push and Pop, which work on the bottom end in LIFO order. Any thread may call
+     * Steal, which takes from the top end in FIFO order. The ring buffer grows on demand, old buffers are kept alive
+     * until the deque is destroyed because a concurrent thief may still read from them.
+     *
+     * Based on "Correct and Efficient Work-Stealing for Weak Memory Models" by Le, Pop, Cohen and Zappa Nardelli.
+     *
+     * Pop and Steal only write item when they return true.
+     *
+     * @tparam T Trivially copyable item type, usually a pointer.
+     */
+    template<typename T>
+    class WorkStealingDeque
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque items must be trivially copyable");
+
+    public:
+        /**
+         * @param capacity Initial capacity, must be a power of two.
+         */
+        explicit WorkStealingDeque(int64_t capacity = 1024)
+        {
+            m_arrays.push_back(std::make_unique<RingBuffer>(capacity));
+            m_array.store(m_arrays.back().get(), std::memory_order_relaxed);
+        }
+
+        WorkStealingDeque(const WorkStealingDeque&)            = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        void Push(T item)
+        {
+            int64_t     bottom = m_bottom.load(std::memory_order_relaxed);
+            int64_t     top    = m_top.load(std::memory_order_acquire);
+            RingBuffer* array  = m_array.load(std::memory_order_relaxed);
+
+            if (bottom - top > array->capacity - 1)
+            {
+                array = Grow(array, bottom, top);
+            }
+
+            array->Put(bottom, item);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        bool Pop(T& item)
+        {
+            int64_t     bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            RingBuffer* array  = m_array.load(std::memory_order_relaxed);
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = m_top.load(std::memory_order_relaxed);
+
+            if (top > bottom)
+            {
+                // empty
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            T result = array->Get(bottom);
+            if (top == bottom)
+            {
+                // last item, race against thieves
+                bool won = m_top.compare_exchange_strong(
+                    top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                if (!won)
+                    return false;
+            }
+
+            item = result;
+            return true;
+        }
+
+        bool Steal(T& item)
+        {
+            int64_t top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+                return false;
+
+            RingBuffer* array  = m_array.load(std::memory_order_acquire);
+            T           result = array->Get(top);
+
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return false;
+
+            item = result;
+            return true;
+        }
+
+        /**
+         * @brief Approximate, only meaningful as a hint.
+         */
+        bool Empty() const
+        {
+            return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct RingBuffer
+        {
+            explicit RingBuffer(int64_t capacity)
+                : capacity(capacity)
+                , mask(capacity - 1)
+                , items(std::make_unique<std::atomic<T>[]>(capacity))
+            {}
+
+            void Put(int64_t index, T item) { items[index & mask].store(item, std::memory_order_relaxed); }
+            T    Get(int64_t index) const { return items[index & mask].load(std::memory_order_relaxed); }
+
+            int64_t                           capacity;
+            int64_t                           mask;
+            std::unique_ptr<std::atomic<T>[]> items;
+        };
+
+        RingBuffer* Grow(RingBuffer* array, int64_t bottom, int64_t top)
+        {
+            m_arrays.push_back(std::make_unique<RingBuffer>(array->capacity * 2));
+            RingBuffer* new_array = m_arrays.back().get();
+
+            for (int64_t i = top; i < bottom; ++i)
+            {
+                new_array->Put(i, array->Get(i));
+            }
+
+            m_array.store(new_array, std::memory_order_release);
+            return new_array;
+        }
+
+        alignas(64) std::atomic<int64_t> m_top {0};
+        alignas(64) std::atomic<int64_t> m_bottom {0};
+        alignas(64) std::atomic<RingBuffer*> m_array {nullptr};
+
+        // owned by the owner thread only
+        std::vector<std::unique_ptr<RingBuffer>> m_arrays;
+    };
+} // namespace Meow
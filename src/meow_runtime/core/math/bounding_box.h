@@ -55,5 +55,19 @@ namespace Meow
             corners[6] = glm::vec3(min.x, max.y, max.z);
             corners[7] = glm::vec3(max.x, max.y, max.z);
         }
+
+        /**
+         * @brief Axis aligned box around this box transformed by matrix, including rotation.
+         */
+        BoundingBox Transformed(const glm::mat4& matrix) const
+        {
+            glm::vec3 center      = glm::vec3(matrix * glm::vec4((min + max) * 0.5f, 1.0f));
+            glm::vec3 half_extent = (max - min) * 0.5f;
+            glm::vec3 extent      = glm::abs(glm::vec3(matrix[0])) * half_extent.x +
+                                    glm::abs(glm::vec3(matrix[1])) * half_extent.y +
+                                    glm::abs(glm::vec3(matrix[2])) * half_extent.z;
+
+            return BoundingBox(center - extent, center + extent);
+        }
     };
 } // namespace Meow
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "core/math/bounding_box.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Axis aligned boxes as centers and half extents in structure of arrays form, for SIMD culling kernels.
+     */
+    struct BoundingBoxSoA
+    {
+        std::vector<float> center_x;
+        std::vector<float> center_y;
+        std::vector<float> center_z;
+        std::vector<float> extent_x;
+        std::vector<float> extent_y;
+        std::vector<float> extent_z;
+
+        uint32_t GetCount() const { return static_cast<uint32_t>(center_x.size()); }
+
+        void Clear()
+        {
+            for (std::vector<float>* component : {&center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z})
+            {
+                component->clear();
+            }
+        }
+
+        void Reserve(uint32_t count)
+        {
+            for (std::vector<float>* component : {&center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z})
+            {
+                component->reserve(count);
+            }
+        }
+
+        void Push(const glm::vec3& center, const glm::vec3& extent)
+        {
+            center_x.push_back(center.x);
+            center_y.push_back(center.y);
+            center_z.push_back(center.z);
+            extent_x.push_back(extent.x);
+            extent_y.push_back(extent.y);
+            extent_z.push_back(extent.z);
+        }
+
+        void Push(const BoundingBox& box) { Push((box.min + box.max) * 0.5f, (box.max - box.min) * 0.5f); }
+
+        BoundingBox Get(uint32_t index) const
+        {
+            glm::vec3 center(center_x[index], center_y[index], center_z[index]);
+            glm::vec3 extent(extent_x[index], extent_y[index], extent_z[index]);
+            return BoundingBox(center - extent, center + extent);
+        }
+    };
+} // namespace Meow
@@ -0,0 +1,294 @@
+#include "dynamic_bounding_box_tree.h"
+
+#include "pch.h"
+
+#include <algorithm>
+
+namespace Meow
+{
+    namespace
+    {
+        // leaves are enlarged by this part of their size plus a fixed margin
+        constexpr float k_margin_ratio = 0.1f;
+        constexpr float k_margin       = 0.1f;
+
+        float GetSurfaceArea(const glm::vec3& min, const glm::vec3& max)
+        {
+            glm::vec3 size = max - min;
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        bool Contains(const glm::vec3& outer_min,
+                      const glm::vec3& outer_max,
+                      const glm::vec3& inner_min,
+                      const glm::vec3& inner_max)
+        {
+            return outer_min.x <= inner_min.x && outer_min.y <= inner_min.y && outer_min.z <= inner_min.z &&
+                   inner_max.x <= outer_max.x && inner_max.y <= outer_max.y && inner_max.z <= outer_max.z;
+        }
+
+        glm::vec3 GetMargin(const BoundingBox& bounds) { return (bounds.max - bounds.min) * k_margin_ratio + k_margin; }
+    } // namespace
+
+    uint32_t DynamicBoundingBoxTree::Insert(const BoundingBox& bounds, uint32_t user_data)
+    {
+        uint32_t  proxy  = AllocateNode();
+        glm::vec3 margin = GetMargin(bounds);
+
+        Node& node     = m_nodes[proxy];
+        node.min       = bounds.min - margin;
+        node.max       = bounds.max + margin;
+        node.height    = 0;
+        node.user_data = user_data;
+
+        InsertLeaf(proxy);
+        m_proxy_count++;
+
+        return proxy;
+    }
+
+    void DynamicBoundingBoxTree::Remove(uint32_t proxy)
+    {
+        ASSERT(proxy < m_nodes.size() && m_nodes[proxy].IsLeaf() && m_nodes[proxy].height == 0);
+
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        m_proxy_count--;
+    }
+
+    bool DynamicBoundingBoxTree::Move(uint32_t proxy, const BoundingBox& bounds)
+    {
+        ASSERT(proxy < m_nodes.size() && m_nodes[proxy].IsLeaf() && m_nodes[proxy].height == 0);
+
+        Node&     node   = m_nodes[proxy];
+        glm::vec3 margin = GetMargin(bounds);
+
+        // keep the leaf while the box is within it, unless the box shrank so much that the leaf is far too large
+        if (Contains(node.min, node.max, bounds.min, bounds.max) &&
+            Contains(bounds.min - margin * 4.0f, bounds.max + margin * 4.0f, node.min, node.max))
+            return false;
+
+        RemoveLeaf(proxy);
+
+        m_nodes[proxy].min = bounds.min - margin;
+        m_nodes[proxy].max = bounds.max + margin;
+
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    void DynamicBoundingBoxTree::QueryFrustum(const Frustum&         frustum,
+                                              std::vector<uint32_t>& inside,
+                                              std::vector<uint32_t>& intersecting) const
+    {
+        if (m_root == k_null_node)
+            return;
+
+        // nodes to visit with the planes they still have to be tested against, 0 once a subtree is inside
+        std::vector<std::pair<uint32_t, uint32_t>> stack;
+        stack.reserve(64);
+        stack.emplace_back(m_root, Frustum::k_all_planes);
+
+        while (!stack.empty())
+        {
+            auto [index, plane_mask] = stack.back();
+            stack.pop_back();
+
+            const Node& node = m_nodes[index];
+            if (plane_mask &&
+                frustum.ClassifyBoundingBox((node.min + node.max) * 0.5f, (node.max - node.min) * 0.5f, plane_mask) !=
+                    Frustum::k_no_plane)
+                continue;
+
+            if (node.IsLeaf())
+            {
+                (plane_mask ? intersecting : inside).push_back(node.user_data);
+                continue;
+            }
+
+            stack.emplace_back(node.child1, plane_mask);
+            stack.emplace_back(node.child2, plane_mask);
+        }
+    }
+
+    uint32_t DynamicBoundingBoxTree::AllocateNode()
+    {
+        if (m_free_list == k_null_node)
+        {
+            m_nodes.emplace_back();
+            return static_cast<uint32_t>(m_nodes.size() - 1);
+        }
+
+        uint32_t index = m_free_list;
+        m_free_list    = m_nodes[index].parent;
+        m_nodes[index] = Node {};
+        return index;
+    }
+
+    void DynamicBoundingBoxTree::FreeNode(uint32_t index)
+    {
+        m_nodes[index]        = Node {};
+        m_nodes[index].parent = m_free_list;
+        m_free_list           = index;
+    }
+
+    void DynamicBoundingBoxTree::InsertLeaf(uint32_t leaf)
+    {
+        if (m_root == k_null_node)
+        {
+            m_root               = leaf;
+            m_nodes[leaf].parent = k_null_node;
+            return;
+        }
+
+        const glm::vec3 leaf_min = m_nodes[leaf].min;
+        const glm::vec3 leaf_max = m_nodes[leaf].max;
+
+        // area the subtree of child grows by if the leaf is pushed into it
+        auto get_descend_cost = [this, &leaf_min, &leaf_max](uint32_t child) {
+            const Node& node = m_nodes[child];
+            float       area = GetSurfaceArea(glm::min(node.min, leaf_min), glm::max(node.max, leaf_max));
+            return node.IsLeaf() ? area : area - GetSurfaceArea(node.min, node.max);
+        };
+
+        uint32_t sibling = m_root;
+        while (!m_nodes[sibling].IsLeaf())
+        {
+            const Node& node          = m_nodes[sibling];
+            float       area          = GetSurfaceArea(node.min, node.max);
+            float       combined_area = GetSurfaceArea(glm::min(node.min, leaf_min), glm::max(node.max, leaf_max));
+
+            // cost of making the leaf a sibling of this node, and the least cost of moving it further down
+            float cost             = 2.0f * combined_area;
+            float inheritance_cost = 2.0f * (combined_area - area);
+            float cost1            = get_descend_cost(node.child1) + inheritance_cost;
+            float cost2            = get_descend_cost(node.child2) + inheritance_cost;
+
+            if (cost < cost1 && cost < cost2)
+                break;
+
+            sibling = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        uint32_t old_parent = m_nodes[sibling].parent;
+        uint32_t new_parent = AllocateNode();
+
+        m_nodes[new_parent].parent = old_parent;
+        m_nodes[new_parent].child1 = sibling;
+        m_nodes[new_parent].child2 = leaf;
+        m_nodes[new_parent].height = m_nodes[sibling].height + 1;
+        SetUnion(new_parent, sibling, leaf);
+
+        if (old_parent == k_null_node)
+            m_root = new_parent;
+        else if (m_nodes[old_parent].child1 == sibling)
+            m_nodes[old_parent].child1 = new_parent;
+        else
+            m_nodes[old_parent].child2 = new_parent;
+
+        m_nodes[sibling].parent = new_parent;
+        m_nodes[leaf].parent    = new_parent;
+
+        Refit(old_parent);
+    }
+
+    void DynamicBoundingBoxTree::RemoveLeaf(uint32_t leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = k_null_node;
+            return;
+        }
+
+        uint32_t parent       = m_nodes[leaf].parent;
+        uint32_t grand_parent = m_nodes[parent].parent;
+        uint32_t sibling      = m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+        // the sibling takes the place of the parent
+        if (grand_parent == k_null_node)
+            m_root = sibling;
+        else if (m_nodes[grand_parent].child1 == parent)
+            m_nodes[grand_parent].child1 = sibling;
+        else
+            m_nodes[grand_parent].child2 = sibling;
+
+        m_nodes[sibling].parent = grand_parent;
+        m_nodes[leaf].parent    = k_null_node;
+        FreeNode(parent);
+
+        Refit(grand_parent);
+    }
+
+    void DynamicBoundingBoxTree::Refit(uint32_t index)
+    {
+        while (index != k_null_node)
+        {
+            index = Balance(index);
+
+            Node& node  = m_nodes[index];
+            node.height = 1 + std::max(m_nodes[node.child1].height, m_nodes[node.child2].height);
+            SetUnion(index, node.child1, node.child2);
+
+            index = node.parent;
+        }
+    }
+
+    uint32_t DynamicBoundingBoxTree::Balance(uint32_t index_a)
+    {
+        Node& a = m_nodes[index_a];
+        if (a.IsLeaf() || a.height < 2)
+            return index_a;
+
+        uint32_t index_b = a.child1;
+        uint32_t index_c = a.child2;
+        int      balance = m_nodes[index_c].height - m_nodes[index_b].height;
+
+        if (balance >= -1 && balance <= 1)
+            return index_a;
+
+        // the taller child of a takes its place, a takes the place of the taller grandchild's lower sibling
+        bool     rotate_c    = balance > 1;
+        uint32_t index_up    = rotate_c ? index_c : index_b;
+        uint32_t index_stays = rotate_c ? index_b : index_c;
+        Node&    up          = m_nodes[index_up];
+
+        uint32_t index_f = up.child1;
+        uint32_t index_g = up.child2;
+
+        up.child1 = index_a;
+        up.parent = a.parent;
+        a.parent  = index_up;
+
+        if (up.parent == k_null_node)
+            m_root = index_up;
+        else if (m_nodes[up.parent].child1 == index_a)
+            m_nodes[up.parent].child1 = index_up;
+        else
+            m_nodes[up.parent].child2 = index_up;
+
+        // the taller grandchild stays below the node moving up, the other one moves below a
+        uint32_t index_taller  = m_nodes[index_f].height > m_nodes[index_g].height ? index_f : index_g;
+        uint32_t index_shorter = index_taller == index_f ? index_g : index_f;
+
+        up.child2 = index_taller;
+        if (rotate_c)
+            a.child2 = index_shorter;
+        else
+            a.child1 = index_shorter;
+        m_nodes[index_shorter].parent = index_a;
+
+        SetUnion(index_a, index_stays, index_shorter);
+        a.height = 1 + std::max(m_nodes[index_stays].height, m_nodes[index_shorter].height);
+
+        SetUnion(index_up, index_a, index_taller);
+        up.height = 1 + std::max(a.height, m_nodes[index_taller].height);
+
+        return index_up;
+    }
+
+    void DynamicBoundingBoxTree::SetUnion(uint32_t index, uint32_t child1, uint32_t child2)
+    {
+        m_nodes[index].min = glm::min(m_nodes[child1].min, m_nodes[child2].min);
+        m_nodes[index].max = glm::max(m_nodes[child1].max, m_nodes[child2].max);
+    }
+} // namespace Meow
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "core/base/non_copyable.h"
+#include "core/math/bounding_box.h"
+#include "core/math/frustum.h"
+#include "core/math/ray.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Bounding volume hierarchy over boxes that move, refitted incrementally.
+     *
+     * Leaves store their box enlarged by a margin, so a box that moves a little stays within its leaf and the tree is
+     * not touched. Only a box that leaves its enlarged box is removed and inserted again. Insertion descends towards
+     * the sibling with the least increase in surface area and tree rotations keep the tree balanced, as in the
+     * dynamic tree of Box2D.
+     */
+    class DynamicBoundingBoxTree : public NonCopyable
+    {
+    public:
+        static constexpr uint32_t k_null_node = ~0u;
+
+        /**
+         * @brief Add a box, the returned proxy stays valid until it is removed.
+         */
+        uint32_t Insert(const BoundingBox& bounds, uint32_t user_data);
+
+        void Remove(uint32_t proxy);
+
+        /**
+         * @brief Update the box of a proxy. Returns true if it left its enlarged box and was inserted again.
+         */
+        bool Move(uint32_t proxy, const BoundingBox& bounds);
+
+        uint32_t GetUserData(uint32_t proxy) const { return m_nodes[proxy].user_data; }
+
+        uint32_t GetProxyCount() const { return m_proxy_count; }
+
+        /**
+         * @brief Height of the root, 0 for a single leaf.
+         */
+        int GetHeight() const { return m_root == k_null_node ? 0 : m_nodes[m_root].height; }
+
+        /**
+         * @brief Append the user data of the proxies whose enlarged box is inside the frustum to inside, and of those
+         * whose enlarged box intersects it to intersecting.
+         *
+         * Subtrees outside the frustum are skipped and subtrees inside it are collected without further plane tests,
+         * so the cost depends on the visible part of the tree rather than on its size.
+         */
+        void QueryFrustum(const Frustum&         frustum,
+                          std::vector<uint32_t>& inside,
+                          std::vector<uint32_t>& intersecting) const;
+
+        /**
+         * @brief Call visit(user_data) for the proxies whose enlarged box the ray enters before max_distance, visiting
+         * the nearer child of a node first.
+         *
+         * visit returns the distance the query is limited to from then on, so a closest hit query skips the boxes
+         * behind the closest hit found so far.
+         */
+        template<typename Func>
+        void QueryRay(const Ray& ray, float max_distance, Func&& visit) const
+        {
+            if (m_root == k_null_node)
+                return;
+
+            const glm::vec3 inverse_direction = 1.0f / ray.direction;
+            const float     infinity          = std::numeric_limits<float>::infinity();
+
+            auto get_distance = [&](uint32_t index) {
+                return IntersectRayBox(
+                    ray.origin, inverse_direction, m_nodes[index].min, m_nodes[index].max, max_distance);
+            };
+
+            // nodes to visit with the distance their box is entered at
+            std::vector<std::pair<uint32_t, float>> stack;
+            stack.reserve(64);
+            stack.emplace_back(m_root, get_distance(m_root));
+
+            while (!stack.empty())
+            {
+                auto [index, distance] = stack.back();
+                stack.pop_back();
+
+                if (distance >= max_distance)
+                    continue;
+
+                const Node& node = m_nodes[index];
+                if (node.IsLeaf())
+                {
+                    max_distance = visit(node.user_data);
+                    continue;
+                }
+
+                // the nearer child is pushed last to be visited next
+                float distance1 = get_distance(node.child1);
+                float distance2 = get_distance(node.child2);
+                if (distance1 < distance2)
+                {
+                    if (distance2 != infinity)
+                        stack.emplace_back(node.child2, distance2);
+                    stack.emplace_back(node.child1, distance1);
+                }
+                else
+                {
+                    if (distance1 != infinity)
+                        stack.emplace_back(node.child1, distance1);
+                    if (distance2 != infinity)
+                        stack.emplace_back(node.child2, distance2);
+                }
+            }
+        }
+
+    private:
+        struct Node
+        {
+            glm::vec3 min;
+            glm::vec3 max;
+
+            uint32_t parent = k_null_node; // next free node while the node is free
+            uint32_t child1 = k_null_node;
+            uint32_t child2 = k_null_node;
+
+            int      height    = -1; // 0 for leaves, -1 for free nodes
+            uint32_t user_data = 0;
+
+            bool IsLeaf() const { return child1 == k_null_node; }
+        };
+
+        uint32_t AllocateNode();
+        void     FreeNode(uint32_t index);
+
+        void InsertLeaf(uint32_t leaf);
+        void RemoveLeaf(uint32_t leaf);
+
+        // recompute boxes and heights from index up to the root, rotating unbalanced nodes on the way
+        void Refit(uint32_t index);
+
+        // rotate the taller grandchild of an unbalanced node up, return the node now at its place
+        uint32_t Balance(uint32_t index);
+
+        void SetUnion(uint32_t index, uint32_t child1, uint32_t child2);
+
+        std::vector<Node> m_nodes;
+
+        uint32_t m_root        = k_null_node;
+        uint32_t m_free_list   = k_null_node;
+        uint32_t m_proxy_count = 0;
+    };
+} // namespace Meow
@@ -10,8 +10,16 @@
 #    define M_PI 3.14159265358979323846264338327
 #endif
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
 #include <format>
 #include <iostream>
+#include <limits>
+
+#ifdef MEOW_SIMD_X86
+#    include <immintrin.h>
+#endif
 
 namespace Meow
 {
@@ -77,6 +85,17 @@ namespace Meow
         normal = glm::normalize(point - cameraPos);
         normal = glm::cross(normal, up);
         pl[RIGHT].setNormalAndPoint(normal, point);
+
+        for (int i = 0; i < 6; ++i)
+        {
+            m_normal_x[i]     = pl[i].normal.x;
+            m_normal_y[i]     = pl[i].normal.y;
+            m_normal_z[i]     = pl[i].normal.z;
+            m_abs_normal_x[i] = glm::abs(pl[i].normal.x);
+            m_abs_normal_y[i] = glm::abs(pl[i].normal.y);
+            m_abs_normal_z[i] = glm::abs(pl[i].normal.z);
+            m_distance[i]     = pl[i].D;
+        }
     }
 
     // False is fully outside, true if inside or intersects
@@ -101,4 +120,275 @@ namespace Meow
         }
         return true;
     }
-} // namespace Meow
\ No newline at end of file
+
+    namespace
+    {
+        // bit k is set if plane k rejected one of the boxes [begin, begin + count) last time
+        uint32_t GetLastPlaneMask(const uint8_t* last_planes, uint32_t begin, uint32_t count)
+        {
+            uint32_t mask = 0;
+            if (last_planes)
+            {
+                for (uint32_t i = begin; i < begin + count; ++i)
+                {
+                    if (last_planes[i] != Frustum::k_no_plane)
+                        mask |= 1u << last_planes[i];
+                }
+            }
+            return mask;
+        }
+
+        void RecordLastPlane(uint8_t* last_planes, uint32_t begin, uint32_t lane_mask, uint32_t plane)
+        {
+            if (!last_planes)
+                return;
+
+            for (; lane_mask; lane_mask &= lane_mask - 1)
+            {
+                last_planes[begin + std::countr_zero(lane_mask)] = static_cast<uint8_t>(plane);
+            }
+        }
+    } // namespace
+
+    // A box is outside a plane if its corner furthest along the normal, the p-vertex, is behind it:
+    // dot(normal, center) + distance + dot(abs(normal), extent) < 0
+    // It is inside if its corner nearest along the normal, the n-vertex, is in front of it:
+    // dot(normal, center) + distance - dot(abs(normal), extent) >= 0
+    float Frustum::GetCenterDistance(uint32_t plane, float x, float y, float z) const
+    {
+        // same operation order as the SIMD kernels, so every box gets the same result on any path
+        return (m_normal_x[plane] * x + m_normal_y[plane] * y) + (m_normal_z[plane] * z + m_distance[plane]);
+    }
+
+    float Frustum::GetRadius(uint32_t plane, float x, float y, float z) const
+    {
+        return (m_abs_normal_x[plane] * x + m_abs_normal_y[plane] * y) + m_abs_normal_z[plane] * z;
+    }
+
+    uint32_t
+    Frustum::ClassifyBoundingBox(const glm::vec3& center, const glm::vec3& extent, uint32_t& plane_mask) const
+    {
+        for (uint32_t planes = plane_mask; planes; planes &= planes - 1)
+        {
+            uint32_t plane           = std::countr_zero(planes);
+            float    center_distance = GetCenterDistance(plane, center.x, center.y, center.z);
+            float    radius          = GetRadius(plane, extent.x, extent.y, extent.z);
+            if (center_distance + radius < 0.0f)
+                return plane;
+            if (center_distance - radius >= 0.0f)
+                plane_mask &= ~(1u << plane);
+        }
+
+        return k_no_plane;
+    }
+
+    void Frustum::CullBoundingBoxes(const BoundingBoxSoA& boxes, uint8_t* visibility, SimdLevel level) const
+    {
+        CullBoundingBoxes(boxes, 0, boxes.GetCount(), visibility, nullptr, level);
+    }
+
+    void Frustum::CullBoundingBoxes(const BoundingBoxSoA& boxes,
+                                    uint32_t              begin,
+                                    uint32_t              end,
+                                    uint8_t*              visibility,
+                                    uint8_t*              last_planes,
+                                    SimdLevel             level) const
+    {
+        // blocks start at multiples of the block size, so splitting the boxes into ranges at such multiples gives
+        // the same blocks as culling them all at once
+        for (uint32_t block_begin = begin; block_begin < end;)
+        {
+            uint32_t block_end = std::min((block_begin / k_cull_block_size + 1) * k_cull_block_size, end);
+
+            glm::vec3 min(std::numeric_limits<float>::max());
+            glm::vec3 max(std::numeric_limits<float>::lowest());
+            for (uint32_t i = block_begin; i < block_end; ++i)
+            {
+                glm::vec3 center(boxes.center_x[i], boxes.center_y[i], boxes.center_z[i]);
+                glm::vec3 extent(boxes.extent_x[i], boxes.extent_y[i], boxes.extent_z[i]);
+                min = glm::min(min, center - extent);
+                max = glm::max(max, center + extent);
+            }
+
+            // padded a little, so that rounding cannot make the block test less conservative than the box tests
+            glm::vec3 block_center = (min + max) * 0.5f;
+            glm::vec3 block_extent = (max - min) * 0.5f;
+            block_extent += (glm::abs(block_center) + block_extent) * 1e-5f;
+
+            // planes the block intersects, the others have all its boxes on their inner side
+            uint32_t test_mask     = k_all_planes;
+            uint32_t outside_plane = ClassifyBoundingBox(block_center, block_extent, test_mask);
+
+            uint32_t block_count = block_end - block_begin;
+            if (outside_plane != k_no_plane)
+            {
+                std::memset(visibility + block_begin, 0, block_count);
+                if (last_planes)
+                    std::memset(last_planes + block_begin, static_cast<int>(outside_plane), block_count);
+            }
+            else if (test_mask == 0)
+            {
+                std::memset(visibility + block_begin, 1, block_count);
+            }
+            else
+            {
+                CullBlock(boxes, block_begin, block_end, test_mask, visibility, last_planes, level);
+            }
+
+            block_begin = block_end;
+        }
+    }
+
+    void Frustum::CullBlock(const BoundingBoxSoA& boxes,
+                            uint32_t              begin,
+                            uint32_t              end,
+                            uint32_t              test_mask,
+                            uint8_t*              visibility,
+                            uint8_t*              last_planes,
+                            SimdLevel             level) const
+    {
+        uint32_t i = begin;
+
+#ifdef MEOW_SIMD_X86
+        if (level == SimdLevel::AVX2 && GetSimdLevel() == SimdLevel::AVX2)
+            i = CullBlockAVX2(boxes, begin, end, test_mask, visibility, last_planes);
+        else if (level != SimdLevel::Scalar)
+            i = CullBlockSSE2(boxes, begin, end, test_mask, visibility, last_planes);
+#endif
+
+        for (; i < end; ++i)
+        {
+            // the plane that rejected the box last time is tested first, it most likely rejects it again
+            uint32_t first_planes = GetLastPlaneMask(last_planes, i, 1) & test_mask;
+            uint32_t visible      = 1;
+            for (uint32_t planes : {first_planes, test_mask & ~first_planes})
+            {
+                for (; planes && visible; planes &= planes - 1)
+                {
+                    uint32_t plane = std::countr_zero(planes);
+                    float    center_distance =
+                        GetCenterDistance(plane, boxes.center_x[i], boxes.center_y[i], boxes.center_z[i]);
+                    float radius = GetRadius(plane, boxes.extent_x[i], boxes.extent_y[i], boxes.extent_z[i]);
+
+                    if (center_distance + radius < 0.0f)
+                    {
+                        RecordLastPlane(last_planes, i, 1, plane);
+                        visible = 0;
+                    }
+                }
+            }
+            visibility[i] = static_cast<uint8_t>(visible);
+        }
+    }
+
+#ifdef MEOW_SIMD_X86
+    uint32_t Frustum::CullBlockSSE2(const BoundingBoxSoA& boxes,
+                                    uint32_t              begin,
+                                    uint32_t              end,
+                                    uint32_t              test_mask,
+                                    uint8_t*              visibility,
+                                    uint8_t*              last_planes) const
+    {
+        const __m128 zero = _mm_setzero_ps();
+
+        uint32_t i = begin;
+        for (; i + 4 <= end; i += 4)
+        {
+            const __m128 center_x = _mm_loadu_ps(&boxes.center_x[i]);
+            const __m128 center_y = _mm_loadu_ps(&boxes.center_y[i]);
+            const __m128 center_z = _mm_loadu_ps(&boxes.center_z[i]);
+            const __m128 extent_x = _mm_loadu_ps(&boxes.extent_x[i]);
+            const __m128 extent_y = _mm_loadu_ps(&boxes.extent_y[i]);
+            const __m128 extent_z = _mm_loadu_ps(&boxes.extent_z[i]);
+
+            // planes that rejected any of the four boxes last time go first
+            uint32_t first_planes = GetLastPlaneMask(last_planes, i, 4) & test_mask;
+
+            // bit k is set while box i + k may be visible
+            uint32_t visible_mask = 0xF;
+            for (uint32_t planes : {first_planes, test_mask & ~first_planes})
+            {
+                for (; planes && visible_mask; planes &= planes - 1)
+                {
+                    uint32_t plane           = std::countr_zero(planes);
+                    __m128   center_distance =
+                        _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m_normal_x[plane]), center_x),
+                                              _mm_mul_ps(_mm_set1_ps(m_normal_y[plane]), center_y)),
+                                   _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m_normal_z[plane]), center_z),
+                                              _mm_set1_ps(m_distance[plane])));
+                    __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m_abs_normal_x[plane]), extent_x),
+                                                          _mm_mul_ps(_mm_set1_ps(m_abs_normal_y[plane]), extent_y)),
+                                               _mm_mul_ps(_mm_set1_ps(m_abs_normal_z[plane]), extent_z));
+
+                    uint32_t outside_mask =
+                        _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(center_distance, radius), zero)) & visible_mask;
+                    RecordLastPlane(last_planes, i, outside_mask, plane);
+                    visible_mask &= ~outside_mask;
+                }
+            }
+
+            for (uint32_t lane = 0; lane < 4; ++lane)
+            {
+                visibility[i + lane] = (visible_mask >> lane) & 1;
+            }
+        }
+
+        return i;
+    }
+
+    MEOW_TARGET_AVX2
+    uint32_t Frustum::CullBlockAVX2(const BoundingBoxSoA& boxes,
+                                    uint32_t              begin,
+                                    uint32_t              end,
+                                    uint32_t              test_mask,
+                                    uint8_t*              visibility,
+                                    uint8_t*              last_planes) const
+    {
+        const __m256 zero = _mm256_setzero_ps();
+
+        uint32_t i = begin;
+        for (; i + 8 <= end; i += 8)
+        {
+            const __m256 center_x = _mm256_loadu_ps(&boxes.center_x[i]);
+            const __m256 center_y = _mm256_loadu_ps(&boxes.center_y[i]);
+            const __m256 center_z = _mm256_loadu_ps(&boxes.center_z[i]);
+            const __m256 extent_x = _mm256_loadu_ps(&boxes.extent_x[i]);
+            const __m256 extent_y = _mm256_loadu_ps(&boxes.extent_y[i]);
+            const __m256 extent_z = _mm256_loadu_ps(&boxes.extent_z[i]);
+
+            uint32_t first_planes = GetLastPlaneMask(last_planes, i, 8) & test_mask;
+
+            uint32_t visible_mask = 0xFF;
+            for (uint32_t planes : {first_planes, test_mask & ~first_planes})
+            {
+                for (; planes && visible_mask; planes &= planes - 1)
+                {
+                    uint32_t plane = std::countr_zero(planes);
+                    __m256   center_distance =
+                        _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m_normal_x[plane]), center_x),
+                                                    _mm256_mul_ps(_mm256_set1_ps(m_normal_y[plane]), center_y)),
+                                      _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m_normal_z[plane]), center_z),
+                                                    _mm256_set1_ps(m_distance[plane])));
+                    __m256 radius =
+                        _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(m_abs_normal_x[plane]), extent_x),
+                                                    _mm256_mul_ps(_mm256_set1_ps(m_abs_normal_y[plane]), extent_y)),
+                                      _mm256_mul_ps(_mm256_set1_ps(m_abs_normal_z[plane]), extent_z));
+
+                    uint32_t outside_mask =
+                        _mm256_movemask_ps(_mm256_cmp_ps(_mm256_add_ps(center_distance, radius), zero, _CMP_LT_OQ)) &
+                        visible_mask;
+                    RecordLastPlane(last_planes, i, outside_mask, plane);
+                    visible_mask &= ~outside_mask;
+                }
+            }
+
+            for (uint32_t lane = 0; lane < 8; ++lane)
+            {
+                visibility[i + lane] = (visible_mask >> lane) & 1;
+            }
+        }
+
+        return i;
+    }
+#endif
+} // namespace Meow
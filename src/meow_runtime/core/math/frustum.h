@@ -1,10 +1,14 @@
 #pragma once
 
 #include "bounding_box.h"
+#include "bounding_box_soa.h"
 #include "plane.h"
+#include "simd.h"
 
 #include <glm/gtc/quaternion.hpp>
 
+#include <cstdint>
+
 namespace Meow
 {
     class Frustum
@@ -25,7 +29,107 @@ namespace Meow
         updatePlanes(const glm::vec3 cameraPos, const glm::quat rotation, float fovy, float AR, float near, float far);
         bool checkIfInside(BoundingBox* bounds);
 
+        /**
+         * @brief Plane index meaning that no plane has rejected a box yet.
+         */
+        static constexpr uint8_t k_no_plane = 0xFF;
+
+        /**
+         * @brief Plane mask with the bits of all six planes set.
+         */
+        static constexpr uint32_t k_all_planes = 0x3F;
+
+        /**
+         * @brief Number of consecutive boxes that are first tested together, as one box bounding them all.
+         */
+        static constexpr uint32_t k_cull_block_size = 64;
+
+        /**
+         * @brief Plane as (normal, distance), a point p is on the inner side if dot(normal, p) + distance >= 0.
+         */
+        glm::vec4 GetPlane(uint32_t plane) const
+        {
+            return glm::vec4(m_normal_x[plane], m_normal_y[plane], m_normal_z[plane], m_distance[plane]);
+        }
+
+        /**
+         * @brief Test one box against the planes whose bits are set in plane_mask.
+         *
+         * @return The first plane the box is outside of, or k_no_plane if it is inside or intersects the frustum. In
+         * that case the bits of the planes the box is fully inside of are cleared from plane_mask, boxes within it
+         * need not be tested against them.
+         */
+        uint32_t
+        ClassifyBoundingBox(const glm::vec3& center, const glm::vec3& extent, uint32_t& plane_mask) const;
+
+        /**
+         * @brief Test all boxes against the frustum at once. visibility[i] is set to 1 if box i is inside or intersects
+         * the frustum, 0 if it is fully outside.
+         *
+         * Uses the p-vertex test, which needs one dot product per plane instead of eight, on 4 (SSE2) or 8 (AVX2)
+         * boxes at a time.
+         */
+        void CullBoundingBoxes(const BoundingBoxSoA& boxes,
+                               uint8_t*              visibility,
+                               SimdLevel             level = GetSimdLevel()) const;
+
+        /**
+         * @brief Test the boxes [begin, end) against the frustum, reusing what the previous frame found out.
+         *
+         * Boxes are grouped into blocks of k_cull_block_size, starting at multiples of it. A block that is outside a
+         * plane is rejected as a whole, and the planes it is fully inside of are not tested for its boxes. The other
+         * planes are tested starting with the one that rejected the box last time, which is recorded in
+         * last_planes (k_no_plane if none). Objects that barely move are then mostly resolved with one plane test.
+         *
+         * Disjoint ranges may be culled from different threads if they are split at multiples of k_cull_block_size.
+         *
+         * @param last_planes May be null to cull without temporal data.
+         */
+        void CullBoundingBoxes(const BoundingBoxSoA& boxes,
+                               uint32_t              begin,
+                               uint32_t              end,
+                               uint8_t*              visibility,
+                               uint8_t*              last_planes,
+                               SimdLevel             level = GetSimdLevel()) const;
+
     private:
+        float GetCenterDistance(uint32_t plane, float x, float y, float z) const;
+        float GetRadius(uint32_t plane, float x, float y, float z) const;
+
+        // test the boxes [begin, end) of one block against the planes in test_mask
+        void CullBlock(const BoundingBoxSoA& boxes,
+                       uint32_t              begin,
+                       uint32_t              end,
+                       uint32_t              test_mask,
+                       uint8_t*              visibility,
+                       uint8_t*              last_planes,
+                       SimdLevel             level) const;
+
+#ifdef MEOW_SIMD_X86
+        // return the index after the last box culled, the remainder is left to the scalar loop
+        uint32_t CullBlockSSE2(const BoundingBoxSoA& boxes,
+                               uint32_t              begin,
+                               uint32_t              end,
+                               uint32_t              test_mask,
+                               uint8_t*              visibility,
+                               uint8_t*              last_planes) const;
+        uint32_t CullBlockAVX2(const BoundingBoxSoA& boxes,
+                               uint32_t              begin,
+                               uint32_t              end,
+                               uint32_t              test_mask,
+                               uint8_t*              visibility,
+                               uint8_t*              last_planes) const;
+#endif
+
         Plane pl[6];
+
+        // planes in structure of arrays form for CullBoundingBoxes
+        float m_normal_x[6]     = {};
+        float m_normal_y[6]     = {};
+        float m_normal_z[6]     = {};
+        float m_abs_normal_x[6] = {};
+        float m_abs_normal_y[6] = {};
+        float m_abs_normal_z[6] = {};
+        float m_distance[6]     = {};
     };
 } // namespace Meow
\ No newline at end of file
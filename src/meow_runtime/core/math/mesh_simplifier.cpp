@@ -0,0 +1,328 @@
+#include "mesh_simplifier.h"
+
+#include "pch.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Meow
+{
+    namespace
+    {
+        /**
+         * @brief Sum of the squared distances to a set of planes, weighted by the area of the triangles they come from.
+         */
+        struct Quadric
+        {
+            // p^T A p + 2 b^T p + c with a symmetric A
+            double a00    = 0.0;
+            double a01    = 0.0;
+            double a02    = 0.0;
+            double a11    = 0.0;
+            double a12    = 0.0;
+            double a22    = 0.0;
+            double b0     = 0.0;
+            double b1     = 0.0;
+            double b2     = 0.0;
+            double c      = 0.0;
+            double weight = 0.0;
+
+            void AddPlane(const glm::vec3& normal, float distance, double area)
+            {
+                double x = normal.x;
+                double y = normal.y;
+                double z = normal.z;
+                double d = distance;
+
+                a00 += area * x * x;
+                a01 += area * x * y;
+                a02 += area * x * z;
+                a11 += area * y * y;
+                a12 += area * y * z;
+                a22 += area * z * z;
+                b0 += area * x * d;
+                b1 += area * y * d;
+                b2 += area * z * d;
+                c += area * d * d;
+                weight += area;
+            }
+
+            void Add(const Quadric& rhs)
+            {
+                a00 += rhs.a00;
+                a01 += rhs.a01;
+                a02 += rhs.a02;
+                a11 += rhs.a11;
+                a12 += rhs.a12;
+                a22 += rhs.a22;
+                b0 += rhs.b0;
+                b1 += rhs.b1;
+                b2 += rhs.b2;
+                c += rhs.c;
+                weight += rhs.weight;
+            }
+
+            // mean squared distance of a position to the planes
+            double GetError(const glm::vec3& position) const
+            {
+                if (weight <= 0.0)
+                    return 0.0;
+
+                double x = position.x;
+                double y = position.y;
+                double z = position.z;
+
+                double error = a00 * x * x + a11 * y * y + a22 * z * z +
+                               2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+                return std::max(error, 0.0) / weight;
+            }
+        };
+
+        struct Collapse
+        {
+            double   error; // squared distance
+            uint32_t from;
+            uint32_t to;
+        };
+
+        uint64_t GetEdgeKey(uint32_t a, uint32_t b)
+        {
+            return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+        }
+    } // namespace
+
+    std::vector<uint32_t> SimplifyMesh(std::span<const float>    vertices,
+                                       uint32_t                  stride,
+                                       std::span<const uint32_t> indices,
+                                       uint32_t                  target_index_count,
+                                       float                     max_error,
+                                       float*                    result_error)
+    {
+        FUNCTION_TIMER();
+
+        const uint32_t vertex_count = static_cast<uint32_t>(vertices.size() / stride);
+
+        auto get_position = [&vertices, stride](uint32_t index) {
+            return glm::vec3(vertices[index * stride], vertices[index * stride + 1], vertices[index * stride + 2]);
+        };
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (uint32_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            if (indices[i] != indices[i + 1] && indices[i + 1] != indices[i + 2] && indices[i] != indices[i + 2])
+                result.insert(result.end(), {indices[i], indices[i + 1], indices[i + 2]});
+        }
+
+        // planes of the triangles around each vertex
+        std::vector<Quadric> quadrics(vertex_count);
+        for (uint32_t i = 0; i < result.size(); i += 3)
+        {
+            glm::vec3 p0 = get_position(result[i]);
+            glm::vec3 cross =
+                glm::cross(get_position(result[i + 1]) - p0, get_position(result[i + 2]) - p0);
+
+            float length = glm::length(cross);
+            if (length == 0.0f)
+                continue;
+
+            glm::vec3 normal = cross / length;
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                quadrics[result[i + k]].AddPlane(normal, -glm::dot(normal, p0), length * 0.5);
+            }
+        }
+
+        // edges of other than two triangles are on a border or a seam, their vertices stay in place
+        std::vector<uint64_t> edges;
+        edges.reserve(result.size());
+        for (uint32_t i = 0; i < result.size(); i += 3)
+        {
+            for (uint32_t k = 0; k < 3; ++k)
+            {
+                edges.push_back(GetEdgeKey(result[i + k], result[i + (k + 1) % 3]));
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+
+        std::vector<uint8_t> is_locked(vertex_count, 0);
+        for (uint32_t i = 0; i < edges.size();)
+        {
+            uint32_t end = i;
+            while (end < edges.size() && edges[end] == edges[i])
+            {
+                ++end;
+            }
+
+            if (end - i != 2)
+            {
+                is_locked[edges[i] >> 32]         = 1;
+                is_locked[edges[i] & 0xffffffffu] = 1;
+            }
+            i = end;
+        }
+
+        const double max_error_squared = static_cast<double>(max_error) * max_error;
+        double       collapse_error    = 0.0;
+
+        std::vector<Collapse> collapses;
+        std::vector<uint32_t> remap(vertex_count);
+        std::vector<uint8_t>  is_touched(vertex_count);
+        std::vector<uint32_t> triangle_offsets(vertex_count + 1);
+        std::vector<uint32_t> triangle_cursors(vertex_count);
+        std::vector<uint32_t> vertex_triangles;
+
+        // each pass collapses the cheapest edges that do not share triangles, then rewrites the indices
+        while (result.size() > target_index_count)
+        {
+            const uint32_t triangle_count = static_cast<uint32_t>(result.size() / 3);
+
+            edges.clear();
+            for (uint32_t i = 0; i < result.size(); i += 3)
+            {
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    uint32_t a = result[i + k];
+                    uint32_t b = result[i + (k + 1) % 3];
+                    if (!is_locked[a] || !is_locked[b])
+                        edges.push_back(GetEdgeKey(a, b));
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+            collapses.clear();
+            for (uint64_t edge : edges)
+            {
+                uint32_t a = static_cast<uint32_t>(edge >> 32);
+                uint32_t b = static_cast<uint32_t>(edge & 0xffffffffu);
+
+                Quadric quadric = quadrics[a];
+                quadric.Add(quadrics[b]);
+
+                double a_to_b = is_locked[a] ? std::numeric_limits<double>::max() : quadric.GetError(get_position(b));
+                double b_to_a = is_locked[b] ? std::numeric_limits<double>::max() : quadric.GetError(get_position(a));
+
+                Collapse collapse = a_to_b <= b_to_a ? Collapse {a_to_b, a, b} : Collapse {b_to_a, b, a};
+                if (collapse.error <= max_error_squared)
+                    collapses.push_back(collapse);
+            }
+
+            if (collapses.empty())
+                break;
+
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) {
+                return lhs.error < rhs.error;
+            });
+
+            // triangles around each vertex
+            std::fill(triangle_offsets.begin(), triangle_offsets.end(), 0);
+            for (uint32_t index : result)
+            {
+                ++triangle_offsets[index + 1];
+            }
+            for (uint32_t i = 0; i < vertex_count; ++i)
+            {
+                triangle_offsets[i + 1] += triangle_offsets[i];
+            }
+            std::copy(triangle_offsets.begin(), triangle_offsets.end() - 1, triangle_cursors.begin());
+            vertex_triangles.resize(result.size());
+            for (uint32_t i = 0; i < result.size(); ++i)
+            {
+                vertex_triangles[triangle_cursors[result[i]]++] = i / 3;
+            }
+
+            for (uint32_t i = 0; i < vertex_count; ++i)
+            {
+                remap[i] = i;
+            }
+            std::fill(is_touched.begin(), is_touched.end(), 0);
+
+            const uint32_t max_removed_count = triangle_count - target_index_count / 3;
+            uint32_t       removed_count     = 0;
+            for (const Collapse& collapse : collapses)
+            {
+                if (removed_count >= max_removed_count)
+                    break;
+
+                if (is_touched[collapse.from] || is_touched[collapse.to])
+                    continue;
+
+                // triangles sharing the edge are removed, the others must keep facing the same side
+                glm::vec3 target          = get_position(collapse.to);
+                bool      is_flipping     = false;
+                uint32_t  collapse_remove = 0;
+                for (uint32_t i = triangle_offsets[collapse.from]; i < triangle_offsets[collapse.from + 1]; ++i)
+                {
+                    const uint32_t* triangle = &result[vertex_triangles[i] * 3];
+                    if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+                    {
+                        ++collapse_remove;
+                        continue;
+                    }
+
+                    glm::vec3 positions[3];
+                    glm::vec3 moved_positions[3];
+                    for (uint32_t k = 0; k < 3; ++k)
+                    {
+                        positions[k]       = get_position(triangle[k]);
+                        moved_positions[k] = triangle[k] == collapse.from ? target : positions[k];
+                    }
+
+                    glm::vec3 normal       = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+                    glm::vec3 moved_normal = glm::cross(moved_positions[1] - moved_positions[0],
+                                                        moved_positions[2] - moved_positions[0]);
+                    if (glm::dot(normal, moved_normal) <= 0.0f)
+                    {
+                        is_flipping = true;
+                        break;
+                    }
+                }
+
+                if (is_flipping)
+                    continue;
+
+                remap[collapse.from] = collapse.to;
+                quadrics[collapse.to].Add(quadrics[collapse.from]);
+                collapse_error = std::max(collapse_error, collapse.error);
+                removed_count += collapse_remove;
+
+                // the neighborhood is changed, other collapses in it wait for the next pass
+                is_touched[collapse.to] = 1;
+                for (uint32_t i = triangle_offsets[collapse.from]; i < triangle_offsets[collapse.from + 1]; ++i)
+                {
+                    for (uint32_t k = 0; k < 3; ++k)
+                    {
+                        is_touched[result[vertex_triangles[i] * 3 + k]] = 1;
+                    }
+                }
+            }
+
+            if (removed_count == 0)
+                break;
+
+            uint32_t write_index = 0;
+            for (uint32_t i = 0; i < result.size(); i += 3)
+            {
+                uint32_t a = remap[result[i]];
+                uint32_t b = remap[result[i + 1]];
+                uint32_t c = remap[result[i + 2]];
+                if (a == b || b == c || a == c)
+                    continue;
+
+                result[write_index++] = a;
+                result[write_index++] = b;
+                result[write_index++] = c;
+            }
+            result.resize(write_index);
+        }
+
+        if (result_error)
+            *result_error = static_cast<float>(std::sqrt(collapse_error));
+
+        return result;
+    }
+} // namespace Meow
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Simplify an indexed triangle list by collapsing edges in the order of their quadric error.
+     *
+     * Vertices are collapsed onto other vertices of the mesh, so the result indexes the same vertex data. Vertices on
+     * borders are never moved, which includes seams where vertices are split by their attributes, so the outline of
+     * the mesh and its texture layout are kept. Collapses that would flip a triangle are rejected.
+     *
+     * @param vertices Interleaved vertex data, each vertex starts with its position.
+     * @param stride Number of floats per vertex.
+     * @param target_index_count Stop once the result has at most this many indices.
+     * @param max_error Stop before collapses with a larger error, as a distance in the space of the vertices.
+     * @param result_error Set to the largest error of the collapses made, as a distance, may be nullptr.
+     * @return Indices of the remaining triangles, more than target_index_count if the mesh could not be simplified
+     * further.
+     */
+    std::vector<uint32_t> SimplifyMesh(std::span<const float>    vertices,
+                                       uint32_t                  stride,
+                                       std::span<const uint32_t> indices,
+                                       uint32_t                  target_index_count,
+                                       float                     max_error,
+                                       float*                    result_error = nullptr);
+} // namespace Meow
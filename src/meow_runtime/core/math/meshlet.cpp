@@ -0,0 +1,272 @@
+#include "meshlet.h"
+
+#include "pch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Meow
+{
+    namespace
+    {
+        // meshlets whose normals spread further than this from their average are never culled by their cone
+        constexpr float k_min_cone_dot = 0.1f;
+
+        constexpr uint32_t k_no_triangle = std::numeric_limits<uint32_t>::max();
+    } // namespace
+
+    std::vector<Meshlet> BuildMeshlets(std::span<const float> vertices, uint32_t stride, std::span<uint32_t> indices)
+    {
+        FUNCTION_TIMER();
+
+        const uint32_t vertex_count   = static_cast<uint32_t>(vertices.size() / stride);
+        const uint32_t triangle_count = static_cast<uint32_t>(indices.size() / 3);
+
+        auto get_position = [&vertices, stride](uint32_t index) {
+            return glm::vec3(vertices[index * stride], vertices[index * stride + 1], vertices[index * stride + 2]);
+        };
+
+        // triangles around each vertex
+        std::vector<uint32_t> triangle_offsets(vertex_count + 1, 0);
+        for (uint32_t i = 0; i < triangle_count * 3; ++i)
+        {
+            ++triangle_offsets[indices[i] + 1];
+        }
+        for (uint32_t i = 0; i < vertex_count; ++i)
+        {
+            triangle_offsets[i + 1] += triangle_offsets[i];
+        }
+        std::vector<uint32_t> triangle_cursors(triangle_offsets.begin(), triangle_offsets.end() - 1);
+        std::vector<uint32_t> vertex_triangles(triangle_count * 3);
+        for (uint32_t i = 0; i < triangle_count * 3; ++i)
+        {
+            vertex_triangles[triangle_cursors[indices[i]]++] = i / 3;
+        }
+
+        std::vector<uint8_t>  is_emitted(triangle_count, 0);
+        std::vector<uint32_t> meshlet_of_vertex(vertex_count, std::numeric_limits<uint32_t>::max());
+        std::vector<uint32_t> ordered_indices;
+        ordered_indices.reserve(triangle_count * 3);
+
+        std::vector<Meshlet>  meshlets;
+        std::vector<uint32_t> meshlet_vertices;
+        glm::vec3             position_sum(0.0f);
+
+        // the triangle around the given vertices that adds the fewest vertices, then the one closest to the meshlet
+        auto find_next_triangle = [&](std::span<const uint32_t> around, uint32_t meshlet_index, uint32_t& new_count) {
+            const glm::vec3 meshlet_center = position_sum / static_cast<float>(meshlet_vertices.size());
+
+            uint32_t best_triangle = k_no_triangle;
+            float    best_distance = 0.0f;
+            new_count              = 4;
+            for (uint32_t vertex : around)
+            {
+                for (uint32_t i = triangle_offsets[vertex]; i < triangle_offsets[vertex + 1]; ++i)
+                {
+                    uint32_t triangle = vertex_triangles[i];
+                    if (is_emitted[triangle])
+                        continue;
+
+                    const uint32_t* triangle_indices = &indices[triangle * 3];
+                    uint32_t        count            = 0;
+                    for (uint32_t k = 0; k < 3; ++k)
+                    {
+                        count += meshlet_of_vertex[triangle_indices[k]] != meshlet_index;
+                    }
+                    if (count > new_count)
+                        continue;
+
+                    glm::vec3 corner_sum = get_position(triangle_indices[0]) + get_position(triangle_indices[1]) +
+                                           get_position(triangle_indices[2]);
+                    glm::vec3 offset     = corner_sum / 3.0f - meshlet_center;
+                    float     distance   = glm::dot(offset, offset);
+                    if (count < new_count || distance < best_distance)
+                    {
+                        best_triangle = triangle;
+                        best_distance = distance;
+                        new_count     = count;
+                    }
+                }
+            }
+            return best_triangle;
+        };
+
+        for (uint32_t seed = 0; seed < triangle_count; ++seed)
+        {
+            if (is_emitted[seed])
+                continue;
+
+            const uint32_t meshlet_index = static_cast<uint32_t>(meshlets.size());
+
+            Meshlet meshlet;
+            meshlet.first_index = static_cast<uint32_t>(ordered_indices.size());
+            meshlet_vertices.clear();
+            position_sum = glm::vec3(0.0f);
+
+            // grow from the seed until the meshlet is full or has no free neighbors left
+            for (uint32_t triangle = seed; triangle != k_no_triangle;)
+            {
+                is_emitted[triangle] = 1;
+                for (uint32_t k = 0; k < 3; ++k)
+                {
+                    uint32_t vertex = indices[triangle * 3 + k];
+                    ordered_indices.push_back(vertex);
+                    if (meshlet_of_vertex[vertex] != meshlet_index)
+                    {
+                        meshlet_of_vertex[vertex] = meshlet_index;
+                        meshlet_vertices.push_back(vertex);
+                        position_sum += get_position(vertex);
+                    }
+                }
+
+                if ((ordered_indices.size() - meshlet.first_index) / 3 == k_meshlet_max_triangle_count)
+                    break;
+
+                // neighbors of the last triangle keep the meshlet compact, the others are searched once they run out
+                uint32_t new_count;
+                uint32_t next = find_next_triangle(indices.subspan(triangle * 3, 3), meshlet_index, new_count);
+                if (next == k_no_triangle)
+                    next = find_next_triangle(meshlet_vertices, meshlet_index, new_count);
+
+                triangle = meshlet_vertices.size() + new_count <= k_meshlet_max_vertex_count ? next : k_no_triangle;
+            }
+
+            meshlet.index_count  = static_cast<uint32_t>(ordered_indices.size()) - meshlet.first_index;
+            meshlet.vertex_count = static_cast<uint32_t>(meshlet_vertices.size());
+
+            // bounding sphere around the center of the bounding box
+            glm::vec3 min(std::numeric_limits<float>::max());
+            glm::vec3 max(std::numeric_limits<float>::lowest());
+            for (uint32_t vertex : meshlet_vertices)
+            {
+                min = glm::min(min, get_position(vertex));
+                max = glm::max(max, get_position(vertex));
+            }
+            meshlet.center = (min + max) * 0.5f;
+            for (uint32_t vertex : meshlet_vertices)
+            {
+                meshlet.radius = std::max(meshlet.radius, glm::length(get_position(vertex) - meshlet.center));
+            }
+
+            // normal cone around the average of the triangle normals
+            std::span<const uint32_t> meshlet_indices(&ordered_indices[meshlet.first_index], meshlet.index_count);
+            glm::vec3                 normal_sum(0.0f);
+            for (uint32_t i = 0; i < meshlet_indices.size(); i += 3)
+            {
+                glm::vec3 p0     = get_position(meshlet_indices[i]);
+                glm::vec3 normal = glm::cross(get_position(meshlet_indices[i + 1]) - p0,
+                                              get_position(meshlet_indices[i + 2]) - p0);
+                float     length = glm::length(normal);
+                if (length > 0.0f)
+                    normal_sum += normal / length;
+            }
+
+            meshlet.cone_apex   = meshlet.center;
+            meshlet.cone_axis   = glm::vec3(0.0f, 0.0f, 1.0f);
+            meshlet.cone_cutoff = 1.0f;
+
+            float axis_length = glm::length(normal_sum);
+            if (axis_length > 0.0f)
+            {
+                glm::vec3 axis = normal_sum / axis_length;
+
+                // the apex is moved back along the axis until every triangle plane is in front of it
+                float min_dot      = 1.0f;
+                float max_distance = 0.0f;
+                for (uint32_t i = 0; i < meshlet_indices.size(); i += 3)
+                {
+                    glm::vec3 p0     = get_position(meshlet_indices[i]);
+                    glm::vec3 normal = glm::cross(get_position(meshlet_indices[i + 1]) - p0,
+                                                  get_position(meshlet_indices[i + 2]) - p0);
+                    float     length = glm::length(normal);
+                    if (length == 0.0f)
+                        continue;
+
+                    normal /= length;
+                    float normal_dot = glm::dot(normal, axis);
+                    min_dot          = std::min(min_dot, normal_dot);
+                    if (normal_dot > 0.0f)
+                        max_distance = std::max(max_distance, glm::dot(meshlet.center - p0, normal) / normal_dot);
+                }
+
+                meshlet.cone_axis = axis;
+                if (min_dot > k_min_cone_dot)
+                {
+                    meshlet.cone_apex   = meshlet.center - axis * max_distance;
+                    meshlet.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+                }
+            }
+
+            meshlets.push_back(meshlet);
+        }
+
+        std::copy(ordered_indices.begin(), ordered_indices.end(), indices.begin());
+
+        return meshlets;
+    }
+
+    MeshletCullParams
+    GetMeshletCullParams(const Frustum& frustum, const glm::vec3& camera_position, const glm::mat4& world_matrix)
+    {
+        MeshletCullParams params;
+
+        glm::mat4 transposed = glm::transpose(world_matrix);
+        for (uint32_t i = 0; i < 6; ++i)
+        {
+            params.planes[i] = transposed * frustum.GetPlane(i);
+        }
+
+        params.camera_position = glm::vec3(glm::inverse(world_matrix) * glm::vec4(camera_position, 1.0f));
+
+        return params;
+    }
+
+    bool IsMeshletVisible(const Meshlet& meshlet, const MeshletCullParams& params)
+    {
+        for (const glm::vec4& plane : params.planes)
+        {
+            glm::vec3 normal(plane);
+            if (glm::dot(normal, meshlet.center) + plane.w < -meshlet.radius * glm::length(normal))
+                return false;
+        }
+
+        // culled if the direction from the camera to the apex is within the cone, without normalizing it
+        if (meshlet.cone_cutoff < 1.0f)
+        {
+            glm::vec3 direction = meshlet.cone_apex - params.camera_position;
+            if (glm::dot(direction, meshlet.cone_axis) > meshlet.cone_cutoff * glm::length(direction))
+                return false;
+        }
+
+        return true;
+    }
+
+    void CullMeshlets(std::span<const Meshlet> meshlets, const MeshletCullParams& params, uint8_t* visibility)
+    {
+        for (uint32_t i = 0; i < meshlets.size(); ++i)
+        {
+            visibility[i] = IsMeshletVisible(meshlets[i], params);
+        }
+    }
+
+    uint32_t AppendVisibleIndexRanges(std::span<const Meshlet> meshlets,
+                                      const uint8_t*           visibility,
+                                      std::vector<IndexRange>& ranges)
+    {
+        const size_t first_range = ranges.size();
+        for (uint32_t i = 0; i < meshlets.size(); ++i)
+        {
+            if (!visibility[i])
+                continue;
+
+            if (ranges.size() > first_range &&
+                ranges.back().first_index + ranges.back().index_count == meshlets[i].first_index)
+                ranges.back().index_count += meshlets[i].index_count;
+            else
+                ranges.push_back({meshlets[i].first_index, meshlets[i].index_count});
+        }
+
+        return static_cast<uint32_t>(ranges.size() - first_range);
+    }
+} // namespace Meow
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "core/math/frustum.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Meow
+{
+    constexpr uint32_t k_meshlet_max_vertex_count   = 64;
+    constexpr uint32_t k_meshlet_max_triangle_count = 124;
+
+    /**
+     * @brief A cluster of neighboring triangles of a mesh, with the bounds to cull it as a whole.
+     *
+     * Members are packed into 16 byte rows, so an array of meshlets has the std430 layout of the same struct in a
+     * shader and can be uploaded to a storage buffer as it is.
+     */
+    struct Meshlet
+    {
+        glm::vec3 center; // bounding sphere
+        float     radius = 0.0f;
+        glm::vec3 cone_apex;          // the triangles face away from cameras inside the cone
+        float     cone_cutoff = 1.0f; // sine of the spread of the normals, 1 if the cone never culls
+        glm::vec3 cone_axis;          // average normal
+        uint32_t  first_index  = 0;   // the triangles of a meshlet are a range of the index buffer
+        uint32_t  index_count  = 0;
+        uint32_t  vertex_count = 0;
+        uint32_t  padding[2]   = {};
+    };
+
+    /**
+     * @brief A range of an index buffer to draw, visible meshlets next to each other are merged into one.
+     */
+    struct IndexRange
+    {
+        uint32_t first_index = 0;
+        uint32_t index_count = 0;
+    };
+
+    /**
+     * @brief What the meshlets of one mesh instance are culled against, in the space of the mesh vertices.
+     */
+    struct MeshletCullParams
+    {
+        glm::vec4 planes[6];       // a point p is inside a plane if dot(plane.xyz, p) + plane.w >= 0
+        glm::vec3 camera_position; // w of the row unused, for the std430 layout
+        float     padding = 0.0f;
+    };
+
+    /**
+     * @brief Split an indexed triangle list into meshlets of at most k_meshlet_max_vertex_count vertices and
+     * k_meshlet_max_triangle_count triangles.
+     *
+     * Meshlets are grown greedily from a seed triangle, adding the neighboring triangle that brings the fewest new
+     * vertices. The triangles in indices are reordered so that each meshlet is a contiguous range of them, the winding
+     * of each triangle is kept.
+     *
+     * @param vertices Interleaved vertex data, each vertex starts with its position.
+     * @param stride Number of floats per vertex.
+     */
+    std::vector<Meshlet> BuildMeshlets(std::span<const float> vertices, uint32_t stride, std::span<uint32_t> indices);
+
+    /**
+     * @brief Transform the frustum and camera position from world space into the space of a mesh instance.
+     *
+     * Planes transformed by the transpose of the world matrix keep the distances of world space, so spheres in mesh
+     * space are tested exactly as the ellipsoids they become in world space, under any scale.
+     */
+    MeshletCullParams
+    GetMeshletCullParams(const Frustum& frustum, const glm::vec3& camera_position, const glm::mat4& world_matrix);
+
+    /**
+     * @brief Whether a meshlet may be visible: its sphere is not outside a frustum plane and its normal cone does not
+     * face away from the camera. Triangles face the side they wind counter-clockwise around.
+     */
+    bool IsMeshletVisible(const Meshlet& meshlet, const MeshletCullParams& params);
+
+    /**
+     * @brief Set visibility[i] to 1 if meshlet i may be visible, 0 if culled. Each meshlet is tested on its own, as
+     * one compute shader invocation would.
+     */
+    void CullMeshlets(std::span<const Meshlet> meshlets, const MeshletCullParams& params, uint8_t* visibility);
+
+    /**
+     * @brief Append the index ranges of the visible meshlets, merging neighbors in the index buffer.
+     *
+     * @return Number of ranges appended.
+     */
+    uint32_t AppendVisibleIndexRanges(std::span<const Meshlet> meshlets,
+                                      const uint8_t*           visibility,
+                                      std::vector<IndexRange>& ranges);
+} // namespace Meow
@@ -0,0 +1,301 @@
+#include "occlusion_buffer.h"
+
+#include "pch.h"
+
+#include "core/jobs/job_system.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef MEOW_SIMD_X86
+#    include <immintrin.h>
+#endif
+
+namespace Meow
+{
+    OcclusionBuffer::OcclusionBuffer(uint32_t width, uint32_t height)
+        : m_width(width)
+        , m_height(height)
+        , m_tile_count_x(width / k_tile_width)
+    {
+        ASSERT(width % k_tile_width == 0 && height % k_tile_height == 0);
+
+        m_depths.resize(m_width * m_height, 0.0f);
+        m_tile_depths.resize(m_tile_count_x * (m_height / k_tile_height), 0.0f);
+    }
+
+    void OcclusionBuffer::Clear(const glm::mat4& view_projection, float near_plane)
+    {
+        m_view_projection = view_projection;
+        m_near_plane      = near_plane;
+
+        std::fill(m_depths.begin(), m_depths.end(), 0.0f);
+        std::fill(m_tile_depths.begin(), m_tile_depths.end(), 0.0f);
+        m_triangles.clear();
+    }
+
+    void OcclusionBuffer::AddOccluder(std::span<const float>    vertices,
+                                      uint32_t                  stride,
+                                      std::span<const uint32_t> indices,
+                                      const glm::mat4&          model_matrix)
+    {
+        const glm::mat4 matrix       = m_view_projection * model_matrix;
+        const uint32_t  vertex_count = static_cast<uint32_t>(vertices.size() / stride);
+
+        m_screen_vertices.resize(vertex_count);
+        for (uint32_t i = 0; i < vertex_count; ++i)
+        {
+            const float* position = &vertices[static_cast<size_t>(i) * stride];
+            glm::vec4    clip     = matrix * glm::vec4(position[0], position[1], position[2], 1.0f);
+            if (clip.w < m_near_plane)
+            {
+                m_screen_vertices[i] = glm::vec3(0.0f, 0.0f, -1.0f);
+                continue;
+            }
+
+            float inverse_w      = 1.0f / clip.w;
+            m_screen_vertices[i] = glm::vec3((clip.x * inverse_w * 0.5f + 0.5f) * m_width,
+                                             (clip.y * inverse_w * 0.5f + 0.5f) * m_height,
+                                             inverse_w);
+        }
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            ScreenTriangle triangle;
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                triangle.vertices[corner] = m_screen_vertices[indices[i + corner]];
+            }
+
+            const glm::vec3& v0 = triangle.vertices[0];
+            const glm::vec3& v1 = triangle.vertices[1];
+            const glm::vec3& v2 = triangle.vertices[2];
+
+            // triangles crossing the near plane are left out instead of clipped, which only makes culling weaker
+            if (v0.z < 0.0f || v1.z < 0.0f || v2.z < 0.0f)
+                continue;
+
+            if ((v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y) == 0.0f)
+                continue;
+
+            float min_x = std::min(std::min(v0.x, v1.x), v2.x);
+            float max_x = std::max(std::max(v0.x, v1.x), v2.x);
+            float min_y = std::min(std::min(v0.y, v1.y), v2.y);
+            float max_y = std::max(std::max(v0.y, v1.y), v2.y);
+            if (max_x < 0.0f || min_x > m_width || max_y < 0.0f || min_y > m_height)
+                continue;
+
+            triangle.min_y = static_cast<int>(std::max(std::floor(min_y), 0.0f));
+            triangle.max_y = static_cast<int>(std::min(std::floor(max_y), static_cast<float>(m_height - 1)));
+            m_triangles.push_back(triangle);
+        }
+    }
+
+    void OcclusionBuffer::Rasterize(JobSystem* job_system, SimdLevel level)
+    {
+        const uint32_t tile_row_count = m_height / k_tile_height;
+
+        // rows of tiles do not share pixels, so each job writes only its own part of the buffer
+        auto rasterize_rows = [this, level](uint32_t begin, uint32_t end) {
+            for (uint32_t tile_row = begin; tile_row < end; ++tile_row)
+            {
+                RasterizeRow(tile_row, level);
+            }
+        };
+
+        if (job_system)
+            job_system->ParallelFor(0, tile_row_count, 1, rasterize_rows);
+        else
+            rasterize_rows(0, tile_row_count);
+    }
+
+    bool OcclusionBuffer::IsOccluded(const BoundingBox& box) const
+    {
+        float min_x   = std::numeric_limits<float>::max();
+        float max_x   = -std::numeric_limits<float>::max();
+        float min_y   = std::numeric_limits<float>::max();
+        float max_y   = -std::numeric_limits<float>::max();
+        float nearest = 0.0f;
+        for (uint32_t corner = 0; corner < 8; ++corner)
+        {
+            glm::vec3 position((corner & 1) ? box.max.x : box.min.x,
+                               (corner & 2) ? box.max.y : box.min.y,
+                               (corner & 4) ? box.max.z : box.min.z);
+            glm::vec4 clip = m_view_projection * glm::vec4(position, 1.0f);
+            if (clip.w < m_near_plane)
+                return false;
+
+            // w is linear in world space, so the nearest point of the box is one of its corners
+            float inverse_w = 1.0f / clip.w;
+            float x         = (clip.x * inverse_w * 0.5f + 0.5f) * m_width;
+            float y         = (clip.y * inverse_w * 0.5f + 0.5f) * m_height;
+
+            min_x   = std::min(min_x, x);
+            max_x   = std::max(max_x, x);
+            min_y   = std::min(min_y, y);
+            max_y   = std::max(max_y, y);
+            nearest = std::max(nearest, inverse_w);
+        }
+
+        // every pixel the box touches, not only those whose center it covers
+        int begin_x = static_cast<int>(std::max(std::floor(min_x), 0.0f));
+        int end_x   = static_cast<int>(std::min(std::floor(max_x), static_cast<float>(m_width - 1))) + 1;
+        int begin_y = static_cast<int>(std::max(std::floor(min_y), 0.0f));
+        int end_y   = static_cast<int>(std::min(std::floor(max_y), static_cast<float>(m_height - 1))) + 1;
+        if (begin_x >= end_x || begin_y >= end_y)
+            return false;
+
+        for (int tile_y = begin_y / k_tile_height; tile_y * k_tile_height < end_y; ++tile_y)
+        {
+            for (int tile_x = begin_x / k_tile_width; tile_x * k_tile_width < end_x; ++tile_x)
+            {
+                if (m_tile_depths[tile_y * m_tile_count_x + tile_x] > nearest)
+                    continue;
+
+                // part of the tile is not in front of the box, test the pixels the box touches
+                int x0 = std::max(begin_x, static_cast<int>(tile_x * k_tile_width));
+                int x1 = std::min(end_x, static_cast<int>((tile_x + 1) * k_tile_width));
+                int y0 = std::max(begin_y, static_cast<int>(tile_y * k_tile_height));
+                int y1 = std::min(end_y, static_cast<int>((tile_y + 1) * k_tile_height));
+                for (int y = y0; y < y1; ++y)
+                {
+                    for (int x = x0; x < x1; ++x)
+                    {
+                        if (m_depths[y * m_width + x] <= nearest)
+                            return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void OcclusionBuffer::RasterizeRow(uint32_t tile_row, SimdLevel level)
+    {
+        const int begin_y = static_cast<int>(tile_row * k_tile_height);
+        const int end_y   = begin_y + static_cast<int>(k_tile_height);
+
+        for (const ScreenTriangle& triangle : m_triangles)
+        {
+            if (triangle.max_y < begin_y || triangle.min_y >= end_y)
+                continue;
+
+            RasterizeTriangle(triangle, std::max(begin_y, triangle.min_y), std::min(end_y, triangle.max_y + 1), level);
+        }
+
+        for (uint32_t tile_x = 0; tile_x < m_tile_count_x; ++tile_x)
+        {
+            float farthest = std::numeric_limits<float>::max();
+            for (int y = begin_y; y < end_y; ++y)
+            {
+                const float* row = &m_depths[y * m_width + tile_x * k_tile_width];
+                for (uint32_t x = 0; x < k_tile_width; ++x)
+                {
+                    farthest = std::min(farthest, row[x]);
+                }
+            }
+            m_tile_depths[tile_row * m_tile_count_x + tile_x] = farthest;
+        }
+    }
+
+    void OcclusionBuffer::RasterizeTriangle(const ScreenTriangle& triangle, int begin_y, int end_y, SimdLevel level)
+    {
+        glm::vec3 v0 = triangle.vertices[0];
+        glm::vec3 v1 = triangle.vertices[1];
+        glm::vec3 v2 = triangle.vertices[2];
+
+        // counter clockwise order makes the edge functions positive inside
+        float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+        if (area < 0.0f)
+        {
+            std::swap(v1, v2);
+            area = -area;
+        }
+
+        // edge function of the edge from a to b is edge_a * x + edge_b * y + edge_c, evaluated at pixel centers
+        const glm::vec3* edge_vertices[4] = {&v0, &v1, &v2, &v0};
+        float            edge_a[3];
+        float            edge_b[3];
+        float            edge_c[3];
+        for (uint32_t edge = 0; edge < 3; ++edge)
+        {
+            const glm::vec3& a = *edge_vertices[edge];
+            const glm::vec3& b = *edge_vertices[edge + 1];
+
+            edge_a[edge] = a.y - b.y;
+            edge_b[edge] = b.x - a.x;
+            edge_c[edge] = -(edge_a[edge] * a.x + edge_b[edge] * a.y);
+        }
+
+        // 1 / w is a plane in screen space
+        float depth_dx = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+        float depth_dy = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) / area;
+        float depth_c  = v0.z - depth_dx * v0.x - depth_dy * v0.y;
+
+        float min_x   = std::min(std::min(v0.x, v1.x), v2.x);
+        float max_x   = std::max(std::max(v0.x, v1.x), v2.x);
+        int   begin_x = static_cast<int>(std::max(std::floor(min_x), 0.0f));
+        int   end_x   = static_cast<int>(std::min(std::floor(max_x), static_cast<float>(m_width - 1))) + 1;
+
+        for (int y = begin_y; y < end_y; ++y)
+        {
+            const float center_y = y + 0.5f;
+            float*      row      = &m_depths[y * m_width];
+
+            float row_c[3];
+            for (uint32_t edge = 0; edge < 3; ++edge)
+            {
+                row_c[edge] = edge_b[edge] * center_y + edge_c[edge];
+            }
+            const float row_depth_c = depth_dy * center_y + depth_c;
+
+            int x = begin_x;
+#ifdef MEOW_SIMD_X86
+            if (level >= SimdLevel::SSE2)
+            {
+                // groups of four pixels start at multiples of four, the width is a multiple of the tile width
+                const __m128 zero       = _mm_setzero_ps();
+                const __m128 lane_x     = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+                const __m128 a0         = _mm_set1_ps(edge_a[0]);
+                const __m128 a1         = _mm_set1_ps(edge_a[1]);
+                const __m128 a2         = _mm_set1_ps(edge_a[2]);
+                const __m128 c0         = _mm_set1_ps(row_c[0]);
+                const __m128 c1         = _mm_set1_ps(row_c[1]);
+                const __m128 c2         = _mm_set1_ps(row_c[2]);
+                const __m128 depth_a    = _mm_set1_ps(depth_dx);
+                const __m128 depth_base = _mm_set1_ps(row_depth_c);
+
+                for (x = begin_x & ~3; x < end_x; x += 4)
+                {
+                    __m128 center_x = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lane_x);
+                    __m128 e0       = _mm_add_ps(_mm_mul_ps(a0, center_x), c0);
+                    __m128 e1       = _mm_add_ps(_mm_mul_ps(a1, center_x), c1);
+                    __m128 e2       = _mm_add_ps(_mm_mul_ps(a2, center_x), c2);
+                    __m128 inside   = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                               _mm_cmpge_ps(e2, zero));
+                    if (!_mm_movemask_ps(inside))
+                        continue;
+
+                    __m128 depth     = _mm_add_ps(_mm_mul_ps(depth_a, center_x), depth_base);
+                    __m128 old_depth = _mm_loadu_ps(row + x);
+                    __m128 new_depth = _mm_max_ps(old_depth, depth);
+                    _mm_storeu_ps(row + x,
+                                  _mm_or_ps(_mm_and_ps(inside, new_depth), _mm_andnot_ps(inside, old_depth)));
+                }
+            }
+#endif
+
+            for (; x < end_x; ++x)
+            {
+                float center_x = x + 0.5f;
+                if (edge_a[0] * center_x + row_c[0] < 0.0f || edge_a[1] * center_x + row_c[1] < 0.0f ||
+                    edge_a[2] * center_x + row_c[2] < 0.0f)
+                    continue;
+
+                row[x] = std::max(row[x], depth_dx * center_x + row_depth_c);
+            }
+        }
+    }
+} // namespace Meow
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "core/base/non_copyable.h"
+#include "core/math/bounding_box.h"
+#include "core/math/simd.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Meow
+{
+    class JobSystem;
+
+    /**
+     * @brief Low resolution depth buffer of a few large occluders, for culling objects hidden behind them on the CPU.
+     *
+     * Occluders are transformed to screen space and rasterized into a depth buffer of 1 / w, which is linear in
+     * screen space and larger for nearer surfaces. Rows of tiles are rasterized as separate jobs, four pixels at a
+     * time with SSE2. Each tile keeps the farthest depth of its pixels, so most tests of a box against the buffer read
+     * one value per tile and only tiles partly in front of the box are tested per pixel.
+     */
+    class OcclusionBuffer : public NonCopyable
+    {
+    public:
+        static constexpr uint32_t k_tile_width  = 8;
+        static constexpr uint32_t k_tile_height = 4;
+
+        /**
+         * @param width Multiple of k_tile_width.
+         * @param height Multiple of k_tile_height.
+         */
+        explicit OcclusionBuffer(uint32_t width = 256, uint32_t height = 128);
+
+        uint32_t GetWidth() const { return m_width; }
+        uint32_t GetHeight() const { return m_height; }
+
+        /**
+         * @brief Start a frame, removing all occluders.
+         *
+         * @param view_projection Perspective projection whose clip w is the view depth.
+         * @param near_plane Triangles and boxes crossing this view depth are not rasterized or culled.
+         */
+        void Clear(const glm::mat4& view_projection, float near_plane);
+
+        /**
+         * @brief Transform the triangles of an occluder to screen space, they are rasterized by Rasterize.
+         *
+         * @param vertices Interleaved vertex data, each vertex starts with its position.
+         * @param stride Number of floats per vertex.
+         */
+        void AddOccluder(std::span<const float>    vertices,
+                         uint32_t                  stride,
+                         std::span<const uint32_t> indices,
+                         const glm::mat4&          model_matrix);
+
+        /**
+         * @brief Rasterize the occluders added since Clear, one row of tiles per job if job_system is set.
+         */
+        void Rasterize(JobSystem* job_system = nullptr, SimdLevel level = GetSimdLevel());
+
+        /**
+         * @brief True if every pixel the box covers has an occluder in front of the nearest point of the box.
+         *
+         * Boxes crossing the near plane are never occluded. May be called from several threads after Rasterize.
+         */
+        bool IsOccluded(const BoundingBox& box) const;
+
+        uint32_t GetTriangleCount() const { return static_cast<uint32_t>(m_triangles.size()); }
+
+        /**
+         * @brief 1 / w of the nearest occluder at a pixel, 0 where there is none.
+         */
+        float GetDepth(uint32_t x, uint32_t y) const { return m_depths[y * m_width + x]; }
+
+    private:
+        struct ScreenTriangle
+        {
+            glm::vec3 vertices[3]; // x and y in pixels, z is 1 / w
+            int       min_y;
+            int       max_y;
+        };
+
+        void RasterizeRow(uint32_t tile_row, SimdLevel level);
+
+        // rasterize the part of a triangle within rows [begin_y, end_y)
+        void RasterizeTriangle(const ScreenTriangle& triangle, int begin_y, int end_y, SimdLevel level);
+
+        uint32_t m_width;
+        uint32_t m_height;
+        uint32_t m_tile_count_x;
+
+        glm::mat4 m_view_projection = glm::mat4(1.0f);
+        float     m_near_plane      = 0.0f;
+
+        std::vector<float>          m_depths;      // per pixel
+        std::vector<float>          m_tile_depths; // farthest depth of the pixels of each tile
+        std::vector<ScreenTriangle> m_triangles;
+
+        // scratch space of AddOccluder, screen position of each vertex with z < 0 behind the near plane
+        std::vector<glm::vec3> m_screen_vertices;
+    };
+} // namespace Meow
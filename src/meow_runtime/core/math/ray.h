@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace Meow
+{
+    /**
+     * @brief Half line from origin along direction. Distances along a ray are in units of the direction length.
+     */
+    struct Ray
+    {
+        glm::vec3 origin;
+        glm::vec3 direction;
+
+        glm::vec3 GetPoint(float distance) const { return origin + direction * distance; }
+    };
+
+    /**
+     * @brief Distance at which a ray enters the box, 0 if it starts inside, infinity if it misses the box or enters it
+     * at or after max_distance.
+     *
+     * @param inverse_direction 1 / ray direction per component, infinite for components that are 0.
+     */
+    inline float IntersectRayBox(const glm::vec3& origin,
+                                 const glm::vec3& inverse_direction,
+                                 const glm::vec3& min,
+                                 const glm::vec3& max,
+                                 float            max_distance)
+    {
+        glm::vec3 t1 = (min - origin) * inverse_direction;
+        glm::vec3 t2 = (max - origin) * inverse_direction;
+
+        float t_near = std::max(std::max(std::min(t1.x, t2.x), std::min(t1.y, t2.y)), std::min(t1.z, t2.z));
+        float t_far  = std::min(std::min(std::max(t1.x, t2.x), std::max(t1.y, t2.y)), std::max(t1.z, t2.z));
+
+        if (t_far < t_near || t_far < 0.0f || t_near >= max_distance)
+            return std::numeric_limits<float>::infinity();
+
+        return std::max(t_near, 0.0f);
+    }
+} // namespace Meow
@@ -0,0 +1,55 @@
+#include "simd.h"
+
+#if defined(MEOW_SIMD_X86) && defined(_MSC_VER)
+#    include <immintrin.h>
+#    include <intrin.h>
+#endif
+
+namespace Meow
+{
+    namespace
+    {
+        SimdLevel DetectSimdLevel()
+        {
+#if defined(MEOW_SIMD_X86) && defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+                return SimdLevel::SSE2;
+
+            __cpuid(info, 1);
+            bool os_saves_avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+
+            __cpuidex(info, 7, 0);
+            bool has_avx2 = info[1] & (1 << 5);
+
+            return os_saves_avx && has_avx2 ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#elif defined(MEOW_SIMD_X86)
+            // also checks that the OS saves the AVX registers
+            return __builtin_cpu_supports("avx2") ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#else
+            return SimdLevel::Scalar;
+#endif
+        }
+    } // namespace
+
+    SimdLevel GetSimdLevel()
+    {
+        static const SimdLevel level = DetectSimdLevel();
+        return level;
+    }
+
+    const char* GetSimdLevelName(SimdLevel level)
+    {
+        switch (level)
+        {
+            case SimdLevel::Scalar:
+                return "Scalar";
+            case SimdLevel::SSE2:
+                return "SSE2";
+            case SimdLevel::AVX2:
+                return "AVX2";
+        }
+        return "Unknown";
+    }
+} // namespace Meow
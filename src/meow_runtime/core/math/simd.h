@@ -0,0 +1,30 @@
+#pragma once
+
+// SSE2 is part of x86-64, so it needs no detection
+#if defined(__x86_64__) || defined(_M_X64)
+#    define MEOW_SIMD_X86
+#endif
+
+// kernels for a higher instruction set than the build target are enabled per function, dispatched at runtime
+#if defined(MEOW_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#    define MEOW_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#    define MEOW_TARGET_AVX2
+#endif
+
+namespace Meow
+{
+    enum class SimdLevel : unsigned char
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    /**
+     * @brief Highest instruction set supported by both the CPU and the OS, detected once.
+     */
+    SimdLevel GetSimdLevel();
+
+    const char* GetSimdLevelName(SimdLevel level);
+} // namespace Meow
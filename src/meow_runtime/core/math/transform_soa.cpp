@@ -0,0 +1,325 @@
+#include "transform_soa.h"
+
+#ifdef MEOW_SIMD_X86
+#    include <immintrin.h>
+#endif
+
+namespace Meow
+{
+    void TransformSoA::Clear()
+    {
+        for (std::vector<float>* component : {&position_x,
+                                              &position_y,
+                                              &position_z,
+                                              &rotation_w,
+                                              &rotation_x,
+                                              &rotation_y,
+                                              &rotation_z,
+                                              &scale_x,
+                                              &scale_y,
+                                              &scale_z})
+        {
+            component->clear();
+        }
+    }
+
+    void TransformSoA::Reserve(uint32_t count)
+    {
+        for (std::vector<float>* component : {&position_x,
+                                              &position_y,
+                                              &position_z,
+                                              &rotation_w,
+                                              &rotation_x,
+                                              &rotation_y,
+                                              &rotation_z,
+                                              &scale_x,
+                                              &scale_y,
+                                              &scale_z})
+        {
+            component->reserve(count);
+        }
+    }
+
+    void TransformSoA::Push(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+    {
+        position_x.push_back(position.x);
+        position_y.push_back(position.y);
+        position_z.push_back(position.z);
+        rotation_w.push_back(rotation.w);
+        rotation_x.push_back(rotation.x);
+        rotation_y.push_back(rotation.y);
+        rotation_z.push_back(rotation.z);
+        scale_x.push_back(scale.x);
+        scale_y.push_back(scale.y);
+        scale_z.push_back(scale.z);
+    }
+
+    namespace
+    {
+        float* GetOutput(std::span<const uint32_t> output_indices, glm::mat4* outputs, uint32_t i)
+        {
+            return &outputs[output_indices.empty() ? i : output_indices[i]][0][0];
+        }
+
+        // All kernels follow Transform3DComponent::GetTransform operation by operation:
+        //
+        //   r = glm::mat3_cast(rotation)
+        //   s = glm::mat3(glm::scale(glm::mat4(1.0f), scale)), whose off diagonal entries are 0.0f * scale[column]
+        //   m = s * r, with m[j][i] = s[0][i] * r[j][0] + s[1][i] * r[j][1] + s[2][i] * r[j][2]
+        //
+        // Zeros are multiplied and added like glm does, which keeps signed zeros identical.
+
+        void ComposeScalar(const TransformSoA&       transforms,
+                           std::span<const uint32_t> output_indices,
+                           glm::mat4*                outputs,
+                           uint32_t                  begin,
+                           uint32_t                  end)
+        {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                const float qw = transforms.rotation_w[i];
+                const float qx = transforms.rotation_x[i];
+                const float qy = transforms.rotation_y[i];
+                const float qz = transforms.rotation_z[i];
+
+                const float qxx = qx * qx;
+                const float qyy = qy * qy;
+                const float qzz = qz * qz;
+                const float qxz = qx * qz;
+                const float qxy = qx * qy;
+                const float qyz = qy * qz;
+                const float qwx = qw * qx;
+                const float qwy = qw * qy;
+                const float qwz = qw * qz;
+
+                const float r[3][3] = {
+                    {1.0f - 2.0f * (qyy + qzz), 2.0f * (qxy + qwz), 2.0f * (qxz - qwy)},
+                    {2.0f * (qxy - qwz), 1.0f - 2.0f * (qxx + qzz), 2.0f * (qyz + qwx)},
+                    {2.0f * (qxz + qwy), 2.0f * (qyz - qwx), 1.0f - 2.0f * (qxx + qyy)},
+                };
+
+                const float sx = transforms.scale_x[i];
+                const float sy = transforms.scale_y[i];
+                const float sz = transforms.scale_z[i];
+                const float zx = 0.0f * sx;
+                const float zy = 0.0f * sy;
+                const float zz = 0.0f * sz;
+
+                float* output = GetOutput(output_indices, outputs, i);
+                for (uint32_t j = 0; j < 3; ++j)
+                {
+                    output[j * 4 + 0] = sx * r[j][0] + zy * r[j][1] + zz * r[j][2];
+                    output[j * 4 + 1] = zx * r[j][0] + sy * r[j][1] + zz * r[j][2];
+                    output[j * 4 + 2] = zx * r[j][0] + zy * r[j][1] + sz * r[j][2];
+                    output[j * 4 + 3] = 0.0f;
+                }
+                output[12] = transforms.position_x[i];
+                output[13] = transforms.position_y[i];
+                output[14] = transforms.position_z[i];
+                output[15] = 1.0f;
+            }
+        }
+
+#ifdef MEOW_SIMD_X86
+        uint32_t ComposeSSE2(const TransformSoA&       transforms,
+                             std::span<const uint32_t> output_indices,
+                             glm::mat4*                outputs)
+        {
+            const uint32_t count = transforms.GetCount() / 4 * 4;
+
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one  = _mm_set1_ps(1.0f);
+            const __m128 two  = _mm_set1_ps(2.0f);
+
+            for (uint32_t i = 0; i < count; i += 4)
+            {
+                const __m128 qw = _mm_loadu_ps(&transforms.rotation_w[i]);
+                const __m128 qx = _mm_loadu_ps(&transforms.rotation_x[i]);
+                const __m128 qy = _mm_loadu_ps(&transforms.rotation_y[i]);
+                const __m128 qz = _mm_loadu_ps(&transforms.rotation_z[i]);
+
+                const __m128 qxx = _mm_mul_ps(qx, qx);
+                const __m128 qyy = _mm_mul_ps(qy, qy);
+                const __m128 qzz = _mm_mul_ps(qz, qz);
+                const __m128 qxz = _mm_mul_ps(qx, qz);
+                const __m128 qxy = _mm_mul_ps(qx, qy);
+                const __m128 qyz = _mm_mul_ps(qy, qz);
+                const __m128 qwx = _mm_mul_ps(qw, qx);
+                const __m128 qwy = _mm_mul_ps(qw, qy);
+                const __m128 qwz = _mm_mul_ps(qw, qz);
+
+                const __m128 r[3][3] = {
+                    {_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(qyy, qzz))),
+                     _mm_mul_ps(two, _mm_add_ps(qxy, qwz)),
+                     _mm_mul_ps(two, _mm_sub_ps(qxz, qwy))},
+                    {_mm_mul_ps(two, _mm_sub_ps(qxy, qwz)),
+                     _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(qxx, qzz))),
+                     _mm_mul_ps(two, _mm_add_ps(qyz, qwx))},
+                    {_mm_mul_ps(two, _mm_add_ps(qxz, qwy)),
+                     _mm_mul_ps(two, _mm_sub_ps(qyz, qwx)),
+                     _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(qxx, qyy)))},
+                };
+
+                const __m128 sx = _mm_loadu_ps(&transforms.scale_x[i]);
+                const __m128 sy = _mm_loadu_ps(&transforms.scale_y[i]);
+                const __m128 sz = _mm_loadu_ps(&transforms.scale_z[i]);
+                const __m128 zx = _mm_mul_ps(zero, sx);
+                const __m128 zy = _mm_mul_ps(zero, sy);
+                const __m128 zz = _mm_mul_ps(zero, sz);
+
+                // after the transpose, columns[j][lane] is column j of the matrix of transform i + lane
+                __m128 columns[4][4];
+                for (uint32_t j = 0; j < 3; ++j)
+                {
+                    columns[j][0] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, r[j][0]), _mm_mul_ps(zy, r[j][1])),
+                                               _mm_mul_ps(zz, r[j][2]));
+                    columns[j][1] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(zx, r[j][0]), _mm_mul_ps(sy, r[j][1])),
+                                               _mm_mul_ps(zz, r[j][2]));
+                    columns[j][2] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(zx, r[j][0]), _mm_mul_ps(zy, r[j][1])),
+                                               _mm_mul_ps(sz, r[j][2]));
+                    columns[j][3] = zero;
+                }
+                columns[3][0] = _mm_loadu_ps(&transforms.position_x[i]);
+                columns[3][1] = _mm_loadu_ps(&transforms.position_y[i]);
+                columns[3][2] = _mm_loadu_ps(&transforms.position_z[i]);
+                columns[3][3] = one;
+
+                for (uint32_t j = 0; j < 4; ++j)
+                {
+                    _MM_TRANSPOSE4_PS(columns[j][0], columns[j][1], columns[j][2], columns[j][3]);
+                }
+
+                for (uint32_t lane = 0; lane < 4; ++lane)
+                {
+                    float* output = GetOutput(output_indices, outputs, i + lane);
+                    for (uint32_t j = 0; j < 4; ++j)
+                    {
+                        _mm_storeu_ps(output + j * 4, columns[j][lane]);
+                    }
+                }
+            }
+
+            return count;
+        }
+
+        MEOW_TARGET_AVX2
+        uint32_t ComposeAVX2(const TransformSoA&       transforms,
+                             std::span<const uint32_t> output_indices,
+                             glm::mat4*                outputs)
+        {
+            const uint32_t count = transforms.GetCount() / 8 * 8;
+
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one  = _mm256_set1_ps(1.0f);
+            const __m256 two  = _mm256_set1_ps(2.0f);
+
+            for (uint32_t i = 0; i < count; i += 8)
+            {
+                const __m256 qw = _mm256_loadu_ps(&transforms.rotation_w[i]);
+                const __m256 qx = _mm256_loadu_ps(&transforms.rotation_x[i]);
+                const __m256 qy = _mm256_loadu_ps(&transforms.rotation_y[i]);
+                const __m256 qz = _mm256_loadu_ps(&transforms.rotation_z[i]);
+
+                const __m256 qxx = _mm256_mul_ps(qx, qx);
+                const __m256 qyy = _mm256_mul_ps(qy, qy);
+                const __m256 qzz = _mm256_mul_ps(qz, qz);
+                const __m256 qxz = _mm256_mul_ps(qx, qz);
+                const __m256 qxy = _mm256_mul_ps(qx, qy);
+                const __m256 qyz = _mm256_mul_ps(qy, qz);
+                const __m256 qwx = _mm256_mul_ps(qw, qx);
+                const __m256 qwy = _mm256_mul_ps(qw, qy);
+                const __m256 qwz = _mm256_mul_ps(qw, qz);
+
+                const __m256 r[3][3] = {
+                    {_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(qyy, qzz))),
+                     _mm256_mul_ps(two, _mm256_add_ps(qxy, qwz)),
+                     _mm256_mul_ps(two, _mm256_sub_ps(qxz, qwy))},
+                    {_mm256_mul_ps(two, _mm256_sub_ps(qxy, qwz)),
+                     _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(qxx, qzz))),
+                     _mm256_mul_ps(two, _mm256_add_ps(qyz, qwx))},
+                    {_mm256_mul_ps(two, _mm256_add_ps(qxz, qwy)),
+                     _mm256_mul_ps(two, _mm256_sub_ps(qyz, qwx)),
+                     _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(qxx, qyy)))},
+                };
+
+                const __m256 sx = _mm256_loadu_ps(&transforms.scale_x[i]);
+                const __m256 sy = _mm256_loadu_ps(&transforms.scale_y[i]);
+                const __m256 sz = _mm256_loadu_ps(&transforms.scale_z[i]);
+                const __m256 zx = _mm256_mul_ps(zero, sx);
+                const __m256 zy = _mm256_mul_ps(zero, sy);
+                const __m256 zz = _mm256_mul_ps(zero, sz);
+
+                __m256 columns[4][4];
+                for (uint32_t j = 0; j < 3; ++j)
+                {
+                    columns[j][0] =
+                        _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, r[j][0]), _mm256_mul_ps(zy, r[j][1])),
+                                      _mm256_mul_ps(zz, r[j][2]));
+                    columns[j][1] =
+                        _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(zx, r[j][0]), _mm256_mul_ps(sy, r[j][1])),
+                                      _mm256_mul_ps(zz, r[j][2]));
+                    columns[j][2] =
+                        _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(zx, r[j][0]), _mm256_mul_ps(zy, r[j][1])),
+                                      _mm256_mul_ps(sz, r[j][2]));
+                    columns[j][3] = zero;
+                }
+                columns[3][0] = _mm256_loadu_ps(&transforms.position_x[i]);
+                columns[3][1] = _mm256_loadu_ps(&transforms.position_y[i]);
+                columns[3][2] = _mm256_loadu_ps(&transforms.position_z[i]);
+                columns[3][3] = one;
+
+                // 4x4 transposes within each 128 bit half, the low half holds lanes 0-3 and the high half lanes 4-7
+                __m128 transposed[4][8];
+                for (uint32_t j = 0; j < 4; ++j)
+                {
+                    const __m256 t0 = _mm256_unpacklo_ps(columns[j][0], columns[j][1]);
+                    const __m256 t1 = _mm256_unpackhi_ps(columns[j][0], columns[j][1]);
+                    const __m256 t2 = _mm256_unpacklo_ps(columns[j][2], columns[j][3]);
+                    const __m256 t3 = _mm256_unpackhi_ps(columns[j][2], columns[j][3]);
+
+                    const __m256 lanes[4] = {
+                        _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)),
+                        _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)),
+                        _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)),
+                        _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2)),
+                    };
+                    for (uint32_t lane = 0; lane < 4; ++lane)
+                    {
+                        transposed[j][lane]     = _mm256_castps256_ps128(lanes[lane]);
+                        transposed[j][lane + 4] = _mm256_extractf128_ps(lanes[lane], 1);
+                    }
+                }
+
+                for (uint32_t lane = 0; lane < 8; ++lane)
+                {
+                    float* output = GetOutput(output_indices, outputs, i + lane);
+                    for (uint32_t j = 0; j < 4; ++j)
+                    {
+                        _mm_storeu_ps(output + j * 4, transposed[j][lane]);
+                    }
+                }
+            }
+
+            return count;
+        }
+#endif
+    } // namespace
+
+    void ComposeTransforms(const TransformSoA&       transforms,
+                           std::span<const uint32_t> output_indices,
+                           glm::mat4*                outputs,
+                           SimdLevel                 level)
+    {
+        uint32_t composed_count = 0;
+
+#ifdef MEOW_SIMD_X86
+        if (level == SimdLevel::AVX2 && GetSimdLevel() == SimdLevel::AVX2)
+            composed_count = ComposeAVX2(transforms, output_indices, outputs);
+        else if (level != SimdLevel::Scalar)
+            composed_count = ComposeSSE2(transforms, output_indices, outputs);
+#endif
+
+        // the remainder that does not fill a whole vector
+        ComposeScalar(transforms, output_indices, outputs, composed_count, transforms.GetCount());
+    }
+} // namespace Meow
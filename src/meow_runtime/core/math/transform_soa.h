@@ -0,0 +1,51 @@
+#pragma once
+
+#include "core/math/simd.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Positions, rotations and scales in structure of arrays form, so that SIMD kernels can process one
+     * transform per lane.
+     */
+    struct TransformSoA
+    {
+        std::vector<float> position_x;
+        std::vector<float> position_y;
+        std::vector<float> position_z;
+        std::vector<float> rotation_w;
+        std::vector<float> rotation_x;
+        std::vector<float> rotation_y;
+        std::vector<float> rotation_z;
+        std::vector<float> scale_x;
+        std::vector<float> scale_y;
+        std::vector<float> scale_z;
+
+        uint32_t GetCount() const { return static_cast<uint32_t>(position_x.size()); }
+
+        void Clear();
+        void Reserve(uint32_t count);
+        void Push(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+    };
+
+    /**
+     * @brief Compose the TRS matrices of all transforms, four (SSE2) or eight (AVX2) at a time.
+     *
+     * The kernels do the same float operations in the same order as Transform3DComponent::GetTransform, so the
+     * result is bit identical to it, as long as the compiler does not contract the glm code into fused multiply-adds
+     * (it does not for the default x86-64 targets). Only the sign and payload of NaNs may differ.
+     *
+     * @param output_indices Matrix i is written to outputs[output_indices[i]]. If empty, it is written to outputs[i].
+     */
+    void ComposeTransforms(const TransformSoA&       transforms,
+                           std::span<const uint32_t> output_indices,
+                           glm::mat4*                outputs,
+                           SimdLevel                 level = GetSimdLevel());
+} // namespace Meow
@@ -0,0 +1,486 @@
+#include "triangle_bvh.h"
+
+#include "pch.h"
+
+#include "core/jobs/job_system.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <limits>
+
+#ifdef MEOW_SIMD_X86
+#    include <immintrin.h>
+#endif
+
+namespace Meow
+{
+    namespace
+    {
+        constexpr uint32_t k_bin_count = 12;
+
+        // leaves are split while they have more triangles, even if SAH would keep them
+        constexpr uint32_t k_max_leaf_size = 8;
+
+        // the traversal stack holds one node per level
+        constexpr uint32_t k_max_depth = 64;
+
+        // cost of visiting an inner node relative to testing a group of four triangles
+        constexpr float k_traversal_cost = 1.0f;
+
+        // subtrees with at least this many triangles are built as jobs
+        constexpr uint32_t k_parallel_triangle_count = 4096;
+
+        constexpr uint32_t k_no_triangle = ~0u;
+
+        // leaves are intersected four triangles at a time, so a leaf of four costs as much as a leaf of one
+        float GetIntersectionCost(uint32_t triangle_count) { return static_cast<float>((triangle_count + 3) / 4); }
+
+        float GetSurfaceArea(const glm::vec3& min, const glm::vec3& max)
+        {
+            glm::vec3 size = max - min;
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        struct Bin
+        {
+            glm::vec3 min   = glm::vec3(std::numeric_limits<float>::max());
+            glm::vec3 max   = glm::vec3(-std::numeric_limits<float>::max());
+            uint32_t  count = 0;
+        };
+
+        // SAH cost of the triangles of a bin range, relative to the area of their parent
+        float GetCost(const Bin& bin)
+        {
+            return bin.count ? GetIntersectionCost(bin.count) * GetSurfaceArea(bin.min, bin.max) : 0.0f;
+        }
+    } // namespace
+
+    struct TriangleBVH::BuildContext
+    {
+        std::vector<glm::vec3> centroids;
+        std::vector<glm::vec3> triangle_min;
+        std::vector<glm::vec3> triangle_max;
+
+        std::atomic<uint32_t> node_count {1};
+        JobSystem*            job_system = nullptr;
+    };
+
+    void TriangleBVH::Build(std::span<const float>    vertices,
+                            uint32_t                  stride,
+                            std::span<const uint32_t> indices,
+                            JobSystem*                job_system)
+    {
+        Clear();
+
+        uint32_t triangle_count = static_cast<uint32_t>(indices.size() / 3);
+        if (triangle_count == 0)
+            return;
+
+        auto get_position = [&vertices, &indices, stride](uint32_t triangle, uint32_t corner) {
+            const float* position = &vertices[static_cast<size_t>(indices[triangle * 3 + corner]) * stride];
+            return glm::vec3(position[0], position[1], position[2]);
+        };
+
+        BuildContext context;
+        context.job_system = job_system;
+        context.centroids.resize(triangle_count);
+        context.triangle_min.resize(triangle_count);
+        context.triangle_max.resize(triangle_count);
+
+        auto prepare = [&context, &get_position](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                glm::vec3 v0 = get_position(i, 0);
+                glm::vec3 v1 = get_position(i, 1);
+                glm::vec3 v2 = get_position(i, 2);
+
+                context.triangle_min[i] = glm::min(glm::min(v0, v1), v2);
+                context.triangle_max[i] = glm::max(glm::max(v0, v1), v2);
+                context.centroids[i]    = (v0 + v1 + v2) * (1.0f / 3.0f);
+            }
+        };
+
+        if (job_system)
+            job_system->ParallelFor(0, triangle_count, k_parallel_triangle_count, prepare);
+        else
+            prepare(0, triangle_count);
+
+        m_triangle_indices.resize(triangle_count);
+        for (uint32_t i = 0; i < triangle_count; ++i)
+        {
+            m_triangle_indices[i] = i;
+        }
+
+        // a binary tree with single triangle leaves is the largest possible, so nodes never move while jobs build
+        m_nodes.resize(triangle_count * 2 - 1);
+        Subdivide(context, 0, 0, triangle_count, 0);
+        m_nodes.resize(context.node_count.load());
+        m_nodes.shrink_to_fit();
+
+        for (std::vector<float>* component :
+             {&m_v0_x, &m_v0_y, &m_v0_z, &m_edge1_x, &m_edge1_y, &m_edge1_z, &m_edge2_x, &m_edge2_y, &m_edge2_z})
+        {
+            component->resize(triangle_count);
+        }
+
+        for (uint32_t i = 0; i < triangle_count; ++i)
+        {
+            uint32_t  triangle = m_triangle_indices[i];
+            glm::vec3 v0       = get_position(triangle, 0);
+            glm::vec3 edge1    = get_position(triangle, 1) - v0;
+            glm::vec3 edge2    = get_position(triangle, 2) - v0;
+
+            m_v0_x[i]    = v0.x;
+            m_v0_y[i]    = v0.y;
+            m_v0_z[i]    = v0.z;
+            m_edge1_x[i] = edge1.x;
+            m_edge1_y[i] = edge1.y;
+            m_edge1_z[i] = edge1.z;
+            m_edge2_x[i] = edge2.x;
+            m_edge2_y[i] = edge2.y;
+            m_edge2_z[i] = edge2.z;
+        }
+    }
+
+    void TriangleBVH::Clear()
+    {
+        m_nodes.clear();
+        m_triangle_indices.clear();
+        for (std::vector<float>* component :
+             {&m_v0_x, &m_v0_y, &m_v0_z, &m_edge1_x, &m_edge1_y, &m_edge1_z, &m_edge2_x, &m_edge2_y, &m_edge2_z})
+        {
+            component->clear();
+        }
+    }
+
+    void TriangleBVH::Subdivide(BuildContext& context,
+                                uint32_t      node_index,
+                                uint32_t      first,
+                                uint32_t      count,
+                                uint32_t      depth)
+    {
+        Node& node = m_nodes[node_index];
+
+        glm::vec3 centroid_min(std::numeric_limits<float>::max());
+        glm::vec3 centroid_max(-std::numeric_limits<float>::max());
+        node.min = centroid_min;
+        node.max = centroid_max;
+        for (uint32_t i = first; i < first + count; ++i)
+        {
+            uint32_t triangle = m_triangle_indices[i];
+            node.min          = glm::min(node.min, context.triangle_min[triangle]);
+            node.max          = glm::max(node.max, context.triangle_max[triangle]);
+            centroid_min      = glm::min(centroid_min, context.centroids[triangle]);
+            centroid_max      = glm::max(centroid_max, context.centroids[triangle]);
+        }
+
+        node.first = first;
+        node.count = count;
+        if (count <= 1 || depth + 1 >= k_max_depth)
+            return;
+
+        // bin the centroids along each axis and find the split plane between bins with the least SAH cost
+        float    best_cost  = std::numeric_limits<float>::max();
+        int      best_axis  = -1;
+        uint32_t best_split = 0;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float extent = centroid_max[axis] - centroid_min[axis];
+            if (extent <= 0.0f)
+                continue;
+
+            std::array<Bin, k_bin_count> bins;
+            float                        scale = k_bin_count / extent;
+            for (uint32_t i = first; i < first + count; ++i)
+            {
+                uint32_t triangle = m_triangle_indices[i];
+                uint32_t bin_index =
+                    std::min(static_cast<uint32_t>((context.centroids[triangle][axis] - centroid_min[axis]) * scale),
+                             k_bin_count - 1);
+
+                Bin& bin = bins[bin_index];
+                bin.min  = glm::min(bin.min, context.triangle_min[triangle]);
+                bin.max  = glm::max(bin.max, context.triangle_max[triangle]);
+                bin.count++;
+            }
+
+            // sweep from the left and from the right, split k puts bins below k to the left
+            std::array<float, k_bin_count> left_costs;
+            Bin                            left;
+            for (uint32_t split = 1; split < k_bin_count; ++split)
+            {
+                left.min = glm::min(left.min, bins[split - 1].min);
+                left.max = glm::max(left.max, bins[split - 1].max);
+                left.count += bins[split - 1].count;
+                left_costs[split] = GetCost(left);
+            }
+
+            Bin right;
+            for (uint32_t split = k_bin_count - 1; split > 0; --split)
+            {
+                right.min = glm::min(right.min, bins[split].min);
+                right.max = glm::max(right.max, bins[split].max);
+                right.count += bins[split].count;
+
+                float cost = left_costs[split] + GetCost(right);
+                if (cost < best_cost)
+                {
+                    best_cost  = cost;
+                    best_axis  = axis;
+                    best_split = split;
+                }
+            }
+        }
+
+        float area      = GetSurfaceArea(node.min, node.max);
+        float leaf_cost = GetIntersectionCost(count) * area;
+        if (count <= k_max_leaf_size && (best_axis < 0 || best_cost + k_traversal_cost * area >= leaf_cost))
+            return;
+
+        auto     begin = m_triangle_indices.begin() + first;
+        uint32_t mid   = first + count / 2;
+        if (best_axis >= 0)
+        {
+            float scale = k_bin_count / (centroid_max[best_axis] - centroid_min[best_axis]);
+            auto  split = std::partition(begin, begin + count, [&](uint32_t triangle) {
+                uint32_t bin_index = std::min(
+                    static_cast<uint32_t>((context.centroids[triangle][best_axis] - centroid_min[best_axis]) * scale),
+                    k_bin_count - 1);
+                return bin_index < best_split;
+            });
+            mid = static_cast<uint32_t>(split - m_triangle_indices.begin());
+        }
+
+        // all centroids in one bin, split in the middle of the range
+        if (mid == first || mid == first + count)
+            mid = first + count / 2;
+
+        uint32_t children = context.node_count.fetch_add(2);
+        node.first        = children;
+        node.count        = 0;
+
+        uint32_t left_count  = mid - first;
+        uint32_t right_count = count - left_count;
+        if (context.job_system && count >= k_parallel_triangle_count)
+        {
+            JobCounter counter;
+            context.job_system->Schedule(
+                [this, &context, children, first, left_count, depth]() {
+                    Subdivide(context, children, first, left_count, depth + 1);
+                },
+                &counter);
+            Subdivide(context, children + 1, mid, right_count, depth + 1);
+            context.job_system->Wait(counter);
+        }
+        else
+        {
+            Subdivide(context, children, first, left_count, depth + 1);
+            Subdivide(context, children + 1, mid, right_count, depth + 1);
+        }
+    }
+
+    bool TriangleBVH::Raycast(const Ray& ray, float max_distance, Hit& hit, SimdLevel level) const
+    {
+        if (IsEmpty())
+            return false;
+
+        const glm::vec3 inverse_direction = 1.0f / ray.direction;
+
+        if (IntersectRayBox(ray.origin, inverse_direction, m_nodes[0].min, m_nodes[0].max, max_distance) ==
+            std::numeric_limits<float>::infinity())
+            return false;
+
+        // nodes still to visit with the distance their box is entered at
+        std::array<std::pair<uint32_t, float>, k_max_depth> stack;
+        uint32_t                                            stack_size = 0;
+
+        float    closest = max_distance;
+        uint32_t hit_at  = k_no_triangle;
+        uint32_t index   = 0;
+
+        auto get_distance = [&](uint32_t child) {
+            return IntersectRayBox(ray.origin, inverse_direction, m_nodes[child].min, m_nodes[child].max, closest);
+        };
+
+        while (true)
+        {
+            const Node& node = m_nodes[index];
+            if (node.count)
+            {
+                uint32_t leaf_hit_at;
+#ifdef MEOW_SIMD_X86
+                if (level >= SimdLevel::SSE2)
+                    leaf_hit_at = IntersectLeafSSE2(ray, node.first, node.count, closest);
+                else
+#endif
+                    leaf_hit_at = IntersectLeaf(ray, node.first, node.count, closest);
+
+                if (leaf_hit_at != k_no_triangle)
+                    hit_at = leaf_hit_at;
+            }
+            else
+            {
+                // descend into the nearer child first, its hits let the farther one be skipped
+                uint32_t near_index    = node.first;
+                uint32_t far_index     = node.first + 1;
+                float    near_distance = get_distance(near_index);
+                float    far_distance  = get_distance(far_index);
+                if (far_distance < near_distance)
+                {
+                    std::swap(near_index, far_index);
+                    std::swap(near_distance, far_distance);
+                }
+
+                if (near_distance != std::numeric_limits<float>::infinity())
+                {
+                    if (far_distance != std::numeric_limits<float>::infinity())
+                        stack[stack_size++] = {far_index, far_distance};
+
+                    index = near_index;
+                    continue;
+                }
+            }
+
+            // pop the next node that is still entered before the closest hit
+            while (stack_size && stack[stack_size - 1].second >= closest)
+            {
+                stack_size--;
+            }
+            if (!stack_size)
+                break;
+
+            index = stack[--stack_size].first;
+        }
+
+        if (hit_at == k_no_triangle)
+            return false;
+
+        hit.distance       = closest;
+        hit.triangle_index = m_triangle_indices[hit_at];
+        hit.normal         = glm::cross(glm::vec3(m_edge1_x[hit_at], m_edge1_y[hit_at], m_edge1_z[hit_at]),
+                                glm::vec3(m_edge2_x[hit_at], m_edge2_y[hit_at], m_edge2_z[hit_at]));
+        return true;
+    }
+
+    uint32_t TriangleBVH::IntersectLeaf(const Ray& ray, uint32_t first, uint32_t count, float& closest) const
+    {
+        // Moller-Trumbore, without culling back faces
+        uint32_t hit_at = k_no_triangle;
+        for (uint32_t i = first; i < first + count; ++i)
+        {
+            glm::vec3 edge1(m_edge1_x[i], m_edge1_y[i], m_edge1_z[i]);
+            glm::vec3 edge2(m_edge2_x[i], m_edge2_y[i], m_edge2_z[i]);
+
+            glm::vec3 p           = glm::cross(ray.direction, edge2);
+            float     determinant = glm::dot(edge1, p);
+            if (determinant == 0.0f)
+                continue;
+
+            float     inverse_determinant = 1.0f / determinant;
+            glm::vec3 s                   = ray.origin - glm::vec3(m_v0_x[i], m_v0_y[i], m_v0_z[i]);
+            float     u                   = glm::dot(s, p) * inverse_determinant;
+            if (u < 0.0f || u > 1.0f)
+                continue;
+
+            glm::vec3 q = glm::cross(s, edge1);
+            float     v = glm::dot(ray.direction, q) * inverse_determinant;
+            if (v < 0.0f || u + v > 1.0f)
+                continue;
+
+            float t = glm::dot(edge2, q) * inverse_determinant;
+            if (t > 0.0f && t < closest)
+            {
+                closest = t;
+                hit_at  = i;
+            }
+        }
+
+        return hit_at;
+    }
+
+#ifdef MEOW_SIMD_X86
+    uint32_t TriangleBVH::IntersectLeafSSE2(const Ray& ray, uint32_t first, uint32_t count, float& closest) const
+    {
+        const __m128 zero        = _mm_setzero_ps();
+        const __m128 one         = _mm_set1_ps(1.0f);
+        const __m128 origin_x    = _mm_set1_ps(ray.origin.x);
+        const __m128 origin_y    = _mm_set1_ps(ray.origin.y);
+        const __m128 origin_z    = _mm_set1_ps(ray.origin.z);
+        const __m128 direction_x = _mm_set1_ps(ray.direction.x);
+        const __m128 direction_y = _mm_set1_ps(ray.direction.y);
+        const __m128 direction_z = _mm_set1_ps(ray.direction.z);
+
+        auto dot = [](__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz) {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_mul_ps(az, bz));
+        };
+
+        uint32_t hit_at = k_no_triangle;
+        uint32_t end    = first + count;
+        uint32_t i      = first;
+        for (; i + 4 <= end; i += 4)
+        {
+            const __m128 edge1_x = _mm_loadu_ps(&m_edge1_x[i]);
+            const __m128 edge1_y = _mm_loadu_ps(&m_edge1_y[i]);
+            const __m128 edge1_z = _mm_loadu_ps(&m_edge1_z[i]);
+            const __m128 edge2_x = _mm_loadu_ps(&m_edge2_x[i]);
+            const __m128 edge2_y = _mm_loadu_ps(&m_edge2_y[i]);
+            const __m128 edge2_z = _mm_loadu_ps(&m_edge2_z[i]);
+
+            // p = direction x edge2
+            __m128 p_x = _mm_sub_ps(_mm_mul_ps(direction_y, edge2_z), _mm_mul_ps(direction_z, edge2_y));
+            __m128 p_y = _mm_sub_ps(_mm_mul_ps(direction_z, edge2_x), _mm_mul_ps(direction_x, edge2_z));
+            __m128 p_z = _mm_sub_ps(_mm_mul_ps(direction_x, edge2_y), _mm_mul_ps(direction_y, edge2_x));
+
+            __m128 determinant         = dot(edge1_x, edge1_y, edge1_z, p_x, p_y, p_z);
+            __m128 inverse_determinant = _mm_div_ps(one, determinant);
+
+            __m128 s_x = _mm_sub_ps(origin_x, _mm_loadu_ps(&m_v0_x[i]));
+            __m128 s_y = _mm_sub_ps(origin_y, _mm_loadu_ps(&m_v0_y[i]));
+            __m128 s_z = _mm_sub_ps(origin_z, _mm_loadu_ps(&m_v0_z[i]));
+            __m128 u   = _mm_mul_ps(dot(s_x, s_y, s_z, p_x, p_y, p_z), inverse_determinant);
+
+            // q = s x edge1
+            __m128 q_x = _mm_sub_ps(_mm_mul_ps(s_y, edge1_z), _mm_mul_ps(s_z, edge1_y));
+            __m128 q_y = _mm_sub_ps(_mm_mul_ps(s_z, edge1_x), _mm_mul_ps(s_x, edge1_z));
+            __m128 q_z = _mm_sub_ps(_mm_mul_ps(s_x, edge1_y), _mm_mul_ps(s_y, edge1_x));
+            __m128 v   = _mm_mul_ps(dot(direction_x, direction_y, direction_z, q_x, q_y, q_z), inverse_determinant);
+            __m128 t   = _mm_mul_ps(dot(edge2_x, edge2_y, edge2_z, q_x, q_y, q_z), inverse_determinant);
+
+            // comparisons with NaN are false, which rejects lanes with a zero determinant
+            __m128 mask = _mm_cmpneq_ps(determinant, zero);
+            mask        = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+            mask        = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+            mask        = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), one));
+            mask        = _mm_and_ps(mask, _mm_cmpgt_ps(t, zero));
+            mask        = _mm_and_ps(mask, _mm_cmplt_ps(t, _mm_set1_ps(closest)));
+
+            uint32_t lanes = _mm_movemask_ps(mask);
+            if (!lanes)
+                continue;
+
+            alignas(16) float distances[4];
+            _mm_store_ps(distances, t);
+            for (; lanes; lanes &= lanes - 1)
+            {
+                uint32_t lane = std::countr_zero(lanes);
+                if (distances[lane] < closest)
+                {
+                    closest = distances[lane];
+                    hit_at  = i + lane;
+                }
+            }
+        }
+
+        if (i < end)
+        {
+            uint32_t tail_hit_at = IntersectLeaf(ray, i, end - i, closest);
+            if (tail_hit_at != k_no_triangle)
+                hit_at = tail_hit_at;
+        }
+
+        return hit_at;
+    }
+#endif
+} // namespace Meow
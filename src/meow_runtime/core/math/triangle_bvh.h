@@ -0,0 +1,96 @@
+#pragma once
+
+#include "core/math/bounding_box.h"
+#include "core/math/ray.h"
+#include "core/math/simd.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Meow
+{
+    class JobSystem;
+
+    /**
+     * @brief Bounding volume hierarchy over the triangles of a mesh, for ray casts and picking.
+     *
+     * Built top down with binned SAH splits, subtrees above a size threshold are built as jobs. Nodes are 32 bytes
+     * with the children of an inner node next to each other. Triangles are reordered to the leaf order and stored as
+     * a vertex and two edges in structure of arrays form, so a leaf is intersected four triangles at a time.
+     */
+    class TriangleBVH
+    {
+    public:
+        struct Hit
+        {
+            float     distance       = 0.0f;
+            uint32_t  triangle_index = 0; // index of the triangle in the index buffer the tree was built from
+            glm::vec3 normal;             // geometric normal, not normalized, in the space of the vertices
+        };
+
+        /**
+         * @brief Build from an indexed triangle list.
+         *
+         * @param vertices Interleaved vertex data, each vertex starts with its position.
+         * @param stride Number of floats per vertex.
+         * @param job_system Builds large subtrees in parallel, may be nullptr.
+         */
+        void Build(std::span<const float>    vertices,
+                   uint32_t                  stride,
+                   std::span<const uint32_t> indices,
+                   JobSystem*                job_system = nullptr);
+
+        void Clear();
+
+        bool IsEmpty() const { return m_nodes.empty(); }
+
+        uint32_t GetNodeCount() const { return static_cast<uint32_t>(m_nodes.size()); }
+        uint32_t GetTriangleCount() const { return static_cast<uint32_t>(m_triangle_indices.size()); }
+
+        BoundingBox GetBounds() const
+        {
+            return IsEmpty() ? BoundingBox() : BoundingBox(m_nodes[0].min, m_nodes[0].max);
+        }
+
+        /**
+         * @brief Closest triangle the ray hits before max_distance, front and back faces alike.
+         */
+        bool Raycast(const Ray& ray, float max_distance, Hit& hit, SimdLevel level = GetSimdLevel()) const;
+
+    private:
+        struct Node
+        {
+            glm::vec3 min;
+            uint32_t  first; // first triangle of a leaf, first child of an inner node
+            glm::vec3 max;
+            uint32_t  count; // triangles of a leaf, 0 for an inner node
+        };
+
+        struct BuildContext;
+
+        void Subdivide(BuildContext& context, uint32_t node_index, uint32_t first, uint32_t count, uint32_t depth);
+
+        // intersect the triangles of a leaf, shrinking closest on a hit, returns the hit triangle or ~0u
+        uint32_t IntersectLeaf(const Ray& ray, uint32_t first, uint32_t count, float& closest) const;
+#ifdef MEOW_SIMD_X86
+        uint32_t IntersectLeafSSE2(const Ray& ray, uint32_t first, uint32_t count, float& closest) const;
+#endif
+
+        std::vector<Node> m_nodes;
+
+        // per triangle in leaf order
+        std::vector<float>    m_v0_x;
+        std::vector<float>    m_v0_y;
+        std::vector<float>    m_v0_z;
+        std::vector<float>    m_edge1_x;
+        std::vector<float>    m_edge1_y;
+        std::vector<float>    m_edge1_z;
+        std::vector<float>    m_edge2_x;
+        std::vector<float>    m_edge2_y;
+        std::vector<float>    m_edge2_z;
+        std::vector<uint32_t> m_triangle_indices;
+    };
+} // namespace Meow
@@ -0,0 +1,137 @@
+#include "pool_allocator.h"
+
+#include "pch.h"
+
+#include "core/base/alignment.h"
+
+#include <algorithm>
+
+namespace Meow
+{
+    PoolAllocator::PoolAllocator(std::string name,
+                                 std::size_t block_size,
+                                 std::size_t block_alignment,
+                                 std::size_t blocks_per_page)
+        : m_name(std::move(name))
+        , m_block_size(block_size)
+        , m_block_alignment(std::max(block_alignment, alignof(FreeBlock)))
+        , m_blocks_per_page(std::max<std::size_t>(blocks_per_page, 1))
+    {
+        if (m_block_size != 0)
+            m_block_size = Align(std::max(m_block_size, sizeof(FreeBlock)), m_block_alignment);
+
+        PoolAllocatorRegistry::Get().Register(this);
+    }
+
+    PoolAllocator::~PoolAllocator()
+    {
+        PoolAllocatorRegistry::Get().Unregister(this);
+
+#ifdef MEOW_DEBUG
+        if (m_used_blocks != 0)
+            MEOW_ERROR("Pool {} is destroyed with {} blocks in use!", m_name, m_used_blocks);
+#endif
+
+        for (std::byte* page : m_pages)
+        {
+            ::operator delete(page, std::align_val_t {m_block_alignment});
+        }
+    }
+
+    void* PoolAllocator::Allocate(std::size_t size, std::size_t alignment)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_block_size == 0)
+            m_block_size = Align(std::max(size, sizeof(FreeBlock)), m_block_alignment);
+
+        if (size > m_block_size || alignment > m_block_alignment)
+            return nullptr;
+
+        if (!m_free_list)
+            AllocatePage();
+
+        FreeBlock* block = m_free_list;
+        m_free_list      = block->next;
+
+        m_used_blocks++;
+        m_peak_blocks = std::max(m_peak_blocks, m_used_blocks);
+
+        return block;
+    }
+
+    void PoolAllocator::Deallocate(void* ptr)
+    {
+        if (!ptr)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->next      = m_free_list;
+        m_free_list      = block;
+
+        m_used_blocks--;
+    }
+
+    bool PoolAllocator::Fits(std::size_t size, std::size_t alignment) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return size <= m_block_size && alignment <= m_block_alignment;
+    }
+
+    PoolStat PoolAllocator::GetStat() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        PoolStat stat;
+        stat.name            = m_name;
+        stat.block_size      = m_block_size;
+        stat.used_blocks     = m_used_blocks;
+        stat.peak_blocks     = m_peak_blocks;
+        stat.capacity_blocks = m_pages.size() * m_blocks_per_page;
+        stat.allocated_bytes = stat.capacity_blocks * m_block_size;
+        return stat;
+    }
+
+    void PoolAllocator::AllocatePage()
+    {
+        std::byte* page = static_cast<std::byte*>(
+            ::operator new(m_block_size * m_blocks_per_page, std::align_val_t {m_block_alignment}));
+        m_pages.push_back(page);
+
+        // thread the new blocks in address order, so that a fresh page is handed out sequentially
+        for (std::size_t i = m_blocks_per_page; i > 0; --i)
+        {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(page + (i - 1) * m_block_size);
+            block->next      = m_free_list;
+            m_free_list      = block;
+        }
+    }
+
+    void PoolAllocatorRegistry::Register(const PoolAllocator* pool)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pools.push_back(pool);
+    }
+
+    void PoolAllocatorRegistry::Unregister(const PoolAllocator* pool)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::erase(m_pools, pool);
+    }
+
+    std::vector<PoolStat> PoolAllocatorRegistry::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::vector<PoolStat> stats;
+        stats.reserve(m_pools.size());
+        for (const PoolAllocator* pool : m_pools)
+        {
+            stats.push_back(pool->GetStat());
+        }
+        return stats;
+    }
+} // namespace Meow
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "core/base/non_copyable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Usage of one pool, reported to the profiler.
+     */
+    struct PoolStat
+    {
+        std::string name;
+        std::size_t block_size      = 0;
+        std::size_t used_blocks     = 0;
+        std::size_t peak_blocks     = 0;
+        std::size_t capacity_blocks = 0;
+        std::size_t allocated_bytes = 0;
+    };
+
+    /**
+     * @brief Fixed size block allocator.
+     *
+     * Blocks are carved from pages of blocks_per_page blocks and recycled through an intrusive free list, so spawn and
+     * despawn churn of one type neither fragments the heap nor goes through malloc. Pages are only released when the
+     * pool is destroyed. Allocate and Deallocate may be called from any thread.
+     *
+     * A block size of 0 is fixed by the first allocation, for types whose size is not known up front like the control
+     * block of std::allocate_shared.
+     */
+    class PoolAllocator : public NonCopyable
+    {
+    public:
+        PoolAllocator(std::string name,
+                      std::size_t block_size      = 0,
+                      std::size_t block_alignment = alignof(std::max_align_t),
+                      std::size_t blocks_per_page = 256);
+
+        ~PoolAllocator() override;
+
+        /**
+         * @return nullptr if size or alignment do not fit the blocks of this pool.
+         */
+        void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+        void Deallocate(void* ptr);
+
+        /**
+         * @brief Whether Allocate serves size and alignment, stable once the block size is fixed.
+         */
+        bool Fits(std::size_t size, std::size_t alignment) const;
+
+        PoolStat GetStat() const;
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        void AllocatePage();
+
+        std::string m_name;
+        std::size_t m_block_size;
+        std::size_t m_block_alignment;
+        std::size_t m_blocks_per_page;
+
+        mutable std::mutex      m_mutex;
+        FreeBlock*              m_free_list = nullptr;
+        std::vector<std::byte*> m_pages;
+        std::size_t             m_used_blocks = 0;
+        std::size_t             m_peak_blocks = 0;
+    };
+
+    /**
+     * @brief All living pools, so that the profiler can show their usage.
+     */
+    class PoolAllocatorRegistry
+    {
+    public:
+        PoolAllocatorRegistry(const PoolAllocatorRegistry&) = delete;
+        PoolAllocatorRegistry(PoolAllocatorRegistry&&)      = delete;
+
+        static PoolAllocatorRegistry& Get()
+        {
+            static PoolAllocatorRegistry instance;
+            return instance;
+        }
+
+        void Register(const PoolAllocator* pool);
+        void Unregister(const PoolAllocator* pool);
+
+        std::vector<PoolStat> GetStats() const;
+
+    private:
+        PoolAllocatorRegistry() {}
+
+        mutable std::mutex                m_mutex;
+        std::vector<const PoolAllocator*> m_pools;
+    };
+
+    /**
+     * @brief Pool shared by all objects of type T, which is never destroyed, so objects may be released during static
+     * destruction.
+     */
+    template<typename T>
+    PoolAllocator& GetTypePool(const char* name)
+    {
+        static PoolAllocator* pool = new PoolAllocator(name);
+        return *pool;
+    }
+
+    /**
+     * @brief Standard allocator on top of a pool, for std::allocate_shared and containers of single elements.
+     *
+     * Requests the pool does not fit, like arrays, fall back to the global heap.
+     */
+    template<typename T>
+    class PoolStdAllocator
+    {
+    public:
+        using value_type = T;
+
+        explicit PoolStdAllocator(PoolAllocator& pool)
+            : m_pool(&pool)
+        {}
+
+        template<typename U>
+        PoolStdAllocator(const PoolStdAllocator<U>& other)
+            : m_pool(other.GetPool())
+        {}
+
+        T* allocate(std::size_t n)
+        {
+            if (n == 1)
+            {
+                if (void* ptr = m_pool->Allocate(sizeof(T), alignof(T)))
+                    return static_cast<T*>(ptr);
+            }
+
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t {alignof(T)}));
+        }
+
+        void deallocate(T* ptr, std::size_t n)
+        {
+            if (n == 1 && m_pool->Fits(sizeof(T), alignof(T)))
+                m_pool->Deallocate(ptr);
+            else
+                ::operator delete(ptr, std::align_val_t {alignof(T)});
+        }
+
+        PoolAllocator* GetPool() const { return m_pool; }
+
+        template<typename U>
+        bool operator==(const PoolStdAllocator<U>& other) const
+        {
+            return m_pool == other.GetPool();
+        }
+
+    private:
+        PoolAllocator* m_pool;
+    };
+} // namespace Meow
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <string>
 #include <thread>
 
@@ -14,5 +15,6 @@ namespace Meow
         std::chrono::microseconds duration;
         int                       depth;
         std::thread::id           thread_id;
+        uint32_t                  item_count = 0; // objects processed in the scope, 0 if not counted
     };
 } // namespace Meow
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "scope_time_data.h"
 
+#include <atomic>
+#include <mutex>
 #include <vector>
 
 namespace Meow
@@ -21,12 +23,17 @@ namespace Meow
         void Push()
         {
             m_curr_depth++;
-            if (m_curr_depth > m_max_depth)
-                m_max_depth = m_curr_depth;
+
+            int max_depth = m_max_depth.load(std::memory_order_relaxed);
+            while (m_curr_depth > max_depth && !m_max_depth.compare_exchange_weak(max_depth, m_curr_depth))
+            {}
         }
 
         void Pop() { m_curr_depth--; }
 
+        /**
+         * @brief Depth of the calling thread, scopes running in jobs are nested per thread.
+         */
         int GetCurrDepth() const { return m_curr_depth; }
 
         int GetMaxDepth() const { return m_max_depth; }
@@ -35,6 +42,8 @@ namespace Meow
 
         void Upload(ScopeTimeData scope_time)
         {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
             if (m_scope_times.size() == 0)
                 m_global_start = scope_time.start;
             else
@@ -45,18 +54,24 @@ namespace Meow
 
         const std::vector<ScopeTimeData>& GetScopeTimes() { return m_scope_times; }
 
+        /**
+         * @brief Only call while no scope is open on any thread, which is between two frames.
+         */
         void Clear()
         {
-            m_curr_depth = -1;
-            m_max_depth  = -1;
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_max_depth = -1;
             m_scope_times.clear();
         }
 
     private:
         TimerSingleton() {}
 
-        int m_curr_depth = -1;
-        int m_max_depth  = -1;
+        inline static thread_local int m_curr_depth = -1;
+
+        std::atomic<int> m_max_depth = -1;
+        std::mutex       m_mutex;
 
         std::chrono::microseconds m_global_start;
 
@@ -103,18 +118,25 @@ namespace Meow
                                           high_res_start,
                                           elapsed_time,
                                           TimerSingleton::Get().GetCurrDepth(),
-                                          std::this_thread::get_id()});
+                                          std::this_thread::get_id(),
+                                          m_item_count});
 
             m_stopped = true;
 
             TimerSingleton::Get().Pop();
         }
 
+        /**
+         * @brief Number of objects processed in the scope, so that the flame graph can show the time per object.
+         */
+        void SetItemCount(uint32_t item_count) { m_item_count = item_count; }
+
     private:
         std::string                                        m_name;
         std::string                                        m_filename;
         std::chrono::time_point<std::chrono::steady_clock> m_start_timepoint;
         bool                                               m_stopped;
+        uint32_t                                           m_item_count = 0;
 
         inline static const std::string cdel_str = "__cdecl ";
     };
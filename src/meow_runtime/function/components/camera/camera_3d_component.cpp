@@ -5,104 +5,129 @@
 #include "function/global/runtime_context.h"
 #include "function/object/game_object.h"
 
+#include <glm/gtc/matrix_transform.hpp>
+
 namespace Meow
 {
     void Camera3DComponent::Start()
     {
         if (!m_parent_object.lock())
             MEOW_INFO("Not Found!");
-        m_transform = m_parent_object.lock()->TryGetComponent<Transform3DComponent>("Transform3DComponent");
     }
 
     void Camera3DComponent::Tick(float dt)
     {
-        auto transfrom_shared_ptr = m_transform.lock();
+        // components are relocated on structural changes, so the transform is not cached
+        Transform3DComponent* transform_comp_ptr = m_parent_object.lock()->GetComponent<Transform3DComponent>();
+        if (!transform_comp_ptr)
+            return;
 
-        m_frustum.updatePlanes(transfrom_shared_ptr->position,
-                               transfrom_shared_ptr->rotation,
+        m_frustum.updatePlanes(transform_comp_ptr->position,
+                               transform_comp_ptr->rotation,
                                field_of_view,
                                aspect_ratio,
                                near_plane,
                                far_plane);
 
+        glm::vec3 forward = transform_comp_ptr->rotation * glm::vec3(0.0f, 0.0f, 1.0f);
+        glm::mat4 view    = glm::lookAt(
+            transform_comp_ptr->position, transform_comp_ptr->position + forward, glm::vec3(0.0f, 1.0f, 0.0f));
+        m_view_projection = Math::perspective_vk(field_of_view, aspect_ratio, near_plane, far_plane) * view;
+
         if (camera_mode == CameraMode::Free)
         {
-            TickFreeCamera(dt);
+            TickFreeCamera(dt, *transform_comp_ptr);
         }
     }
 
-    bool Camera3DComponent::FrustumCulling(std::shared_ptr<GameObject> gameobject)
+    bool Camera3DComponent::FrustumCulling(const GameObject& gameobject)
     {
-        auto transform_shared_ptr = gameobject->TryGetComponent<Transform3DComponent>("Transform3DComponent");
-        if (!transform_shared_ptr)
+        BoundingBox bounding;
+        if (!GetWorldBounding(gameobject, bounding))
             return false;
 
-        auto model_shared_ptr = gameobject->TryGetComponent<ModelComponent>("ModelComponent");
-        if (!model_shared_ptr)
+        return CheckVisibility(&bounding);
+    }
+
+    bool Camera3DComponent::GetWorldBounding(const GameObject& gameobject, BoundingBox& bounding)
+    {
+        Transform3DComponent* transform_comp_ptr = gameobject.GetComponent<Transform3DComponent>();
+        if (!transform_comp_ptr)
             return false;
 
-        auto bounding = model_shared_ptr->model_ptr.lock()->GetBounding();
-        bounding.min  = bounding.min * transform_shared_ptr->scale + transform_shared_ptr->position;
-        bounding.max  = bounding.max * transform_shared_ptr->scale + transform_shared_ptr->position;
+        // cached by the transform hierarchy of the level
+        if (transform_comp_ptr->GetWorldBounds(bounding))
+            return true;
 
-        return CheckVisibility(&bounding);
+        ModelComponent* model_comp_ptr = gameobject.GetComponent<ModelComponent>();
+        if (!model_comp_ptr)
+            return false;
+
+        std::shared_ptr<Model> model = model_comp_ptr->model_ptr.lock();
+        if (!model)
+            return false;
+
+        bounding = model->GetBounding().Transformed(transform_comp_ptr->GetWorldTransform());
+        return true;
     }
 
     bool Camera3DComponent::CheckVisibility(BoundingBox* bounding) { return m_frustum.checkIfInside(bounding); }
 
-    void Camera3DComponent::TickFreeCamera(float dt)
+    void Camera3DComponent::TickFreeCamera(float dt, Transform3DComponent& transform_component)
     {
-        if (std::shared_ptr<Transform3DComponent> transform_component = m_transform.lock())
+        if (g_runtime_context.input_system->GetButton("RightMouse")->GetAction() == InputAction::Press)
+        {
+            float dx = g_runtime_context.input_system->GetAxis("MouseX")->GetAmount();
+            float dy = g_runtime_context.input_system->GetAxis("MouseY")->GetAmount();
+
+            glm::vec3 temp_right = transform_component.rotation * glm::vec3(1.0f, 0.0f, 0.0f);
+
+            // TODO: config camera rotate velocity
+            glm::quat dyaw   = Math::QuaternionFromAngleAxis(-dx * dt * 100.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+            glm::quat dpitch = Math::QuaternionFromAngleAxis(-dy * dt * 100.0f, temp_right);
+
+            transform_component.rotation = dyaw * dpitch * transform_component.rotation;
+            transform_component.MarkDirty();
+        }
+
+        glm::vec3 right   = transform_component.rotation * glm::vec3(1.0f, 0.0f, 0.0f);
+        glm::vec3 forward = transform_component.rotation * glm::vec3(0.0f, 0.0f, 1.0f);
+        glm::vec3 up      = glm::vec3(0.0f, 1.0f, 0.0f);
+
+        glm::vec3 movement = glm::vec3(0.0f);
+
+        if (g_runtime_context.input_system->GetButton("Left")->GetAction() == InputAction::Press)
+        {
+            movement += -right;
+        }
+        if (g_runtime_context.input_system->GetButton("Right")->GetAction() == InputAction::Press)
+        {
+            movement += right;
+        }
+        if (g_runtime_context.input_system->GetButton("Forward")->GetAction() == InputAction::Press)
+        {
+            movement += forward;
+        }
+        if (g_runtime_context.input_system->GetButton("Backward")->GetAction() == InputAction::Press)
+        {
+            movement += -forward;
+        }
+        if (g_runtime_context.input_system->GetButton("Up")->GetAction() == InputAction::Press)
+        {
+            movement += up;
+        }
+        if (g_runtime_context.input_system->GetButton("Down")->GetAction() == InputAction::Press)
+        {
+            movement += -up;
+        }
+
+        // TODO: config camera move velocity
+        movement *= dt * 20.0f;
+
+        if (movement != glm::vec3(0.0f))
         {
-            if (g_runtime_context.input_system->GetButton("RightMouse")->GetAction() == InputAction::Press)
-            {
-                float dx = g_runtime_context.input_system->GetAxis("MouseX")->GetAmount();
-                float dy = g_runtime_context.input_system->GetAxis("MouseY")->GetAmount();
-
-                glm::vec3 temp_right = transform_component->rotation * glm::vec3(1.0f, 0.0f, 0.0f);
-
-                // TODO: config camera rotate velocity
-                glm::quat dyaw   = Math::QuaternionFromAngleAxis(-dx * dt * 100.0f, glm::vec3(0.0f, 1.0f, 0.0f));
-                glm::quat dpitch = Math::QuaternionFromAngleAxis(-dy * dt * 100.0f, temp_right);
-
-                transform_component->rotation = dyaw * dpitch * transform_component->rotation;
-            }
-
-            glm::vec3 right   = transform_component->rotation * glm::vec3(1.0f, 0.0f, 0.0f);
-            glm::vec3 forward = transform_component->rotation * glm::vec3(0.0f, 0.0f, 1.0f);
-            glm::vec3 up      = glm::vec3(0.0f, 1.0f, 0.0f);
-
-            glm::vec3 movement = glm::vec3(0.0f);
-
-            if (g_runtime_context.input_system->GetButton("Left")->GetAction() == InputAction::Press)
-            {
-                movement += -right;
-            }
-            if (g_runtime_context.input_system->GetButton("Right")->GetAction() == InputAction::Press)
-            {
-                movement += right;
-            }
-            if (g_runtime_context.input_system->GetButton("Forward")->GetAction() == InputAction::Press)
-            {
-                movement += forward;
-            }
-            if (g_runtime_context.input_system->GetButton("Backward")->GetAction() == InputAction::Press)
-            {
-                movement += -forward;
-            }
-            if (g_runtime_context.input_system->GetButton("Up")->GetAction() == InputAction::Press)
-            {
-                movement += up;
-            }
-            if (g_runtime_context.input_system->GetButton("Down")->GetAction() == InputAction::Press)
-            {
-                movement += -up;
-            }
-
-            // TODO: config camera move velocity
-            movement *= dt * 20.0f;
-
-            transform_component->position += movement;
+            transform_component.position += movement;
+            transform_component.MarkDirty();
         }
     }
 } // namespace Meow
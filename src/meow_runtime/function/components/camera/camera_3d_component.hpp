@@ -39,14 +39,29 @@ namespace Meow
 
         void Tick(float dt) override;
 
-        bool FrustumCulling(std::shared_ptr<GameObject> gameobject);
+        bool FrustumCulling(const GameObject& gameobject);
+
+        /**
+         * @brief World space box around the model of gameobject, false if it has no model or no transform.
+         */
+        static bool GetWorldBounding(const GameObject& gameobject, BoundingBox& bounding);
 
         bool CheckVisibility(BoundingBox* bounding);
 
+        /**
+         * @brief Frustum in world space as of the last tick of this camera.
+         */
+        const Frustum& GetFrustum() const { return m_frustum; }
+
+        /**
+         * @brief Projection times view matrix as of the last tick of this camera, clip w is the view depth.
+         */
+        const glm::mat4& GetViewProjection() const { return m_view_projection; }
+
     private:
-        void TickFreeCamera(float dt);
+        void TickFreeCamera(float dt, Transform3DComponent& transform_component);
 
-        std::weak_ptr<Transform3DComponent> m_transform;
-        Frustum                             m_frustum;
+        Frustum   m_frustum;
+        glm::mat4 m_view_projection = glm::mat4(1.0f);
     };
 } // namespace Meow
@@ -1,5 +1,6 @@
 #include "model_component.h"
 
+#include "function/components/transform/transform_3d_component.hpp"
 #include "function/global/runtime_context.h"
 
 namespace Meow
@@ -20,4 +21,15 @@ namespace Meow
         if (success)
             model_ptr = g_runtime_context.resource_system->GetModel(model_uuid);
     }
+
+    void ModelComponent::Start()
+    {
+        std::shared_ptr<GameObject> gameobject = m_parent_object.lock();
+        std::shared_ptr<Model>      model      = model_ptr.lock();
+        if (!gameobject || !model)
+            return;
+
+        if (Transform3DComponent* transform_comp_ptr = gameobject->GetComponent<Transform3DComponent>())
+            transform_comp_ptr->SetLocalBounds(model->GetBounding());
+    }
 } // namespace Meow
\ No newline at end of file
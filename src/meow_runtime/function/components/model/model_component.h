@@ -22,5 +22,10 @@ namespace Meow
                        BitMask<VertexAttributeBit> attributes);
 
         ModelComponent(const std::string& file_path, BitMask<VertexAttributeBit> attributes);
+
+        /**
+         * @brief Hand the bounds of the model to the transform of the parent object, if it is started already.
+         */
+        void Start() override;
     };
 } // namespace Meow
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "transform_3d_component.hpp"
+
+#include "pch.h"
+
+#include "function/components/model/model_component.h"
+#include "function/level/level.h"
+#include "function/level/transform_hierarchy.h"
+
+namespace Meow
+{
+    Transform3DComponent::~Transform3DComponent()
+    {
+        if (m_hierarchy)
+            m_hierarchy->Remove(m_hierarchy_id);
+    }
+
+    Transform3DComponent::Transform3DComponent(const Transform3DComponent& other)
+        : Component(other)
+        , position(other.position)
+        , rotation(other.rotation)
+        , scale(other.scale)
+    {}
+
+    Transform3DComponent& Transform3DComponent::operator=(const Transform3DComponent& other)
+    {
+        Component::operator=(other);
+        position = other.position;
+        rotation = other.rotation;
+        scale    = other.scale;
+        MarkDirty();
+        return *this;
+    }
+
+    Transform3DComponent::Transform3DComponent(Transform3DComponent&& other) noexcept
+        : Component(std::move(other))
+        , position(other.position)
+        , rotation(other.rotation)
+        , scale(other.scale)
+        , m_hierarchy(other.m_hierarchy)
+        , m_hierarchy_id(other.m_hierarchy_id)
+    {
+        other.m_hierarchy    = nullptr;
+        other.m_hierarchy_id = TransformHierarchy::k_invalid_id;
+    }
+
+    Transform3DComponent& Transform3DComponent::operator=(Transform3DComponent&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        if (m_hierarchy)
+            m_hierarchy->Remove(m_hierarchy_id);
+
+        Component::operator=(std::move(other));
+        position       = other.position;
+        rotation       = other.rotation;
+        scale          = other.scale;
+        m_hierarchy    = other.m_hierarchy;
+        m_hierarchy_id = other.m_hierarchy_id;
+
+        other.m_hierarchy    = nullptr;
+        other.m_hierarchy_id = TransformHierarchy::k_invalid_id;
+        return *this;
+    }
+
+    void Transform3DComponent::Start()
+    {
+        if (m_hierarchy)
+            return;
+
+        std::shared_ptr<GameObject> gameobject = m_parent_object.lock();
+        if (!gameobject || !gameobject->GetLevel())
+            return;
+
+        m_hierarchy    = &gameobject->GetLevel()->GetTransformHierarchy();
+        m_hierarchy_id = m_hierarchy->Add(gameobject->GetHandle());
+
+        // the model may have been added first, otherwise ModelComponent::Start sets the bounds
+        if (ModelComponent* model_comp_ptr = gameobject->GetComponent<ModelComponent>())
+        {
+            if (std::shared_ptr<Model> model = model_comp_ptr->model_ptr.lock())
+                SetLocalBounds(model->GetBounding());
+        }
+    }
+
+    void Transform3DComponent::MarkDirty()
+    {
+        if (m_hierarchy)
+            m_hierarchy->MarkDirty(m_hierarchy_id);
+    }
+
+    bool Transform3DComponent::SetParent(Transform3DComponent* parent)
+    {
+        if (!m_hierarchy)
+        {
+            MEOW_ERROR("Transform is not part of a level!");
+            return false;
+        }
+
+        if (!parent)
+            return m_hierarchy->SetParent(m_hierarchy_id, TransformHierarchy::k_invalid_id);
+
+        if (parent->m_hierarchy != m_hierarchy)
+        {
+            MEOW_ERROR("Parent transform is not part of the same level!");
+            return false;
+        }
+
+        return m_hierarchy->SetParent(m_hierarchy_id, parent->m_hierarchy_id);
+    }
+
+    glm::mat4 Transform3DComponent::GetWorldTransform() const
+    {
+        if (!m_hierarchy)
+            return GetTransform();
+
+        return m_hierarchy->GetWorldMatrix(m_hierarchy_id);
+    }
+
+    void Transform3DComponent::SetLocalBounds(const BoundingBox& bounds)
+    {
+        if (m_hierarchy)
+            m_hierarchy->SetLocalBounds(m_hierarchy_id, bounds);
+    }
+
+    bool Transform3DComponent::GetWorldBounds(BoundingBox& bounds) const
+    {
+        return m_hierarchy && m_hierarchy->GetWorldBounds(m_hierarchy_id, bounds);
+    }
+} // namespace Meow
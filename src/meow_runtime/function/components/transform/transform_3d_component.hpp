@@ -1,12 +1,23 @@
 #pragma once
 
+#include "core/math/bounding_box.h"
 #include "function/object/game_object.h"
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include <cstdint>
+
 namespace Meow
 {
+    class TransformHierarchy;
+
+    /**
+     * @brief Position, rotation and scale relative to the parent transform.
+     *
+     * Started transforms own a node in the TransformHierarchy of their level, which caches the world matrix. The
+     * fields are public for reflection, so after writing them directly call MarkDirty, or use the setters.
+     */
     class [[reflectable_class()]] Transform3DComponent : public Component
     {
     public:
@@ -19,8 +30,79 @@ namespace Meow
         [[reflectable_field()]]
         glm::vec3 scale = glm::vec3(1.0f);
 
+        Transform3DComponent() = default;
+        ~Transform3DComponent();
+
+        /**
+         * @brief Copies position, rotation and scale, but not the hierarchy node, which belongs to the copied object.
+         */
+        Transform3DComponent(const Transform3DComponent& other);
+        Transform3DComponent& operator=(const Transform3DComponent& other);
+
+        /**
+         * @brief Takes over the hierarchy node, components are moved when their game object changes archetype.
+         */
+        Transform3DComponent(Transform3DComponent&& other) noexcept;
+        Transform3DComponent& operator=(Transform3DComponent&& other) noexcept;
+
+        /**
+         * @brief Add a node to the transform hierarchy of the level of the parent object, with the bounds of its
+         * model if it has one.
+         */
+        void Start() override;
+
+        void SetPosition(const glm::vec3& new_position)
+        {
+            position = new_position;
+            MarkDirty();
+        }
+
+        void SetRotation(const glm::quat& new_rotation)
+        {
+            rotation = new_rotation;
+            MarkDirty();
+        }
+
+        void SetScale(const glm::vec3& new_scale)
+        {
+            scale = new_scale;
+            MarkDirty();
+        }
+
+        /**
+         * @brief Update the cached world matrix of this transform and its children on the next level tick.
+         */
+        void MarkDirty();
+
+        /**
+         * @brief Attach to a parent transform of the same level, nullptr detaches. Position, rotation and scale become
+         * relative to the new parent. Returns false if that would create a cycle.
+         */
+        bool SetParent(Transform3DComponent* parent);
+
+        /**
+         * @brief Cached world matrix as of the last level tick, the local transform if this transform is not started.
+         */
+        glm::mat4 GetWorldTransform() const;
+
         /**
-         * @brief Get the Transform from position, rotation(quaternion) and scale
+         * @brief Set the bounds of what this object renders, in local space. Ignored if this transform is not started.
+         */
+        void SetLocalBounds(const BoundingBox& bounds);
+
+        /**
+         * @brief Cached world bounds as of the last level tick, false if there are none.
+         */
+        bool GetWorldBounds(BoundingBox& bounds) const;
+
+        /**
+         * @brief Id of the node of this transform in the transform hierarchy of its level, invalid if this transform is
+         * not started.
+         */
+        uint32_t GetHierarchyId() const { return m_hierarchy_id; }
+
+        /**
+         * @brief Get the local Transform from position, rotation(quaternion) and scale
          *
          * Construct Ordering:
          *
@@ -57,5 +139,9 @@ namespace Meow
 
             return transform;
         }
+
+    private:
+        TransformHierarchy* m_hierarchy    = nullptr;
+        uint32_t            m_hierarchy_id = ~0u;
     };
-} // namespace Meow
\ No newline at end of file
+} // namespace Meow
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/jobs/job_system.h"
 #include "function/file/file_system.h"
 #include "function/input/input_system.h"
 #include "function/level/level_system.h"
@@ -16,6 +17,7 @@ namespace Meow
     {
         bool running = true;
 
+        std::shared_ptr<JobSystem>      job_system      = nullptr;
         std::shared_ptr<TimeSystem>     time_system     = nullptr;
         std::shared_ptr<ResourceSystem> resource_system = nullptr;
         std::shared_ptr<WindowSystem>   window_system   = nullptr;
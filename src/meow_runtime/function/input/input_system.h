@@ -19,6 +19,10 @@ namespace Meow
 
         void Tick(float dt) override;
 
+        SystemResources GetWriteResources() const override { return SystemResourceBit::Input; }
+
+        bool IsMainThreadOnly() const override { return true; }
+
         InputScheme* GetScheme() const { return m_current_scheme; }
         InputScheme* GetScheme(const std::string& name) const;
         InputScheme* AddScheme(const std::string& name, std::unique_ptr<InputScheme>&& scheme, bool setCurrent = false);
@@ -2,77 +2,1068 @@
 
 #include "pch.h"
 
+#include "core/memory/pool_allocator.h"
+#include "function/components/model/model_component.h"
 #include "function/global/runtime_context.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
 namespace Meow
 {
+    Level::Level() { ResizeCommandBuffers(); }
+
     void Level::Tick(float dt)
     {
         FUNCTION_TIMER();
 
-        for (auto& kv : m_gameobjects)
+        ++m_tick_count;
+
+        // the job system may have been replaced since the last tick
+        ResizeCommandBuffers();
+
+        m_component_storage.Tick(dt,
+                                 m_tick_mode == LevelTickMode::Parallel ? g_runtime_context.job_system.get() : nullptr);
+
+        PlaybackCommandBuffers();
+
+        m_transform_hierarchy.Update(*this);
+
+        UpdateSpatialTree();
+
+        if (!m_is_cpu_culling_enabled)
         {
-            kv.second->Tick(dt);
+            ClearDrawLists();
+            return;
         }
 
         FrustumCulling();
-    }
 
-    std::weak_ptr<GameObject> Level::GetGameObjectByID(UUID go_id) const
-    {
-        FUNCTION_TIMER();
+        OcclusionCulling();
 
-        auto iter = m_gameobjects.find(go_id);
-        if (iter != m_gameobjects.end())
-        {
-            return iter->second;
-        }
+        MeshCulling();
+
+        SelectLods();
 
-        return std::weak_ptr<GameObject>();
+        MeshletCulling();
+
+        BatchInstances();
     }
 
-    UUID Level::CreateObject()
+    GameObjectHandle Level::CreateObject()
     {
         FUNCTION_TIMER();
 
+        if (m_component_storage.IsTicking())
+        {
+            MEOW_ERROR("Can not create object while level is ticking!");
+            return GameObjectHandle {};
+        }
+
         UUID object_id;
 
+        // object and control block come from one pooled block
+        PoolStdAllocator<GameObject> allocator(GetTypePool<GameObject>("GameObject"));
+
         std::shared_ptr<GameObject> gobject;
         try
         {
-            gobject = std::make_shared<GameObject>(object_id);
+            gobject = std::allocate_shared<GameObject>(allocator, object_id, &m_component_storage);
         }
         catch (const std::bad_alloc&)
         {
             MEOW_ERROR("cannot allocate memory for new gobject");
+            return GameObjectHandle {};
         }
 
-        m_gameobjects.insert({object_id, gobject});
+        uint32_t slot_index;
+        if (m_free_slots.empty())
+        {
+            slot_index = static_cast<uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        }
+        else
+        {
+            slot_index = m_free_slots.back();
+            m_free_slots.pop_back();
+        }
 
-        return object_id;
+        Slot& slot       = m_slots[slot_index];
+        slot.dense_index = static_cast<uint32_t>(m_gameobjects.size());
+
+        // a reused slot must not pass the culling data of its previous object on
+        if (slot_index < m_cull_planes_by_slot.size())
+            m_cull_planes_by_slot[slot_index] = Frustum::k_no_plane;
+        if (slot_index < m_lod_by_slot.size())
+            m_lod_by_slot[slot_index] = 0;
+
+        GameObjectHandle handle {slot_index, slot.generation};
+        gobject->m_handle = handle;
+        gobject->m_level  = this;
+
+        m_gameobjects.push_back(std::move(gobject));
+        m_dense_handles.push_back(handle);
+        m_handles_by_id[object_id] = handle;
+
+        return handle;
+    }
+
+    void Level::DestroyObject(GameObjectHandle handle)
+    {
+        FUNCTION_TIMER();
+
+        if (m_component_storage.IsTicking())
+        {
+            MEOW_ERROR("Can not destroy object while level is ticking!");
+            return;
+        }
+
+        if (!GetGameObject(handle))
+            return;
+
+        Slot&    slot        = m_slots[handle.index];
+        uint32_t dense_index = slot.dense_index;
+
+        // keep the object alive until the containers are consistent again, its destructor may run arbitrary code
+        std::shared_ptr<GameObject> gameobject = std::move(m_gameobjects[dense_index]);
+
+        uint32_t last_index = static_cast<uint32_t>(m_gameobjects.size()) - 1;
+        if (dense_index != last_index)
+        {
+            GameObjectHandle moved_handle = m_dense_handles[last_index];
+
+            m_gameobjects[dense_index]              = std::move(m_gameobjects[last_index]);
+            m_dense_handles[dense_index]            = moved_handle;
+            m_slots[moved_handle.index].dense_index = dense_index;
+        }
+        m_gameobjects.pop_back();
+        m_dense_handles.pop_back();
+
+        slot.dense_index = k_free_slot;
+        slot.generation++;
+        m_free_slots.push_back(handle.index);
+
+        m_handles_by_id.erase(gameobject->GetID());
+        gameobject->m_handle = GameObjectHandle {};
+        gameobject->m_level  = nullptr;
+
+        // the components leave the level with the object, even if it outlives the level through other references, so
+        // that its transform leaves the hierarchy
+        m_component_storage.RemoveObject(*gameobject);
+    }
+
+    LevelCommandBuffer& Level::GetCommandBuffer()
+    {
+        uint32_t thread_index =
+            g_runtime_context.job_system ? g_runtime_context.job_system->GetCurrentThreadIndex() : 0;
+
+        ASSERT(thread_index < m_command_buffers.size());
+        return *m_command_buffers[thread_index];
+    }
+
+    void Level::PlaybackCommandBuffers()
+    {
+        FUNCTION_TIMER();
+
+        if (m_component_storage.IsTicking())
+        {
+            MEOW_ERROR("Can not play back command buffers while level is ticking!");
+            return;
+        }
+
+        m_playback_commands.clear();
+        for (uint32_t buffer_index = 0; buffer_index < m_command_buffers.size(); ++buffer_index)
+        {
+            const std::vector<LevelCommandBuffer::Command>& commands = m_command_buffers[buffer_index]->m_commands;
+            for (uint32_t command_index = 0; command_index < commands.size(); ++command_index)
+            {
+                m_playback_commands.push_back({commands[command_index].batch_key, buffer_index, command_index});
+            }
+        }
+
+        if (m_playback_commands.empty())
+            return;
+
+        // within a batch all commands come from one buffer, so this order does not depend on which thread ran a batch
+        std::stable_sort(m_playback_commands.begin(),
+                         m_playback_commands.end(),
+                         [](const PlaybackCommand& lhs, const PlaybackCommand& rhs) {
+                             return lhs.batch_key < rhs.batch_key;
+                         });
+
+        ReservePlayback();
+
+        for (const PlaybackCommand& playback_command : m_playback_commands)
+        {
+            LevelCommandBuffer&                buffer  = *m_command_buffers[playback_command.buffer_index];
+            const LevelCommandBuffer::Command& command = buffer.m_commands[playback_command.command_index];
+
+            switch (command.type)
+            {
+                case LevelCommandBuffer::CommandType::CreateObject:
+                    CreatePendingObject(buffer, command.pending_object);
+                    break;
+                case LevelCommandBuffer::CommandType::DestroyObject:
+                    DestroyObject(command.handle);
+                    break;
+                case LevelCommandBuffer::CommandType::AddComponent:
+                    if (GameObject* gameobject = GetGameObject(command.handle))
+                    {
+                        m_playback_components.clear();
+                        m_playback_components.push_back(&buffer.m_pending_components[command.components]);
+                        AddPlaybackComponents(*gameobject);
+                    }
+                    break;
+                case LevelCommandBuffer::CommandType::RemoveComponent:
+                    if (GameObject* gameobject = GetGameObject(command.handle); gameobject && command.remove_type)
+                        m_component_storage.RemoveComponent(*gameobject, *command.remove_type);
+                    break;
+            }
+        }
+
+        for (const auto& buffer : m_command_buffers)
+        {
+            buffer->Clear();
+        }
+    }
+
+    GameObjectHandle Level::GetHandleByID(UUID go_id) const
+    {
+        auto iter = m_handles_by_id.find(go_id);
+        return iter != m_handles_by_id.end() ? iter->second : GameObjectHandle {};
+    }
+
+    std::weak_ptr<GameObject> Level::GetGameObjectByID(UUID go_id) const
+    {
+        FUNCTION_TIMER();
+
+        GameObject* gameobject = GetGameObject(GetHandleByID(go_id));
+        if (!gameobject)
+            return std::weak_ptr<GameObject>();
+
+        return gameobject->weak_from_this();
+    }
+
+    void Level::UpdateSpatialTree()
+    {
+        FUNCTION_TIMER();
+
+        for (uint32_t id : m_transform_hierarchy.GetRemovedBoundsIds())
+        {
+            if (id < m_spatial_proxies.size() && m_spatial_proxies[id] != DynamicBoundingBoxTree::k_null_node)
+            {
+                m_spatial_tree.Remove(m_spatial_proxies[id]);
+                m_spatial_proxies[id] = DynamicBoundingBoxTree::k_null_node;
+            }
+        }
+
+        for (uint32_t id : m_transform_hierarchy.GetChangedBoundsIds())
+        {
+            if (id >= m_spatial_proxies.size())
+                m_spatial_proxies.resize(id + 1, DynamicBoundingBoxTree::k_null_node);
+
+            // an id removed after its bounds changed has no bounds, its removal was applied above
+            uint32_t&   proxy = m_spatial_proxies[id];
+            BoundingBox bounding;
+            if (!m_transform_hierarchy.GetWorldBounds(id, bounding))
+                continue;
+
+            if (proxy == DynamicBoundingBoxTree::k_null_node)
+                proxy = m_spatial_tree.Insert(bounding, id);
+            else
+                m_spatial_tree.Move(proxy, bounding);
+        }
+
+        const std::vector<uint32_t>& changed_ids = m_transform_hierarchy.GetChangedBoundsIds();
+        const std::vector<uint32_t>& removed_ids = m_transform_hierarchy.GetRemovedBoundsIds();
+        m_changed_bounds_ids.assign(changed_ids.begin(), changed_ids.end());
+        m_removed_bounds_ids.assign(removed_ids.begin(), removed_ids.end());
+
+        m_transform_hierarchy.ClearBoundsChanges();
+    }
+
+    void Level::ClearDrawLists()
+    {
+        m_visibles.clear();
+        m_visible_ids.clear();
+        m_visible_meshes.clear();
+        m_index_ranges.clear();
+        m_instanced_meshes.clear();
+        m_instance_batches.clear();
+
+        m_occlusion_culled_count      = 0;
+        m_meshlet_culled_count        = 0;
+        m_is_occlusion_buffer_current = false;
     }
 
     void Level::FrustumCulling()
     {
+        Timer timer(FUNC_SIG, __FILE__);
+
         m_visibles.clear();
+        m_visible_ids.clear();
 
-        std::shared_ptr<GameObject> camera_go_ptr = GetGameObjectByID(m_main_camera_id).lock();
+        GameObject* camera_go_ptr = GetGameObject(m_main_camera);
 
         if (!camera_go_ptr)
             return;
 
-        std::shared_ptr<Camera3DComponent> camera_comp_ptr =
-            camera_go_ptr->TryGetComponent<Camera3DComponent>("Camera3DComponent");
+        Camera3DComponent* camera_comp_ptr = camera_go_ptr->GetComponent<Camera3DComponent>();
+
+        if (!camera_comp_ptr)
+            return;
+
+        timer.SetItemCount(m_spatial_tree.GetProxyCount());
+
+        const Frustum& frustum = camera_comp_ptr->GetFrustum();
+
+        // whole subtrees inside or outside the frustum are resolved by the tree, only objects whose enlarged box
+        // intersects it are tested one by one
+        m_cull_inside_ids.clear();
+        m_cull_intersecting_ids.clear();
+        m_spatial_tree.QueryFrustum(frustum, m_cull_inside_ids, m_cull_intersecting_ids);
+
+        m_visible_ids.insert(m_visible_ids.end(), m_cull_inside_ids.begin(), m_cull_inside_ids.end());
+
+        m_cull_bounds.Clear();
+        m_cull_handles.clear();
+        for (uint32_t id : m_cull_intersecting_ids)
+        {
+            BoundingBox bounding;
+            m_transform_hierarchy.GetWorldBounds(id, bounding);
+            m_cull_bounds.Push(bounding);
+            m_cull_handles.push_back(m_transform_hierarchy.GetOwner(id));
+        }
+
+        const uint32_t cull_count = static_cast<uint32_t>(m_cull_handles.size());
+
+        // the plane that rejected each object last frame is kept per slot, as objects move in the dense array
+        m_cull_planes_by_slot.resize(m_slots.size(), Frustum::k_no_plane);
+        m_cull_last_planes.resize(cull_count);
+        for (uint32_t i = 0; i < cull_count; ++i)
+        {
+            m_cull_last_planes[i] = m_cull_planes_by_slot[m_cull_handles[i].index];
+        }
+
+        m_cull_visibility.resize(cull_count);
+
+        auto cull = [this, &frustum](uint32_t begin, uint32_t end) {
+            Timer batch_timer("Frustum::CullBoundingBoxes", __FILE__);
+            batch_timer.SetItemCount(end - begin);
+
+            frustum.CullBoundingBoxes(m_cull_bounds, begin, end, m_cull_visibility.data(), m_cull_last_planes.data());
+        };
+
+        JobSystem* job_system = m_tick_mode == LevelTickMode::Parallel ? g_runtime_context.job_system.get() : nullptr;
+        if (job_system)
+            job_system->ParallelFor(0, cull_count, k_cull_batch_size, cull);
+        else
+            cull(0, cull_count);
+
+        for (uint32_t i = 0; i < cull_count; ++i)
+        {
+            m_cull_planes_by_slot[m_cull_handles[i].index] = m_cull_last_planes[i];
+            if (m_cull_visibility[i])
+                m_visible_ids.push_back(m_cull_intersecting_ids[i]);
+        }
+
+        // the order of the tree depends on the history of its updates, ids give the same order for the same objects
+        std::sort(m_visible_ids.begin(), m_visible_ids.end());
+        for (uint32_t id : m_visible_ids)
+        {
+            m_visibles.push_back(m_transform_hierarchy.GetOwner(id));
+        }
+    }
+
+    void Level::OcclusionCulling()
+    {
+        Timer timer(FUNC_SIG, __FILE__);
+
+        m_occlusion_culled_count      = 0;
+        m_is_occlusion_buffer_current = false;
+
+        std::erase_if(m_occluders, [this](GameObjectHandle handle) { return !GetGameObject(handle); });
+
+        if (!m_is_occlusion_culling_enabled || m_occluders.empty() || m_visibles.empty())
+            return;
+
+        GameObject*        camera_go_ptr   = GetGameObject(m_main_camera);
+        Camera3DComponent* camera_comp_ptr = camera_go_ptr ? camera_go_ptr->GetComponent<Camera3DComponent>() : nullptr;
+        if (!camera_comp_ptr)
+            return;
+
+        timer.SetItemCount(m_visibles.size());
+
+        m_occlusion_buffer.Clear(camera_comp_ptr->GetViewProjection(), camera_comp_ptr->near_plane);
+
+        m_occluder_by_slot.assign(m_slots.size(), 0);
+        for (GameObjectHandle handle : m_occluders)
+        {
+            m_occluder_by_slot[handle.index] = 1;
+
+            GameObject*           gameobject         = GetGameObject(handle);
+            Transform3DComponent* transform_comp_ptr = gameobject->GetComponent<Transform3DComponent>();
+            ModelComponent*       model_comp_ptr     = gameobject->GetComponent<ModelComponent>();
+            if (!transform_comp_ptr || !model_comp_ptr)
+                continue;
+
+            std::shared_ptr<Model> model = model_comp_ptr->model_ptr.lock();
+            if (!model || !(model->attributes & VertexAttributeBit::Position))
+                continue;
+
+            uint32_t  stride       = VertexAttributesToSize(model->attributes) / sizeof(float);
+            glm::mat4 world_matrix = transform_comp_ptr->GetWorldTransform();
+            for (const ModelMesh* mesh : model->meshes)
+            {
+                glm::mat4 mesh_matrix = mesh->link_node ? world_matrix * mesh->link_node->global_matrix : world_matrix;
+                m_occlusion_buffer.AddOccluder(mesh->vertices, stride, mesh->indices, mesh_matrix);
+            }
+        }
+
+        JobSystem* job_system = m_tick_mode == LevelTickMode::Parallel ? g_runtime_context.job_system.get() : nullptr;
+
+        m_occlusion_buffer.Rasterize(job_system);
+        m_is_occlusion_buffer_current = true;
+
+        const uint32_t visible_count = static_cast<uint32_t>(m_visibles.size());
+        m_occlusion_visibility.resize(visible_count);
+
+        // occluders are kept, they would only hide each other
+        auto test = [this](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                BoundingBox bounding;
+                m_occlusion_visibility[i] = m_occluder_by_slot[m_visibles[i].index] ||
+                                            !m_transform_hierarchy.GetWorldBounds(m_visible_ids[i], bounding) ||
+                                            !m_occlusion_buffer.IsOccluded(bounding);
+            }
+        };
+
+        if (job_system)
+            job_system->ParallelFor(0, visible_count, k_occlusion_batch_size, test);
+        else
+            test(0, visible_count);
+
+        uint32_t visible_index = 0;
+        for (uint32_t i = 0; i < visible_count; ++i)
+        {
+            if (!m_occlusion_visibility[i])
+                continue;
+
+            m_visibles[visible_index]      = m_visibles[i];
+            m_visible_ids[visible_index++] = m_visible_ids[i];
+        }
+
+        m_occlusion_culled_count = visible_count - visible_index;
+        m_visibles.resize(visible_index);
+        m_visible_ids.resize(visible_index);
+    }
+
+    void Level::MeshCulling()
+    {
+        Timer timer(FUNC_SIG, __FILE__);
+
+        m_visible_meshes.clear();
+        m_mesh_cull_bounds.Clear();
+        m_mesh_cull_indices.clear();
+        m_mesh_cull_occludable.clear();
+
+        for (uint32_t visible_index = 0; visible_index < m_visibles.size(); ++visible_index)
+        {
+            GameObjectHandle handle     = m_visibles[visible_index];
+            uint32_t         id         = m_visible_ids[visible_index];
+            GameObject*      gameobject = GetGameObject(handle);
+            if (!gameobject)
+                continue;
+
+            ModelComponent* model_comp_ptr = gameobject->GetComponent<ModelComponent>();
+            if (!model_comp_ptr)
+                continue;
+
+            std::shared_ptr<Model> model = model_comp_ptr->model_ptr.lock();
+            if (!model)
+                continue;
+
+            const uint32_t mesh_count = static_cast<uint32_t>(model->meshes.size());
+            if (mesh_count == 1)
+            {
+                m_visible_meshes.push_back({handle, 0, id});
+                continue;
+            }
+
+            // occluders are not culled by occlusion, so neither are their meshes
+            bool is_occludable = m_is_occlusion_buffer_current && !m_occluder_by_slot[handle.index];
+
+            const glm::mat4& world_matrix = m_transform_hierarchy.GetWorldMatrix(id);
+            for (uint32_t i = 0; i < mesh_count; ++i)
+            {
+                const ModelMesh* mesh = model->meshes[i];
+                glm::mat4 mesh_matrix = mesh->link_node ? world_matrix * mesh->link_node->global_matrix : world_matrix;
+
+                m_mesh_cull_bounds.Push(mesh->bounding.Transformed(mesh_matrix));
+                m_mesh_cull_indices.push_back(static_cast<uint32_t>(m_visible_meshes.size()));
+                m_mesh_cull_occludable.push_back(is_occludable);
+                m_visible_meshes.push_back({handle, i, id});
+            }
+        }
+
+        const uint32_t cull_count = static_cast<uint32_t>(m_mesh_cull_indices.size());
+        if (cull_count == 0)
+            return;
+
+        timer.SetItemCount(cull_count);
+
+        const Frustum& frustum = GetGameObject(m_main_camera)->GetComponent<Camera3DComponent>()->GetFrustum();
+
+        m_mesh_cull_visibility.resize(cull_count);
+
+        auto cull = [this, &frustum](uint32_t begin, uint32_t end) {
+            frustum.CullBoundingBoxes(m_mesh_cull_bounds, begin, end, m_mesh_cull_visibility.data(), nullptr);
+
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                if (m_mesh_cull_visibility[i] && m_mesh_cull_occludable[i])
+                    m_mesh_cull_visibility[i] = !m_occlusion_buffer.IsOccluded(m_mesh_cull_bounds.Get(i));
+            }
+        };
+
+        JobSystem* job_system = m_tick_mode == LevelTickMode::Parallel ? g_runtime_context.job_system.get() : nullptr;
+        if (job_system)
+            job_system->ParallelFor(0, cull_count, k_cull_batch_size, cull);
+        else
+            cull(0, cull_count);
+
+        // drop the culled meshes, keeping the order of the draw list
+        uint32_t visible_index = 0;
+        uint32_t cull_index    = 0;
+        for (uint32_t i = 0; i < m_visible_meshes.size(); ++i)
+        {
+            if (cull_index < cull_count && m_mesh_cull_indices[cull_index] == i)
+            {
+                if (!m_mesh_cull_visibility[cull_index++])
+                    continue;
+            }
+
+            m_visible_meshes[visible_index++] = m_visible_meshes[i];
+        }
+        m_visible_meshes.resize(visible_index);
+    }
+
+    void Level::SelectLods()
+    {
+        Timer timer(FUNC_SIG, __FILE__);
+
+        if (m_visible_meshes.empty())
+            return;
+
+        timer.SetItemCount(m_visibles.size());
+
+        GameObject*           camera_go_ptr        = GetGameObject(m_main_camera);
+        Camera3DComponent*    camera_comp_ptr      = camera_go_ptr->GetComponent<Camera3DComponent>();
+        Transform3DComponent* camera_transform_ptr = camera_go_ptr->GetComponent<Transform3DComponent>();
+        if (!camera_transform_ptr)
+            return;
+
+        // an error of one unit at a distance of one unit covers this many pixels
+        const float pixels_per_unit =
+            m_lod_settings.viewport_height / (2.0f * std::tan(camera_comp_ptr->field_of_view * 0.5f));
+        const float     min_distance    = std::max(camera_comp_ptr->near_plane, 1e-4f);
+        const glm::vec3 camera_position = camera_transform_ptr->position;
 
-        if (camera_comp_ptr)
+        m_lod_by_slot.resize(m_slots.size(), 0);
+
+        // the meshes of an object are next to each other in the draw list
+        for (uint32_t first = 0; first < m_visible_meshes.size();)
         {
-            for (const auto& pair : m_gameobjects)
+            const GameObjectHandle handle = m_visible_meshes[first].object;
+            const uint32_t         id     = m_visible_meshes[first].world_matrix_index;
+
+            uint32_t end = first + 1;
+            while (end < m_visible_meshes.size() && m_visible_meshes[end].object == handle)
+            {
+                ++end;
+            }
+
+            GameObject* gameobject = GetGameObject(handle);
+            if (!gameobject)
+            {
+                first = end;
+                continue;
+            }
+
+            ModelComponent*        model_comp_ptr = gameobject->GetComponent<ModelComponent>();
+            std::shared_ptr<Model> model          = model_comp_ptr ? model_comp_ptr->model_ptr.lock() : nullptr;
+            const uint32_t         lod_count      = model ? model->GetLodCount() : 1;
+
+            uint32_t    lod = std::min<uint32_t>(m_lod_by_slot[handle.index], lod_count - 1);
+            BoundingBox bounding;
+            if (lod_count > 1 && m_transform_hierarchy.GetWorldBounds(id, bounding))
             {
-                if (camera_comp_ptr->FrustumCulling(pair.second))
+                const glm::mat4& world_matrix = m_transform_hierarchy.GetWorldMatrix(id);
+                float            scale        = std::max({glm::length(glm::vec3(world_matrix[0])),
+                                                          glm::length(glm::vec3(world_matrix[1])),
+                                                          glm::length(glm::vec3(world_matrix[2]))});
+
+                glm::vec3 offset   = glm::max(glm::max(bounding.min - camera_position, camera_position - bounding.max),
+                                            glm::vec3(0.0f));
+                float     distance = std::max(glm::length(offset), min_distance);
+
+                auto get_pixel_error = [&model, scale, pixels_per_unit, distance](uint32_t lod_index) {
+                    return model->GetLodError(lod_index) * scale * pixels_per_unit / distance;
+                };
+
+                if (get_pixel_error(lod) > m_lod_settings.pixel_error)
                 {
-                    m_visibles[pair.first] = pair.second;
+                    while (lod > 0 && get_pixel_error(lod) > m_lod_settings.pixel_error)
+                    {
+                        --lod;
+                    }
                 }
+                else
+                {
+                    const float coarser_pixel_error = m_lod_settings.pixel_error * (1.0f - m_lod_settings.hysteresis);
+                    while (lod + 1 < lod_count && get_pixel_error(lod + 1) <= coarser_pixel_error)
+                    {
+                        ++lod;
+                    }
+                }
+            }
+
+            m_lod_by_slot[handle.index] = static_cast<uint8_t>(lod);
+            for (uint32_t i = first; i < end; ++i)
+            {
+                m_visible_meshes[i].lod_index = lod;
             }
+
+            first = end;
+        }
+    }
+
+    void Level::MeshletCulling()
+    {
+        Timer timer(FUNC_SIG, __FILE__);
+
+        m_index_ranges.clear();
+        m_meshlet_cull_meshes.clear();
+        m_meshlet_culled_count = 0;
+
+        if (!m_is_meshlet_culling_enabled || m_visible_meshes.empty())
+            return;
+
+        GameObject*           camera_go_ptr        = GetGameObject(m_main_camera);
+        Camera3DComponent*    camera_comp_ptr      = camera_go_ptr->GetComponent<Camera3DComponent>();
+        Transform3DComponent* camera_transform_ptr = camera_go_ptr->GetComponent<Transform3DComponent>();
+        if (!camera_transform_ptr)
+            return;
+
+        // meshlets cover the full resolution level only
+        uint32_t meshlet_count = 0;
+        for (uint32_t i = 0; i < m_visible_meshes.size(); ++i)
+        {
+            const VisibleMesh& visible_mesh = m_visible_meshes[i];
+            GameObject*        gameobject   = GetGameObject(visible_mesh.object);
+            if (!gameobject)
+                continue;
+
+            ModelComponent* model_comp_ptr = gameobject->GetComponent<ModelComponent>();
+            if (!model_comp_ptr)
+                continue;
+
+            std::shared_ptr<Model> model = model_comp_ptr->model_ptr.lock();
+            if (!model)
+                continue;
+
+            const ModelMesh* mesh = model->meshes[visible_mesh.mesh_index];
+            if (mesh->meshlets.empty() || std::min(visible_mesh.lod_index, mesh->GetLodCount() - 1) != 0)
+                continue;
+
+            m_meshlet_cull_meshes.push_back({i, meshlet_count, mesh});
+            meshlet_count += static_cast<uint32_t>(mesh->meshlets.size());
+        }
+
+        if (meshlet_count == 0)
+            return;
+
+        timer.SetItemCount(meshlet_count);
+
+        m_meshlet_visibility.resize(meshlet_count);
+
+        const Frustum&  frustum         = camera_comp_ptr->GetFrustum();
+        const glm::vec3 camera_position = camera_transform_ptr->position;
+
+        auto cull = [this, &frustum, &camera_position](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                const MeshletCullMesh& cull_mesh    = m_meshlet_cull_meshes[i];
+                const glm::mat4&       world_matrix = m_transform_hierarchy.GetWorldMatrix(
+                    m_visible_meshes[cull_mesh.visible_index].world_matrix_index);
+                glm::mat4 mesh_matrix =
+                    cull_mesh.mesh->link_node ? world_matrix * cull_mesh.mesh->link_node->global_matrix : world_matrix;
+
+                CullMeshlets(cull_mesh.mesh->meshlets,
+                             GetMeshletCullParams(frustum, camera_position, mesh_matrix),
+                             m_meshlet_visibility.data() + cull_mesh.first_meshlet);
+            }
+        };
+
+        const uint32_t cull_count = static_cast<uint32_t>(m_meshlet_cull_meshes.size());
+        JobSystem* job_system = m_tick_mode == LevelTickMode::Parallel ? g_runtime_context.job_system.get() : nullptr;
+        if (job_system)
+            job_system->ParallelFor(0, cull_count, k_meshlet_cull_batch_size, cull);
+        else
+            cull(0, cull_count);
+
+        m_meshlet_culled_count =
+            static_cast<uint32_t>(std::count(m_meshlet_visibility.begin(), m_meshlet_visibility.end(), 0));
+
+        // ranges in the order of the draw list, meshes without visible meshlets are dropped
+        uint32_t visible_index = 0;
+        uint32_t cull_index    = 0;
+        for (uint32_t i = 0; i < m_visible_meshes.size(); ++i)
+        {
+            VisibleMesh visible_mesh = m_visible_meshes[i];
+            if (cull_index < cull_count && m_meshlet_cull_meshes[cull_index].visible_index == i)
+            {
+                const MeshletCullMesh& cull_mesh = m_meshlet_cull_meshes[cull_index++];
+
+                visible_mesh.first_index_range = static_cast<uint32_t>(m_index_ranges.size());
+                visible_mesh.index_range_count = AppendVisibleIndexRanges(
+                    cull_mesh.mesh->meshlets, m_meshlet_visibility.data() + cull_mesh.first_meshlet, m_index_ranges);
+                if (visible_mesh.index_range_count == 0)
+                    continue;
+            }
+
+            m_visible_meshes[visible_index++] = visible_mesh;
+        }
+        m_visible_meshes.resize(visible_index);
+    }
+
+    void Level::BatchInstances()
+    {
+        Timer timer(FUNC_SIG, __FILE__);
+
+        m_instanced_meshes.clear();
+        m_instance_batches.clear();
+        m_instance_keys.clear();
+
+        if (m_visible_meshes.empty())
+            return;
+
+        timer.SetItemCount(m_visible_meshes.size());
+
+        for (uint32_t i = 0; i < m_visible_meshes.size(); ++i)
+        {
+            const VisibleMesh& visible_mesh = m_visible_meshes[i];
+            GameObject*        gameobject   = GetGameObject(visible_mesh.object);
+            if (!gameobject)
+                continue;
+
+            ModelComponent* model_comp_ptr = gameobject->GetComponent<ModelComponent>();
+            if (!model_comp_ptr)
+                continue;
+
+            std::shared_ptr<Model> model = model_comp_ptr->model_ptr.lock();
+            if (!model)
+                continue;
+
+            const ModelMesh* mesh = model->meshes[visible_mesh.mesh_index];
+
+            m_instance_keys.push_back({mesh, std::min(visible_mesh.lod_index, mesh->GetLodCount() - 1), i});
+        }
+
+        // the visible index keeps the instances of a batch in the order of the draw list
+        std::sort(m_instance_keys.begin(), m_instance_keys.end(), [](const InstanceKey& a, const InstanceKey& b) {
+            if (a.mesh != b.mesh)
+                return std::less<const ModelMesh*>()(a.mesh, b.mesh);
+            if (a.lod_index != b.lod_index)
+                return a.lod_index < b.lod_index;
+            return a.visible_index < b.visible_index;
+        });
+
+        for (uint32_t i = 0; i < m_instance_keys.size(); ++i)
+        {
+            const InstanceKey& key = m_instance_keys[i];
+
+            // index ranges differ from mesh to mesh, so those meshes are never batched
+            bool is_batchable = m_visible_meshes[key.visible_index].index_range_count == 0;
+            if (is_batchable && !m_instance_batches.empty())
+            {
+                const InstanceKey& last = m_instance_keys[i - 1];
+                if (last.mesh == key.mesh && last.lod_index == key.lod_index &&
+                    m_visible_meshes[last.visible_index].index_range_count == 0)
+                {
+                    ++m_instance_batches.back().instance_count;
+                    m_instanced_meshes.push_back(key.visible_index);
+                    continue;
+                }
+            }
+
+            m_instance_batches.push_back({i, 1});
+            m_instanced_meshes.push_back(key.visible_index);
+        }
+    }
+
+    glm::mat4 Level::GetMeshMatrix(const VisibleMesh& visible_mesh) const
+    {
+        const glm::mat4& world_matrix = m_transform_hierarchy.GetWorldMatrix(visible_mesh.world_matrix_index);
+
+        GameObject*     gameobject     = GetGameObject(visible_mesh.object);
+        ModelComponent* model_comp_ptr = gameobject ? gameobject->GetComponent<ModelComponent>() : nullptr;
+        if (!model_comp_ptr)
+            return world_matrix;
+
+        std::shared_ptr<Model> model = model_comp_ptr->model_ptr.lock();
+        if (!model)
+            return world_matrix;
+
+        const ModelMesh* mesh = model->meshes[visible_mesh.mesh_index];
+        return mesh->link_node ? world_matrix * mesh->link_node->global_matrix : world_matrix;
+    }
+
+    bool Level::Raycast(const Ray& ray, float max_distance, RaycastHit& hit) const
+    {
+        FUNCTION_TIMER();
+
+        // each hit limits the query to the boxes in front of it
+        bool is_hit = false;
+        m_spatial_tree.QueryRay(ray, max_distance, [this, &ray, &hit, &is_hit, &max_distance](uint32_t id) {
+            RaycastHit object_hit;
+            if (RaycastObject(id, ray, max_distance, object_hit))
+            {
+                hit          = object_hit;
+                max_distance = object_hit.distance;
+                is_hit       = true;
+            }
+            return max_distance;
+        });
+
+        return is_hit;
+    }
+
+    void Level::RaycastAll(const Ray& ray, float max_distance, std::vector<RaycastHit>& hits) const
+    {
+        FUNCTION_TIMER();
+
+        hits.clear();
+        m_spatial_tree.QueryRay(ray, max_distance, [this, &ray, &hits, max_distance](uint32_t id) {
+            RaycastHit object_hit;
+            if (RaycastObject(id, ray, max_distance, object_hit))
+                hits.push_back(object_hit);
+            return max_distance;
+        });
+
+        std::sort(hits.begin(), hits.end(), [](const RaycastHit& lhs, const RaycastHit& rhs) {
+            return lhs.distance < rhs.distance;
+        });
+    }
+
+    bool Level::RaycastObject(uint32_t hierarchy_id, const Ray& ray, float max_distance, RaycastHit& hit) const
+    {
+        if (!m_transform_hierarchy.Contains(hierarchy_id))
+            return false;
+
+        GameObjectHandle owner          = m_transform_hierarchy.GetOwner(hierarchy_id);
+        GameObject*      gameobject     = GetGameObject(owner);
+        ModelComponent*  model_comp_ptr = gameobject ? gameobject->GetComponent<ModelComponent>() : nullptr;
+        if (!model_comp_ptr)
+            return false;
+
+        std::shared_ptr<Model> model = model_comp_ptr->model_ptr.lock();
+        if (!model)
+            return false;
+
+        const glm::mat4& world_matrix = m_transform_hierarchy.GetWorldMatrix(hierarchy_id);
+
+        bool is_hit = false;
+        for (uint32_t i = 0; i < model->meshes.size(); ++i)
+        {
+            const ModelMesh* mesh = model->meshes[i];
+            if (mesh->bvh.IsEmpty())
+                continue;
+
+            // the direction is transformed without normalizing, so distances stay those along the world ray
+            glm::mat4 mesh_matrix    = mesh->link_node ? world_matrix * mesh->link_node->global_matrix : world_matrix;
+            glm::mat4 inverse_matrix = glm::inverse(mesh_matrix);
+
+            Ray local_ray;
+            local_ray.origin    = glm::vec3(inverse_matrix * glm::vec4(ray.origin, 1.0f));
+            local_ray.direction = glm::vec3(inverse_matrix * glm::vec4(ray.direction, 0.0f));
+
+            TriangleBVH::Hit mesh_hit;
+            if (!mesh->bvh.Raycast(local_ray, max_distance, mesh_hit))
+                continue;
+
+            max_distance       = mesh_hit.distance;
+            is_hit             = true;
+            hit.object         = owner;
+            hit.distance       = mesh_hit.distance;
+            hit.position       = ray.GetPoint(mesh_hit.distance);
+            hit.normal         = glm::normalize(glm::mat3(glm::transpose(inverse_matrix)) * mesh_hit.normal);
+            hit.mesh_index     = i;
+            hit.triangle_index = mesh_hit.triangle_index;
+        }
+
+        return is_hit;
+    }
+
+    void Level::AddOccluder(GameObjectHandle handle)
+    {
+        if (!GetGameObject(handle) || std::find(m_occluders.begin(), m_occluders.end(), handle) != m_occluders.end())
+            return;
+
+        m_occluders.push_back(handle);
+    }
+
+    void Level::RemoveOccluder(GameObjectHandle handle) { std::erase(m_occluders, handle); }
+
+    void Level::ResizeCommandBuffers()
+    {
+        std::size_t thread_count = g_runtime_context.job_system ? g_runtime_context.job_system->GetThreadCount() : 1;
+        while (m_command_buffers.size() < thread_count)
+        {
+            m_command_buffers.push_back(std::make_unique<LevelCommandBuffer>());
+        }
+    }
+
+    void Level::ReservePlayback()
+    {
+        struct ReserveGroup
+        {
+            uint32_t                                       object_count = 0;
+            const LevelCommandBuffer::PendingObjectRecord* record       = nullptr;
+            const LevelCommandBuffer*                      buffer       = nullptr;
+        };
+
+        std::unordered_map<ComponentSignature, ReserveGroup> groups;
+
+        std::size_t create_count  = 0;
+        std::size_t destroy_count = 0;
+        for (const auto& buffer : m_command_buffers)
+        {
+            // first time component types are registered here, on the main thread
+            for (LevelCommandBuffer::PendingComponent& pending_component : buffer->m_pending_components)
+            {
+                if (!pending_component.type_info)
+                    pending_component.type_info = &pending_component.register_type(pending_component.type_name);
+            }
+
+            for (const LevelCommandBuffer::PendingObjectRecord& record : buffer->m_pending_objects)
+            {
+                ComponentSignature signature;
+                for (uint32_t i = record.first_component; i != LevelCommandBuffer::k_none;)
+                {
+                    signature.set(buffer->m_pending_components[i].type_info->type_id);
+                    i = buffer->m_pending_components[i].next;
+                }
+
+                ReserveGroup& group = groups[signature];
+                if (group.object_count++ == 0)
+                {
+                    group.record = &record;
+                    group.buffer = buffer.get();
+                }
+            }
+
+            create_count += buffer->m_pending_objects.size();
+            for (const LevelCommandBuffer::Command& command : buffer->m_commands)
+            {
+                if (command.type == LevelCommandBuffer::CommandType::DestroyObject)
+                    ++destroy_count;
+            }
+        }
+
+        m_slots.reserve(m_slots.size() + create_count);
+        m_gameobjects.reserve(m_gameobjects.size() + create_count);
+        m_dense_handles.reserve(m_dense_handles.size() + create_count);
+        m_handles_by_id.reserve(m_handles_by_id.size() + create_count);
+        m_free_slots.reserve(m_free_slots.size() + destroy_count);
+
+        for (const auto& [signature, group] : groups)
+        {
+            m_playback_types.clear();
+            for (uint32_t i = group.record->first_component; i != LevelCommandBuffer::k_none;)
+            {
+                const ComponentTypeInfo* type_info = group.buffer->m_pending_components[i].type_info;
+                if (std::find(m_playback_types.begin(), m_playback_types.end(), type_info) == m_playback_types.end())
+                    m_playback_types.push_back(type_info);
+                i = group.buffer->m_pending_components[i].next;
+            }
+
+            m_component_storage.Reserve(m_playback_types, group.object_count);
+        }
+    }
+
+    void Level::CreatePendingObject(LevelCommandBuffer& buffer, uint32_t pending_index)
+    {
+        LevelCommandBuffer::PendingObjectRecord& record = buffer.m_pending_objects[pending_index];
+
+        GameObject* gameobject = GetGameObject(CreateObject());
+        if (!gameobject)
+            return;
+
+        if (!record.name.empty())
+            gameobject->SetName(std::move(record.name));
+
+        m_playback_components.clear();
+        for (uint32_t i = record.first_component; i != LevelCommandBuffer::k_none;)
+        {
+            m_playback_components.push_back(&buffer.m_pending_components[i]);
+            i = buffer.m_pending_components[i].next;
+        }
+
+        AddPlaybackComponents(*gameobject);
+    }
+
+    void Level::AddPlaybackComponents(GameObject& gameobject)
+    {
+        m_playback_types.clear();
+        m_playback_values.clear();
+        for (LevelCommandBuffer::PendingComponent*& pending_component : m_playback_components)
+        {
+            const ComponentTypeInfo* type_info = pending_component->type_info;
+            if (gameobject.GetSignature().test(type_info->type_id) ||
+                std::find(m_playback_types.begin(), m_playback_types.end(), type_info) != m_playback_types.end())
+            {
+                // the value is destroyed when the buffer is cleared
+                MEOW_ERROR("Component already exists: {}", type_info->type_name);
+                pending_component = nullptr;
+                continue;
+            }
+
+            m_playback_types.push_back(type_info);
+            m_playback_values.push_back(pending_component->value);
+        }
+
+        if (m_playback_types.empty())
+            return;
+
+        if (!m_component_storage.AddComponents(gameobject, m_playback_types, m_playback_values))
+            return;
+
+        // the moved-from values are destroyed now, so that clearing the buffer does not destroy them again
+        for (LevelCommandBuffer::PendingComponent* pending_component : m_playback_components)
+        {
+            if (!pending_component)
+                continue;
+
+            pending_component->destruct(pending_component->value);
+            pending_component->value = nullptr;
+        }
+
+        // parents are set before any Start, which may look at the other new components
+        std::shared_ptr<GameObject> gameobject_ptr = gameobject.shared_from_this();
+        for (const ComponentTypeInfo* type_info : m_playback_types)
+        {
+            type_info->as_component(gameobject.GetComponentByTypeID(type_info->type_id))->m_parent_object =
+                gameobject_ptr;
+        }
+
+        // Start may add or remove components, which relocates the others
+        for (const ComponentTypeInfo* type_info : m_playback_types)
+        {
+            if (void* component = gameobject.GetComponentByTypeID(type_info->type_id))
+                type_info->as_component(component)->Start();
         }
     }
 } // namespace Meow
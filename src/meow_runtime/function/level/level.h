@@ -1,35 +1,465 @@
 #pragma once
 
+#include "core/math/bounding_box_soa.h"
+#include "core/math/dynamic_bounding_box_tree.h"
+#include "core/math/meshlet.h"
+#include "core/math/occlusion_buffer.h"
+#include "core/math/ray.h"
 #include "function/components/camera/camera_3d_component.hpp"
+#include "function/level/level_command_buffer.h"
+#include "function/level/transform_hierarchy.h"
+#include "function/object/component_storage.h"
 #include "function/object/game_object.h"
+#include "function/object/game_object_handle.h"
 
+#include <memory>
+#include <span>
 #include <unordered_map>
+#include <vector>
 
 namespace Meow
 {
+    struct ModelMesh;
+
+    enum class LevelTickMode : unsigned char
+    {
+        Serial,
+        Parallel
+    };
+
+    /**
+     * @brief Triangle of an object hit by a ray cast against a level.
+     */
+    struct RaycastHit
+    {
+        GameObjectHandle object;
+        float            distance = 0.0f; // along the ray, in units of its direction length
+        glm::vec3        position;
+        glm::vec3        normal; // normalized, facing either side of the triangle
+        uint32_t         mesh_index     = 0;
+        uint32_t         triangle_index = 0;
+    };
+
+    /**
+     * @brief One mesh of the model of a visible object, an entry of the draw list built by culling.
+     */
+    struct VisibleMesh
+    {
+        GameObjectHandle object;
+        uint32_t         mesh_index         = 0;
+        uint32_t         world_matrix_index = 0; // transform hierarchy id, see TransformHierarchy::GetWorldMatrix
+        uint32_t         lod_index          = 0; // meshes with fewer levels of detail draw their coarsest
+        uint32_t         first_index_range  = 0; // see Level::GetIndexRanges
+        uint32_t         index_range_count  = 0;
+    };
+
+    /**
+     * @brief Visible meshes drawn with one instanced draw, a range of Level::GetInstancedMeshes.
+     */
+    struct InstanceBatch
+    {
+        uint32_t first_instance = 0;
+        uint32_t instance_count = 0;
+    };
+
+    /**
+     * @brief How the level of detail of visible objects is picked from the error of the levels on screen.
+     */
+    struct LodSettings
+    {
+        float pixel_error     = 1.0f;    // largest error of a level on screen in pixels, 0 keeps full resolution
+        float viewport_height = 1080.0f; // pixels the vertical field of view of the main camera covers
+        float hysteresis      = 0.25f;   // fraction the error of a coarser level must be below pixel_error to switch
+    };
+
+    /**
+     * @brief Owns the game objects of a level in a slot map.
+     *
+     * Game objects are stored densely for linear iteration and addressed by generational handles, which resolve with
+     * two array lookups and without touching reference counts. UUIDs are kept as persistent identity in a side index.
+     */
     class Level
     {
     public:
+        Level();
+
+        /**
+         * @brief Tick all components, play back the command buffers recorded during the tick, then update the world
+         * matrices and bounds of changed transforms and, unless CPU culling is off, cull against the main camera.
+         */
         void Tick(float dt);
 
-        const std::unordered_map<UUID, std::shared_ptr<GameObject>>& GetAllGameObjects() const { return m_gameobjects; }
+        /**
+         * @brief Parallel mode ticks component chunks on the job system. Both modes give the same result, since writes
+         * to other objects are deferred in either mode.
+         */
+        void          SetTickMode(LevelTickMode mode) { m_tick_mode = mode; }
+        LevelTickMode GetTickMode() const { return m_tick_mode; }
+
+        /**
+         * @brief Persistent identity of this level, unlike its address, which a later level may reuse.
+         */
+        UUID GetID() const { return m_id; }
+
+        /**
+         * @brief Number of ticks so far. Consumers of the bounds changes of the last tick compare it with the tick they
+         * saw last, to notice that they missed ticks.
+         */
+        uint64_t GetTickCount() const { return m_tick_count; }
+
+        /**
+         * @brief Create an object immediately. Not allowed while the level is ticking, use GetCommandBuffer instead.
+         */
+        GameObjectHandle CreateObject();
+
+        void DestroyObject(GameObjectHandle handle);
+
+        /**
+         * @brief Command buffer of the calling thread, for structural changes while the level is ticking.
+         *
+         * Only the main thread and jobs of the runtime job system have a buffer of their own.
+         */
+        LevelCommandBuffer& GetCommandBuffer();
 
-        const std::unordered_map<UUID, std::weak_ptr<GameObject>>& GetAllVisibles() const { return m_visibles; }
+        /**
+         * @brief Apply all recorded commands. Tick does this at the end of the component tick, call it directly to
+         * apply commands recorded outside of a tick right away.
+         */
+        void PlaybackCommandBuffers();
+
+        /**
+         * @brief Resolve a handle, nullptr if the handle is stale or invalid.
+         */
+        GameObject* GetGameObject(GameObjectHandle handle) const
+        {
+            if (handle.index >= m_slots.size() || m_slots[handle.index].generation != handle.generation ||
+                m_slots[handle.index].dense_index == k_free_slot)
+                return nullptr;
+
+            return m_gameobjects[m_slots[handle.index].dense_index].get();
+        }
+
+        /**
+         * @brief Handle of the object with a persistent id, invalid handle if there is no such object.
+         */
+        GameObjectHandle GetHandleByID(UUID go_id) const;
 
         std::weak_ptr<GameObject> GetGameObjectByID(UUID go_id) const;
 
-        UUID CreateObject();
-        void DeleteGameObjectByID(UUID go_id) { m_gameobjects.erase(go_id); }
+        void DeleteGameObjectByID(UUID go_id) { DestroyObject(GetHandleByID(go_id)); }
+
+        /**
+         * @brief All game objects, densely packed in no particular order.
+         */
+        const std::vector<std::shared_ptr<GameObject>>& GetAllGameObjects() const { return m_gameobjects; }
+
+        /**
+         * @brief Handles of the objects that passed frustum and occlusion culling in the last tick, ordered by their
+         * transform hierarchy ids, so the same objects are always in the same order.
+         */
+        std::span<const GameObjectHandle> GetVisibleHandles() const { return m_visibles; }
+
+        /**
+         * @brief Meshes of the visible objects that passed culling on their own in the last tick, in the order of
+         * GetVisibleHandles. Models with a single mesh are not tested again.
+         *
+         * Valid until the next tick. Built in storage kept across ticks, so it does not allocate in steady state.
+         */
+        std::span<const VisibleMesh> GetVisibleMeshes() const { return m_visible_meshes; }
+
+        /**
+         * @brief Ranges of the index buffer of a visible mesh left by meshlet culling, to be drawn instead of its
+         * level of detail. Empty if its meshlets were not culled.
+         */
+        std::span<const IndexRange> GetIndexRanges(const VisibleMesh& visible_mesh) const
+        {
+            return std::span<const IndexRange>(m_index_ranges)
+                .subspan(visible_mesh.first_index_range, visible_mesh.index_range_count);
+        }
+
+        /**
+         * @brief World matrix of a visible mesh, that of its object times that of its node in the model, as culled.
+         */
+        glm::mat4 GetMeshMatrix(const VisibleMesh& visible_mesh) const;
+
+        /**
+         * @brief Indices of GetVisibleMeshes grouped by batch, the order in which instanced draws read their data.
+         *
+         * Meshes of the same model mesh at the same level of detail share a batch, meshes drawn by index ranges get
+         * one of their own. Render passes draw all meshes with their own material, so it is not part of the key.
+         */
+        std::span<const uint32_t> GetInstancedMeshes() const { return m_instanced_meshes; }
+
+        /**
+         * @brief Batches of the last tick in the order of GetInstancedMeshes, one instanced draw each.
+         */
+        std::span<const InstanceBatch> GetInstanceBatches() const { return m_instance_batches; }
+
+        void               SetLodSettings(const LodSettings& settings) { m_lod_settings = settings; }
+        const LodSettings& GetLodSettings() const { return m_lod_settings; }
+
+        void             SetMainCamera(GameObjectHandle handle) { m_main_camera = handle; }
+        GameObjectHandle GetMainCamera() const { return m_main_camera; }
+
+        ComponentStorage& GetComponentStorage() { return m_component_storage; }
+
+        TransformHierarchy&       GetTransformHierarchy() { return m_transform_hierarchy; }
+        const TransformHierarchy& GetTransformHierarchy() const { return m_transform_hierarchy; }
+
+        /**
+         * @brief World bounds of all objects with a transform and a model, as of the last tick. The user data of a
+         * proxy is the transform hierarchy id of its object.
+         */
+        const DynamicBoundingBoxTree& GetSpatialTree() const { return m_spatial_tree; }
+
+        /**
+         * @brief Transform hierarchy ids whose bounds changed in the last tick, as applied to the spatial tree. Ids may
+         * repeat. For renderers keeping their own copy of the bounds, which have to read them after every tick and
+         * start over when GetTickCount shows that they missed one.
+         */
+        std::span<const uint32_t> GetChangedBoundsIds() const { return m_changed_bounds_ids; }
+
+        /**
+         * @brief Transform hierarchy ids whose bounds were removed in the last tick. They may have been reused by ids
+         * of GetChangedBoundsIds since, so apply removals first.
+         */
+        std::span<const uint32_t> GetRemovedBoundsIds() const { return m_removed_bounds_ids; }
+
+        /**
+         * @brief Closest triangle of an object with a model that the ray hits before max_distance.
+         *
+         * Candidates come from the spatial tree as of the last tick, nearest first, and their meshes are tested
+         * through the triangle BVHs built at import. May be called from several threads while the level is not
+         * ticking.
+         */
+        bool Raycast(const Ray& ray, float max_distance, RaycastHit& hit) const;
+
+        /**
+         * @brief Fill hits with the closest hit of every object the ray hits before max_distance, nearest first.
+         */
+        void RaycastAll(const Ray& ray, float max_distance, std::vector<RaycastHit>& hits) const;
+
+        /**
+         * @brief Rasterize the model of an object into the occlusion buffer every tick, it should be large and cheap
+         * like a wall or terrain. Occluders are culled by the frustum like other objects but never by occlusion.
+         */
+        void AddOccluder(GameObjectHandle handle);
+
+        void RemoveOccluder(GameObjectHandle handle);
 
-        void       SetMainCameraID(UUID go_id) { m_main_camera_id = go_id; }
-        const UUID GetMainCameraID() const { return m_main_camera_id; }
+        const std::vector<GameObjectHandle>& GetOccluders() const { return m_occluders; }
+
+        /**
+         * @brief Cull the objects that passed frustum culling against a depth buffer of the occluders, on by default.
+         */
+        void SetOcclusionCulling(bool enabled) { m_is_occlusion_culling_enabled = enabled; }
+        bool IsOcclusionCullingEnabled() const { return m_is_occlusion_culling_enabled; }
+
+        /**
+         * @brief Number of objects that passed frustum culling but were hidden behind occluders in the last tick.
+         */
+        uint32_t GetOcclusionCulledCount() const { return m_occlusion_culled_count; }
+
+        /**
+         * @brief Depth buffer of the occluders as of the last tick, for debug views.
+         */
+        const OcclusionBuffer& GetOcclusionBuffer() const { return m_occlusion_buffer; }
+
+        /**
+         * @brief Cull the meshlets of visible meshes drawn at full resolution by the frustum and by their normal cones,
+         * on by default.
+         */
+        void SetMeshletCulling(bool enabled) { m_is_meshlet_culling_enabled = enabled; }
+        bool IsMeshletCullingEnabled() const { return m_is_meshlet_culling_enabled; }
+
+        /**
+         * @brief Number of meshlets of visible meshes that were culled in the last tick.
+         */
+        uint32_t GetMeshletCulledCount() const { return m_meshlet_culled_count; }
+
+        /**
+         * @brief Cull against the main camera and build the draw lists every tick, on by default. Renderers culling on
+         * the GPU turn it off, the draw lists stay empty then.
+         */
+        void SetCpuCulling(bool enabled) { m_is_cpu_culling_enabled = enabled; }
+        bool IsCpuCullingEnabled() const { return m_is_cpu_culling_enabled; }
 
     private:
+        static constexpr uint32_t k_free_slot = ~0u;
+
+        // boxes culled per job, a multiple of Frustum::k_cull_block_size
+        static constexpr uint32_t k_cull_batch_size = Frustum::k_cull_block_size * 64;
+
+        // boxes tested against the occlusion buffer per job
+        static constexpr uint32_t k_occlusion_batch_size = 256;
+
+        // meshes whose meshlets are culled per job
+        static constexpr uint32_t k_meshlet_cull_batch_size = 16;
+
+        struct Slot
+        {
+            uint32_t dense_index = k_free_slot;
+            uint32_t generation  = 0;
+        };
+
+        /**
+         * @brief Insert, move and remove proxies for the transforms whose bounds changed in the last update.
+         */
+        void UpdateSpatialTree();
+
+        /**
+         * @brief Empty the draw lists, for ticks that do not cull on the CPU.
+         */
+        void ClearDrawLists();
+
         void FrustumCulling();
 
-        std::unordered_map<UUID, std::shared_ptr<GameObject>> m_gameobjects;
-        std::unordered_map<UUID, std::weak_ptr<GameObject>>   m_visibles;
+        /**
+         * @brief Remove the visible objects that are hidden behind occluders from the camera of the last tick.
+         */
+        void OcclusionCulling();
+
+        /**
+         * @brief Fill the draw list with the meshes of the visible objects, culling the meshes of models with several
+         * meshes by their own bounds.
+         */
+        void MeshCulling();
+
+        /**
+         * @brief Pick the coarsest level of detail of each visible object whose error covers at most
+         * LodSettings::pixel_error pixels, switching to coarser levels only with a margin.
+         */
+        void SelectLods();
+
+        /**
+         * @brief Replace the visible meshes drawn at full resolution by the index ranges of their visible meshlets,
+         * dropping meshes none of which are visible.
+         */
+        void MeshletCulling();
+
+        /**
+         * @brief Group the draw list into batches of meshes that can be drawn with one instanced draw.
+         */
+        void BatchInstances();
+
+        /**
+         * @brief Closest hit of the ray with the model meshes of the object owning a transform hierarchy node.
+         */
+        bool RaycastObject(uint32_t hierarchy_id, const Ray& ray, float max_distance, RaycastHit& hit) const;
+
+        void ResizeCommandBuffers();
+
+        /**
+         * @brief Reserve level containers and component chunks for everything the recorded commands create.
+         */
+        void ReservePlayback();
+
+        void CreatePendingObject(LevelCommandBuffer& buffer, uint32_t pending_index);
+
+        /**
+         * @brief Move the collected playback components into gameobject, then set their parent and start them.
+         */
+        void AddPlaybackComponents(GameObject& gameobject);
+
+        // declared before the component storage, transform components remove their node on destruction
+        TransformHierarchy m_transform_hierarchy;
+
+        // declared before game objects, which release their components on destruction
+        ComponentStorage m_component_storage;
+
+        std::vector<Slot>                        m_slots;
+        std::vector<uint32_t>                    m_free_slots;
+        std::vector<std::shared_ptr<GameObject>> m_gameobjects;
+        std::vector<GameObjectHandle>            m_dense_handles;
+
+        std::unordered_map<UUID, GameObjectHandle> m_handles_by_id;
+
+        std::vector<GameObjectHandle> m_visibles;
+        std::vector<uint32_t>         m_visible_ids; // transform hierarchy id of each visible object
+
+        DynamicBoundingBoxTree m_spatial_tree;
+        std::vector<uint32_t>  m_spatial_proxies; // indexed by transform hierarchy id
+
+        // bounds changes of the last tick, the hierarchy forgets its own once the spatial tree applied them
+        std::vector<uint32_t> m_changed_bounds_ids;
+        std::vector<uint32_t> m_removed_bounds_ids;
+
+        // scratch space of FrustumCulling, kept to avoid allocations
+        std::vector<uint32_t>         m_cull_inside_ids;
+        std::vector<uint32_t>         m_cull_intersecting_ids;
+        BoundingBoxSoA                m_cull_bounds;
+        std::vector<GameObjectHandle> m_cull_handles;
+        std::vector<uint8_t>          m_cull_visibility;
+        std::vector<uint8_t>          m_cull_last_planes;
+        std::vector<uint8_t>          m_cull_planes_by_slot;
+
+        OcclusionBuffer               m_occlusion_buffer;
+        std::vector<GameObjectHandle> m_occluders;
+        uint32_t                      m_occlusion_culled_count       = 0;
+        bool                          m_is_occlusion_culling_enabled = true;
+        bool                          m_is_occlusion_buffer_current  = false; // rasterized in the last tick
+
+        // scratch space of OcclusionCulling, kept to avoid allocations
+        std::vector<uint8_t> m_occlusion_visibility;
+        std::vector<uint8_t> m_occluder_by_slot;
+
+        std::vector<VisibleMesh> m_visible_meshes;
+
+        LodSettings          m_lod_settings;
+        std::vector<uint8_t> m_lod_by_slot; // level of detail of each object in its last visible tick
+
+        // scratch space of MeshCulling, meshes of models with several meshes and their index in the draw list
+        BoundingBoxSoA        m_mesh_cull_bounds;
+        std::vector<uint32_t> m_mesh_cull_indices;
+        std::vector<uint8_t>  m_mesh_cull_occludable;
+        std::vector<uint8_t>  m_mesh_cull_visibility;
+
+        std::vector<IndexRange> m_index_ranges;
+        uint32_t                m_meshlet_culled_count       = 0;
+        bool                    m_is_meshlet_culling_enabled = true;
+
+        // scratch space of MeshletCulling, meshes whose meshlets are culled and where their visibility starts
+        struct MeshletCullMesh
+        {
+            uint32_t         visible_index;
+            uint32_t         first_meshlet;
+            const ModelMesh* mesh;
+        };
+        std::vector<MeshletCullMesh> m_meshlet_cull_meshes;
+        std::vector<uint8_t>         m_meshlet_visibility;
+
+        std::vector<uint32_t>      m_instanced_meshes;
+        std::vector<InstanceBatch> m_instance_batches;
+
+        // scratch space of BatchInstances, the batch key of each visible mesh
+        struct InstanceKey
+        {
+            const ModelMesh* mesh;
+            uint32_t         lod_index;
+            uint32_t         visible_index;
+        };
+        std::vector<InstanceKey> m_instance_keys;
+
+        GameObjectHandle m_main_camera;
+
+        std::vector<std::unique_ptr<LevelCommandBuffer>> m_command_buffers;
+
+        // scratch space of PlaybackCommandBuffers, kept to avoid allocations
+        struct PlaybackCommand
+        {
+            uint32_t batch_key;
+            uint32_t buffer_index;
+            uint32_t command_index;
+        };
+
+        std::vector<PlaybackCommand>                       m_playback_commands;
+        std::vector<LevelCommandBuffer::PendingComponent*> m_playback_components;
+        std::vector<const ComponentTypeInfo*>              m_playback_types;
+        std::vector<void*>                                 m_playback_values;
 
-        UUID m_main_camera_id;
+        UUID          m_id;
+        uint64_t      m_tick_count             = 0;
+        LevelTickMode m_tick_mode              = LevelTickMode::Parallel;
+        bool          m_is_cpu_culling_enabled = true;
     };
 } // namespace Meow
@@ -0,0 +1,89 @@
+#include "level_command_buffer.h"
+
+#include "pch.h"
+
+#include "core/base/alignment.h"
+#include "function/object/component_storage.h"
+
+#include <algorithm>
+
+namespace Meow
+{
+    LevelCommandBuffer::~LevelCommandBuffer()
+    {
+        Clear();
+
+        for (const Page& page : m_pages)
+        {
+            ::operator delete(page.data, std::align_val_t {k_page_alignment});
+        }
+    }
+
+    LevelCommandBuffer::PendingObject LevelCommandBuffer::CreateObject(std::string name)
+    {
+        uint32_t pending_index = static_cast<uint32_t>(m_pending_objects.size());
+        m_pending_objects.push_back({std::move(name)});
+
+        Command& command       = PushCommand(CommandType::CreateObject);
+        command.pending_object = pending_index;
+
+        return {pending_index};
+    }
+
+    void LevelCommandBuffer::DestroyObject(GameObjectHandle handle)
+    {
+        Command& command = PushCommand(CommandType::DestroyObject);
+        command.handle   = handle;
+    }
+
+    void LevelCommandBuffer::Clear()
+    {
+        // values which have been played back are moved into the component storage and already destroyed
+        for (PendingComponent& pending_component : m_pending_components)
+        {
+            if (pending_component.value)
+                pending_component.destruct(pending_component.value);
+        }
+
+        m_commands.clear();
+        m_pending_objects.clear();
+        m_pending_components.clear();
+
+        m_page_index  = 0;
+        m_page_offset = 0;
+    }
+
+    LevelCommandBuffer::Command& LevelCommandBuffer::PushCommand(CommandType type)
+    {
+        Command& command  = m_commands.emplace_back();
+        command.type      = type;
+        command.batch_key = ComponentStorage::GetCurrentBatchIndex();
+        return command;
+    }
+
+    void* LevelCommandBuffer::Allocate(std::size_t size, std::size_t alignment)
+    {
+        while (m_page_index < m_pages.size())
+        {
+            std::size_t offset = Align(m_page_offset, alignment);
+            if (offset + size <= m_pages[m_page_index].size)
+            {
+                m_page_offset = offset + size;
+                return m_pages[m_page_index].data + offset;
+            }
+
+            ++m_page_index;
+            m_page_offset = 0;
+        }
+
+        // a value larger than a page gets a page of its own
+        Page page;
+        page.size = std::max(k_page_size, Align(size, k_page_alignment));
+        page.data = static_cast<std::byte*>(::operator new(page.size, std::align_val_t {k_page_alignment}));
+        m_pages.push_back(page);
+
+        m_page_index  = m_pages.size() - 1;
+        m_page_offset = size;
+        return page.data;
+    }
+} // namespace Meow
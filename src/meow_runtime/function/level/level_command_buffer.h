@@ -0,0 +1,180 @@
+#pragma once
+
+#include "core/base/non_copyable.h"
+#include "function/object/component_type_info.h"
+#include "function/object/game_object_handle.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Meow
+{
+    class Level;
+
+    /**
+     * @brief Records structural changes of a level, which are played back in bulk at the next sync point.
+     *
+     * Every thread of the job system records into its own buffer, so recording needs no locks. Commands are played
+     * back ordered by the tick batch that recorded them, which keeps the result independent of the thread count.
+     * Component values are moved into a page arena that is kept between frames, so steady state spawning does not
+     * allocate per component.
+     */
+    class LevelCommandBuffer : public NonCopyable
+    {
+    public:
+        /**
+         * @brief Placeholder for an object created by this buffer. Only valid for this buffer until its playback.
+         */
+        struct PendingObject
+        {
+            uint32_t index;
+        };
+
+        LevelCommandBuffer() = default;
+        ~LevelCommandBuffer() override;
+
+        PendingObject CreateObject(std::string name = {});
+
+        void DestroyObject(GameObjectHandle handle);
+
+        /**
+         * @brief Components of a pending object are placed directly into the archetype holding all of them, and are
+         * started in recording order after all of them have been added.
+         */
+        template<typename TComponent>
+        void AddComponent(PendingObject pending_object, const std::string& component_type_name, TComponent component)
+        {
+            uint32_t component_index = static_cast<uint32_t>(m_pending_components.size());
+            m_pending_components.push_back(RecordComponent<TComponent>(component_type_name, std::move(component)));
+
+            PendingObjectRecord& record = m_pending_objects[pending_object.index];
+            if (record.last_component == k_none)
+                record.first_component = component_index;
+            else
+                m_pending_components[record.last_component].next = component_index;
+            record.last_component = component_index;
+        }
+
+        template<typename TComponent>
+        void AddComponent(GameObjectHandle handle, const std::string& component_type_name, TComponent component)
+        {
+            Command& command   = PushCommand(CommandType::AddComponent);
+            command.handle     = handle;
+            command.components = static_cast<uint32_t>(m_pending_components.size());
+            m_pending_components.push_back(RecordComponent<TComponent>(component_type_name, std::move(component)));
+        }
+
+        template<typename TComponent>
+        void RemoveComponent(GameObjectHandle handle)
+        {
+            Command& command    = PushCommand(CommandType::RemoveComponent);
+            command.handle      = handle;
+            command.remove_type = ComponentTypeRegistry::instance().Find<TComponent>();
+        }
+
+        bool IsEmpty() const { return m_commands.empty(); }
+
+        /**
+         * @brief Drop all recorded commands, destroying component values that have not been played back.
+         */
+        void Clear();
+
+    private:
+        friend class Level;
+
+        static constexpr uint32_t    k_none           = ~0u;
+        static constexpr std::size_t k_page_size      = 64 * 1024;
+        static constexpr std::size_t k_page_alignment = 64;
+
+        enum class CommandType : unsigned char
+        {
+            CreateObject,
+            DestroyObject,
+            AddComponent,
+            RemoveComponent
+        };
+
+        struct Command
+        {
+            CommandType type;
+
+            // tick batch the command was recorded in, playback is ordered by it
+            uint32_t batch_key;
+
+            GameObjectHandle         handle;
+            uint32_t                 pending_object = k_none;
+            uint32_t                 components     = k_none;
+            const ComponentTypeInfo* remove_type    = nullptr;
+        };
+
+        using RegisterFunction = const ComponentTypeInfo& (*)(const std::string& component_type_name);
+
+        /**
+         * @brief A component value in the arena.
+         *
+         * Registering a component type while other threads tick is not safe, so types seen for the first time keep
+         * their name and are registered on playback.
+         */
+        struct PendingComponent
+        {
+            void* value = nullptr;
+            void (*destruct)(void* ptr) = nullptr;
+
+            const ComponentTypeInfo* type_info     = nullptr;
+            RegisterFunction         register_type = nullptr;
+            std::string              type_name;
+
+            uint32_t next = k_none;
+        };
+
+        struct PendingObjectRecord
+        {
+            std::string name;
+            uint32_t    first_component = k_none;
+            uint32_t    last_component  = k_none;
+        };
+
+        template<typename TComponent>
+        PendingComponent RecordComponent(const std::string& component_type_name, TComponent&& component)
+        {
+            static_assert(alignof(TComponent) <= k_page_alignment, "Component alignment is too large");
+
+            PendingComponent pending_component;
+            pending_component.value =
+                new (Allocate(sizeof(TComponent), alignof(TComponent))) TComponent(std::move(component));
+            pending_component.destruct  = [](void* ptr) { static_cast<TComponent*>(ptr)->~TComponent(); };
+            pending_component.type_info = ComponentTypeRegistry::instance().Find<TComponent>();
+            if (!pending_component.type_info)
+            {
+                pending_component.register_type = [](const std::string& type_name) -> const ComponentTypeInfo& {
+                    return ComponentTypeRegistry::instance().Register<TComponent>(type_name);
+                };
+                pending_component.type_name = component_type_name;
+            }
+            return pending_component;
+        }
+
+        Command& PushCommand(CommandType type);
+
+        void* Allocate(std::size_t size, std::size_t alignment);
+
+        struct Page
+        {
+            std::byte*  data = nullptr;
+            std::size_t size = 0;
+        };
+
+        std::vector<Command>             m_commands;
+        std::vector<PendingObjectRecord> m_pending_objects;
+        std::vector<PendingComponent>    m_pending_components;
+
+        // pages are kept when the buffer is cleared
+        std::vector<Page> m_pages;
+        std::size_t       m_page_index  = 0;
+        std::size_t       m_page_offset = 0;
+    };
+} // namespace Meow
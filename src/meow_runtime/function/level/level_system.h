@@ -17,6 +17,16 @@ namespace Meow
 
         void Tick(float dt) override;
 
+        SystemResources GetReadResources() const override
+        {
+            return SystemResources(SystemResourceBit::Time) | SystemResourceBit::Input | SystemResourceBit::Resources;
+        }
+
+        SystemResources GetWriteResources() const override
+        {
+            return SystemResources(SystemResourceBit::Level) | SystemResourceBit::Transform;
+        }
+
         std::weak_ptr<Level> GetCurrentActiveLevel() const { return m_current_active_level; }
 
     private:
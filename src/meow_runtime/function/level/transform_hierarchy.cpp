@@ -0,0 +1,374 @@
+#include "transform_hierarchy.h"
+
+#include "pch.h"
+
+#include "function/components/transform/transform_3d_component.hpp"
+#include "function/global/runtime_context.h"
+#include "function/level/level.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace Meow
+{
+    TransformHierarchy::TransformHierarchy() { ResizeDirtyLists(); }
+
+    uint32_t TransformHierarchy::Add(GameObjectHandle owner)
+    {
+        uint32_t id;
+        if (m_free_ids.empty())
+        {
+            id = static_cast<uint32_t>(m_positions.size());
+            m_positions.push_back(k_invalid_position);
+            m_parent_ids.push_back(k_invalid_id);
+            m_child_counts.push_back(0);
+            m_dirty_flags.push_back(0);
+        }
+        else
+        {
+            id = m_free_ids.back();
+            m_free_ids.pop_back();
+        }
+
+        // a new root does not break the breadth first order, so it is appended without rebuilding
+        m_positions[id] = static_cast<uint32_t>(m_ids.size());
+        m_ids.push_back(id);
+        m_parent_positions.push_back(k_invalid_position);
+        m_first_child_positions.push_back(k_invalid_position);
+        m_child_position_counts.push_back(0);
+        m_owners.push_back(owner);
+        m_local_matrices.emplace_back(1.0f);
+        m_world_matrices.emplace_back(1.0f);
+        m_update_stamps.push_back(0);
+        m_has_bounds.push_back(0);
+        m_local_bounds_centers.emplace_back(0.0f);
+        m_local_bounds_extents.emplace_back(0.0f);
+        m_world_bounds_centers.emplace_back(0.0f);
+        m_world_bounds_extents.emplace_back(0.0f);
+
+        m_node_count++;
+
+        MarkDirty(id);
+        return id;
+    }
+
+    void TransformHierarchy::Remove(uint32_t id)
+    {
+        uint32_t position = m_positions[id];
+        if (position == k_invalid_position)
+            return;
+
+        if (m_parent_ids[id] != k_invalid_id)
+            m_child_counts[m_parent_ids[id]]--;
+
+        if (m_child_counts[id] > 0)
+        {
+            for (uint32_t child_id = 0; child_id < m_parent_ids.size(); ++child_id)
+            {
+                if (m_parent_ids[child_id] == id)
+                {
+                    m_parent_ids[child_id] = k_invalid_id;
+                    MarkDirty(child_id);
+                }
+            }
+            m_is_structure_dirty = true;
+        }
+
+        // leave a hole, a leaf can be removed without reordering
+        if (m_has_bounds[position])
+            m_removed_bounds_ids.push_back(id);
+
+        m_ids[position]        = k_invalid_id;
+        m_owners[position]     = GameObjectHandle {};
+        m_has_bounds[position] = 0;
+
+        m_positions[id]    = k_invalid_position;
+        m_parent_ids[id]   = k_invalid_id;
+        m_child_counts[id] = 0;
+        m_dirty_flags[id]  = 0;
+        m_free_ids.push_back(id);
+
+        m_node_count--;
+        m_hole_count++;
+
+        if (m_hole_count > m_node_count)
+            m_is_structure_dirty = true;
+    }
+
+    bool TransformHierarchy::SetParent(uint32_t id, uint32_t parent_id)
+    {
+        for (uint32_t ancestor_id = parent_id; ancestor_id != k_invalid_id; ancestor_id = m_parent_ids[ancestor_id])
+        {
+            if (ancestor_id == id)
+                return false;
+        }
+
+        if (m_parent_ids[id] == parent_id)
+            return true;
+
+        if (m_parent_ids[id] != k_invalid_id)
+            m_child_counts[m_parent_ids[id]]--;
+        if (parent_id != k_invalid_id)
+            m_child_counts[parent_id]++;
+
+        m_parent_ids[id]     = parent_id;
+        m_is_structure_dirty = true;
+
+        MarkDirty(id);
+        return true;
+    }
+
+    void TransformHierarchy::MarkDirty(uint32_t id)
+    {
+        if (m_dirty_flags[id])
+            return;
+
+        m_dirty_flags[id] = 1;
+
+        uint32_t thread_index =
+            g_runtime_context.job_system ? g_runtime_context.job_system->GetCurrentThreadIndex() : 0;
+
+        ASSERT(thread_index < m_dirty_ids.size());
+        m_dirty_ids[thread_index].push_back(id);
+    }
+
+    void TransformHierarchy::SetLocalBounds(uint32_t id, const BoundingBox& bounds)
+    {
+        uint32_t position = m_positions[id];
+        if (position == k_invalid_position)
+            return;
+
+        m_has_bounds[position]           = 1;
+        m_local_bounds_centers[position] = (bounds.min + bounds.max) * 0.5f;
+        m_local_bounds_extents[position] = (bounds.max - bounds.min) * 0.5f;
+
+        // a dirty node gets its world bounds in the next Update, together with its world matrix
+        if (!m_dirty_flags[id])
+        {
+            UpdateWorldBounds(position);
+            m_changed_bounds_ids.push_back(id);
+        }
+    }
+
+    bool TransformHierarchy::GetWorldBounds(uint32_t id, BoundingBox& bounds) const
+    {
+        uint32_t position = m_positions[id];
+        if (position == k_invalid_position || !m_has_bounds[position])
+            return false;
+
+        bounds = BoundingBox(m_world_bounds_centers[position] - m_world_bounds_extents[position],
+                             m_world_bounds_centers[position] + m_world_bounds_extents[position]);
+        return true;
+    }
+
+    void TransformHierarchy::ClearBoundsChanges()
+    {
+        m_changed_bounds_ids.clear();
+        m_removed_bounds_ids.clear();
+    }
+
+    void TransformHierarchy::Update(const Level& level)
+    {
+        FUNCTION_TIMER();
+
+        ResizeDirtyLists();
+
+        if (m_is_structure_dirty)
+            Rebuild();
+
+        if (++m_update_stamp == 0)
+        {
+            std::fill(m_update_stamps.begin(), m_update_stamps.end(), 0);
+            m_update_stamp = 1;
+        }
+
+        m_update_queue.clear();
+        for (std::vector<uint32_t>& dirty_ids : m_dirty_ids)
+        {
+            for (uint32_t id : dirty_ids)
+            {
+                uint32_t position = m_positions[id];
+                if (position == k_invalid_position)
+                    continue;
+
+                if (m_dirty_flags[id])
+                {
+                    m_dirty_flags[id] = 0;
+
+                    GameObject* gameobject = level.GetGameObject(m_owners[position]);
+                    if (Transform3DComponent* transform = gameobject ? gameobject->GetComponent<Transform3DComponent>()
+                                                                     : nullptr)
+                    {
+                        if (m_update_mode == TransformUpdateMode::Batched)
+                        {
+                            m_dirty_transforms.Push(transform->position, transform->rotation, transform->scale);
+                            m_dirty_positions.push_back(position);
+                        }
+                        else
+                        {
+                            m_local_matrices[position] = transform->GetTransform();
+                        }
+                    }
+                }
+
+                m_update_queue.push_back(position);
+            }
+            dirty_ids.clear();
+        }
+
+        if (!m_dirty_positions.empty())
+        {
+            ComposeTransforms(m_dirty_transforms, m_dirty_positions, m_local_matrices.data());
+            m_dirty_transforms.Clear();
+            m_dirty_positions.clear();
+        }
+
+        // parents come before their children, so popping the smallest position first sees every parent updated
+        std::make_heap(m_update_queue.begin(), m_update_queue.end(), std::greater<uint32_t>());
+
+        m_last_update_count = 0;
+        while (!m_update_queue.empty())
+        {
+            std::pop_heap(m_update_queue.begin(), m_update_queue.end(), std::greater<uint32_t>());
+            uint32_t position = m_update_queue.back();
+            m_update_queue.pop_back();
+
+            if (m_update_stamps[position] == m_update_stamp || m_ids[position] == k_invalid_id)
+                continue;
+            m_update_stamps[position] = m_update_stamp;
+
+            uint32_t parent_position = m_parent_positions[position];
+            m_world_matrices[position] =
+                parent_position == k_invalid_position ?
+                    m_local_matrices[position] :
+                    m_world_matrices[parent_position] * m_local_matrices[position];
+            m_last_update_count++;
+
+            if (m_has_bounds[position])
+            {
+                UpdateWorldBounds(position);
+                m_changed_bounds_ids.push_back(m_ids[position]);
+            }
+
+            uint32_t first_child = m_first_child_positions[position];
+            for (uint32_t child = 0; child < m_child_position_counts[position]; ++child)
+            {
+                m_update_queue.push_back(first_child + child);
+                std::push_heap(m_update_queue.begin(), m_update_queue.end(), std::greater<uint32_t>());
+            }
+        }
+    }
+
+    void TransformHierarchy::Rebuild()
+    {
+        FUNCTION_TIMER();
+
+        uint32_t id_count = static_cast<uint32_t>(m_positions.size());
+
+        // children of every id, grouped by parent and sorted by id
+        std::vector<uint32_t> child_offsets(id_count + 1, 0);
+        for (uint32_t id = 0; id < id_count; ++id)
+        {
+            if (m_positions[id] != k_invalid_position && m_parent_ids[id] != k_invalid_id)
+                child_offsets[m_parent_ids[id] + 1]++;
+        }
+        for (uint32_t id = 0; id < id_count; ++id)
+        {
+            child_offsets[id + 1] += child_offsets[id];
+        }
+
+        std::vector<uint32_t> children(child_offsets[id_count]);
+        std::vector<uint32_t> child_cursors(child_offsets.begin(), child_offsets.end() - 1);
+        for (uint32_t id = 0; id < id_count; ++id)
+        {
+            if (m_positions[id] != k_invalid_position && m_parent_ids[id] != k_invalid_id)
+                children[child_cursors[m_parent_ids[id]]++] = id;
+        }
+
+        // breadth first order, roots first
+        std::vector<uint32_t> order;
+        order.reserve(m_node_count);
+        for (uint32_t id = 0; id < id_count; ++id)
+        {
+            if (m_positions[id] != k_invalid_position && m_parent_ids[id] == k_invalid_id)
+                order.push_back(id);
+        }
+
+        std::vector<uint32_t> first_child_positions(m_node_count, k_invalid_position);
+        std::vector<uint32_t> child_position_counts(m_node_count, 0);
+        for (uint32_t position = 0; position < order.size(); ++position)
+        {
+            uint32_t id                      = order[position];
+            first_child_positions[position]  = static_cast<uint32_t>(order.size());
+            child_position_counts[position]  = child_offsets[id + 1] - child_offsets[id];
+            order.insert(order.end(), children.begin() + child_offsets[id], children.begin() + child_offsets[id + 1]);
+        }
+
+        std::vector<uint32_t>         parent_positions(m_node_count, k_invalid_position);
+        std::vector<GameObjectHandle> owners(m_node_count);
+        std::vector<glm::mat4>        local_matrices(m_node_count);
+        std::vector<glm::mat4>        world_matrices(m_node_count);
+        std::vector<uint8_t>          has_bounds(m_node_count);
+        std::vector<glm::vec3>        local_bounds_centers(m_node_count);
+        std::vector<glm::vec3>        local_bounds_extents(m_node_count);
+        std::vector<glm::vec3>        world_bounds_centers(m_node_count);
+        std::vector<glm::vec3>        world_bounds_extents(m_node_count);
+        for (uint32_t position = 0; position < m_node_count; ++position)
+        {
+            uint32_t old_position          = m_positions[order[position]];
+            owners[position]               = m_owners[old_position];
+            local_matrices[position]       = m_local_matrices[old_position];
+            world_matrices[position]       = m_world_matrices[old_position];
+            has_bounds[position]           = m_has_bounds[old_position];
+            local_bounds_centers[position] = m_local_bounds_centers[old_position];
+            local_bounds_extents[position] = m_local_bounds_extents[old_position];
+            world_bounds_centers[position] = m_world_bounds_centers[old_position];
+            world_bounds_extents[position] = m_world_bounds_extents[old_position];
+        }
+        for (uint32_t position = 0; position < m_node_count; ++position)
+        {
+            m_positions[order[position]] = position;
+        }
+        for (uint32_t position = 0; position < m_node_count; ++position)
+        {
+            uint32_t parent_id = m_parent_ids[order[position]];
+            if (parent_id != k_invalid_id)
+                parent_positions[position] = m_positions[parent_id];
+        }
+
+        m_ids                   = std::move(order);
+        m_parent_positions      = std::move(parent_positions);
+        m_first_child_positions = std::move(first_child_positions);
+        m_child_position_counts = std::move(child_position_counts);
+        m_owners                = std::move(owners);
+        m_local_matrices        = std::move(local_matrices);
+        m_world_matrices        = std::move(world_matrices);
+        m_has_bounds            = std::move(has_bounds);
+        m_local_bounds_centers  = std::move(local_bounds_centers);
+        m_local_bounds_extents  = std::move(local_bounds_extents);
+        m_world_bounds_centers  = std::move(world_bounds_centers);
+        m_world_bounds_extents  = std::move(world_bounds_extents);
+        m_update_stamps.assign(m_node_count, 0);
+
+        m_hole_count         = 0;
+        m_is_structure_dirty = false;
+    }
+
+    void TransformHierarchy::UpdateWorldBounds(uint32_t position)
+    {
+        // the extent along each world axis is the sum of the local extents projected onto it
+        const glm::mat4& matrix          = m_world_matrices[position];
+        const glm::vec3& extent          = m_local_bounds_extents[position];
+        m_world_bounds_centers[position] = glm::vec3(matrix * glm::vec4(m_local_bounds_centers[position], 1.0f));
+        m_world_bounds_extents[position] = glm::abs(glm::vec3(matrix[0])) * extent.x +
+                                           glm::abs(glm::vec3(matrix[1])) * extent.y +
+                                           glm::abs(glm::vec3(matrix[2])) * extent.z;
+    }
+
+    void TransformHierarchy::ResizeDirtyLists()
+    {
+        std::size_t thread_count = g_runtime_context.job_system ? g_runtime_context.job_system->GetThreadCount() : 1;
+        if (m_dirty_ids.size() < thread_count)
+            m_dirty_ids.resize(thread_count);
+    }
+} // namespace Meow
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "core/base/non_copyable.h"
+#include "core/math/bounding_box.h"
+#include "core/math/transform_soa.h"
+#include "function/object/game_object_handle.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Meow
+{
+    class Level;
+
+    enum class TransformUpdateMode : unsigned char
+    {
+        PerObject, // compose each dirty local matrix with glm
+        Batched    // gather dirty transforms into structure of arrays form and compose them with SIMD kernels
+    };
+
+    /**
+     * @brief Parent links and cached local and world matrices of all transforms in a level.
+     *
+     * Nodes are addressed by stable ids. Matrices live in contiguous arrays in breadth first order, so a parent is
+     * always stored before its children and the children of a node are adjacent. Changed transforms are marked dirty
+     * and Update recomputes exactly the dirty nodes and their subtrees, in array order. Transforms which do not
+     * change cost nothing per frame.
+     *
+     * Nodes may also carry the bounds of what their owner renders. The world bounds are recomputed together with the
+     * world matrix, so culling only reads them.
+     */
+    class TransformHierarchy : public NonCopyable
+    {
+    public:
+        static constexpr uint32_t k_invalid_id = ~0u;
+
+        TransformHierarchy();
+
+        /**
+         * @brief Add a root node for the transform of owner, dirty until the next Update.
+         */
+        uint32_t Add(GameObjectHandle owner);
+
+        /**
+         * @brief Remove a node. Its children become roots, keeping their local transform.
+         */
+        void Remove(uint32_t id);
+
+        /**
+         * @brief Attach a node to a parent, k_invalid_id makes it a root. The local transform of the node is kept
+         * and becomes relative to the new parent. Returns false if parent_id is the node itself or a descendant.
+         */
+        bool SetParent(uint32_t id, uint32_t parent_id);
+
+        /**
+         * @brief False for ids that were removed and not reused since.
+         */
+        bool Contains(uint32_t id) const { return id < m_positions.size() && m_positions[id] != k_invalid_position; }
+
+        uint32_t GetParent(uint32_t id) const { return m_parent_ids[id]; }
+
+        GameObjectHandle GetOwner(uint32_t id) const { return m_owners[m_positions[id]]; }
+
+        /**
+         * @brief Request the local matrix of a node to be rebuilt from its transform component on the next Update.
+         *
+         * May be called while the level ticks in parallel, from the thread ticking the owner of the node.
+         */
+        void MarkDirty(uint32_t id);
+
+        /**
+         * @brief Recompute dirty local matrices and the world matrices of their subtrees.
+         */
+        void Update(const Level& level);
+
+        /**
+         * @brief Both modes give bit identical matrices.
+         */
+        void                SetUpdateMode(TransformUpdateMode mode) { m_update_mode = mode; }
+        TransformUpdateMode GetUpdateMode() const { return m_update_mode; }
+
+        const glm::mat4& GetLocalMatrix(uint32_t id) const { return m_local_matrices[m_positions[id]]; }
+        const glm::mat4& GetWorldMatrix(uint32_t id) const { return m_world_matrices[m_positions[id]]; }
+
+        /**
+         * @brief Set the bounds of a node in its local space, usually those of the model of its owner.
+         */
+        void SetLocalBounds(uint32_t id, const BoundingBox& bounds);
+
+        /**
+         * @brief Axis aligned box around the local bounds in world space as of the last Update, false if the node has
+         * no bounds.
+         */
+        bool GetWorldBounds(uint32_t id, BoundingBox& bounds) const;
+
+        /**
+         * @brief Ids whose world bounds were set or recomputed since the last ClearBoundsChanges, ids may repeat and
+         * may have been removed since.
+         */
+        const std::vector<uint32_t>& GetChangedBoundsIds() const { return m_changed_bounds_ids; }
+
+        /**
+         * @brief Ids removed since the last ClearBoundsChanges while they had bounds. They may have been reused by
+         * new nodes since, so apply removals before changes.
+         */
+        const std::vector<uint32_t>& GetRemovedBoundsIds() const { return m_removed_bounds_ids; }
+
+        void ClearBoundsChanges();
+
+        uint32_t GetNodeCount() const { return m_node_count; }
+
+        /**
+         * @brief World matrices recomputed by the last Update, for profiling.
+         */
+        uint32_t GetLastUpdateCount() const { return m_last_update_count; }
+
+    private:
+        static constexpr uint32_t k_invalid_position = ~0u;
+
+        /**
+         * @brief Reorder all nodes breadth first and drop the holes left by removed nodes.
+         */
+        void Rebuild();
+
+        void ResizeDirtyLists();
+
+        void UpdateWorldBounds(uint32_t position);
+
+        // indexed by id
+        std::vector<uint32_t> m_positions;
+        std::vector<uint32_t> m_parent_ids;
+        std::vector<uint32_t> m_child_counts;
+        std::vector<uint8_t>  m_dirty_flags;
+        std::vector<uint32_t> m_free_ids;
+
+        // indexed by position in breadth first order, removed nodes leave holes with an invalid id
+        std::vector<uint32_t>         m_ids;
+        std::vector<uint32_t>         m_parent_positions;
+        std::vector<uint32_t>         m_first_child_positions;
+        std::vector<uint32_t>         m_child_position_counts;
+        std::vector<GameObjectHandle> m_owners;
+        std::vector<glm::mat4>        m_local_matrices;
+        std::vector<glm::mat4>        m_world_matrices;
+        std::vector<uint32_t>         m_update_stamps;
+
+        // bounds as centers and half extents, only meaningful where m_has_bounds is set
+        std::vector<uint8_t>   m_has_bounds;
+        std::vector<glm::vec3> m_local_bounds_centers;
+        std::vector<glm::vec3> m_local_bounds_extents;
+        std::vector<glm::vec3> m_world_bounds_centers;
+        std::vector<glm::vec3> m_world_bounds_extents;
+
+        std::vector<uint32_t> m_changed_bounds_ids;
+        std::vector<uint32_t> m_removed_bounds_ids;
+
+        // dirty ids per job system thread, so marking dirty during a parallel tick needs no locks
+        std::vector<std::vector<uint32_t>> m_dirty_ids;
+
+        std::vector<uint32_t> m_update_queue;
+
+        // dirty local transforms of a batched update and the positions their matrices are written to
+        TransformSoA          m_dirty_transforms;
+        std::vector<uint32_t> m_dirty_positions;
+
+        TransformUpdateMode m_update_mode = TransformUpdateMode::Batched;
+
+        uint32_t m_node_count         = 0;
+        uint32_t m_hole_count         = 0;
+        uint32_t m_update_stamp       = 0;
+        uint32_t m_last_update_count  = 0;
+        bool     m_is_structure_dirty = false;
+    };
+} // namespace Meow
@@ -0,0 +1,195 @@
+#include "archetype.h"
+
+#include "pch.h"
+
+#include "core/base/alignment.h"
+#include "core/memory/pool_allocator.h"
+
+#include <algorithm>
+
+namespace Meow
+{
+    namespace
+    {
+        constexpr std::size_t k_chunks_per_pool_page = 16;
+
+        // chunks of all archetypes share one pool, so memory freed by one archetype is reused by the others
+        PoolAllocator& GetChunkPool()
+        {
+            static PoolAllocator* pool = new PoolAllocator(
+                "Component Chunks", Archetype::k_chunk_size, Archetype::k_chunk_alignment, k_chunks_per_pool_page);
+            return *pool;
+        }
+    } // namespace
+
+    Archetype::Archetype(std::vector<const ComponentTypeInfo*> types)
+        : m_types(std::move(types))
+    {
+        m_column_indices.fill(-1);
+
+        std::size_t row_bytes = sizeof(GameObject*);
+        for (std::size_t i = 0; i < m_types.size(); ++i)
+        {
+            ASSERT(m_types[i]->alignment <= k_chunk_alignment);
+            row_bytes += m_types[i]->size;
+
+            m_signature.set(m_types[i]->type_id);
+            m_column_indices[m_types[i]->type_id] = static_cast<int8_t>(i);
+        }
+
+        m_column_offsets.resize(m_types.size());
+
+        // Lay out columns for a guessed capacity, shrink the capacity until alignment padding fits as well
+        auto layout = [&](uint32_t capacity) -> std::size_t {
+            std::size_t offset = 0;
+            for (std::size_t i = 0; i < m_types.size(); ++i)
+            {
+                offset              = Align(offset, m_types[i]->alignment);
+                m_column_offsets[i] = offset;
+                offset += m_types[i]->size * capacity;
+            }
+            offset           = Align(offset, alignof(GameObject*));
+            m_objects_offset = offset;
+            offset += sizeof(GameObject*) * capacity;
+            return offset;
+        };
+
+        m_chunk_capacity = static_cast<uint32_t>(std::max<std::size_t>(k_chunk_size / row_bytes, 1));
+        while (m_chunk_capacity > 1 && layout(m_chunk_capacity) > k_chunk_size)
+        {
+            --m_chunk_capacity;
+        }
+
+        // a single huge component may not fit into a default chunk
+        m_chunk_bytes = Align(std::max(layout(m_chunk_capacity), k_chunk_size), k_chunk_alignment);
+    }
+
+    Archetype::~Archetype()
+    {
+        for (uint32_t chunk_index = 0; chunk_index < m_chunks.size(); ++chunk_index)
+        {
+            for (uint32_t row = 0; row < m_chunks[chunk_index].count; ++row)
+            {
+                DestroyRow(chunk_index, row);
+            }
+        }
+
+        while (!m_chunks.empty())
+        {
+            PopChunk();
+        }
+
+        for (std::byte* data : m_spare_chunks)
+        {
+            FreeChunkData(data);
+        }
+    }
+
+    EntityLocation Archetype::AllocateRow(GameObject* owner)
+    {
+        if (m_chunks.empty() || m_chunks.back().count == m_chunk_capacity)
+        {
+            PushChunk();
+        }
+
+        uint32_t chunk_index = static_cast<uint32_t>(m_chunks.size() - 1);
+        Chunk&   chunk       = m_chunks.back();
+
+        uint32_t row                 = chunk.count++;
+        GetObjects(chunk_index)[row] = owner;
+        ++m_object_count;
+
+        return {this, chunk_index, row};
+    }
+
+    void Archetype::Reserve(uint32_t object_count)
+    {
+        std::size_t free_rows = m_chunks.empty() ? 0 : m_chunk_capacity - m_chunks.back().count;
+        free_rows += m_spare_chunks.size() * m_chunk_capacity;
+
+        while (free_rows < object_count)
+        {
+            m_spare_chunks.push_back(AllocateChunkData());
+            free_rows += m_chunk_capacity;
+        }
+
+        m_chunks.reserve(m_chunks.size() + m_spare_chunks.size());
+    }
+
+    void Archetype::DestroyRow(uint32_t chunk_index, uint32_t row)
+    {
+        for (uint32_t column = 0; column < m_types.size(); ++column)
+        {
+            m_types[column]->destruct(GetComponent(chunk_index, row, column));
+        }
+    }
+
+    GameObject* Archetype::FillHole(uint32_t chunk_index, uint32_t row)
+    {
+        uint32_t last_chunk_index = static_cast<uint32_t>(m_chunks.size() - 1);
+        uint32_t last_row         = m_chunks[last_chunk_index].count - 1;
+
+        GameObject* moved_object = nullptr;
+
+        if (chunk_index != last_chunk_index || row != last_row)
+        {
+            for (uint32_t column = 0; column < m_types.size(); ++column)
+            {
+                void* src = GetComponent(last_chunk_index, last_row, column);
+                m_types[column]->move_construct(GetComponent(chunk_index, row, column), src);
+                m_types[column]->destruct(src);
+            }
+
+            moved_object                 = GetObjects(last_chunk_index)[last_row];
+            GetObjects(chunk_index)[row] = moved_object;
+        }
+
+        --m_chunks[last_chunk_index].count;
+        --m_object_count;
+
+        if (m_chunks[last_chunk_index].count == 0)
+        {
+            PopChunk();
+        }
+
+        return moved_object;
+    }
+
+    void Archetype::PushChunk()
+    {
+        Chunk chunk;
+        if (!m_spare_chunks.empty())
+        {
+            chunk.data = m_spare_chunks.back();
+            m_spare_chunks.pop_back();
+        }
+        else
+        {
+            chunk.data = AllocateChunkData();
+        }
+        m_chunks.push_back(chunk);
+    }
+
+    void Archetype::PopChunk()
+    {
+        FreeChunkData(m_chunks.back().data);
+        m_chunks.pop_back();
+    }
+
+    std::byte* Archetype::AllocateChunkData() const
+    {
+        // chunks enlarged for a huge component do not fit the pool
+        if (m_chunk_bytes == k_chunk_size)
+            return static_cast<std::byte*>(GetChunkPool().Allocate(k_chunk_size, k_chunk_alignment));
+
+        return static_cast<std::byte*>(::operator new(m_chunk_bytes, std::align_val_t {k_chunk_alignment}));
+    }
+
+    void Archetype::FreeChunkData(std::byte* data) const
+    {
+        if (m_chunk_bytes == k_chunk_size)
+            GetChunkPool().Deallocate(data);
+        else
+            ::operator delete(data, std::align_val_t {k_chunk_alignment});
+    }
+} // namespace Meow
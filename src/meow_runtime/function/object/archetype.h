@@ -0,0 +1,140 @@
+#pragma once
+
+#include "core/base/non_copyable.h"
+#include "function/object/component_type_info.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Meow
+{
+    class GameObject;
+    class Archetype;
+
+    /**
+     * @brief Where the components of a game object live.
+     */
+    struct EntityLocation
+    {
+        Archetype* archetype   = nullptr;
+        uint32_t   chunk_index = 0;
+        uint32_t   row         = 0;
+    };
+
+    /**
+     * @brief Storage of all game objects sharing the same set of components.
+     *
+     * Components are stored by value in fixed size chunks. Inside a chunk every component type has its own
+     * contiguous column, followed by a column of owner object pointers, so iterating one component type over a chunk
+     * touches only tightly packed memory.
+     *
+     * Rows are kept packed: removing a row moves the last row of the archetype into the hole.
+     */
+    class Archetype : public NonCopyable
+    {
+    public:
+        static constexpr std::size_t k_chunk_size      = 16 * 1024;
+        static constexpr std::size_t k_chunk_alignment = 64;
+
+        /**
+         * @brief types must be sorted by type id.
+         */
+        Archetype(std::vector<const ComponentTypeInfo*> types);
+
+        ~Archetype() override;
+
+        const std::vector<const ComponentTypeInfo*>& GetTypes() const { return m_types; }
+        const ComponentSignature&                    GetSignature() const { return m_signature; }
+
+        /**
+         * @brief Column index of a component type, -1 if this archetype does not contain the type.
+         *
+         * This is the slot table of every object in the archetype, indexed directly by type id.
+         */
+        int FindColumn(uint32_t type_id) const
+        {
+            return type_id < k_max_component_types ? m_column_indices[type_id] : -1;
+        }
+
+        int FindColumn(const ComponentTypeInfo* type_info) const { return FindColumn(type_info->type_id); }
+
+        uint32_t GetChunkCapacity() const { return m_chunk_capacity; }
+        uint32_t GetChunkCount() const { return static_cast<uint32_t>(m_chunks.size()); }
+        uint32_t GetRowCount(uint32_t chunk_index) const { return m_chunks[chunk_index].count; }
+        uint32_t GetObjectCount() const { return m_object_count; }
+
+        std::byte* GetColumnData(uint32_t chunk_index, uint32_t column) const
+        {
+            return m_chunks[chunk_index].data + m_column_offsets[column];
+        }
+
+        GameObject** GetObjects(uint32_t chunk_index) const
+        {
+            return reinterpret_cast<GameObject**>(m_chunks[chunk_index].data + m_objects_offset);
+        }
+
+        void* GetComponent(uint32_t chunk_index, uint32_t row, uint32_t column) const
+        {
+            return GetColumnData(chunk_index, column) + row * m_types[column]->size;
+        }
+
+        /**
+         * @brief Append a row for owner. The components of the row are left unconstructed.
+         */
+        EntityLocation AllocateRow(GameObject* owner);
+
+        /**
+         * @brief Allocate chunks up front, so that the next object_count rows can be appended without allocating.
+         */
+        void Reserve(uint32_t object_count);
+
+        /**
+         * @brief Call destructors of every component in a row.
+         */
+        void DestroyRow(uint32_t chunk_index, uint32_t row);
+
+        /**
+         * @brief Fill a row whose components have already been destroyed or moved away with the last row.
+         *
+         * @return The object which is moved into the row, nullptr if the row was the last one.
+         */
+        GameObject* FillHole(uint32_t chunk_index, uint32_t row);
+
+        /**
+         * @brief Cached archetype transitions, so that adding or removing the same component type again does not need
+         * to search the archetype table.
+         */
+        std::unordered_map<const ComponentTypeInfo*, Archetype*> add_edges;
+        std::unordered_map<const ComponentTypeInfo*, Archetype*> remove_edges;
+
+    private:
+        struct Chunk
+        {
+            std::byte* data  = nullptr;
+            uint32_t   count = 0;
+        };
+
+        void PushChunk();
+        void PopChunk();
+
+        std::byte* AllocateChunkData() const;
+        void       FreeChunkData(std::byte* data) const;
+
+        std::vector<const ComponentTypeInfo*>     m_types;
+        ComponentSignature                        m_signature;
+        std::array<int8_t, k_max_component_types> m_column_indices;
+        std::vector<std::size_t>                  m_column_offsets;
+        std::size_t                               m_objects_offset = 0;
+        std::size_t                               m_chunk_bytes    = k_chunk_size;
+        uint32_t                                  m_chunk_capacity = 0;
+
+        std::vector<Chunk> m_chunks;
+        uint32_t           m_object_count = 0;
+
+        // reserved chunk memory, taken by PushChunk before allocating
+        std::vector<std::byte*> m_spare_chunks;
+    };
+} // namespace Meow
@@ -0,0 +1,337 @@
+#include "component_storage.h"
+
+#include "pch.h"
+
+#include "core/jobs/job_system.h"
+#include "function/object/game_object.h"
+
+#include <algorithm>
+
+namespace Meow
+{
+    namespace
+    {
+        // deferred write queue and index of the batch ticking on this thread
+        thread_local std::vector<std::function<void()>>* t_deferred_writes = nullptr;
+        thread_local uint32_t                            t_batch_index     = 0;
+    } // namespace
+
+    ComponentStorage::~ComponentStorage()
+    {
+        m_archetype_map.clear();
+        m_archetypes.clear();
+    }
+
+    void* ComponentStorage::AddComponent(GameObject& gameobject, const ComponentTypeInfo& type_info, void* src)
+    {
+        FUNCTION_TIMER();
+
+        if (m_is_ticking)
+        {
+            MEOW_ERROR("Can not add component {} while component storage is ticking!", type_info.type_name);
+            return nullptr;
+        }
+
+        if (GetComponent(gameobject, type_info))
+            return nullptr;
+
+        Archetype* new_archetype = GetArchetypeWith(gameobject.m_location.archetype, &type_info);
+        MoveObject(gameobject, new_archetype);
+
+        const EntityLocation& location = gameobject.m_location;
+
+        void* dst = new_archetype->GetComponent(
+            location.chunk_index, location.row, static_cast<uint32_t>(new_archetype->FindColumn(&type_info)));
+        type_info.move_construct(dst, src);
+
+        return dst;
+    }
+
+    bool ComponentStorage::AddComponents(GameObject&                              gameobject,
+                                         std::span<const ComponentTypeInfo* const> type_infos,
+                                         std::span<void* const>                    srcs)
+    {
+        if (m_is_ticking)
+        {
+            MEOW_ERROR("Can not add components while component storage is ticking!");
+            return false;
+        }
+
+        ComponentSignature signature = gameobject.m_signature;
+        for (const ComponentTypeInfo* type_info : type_infos)
+        {
+            if (signature.test(type_info->type_id))
+                return false;
+            signature.set(type_info->type_id);
+        }
+
+        Archetype* new_archetype = GetOrCreateArchetype(gameobject.m_location.archetype, type_infos);
+        MoveObject(gameobject, new_archetype);
+
+        const EntityLocation& location = gameobject.m_location;
+        for (std::size_t i = 0; i < type_infos.size(); ++i)
+        {
+            void* dst = new_archetype->GetComponent(
+                location.chunk_index, location.row, static_cast<uint32_t>(new_archetype->FindColumn(type_infos[i])));
+            type_infos[i]->move_construct(dst, srcs[i]);
+        }
+
+        return true;
+    }
+
+    bool ComponentStorage::RemoveComponent(GameObject& gameobject, const ComponentTypeInfo& type_info)
+    {
+        FUNCTION_TIMER();
+
+        if (m_is_ticking)
+        {
+            MEOW_ERROR("Can not remove component {} while component storage is ticking!", type_info.type_name);
+            return false;
+        }
+
+        if (!GetComponent(gameobject, type_info))
+            return false;
+
+        MoveObject(gameobject, GetArchetypeWithout(gameobject.m_location.archetype, &type_info));
+
+        return true;
+    }
+
+    void ComponentStorage::RemoveObject(GameObject& gameobject)
+    {
+        const EntityLocation location = gameobject.m_location;
+        if (!location.archetype)
+            return;
+
+        location.archetype->DestroyRow(location.chunk_index, location.row);
+        ReleaseRow(location);
+
+        gameobject.m_location  = {};
+        gameobject.m_signature = {};
+    }
+
+    void* ComponentStorage::GetComponent(const GameObject& gameobject, const ComponentTypeInfo& type_info) const
+    {
+        return gameobject.GetComponentByTypeID(type_info.type_id);
+    }
+
+    void ComponentStorage::Reserve(std::span<const ComponentTypeInfo* const> type_infos, uint32_t object_count)
+    {
+        if (type_infos.empty() || object_count == 0)
+            return;
+
+        GetOrCreateArchetype(nullptr, type_infos)->Reserve(object_count);
+    }
+
+    void ComponentStorage::Tick(float dt, JobSystem* job_system)
+    {
+        FUNCTION_TIMER();
+
+        m_tick_batches.clear();
+        for (const auto& archetype : m_archetypes)
+        {
+            for (uint32_t chunk_index = 0; chunk_index < archetype->GetChunkCount(); ++chunk_index)
+            {
+                m_tick_batches.push_back({archetype.get(), chunk_index});
+            }
+        }
+
+        uint32_t batch_count = static_cast<uint32_t>(m_tick_batches.size());
+        if (m_deferred_writes.size() < batch_count)
+            m_deferred_writes.resize(batch_count);
+
+        m_is_ticking = true;
+
+        if (job_system)
+        {
+            job_system->ParallelFor(0, batch_count, 1, [this, dt](uint32_t begin, uint32_t end) {
+                for (uint32_t batch_index = begin; batch_index < end; ++batch_index)
+                {
+                    TickBatch(batch_index, dt);
+                }
+            });
+        }
+        else
+        {
+            for (uint32_t batch_index = 0; batch_index < batch_count; ++batch_index)
+            {
+                TickBatch(batch_index, dt);
+            }
+        }
+
+        m_is_ticking = false;
+
+        for (uint32_t batch_index = 0; batch_index < batch_count; ++batch_index)
+        {
+            // the storage is not ticking anymore, so a write deferring another write applies it right away
+            for (std::function<void()>& write : m_deferred_writes[batch_index])
+            {
+                write();
+            }
+            m_deferred_writes[batch_index].clear();
+        }
+    }
+
+    void ComponentStorage::DeferWrite(std::function<void()> write)
+    {
+        if (t_deferred_writes)
+            t_deferred_writes->push_back(std::move(write));
+        else
+            write();
+    }
+
+    uint32_t ComponentStorage::GetCurrentBatchIndex() { return t_batch_index; }
+
+    Archetype* ComponentStorage::GetArchetypeWith(Archetype* archetype, const ComponentTypeInfo* type_info)
+    {
+        if (archetype)
+        {
+            auto iter = archetype->add_edges.find(type_info);
+            if (iter != archetype->add_edges.end())
+                return iter->second;
+        }
+
+        std::vector<const ComponentTypeInfo*> types;
+        if (archetype)
+            types = archetype->GetTypes();
+
+        auto insert_pos = std::lower_bound(
+            types.begin(), types.end(), type_info, [](const ComponentTypeInfo* lhs, const ComponentTypeInfo* rhs) {
+                return lhs->type_id < rhs->type_id;
+            });
+        types.insert(insert_pos, type_info);
+
+        Archetype* new_archetype = GetOrCreateArchetype(std::move(types));
+        if (archetype)
+        {
+            archetype->add_edges[type_info]        = new_archetype;
+            new_archetype->remove_edges[type_info] = archetype;
+        }
+
+        return new_archetype;
+    }
+
+    Archetype* ComponentStorage::GetArchetypeWithout(Archetype* archetype, const ComponentTypeInfo* type_info)
+    {
+        auto iter = archetype->remove_edges.find(type_info);
+        if (iter != archetype->remove_edges.end())
+            return iter->second;
+
+        std::vector<const ComponentTypeInfo*> types = archetype->GetTypes();
+        types.erase(std::find(types.begin(), types.end(), type_info));
+
+        // objects without any component are not stored
+        Archetype* new_archetype = types.empty() ? nullptr : GetOrCreateArchetype(std::move(types));
+
+        archetype->remove_edges[type_info] = new_archetype;
+        if (new_archetype)
+            new_archetype->add_edges[type_info] = archetype;
+
+        return new_archetype;
+    }
+
+    Archetype* ComponentStorage::GetOrCreateArchetype(std::vector<const ComponentTypeInfo*> types)
+    {
+        ComponentSignature signature;
+        for (const ComponentTypeInfo* type_info : types)
+        {
+            signature.set(type_info->type_id);
+        }
+
+        auto iter = m_archetype_map.find(signature);
+        if (iter != m_archetype_map.end())
+            return iter->second;
+
+        m_archetypes.push_back(std::make_unique<Archetype>(std::move(types)));
+
+        Archetype* archetype       = m_archetypes.back().get();
+        m_archetype_map[signature] = archetype;
+
+        return archetype;
+    }
+
+    Archetype* ComponentStorage::GetOrCreateArchetype(Archetype*                                archetype,
+                                                      std::span<const ComponentTypeInfo* const> type_infos)
+    {
+        ComponentSignature signature = archetype ? archetype->GetSignature() : ComponentSignature {};
+        for (const ComponentTypeInfo* type_info : type_infos)
+        {
+            signature.set(type_info->type_id);
+        }
+
+        // look up by signature first, the sorted type list is only needed for a new archetype
+        auto iter = m_archetype_map.find(signature);
+        if (iter != m_archetype_map.end())
+            return iter->second;
+
+        std::vector<const ComponentTypeInfo*> types;
+        if (archetype)
+            types = archetype->GetTypes();
+        types.insert(types.end(), type_infos.begin(), type_infos.end());
+        std::sort(types.begin(), types.end(), [](const ComponentTypeInfo* lhs, const ComponentTypeInfo* rhs) {
+            return lhs->type_id < rhs->type_id;
+        });
+
+        return GetOrCreateArchetype(std::move(types));
+    }
+
+    void ComponentStorage::MoveObject(GameObject& gameobject, Archetype* new_archetype)
+    {
+        const EntityLocation old_location = gameobject.m_location;
+        EntityLocation       new_location = new_archetype ? new_archetype->AllocateRow(&gameobject) : EntityLocation {};
+
+        if (Archetype* old_archetype = old_location.archetype)
+        {
+            const std::vector<const ComponentTypeInfo*>& old_types = old_archetype->GetTypes();
+            for (uint32_t column = 0; column < old_types.size(); ++column)
+            {
+                void* src = old_archetype->GetComponent(old_location.chunk_index, old_location.row, column);
+
+                int new_column = new_archetype ? new_archetype->FindColumn(old_types[column]) : -1;
+                if (new_column >= 0)
+                {
+                    old_types[column]->move_construct(new_archetype->GetComponent(new_location.chunk_index,
+                                                                                  new_location.row,
+                                                                                  static_cast<uint32_t>(new_column)),
+                                                      src);
+                }
+
+                old_types[column]->destruct(src);
+            }
+
+            ReleaseRow(old_location);
+        }
+
+        gameobject.m_location  = new_location;
+        gameobject.m_signature = new_archetype ? new_archetype->GetSignature() : ComponentSignature {};
+    }
+
+    void ComponentStorage::TickBatch(uint32_t batch_index, float dt)
+    {
+        const ChunkBatch&                            batch = m_tick_batches[batch_index];
+        const std::vector<const ComponentTypeInfo*>& types = batch.archetype->GetTypes();
+
+        // a thread waiting for a parallel tick may run a batch of another storage, so restore the previous queue
+        std::vector<std::function<void()>>* previous_deferred_writes = t_deferred_writes;
+        uint32_t                            previous_batch_index     = t_batch_index;
+        t_deferred_writes                                            = &m_deferred_writes[batch_index];
+        t_batch_index                                                = batch_index;
+
+        uint32_t count = batch.archetype->GetRowCount(batch.chunk_index);
+        for (uint32_t column = 0; column < types.size(); ++column)
+        {
+            types[column]->tick(batch.archetype->GetColumnData(batch.chunk_index, column), count, dt);
+        }
+
+        t_deferred_writes = previous_deferred_writes;
+        t_batch_index     = previous_batch_index;
+    }
+
+    void ComponentStorage::ReleaseRow(const EntityLocation& location)
+    {
+        if (GameObject* moved_object = location.archetype->FillHole(location.chunk_index, location.row))
+        {
+            moved_object->m_location = location;
+        }
+    }
+} // namespace Meow
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "core/base/non_copyable.h"
+#include "function/object/archetype.h"
+
+#include <functional>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Meow
+{
+    class JobSystem;
+
+    /**
+     * @brief Archetype based storage of the components of all game objects in a level.
+     *
+     * Adding or removing a component moves every component of the object to another archetype, so raw pointers and
+     * references to components are only valid until the next structural change of the same archetype. Structural
+     * changes are not allowed while the storage is ticking.
+     */
+    class ComponentStorage : public NonCopyable
+    {
+    public:
+        ComponentStorage() = default;
+        ~ComponentStorage() override;
+
+        /**
+         * @brief Move construct a component from src into the storage of gameobject.
+         *
+         * @return Pointer to the stored component, nullptr if gameobject already has a component of this type.
+         */
+        void* AddComponent(GameObject& gameobject, const ComponentTypeInfo& type_info, void* src);
+
+        /**
+         * @brief Move construct several components at once, moving the object to its final archetype only once.
+         *
+         * @return false if gameobject already has one of the types or a type is given twice, nothing is added then.
+         */
+        bool AddComponents(GameObject&                              gameobject,
+                           std::span<const ComponentTypeInfo* const> type_infos,
+                           std::span<void* const>                    srcs);
+
+        bool RemoveComponent(GameObject& gameobject, const ComponentTypeInfo& type_info);
+
+        void RemoveObject(GameObject& gameobject);
+
+        void* GetComponent(const GameObject& gameobject, const ComponentTypeInfo& type_info) const;
+
+        /**
+         * @brief Allocate chunks for object_count more objects with exactly the given component types.
+         */
+        void Reserve(std::span<const ComponentTypeInfo* const> type_infos, uint32_t object_count);
+
+        /**
+         * @brief Tick all components chunk by chunk and column by column.
+         *
+         * Every chunk is one batch. With a job system the batches are ticked in parallel, so a component may access
+         * the other components of its own object, but writes to other objects have to go through DeferWrite.
+         */
+        void Tick(float dt, JobSystem* job_system = nullptr);
+
+        /**
+         * @brief Queue a write to another game object from a ticking component.
+         *
+         * Deferred writes are applied after all batches have ticked, batch by batch in storage order and in queue
+         * order within a batch, so the result does not depend on the number of threads. Capture game objects, not
+         * component pointers, since writes may relocate components. Outside of Tick the write is applied immediately.
+         */
+        static void DeferWrite(std::function<void()> write);
+
+        bool IsTicking() const { return m_is_ticking; }
+
+        /**
+         * @brief Index of the batch ticking on the calling thread, 0 outside of Tick. Batches are numbered in storage
+         * order, so this is a thread count independent sort key for work recorded during a tick.
+         */
+        static uint32_t GetCurrentBatchIndex();
+
+        /**
+         * @brief Call func once per chunk, with typed spans of every requested component type, for all archetypes
+         * containing all of TComponents.
+         */
+        template<typename... TComponents, typename Func>
+        void ForEach(Func&& func)
+        {
+            const uint32_t type_ids[] = {ComponentTypeRegistry::GetTypeID<TComponents>()...};
+
+            ComponentSignature required;
+            for (uint32_t type_id : type_ids)
+            {
+                if (type_id >= k_max_component_types)
+                    return;
+                required.set(type_id);
+            }
+
+            for (const auto& archetype : m_archetypes)
+            {
+                if ((archetype->GetSignature() & required) != required)
+                    continue;
+
+                int columns[sizeof...(TComponents)];
+                for (std::size_t i = 0; i < sizeof...(TComponents); ++i)
+                {
+                    columns[i] = archetype->FindColumn(type_ids[i]);
+                }
+
+                for (uint32_t chunk_index = 0; chunk_index < archetype->GetChunkCount(); ++chunk_index)
+                {
+                    CallWithSpans<TComponents...>(
+                        func, *archetype, chunk_index, columns, std::index_sequence_for<TComponents...> {});
+                }
+            }
+        }
+
+        const std::vector<std::unique_ptr<Archetype>>& GetArchetypes() const { return m_archetypes; }
+
+    private:
+        template<typename... TComponents, typename Func, std::size_t... Is>
+        static void CallWithSpans(Func&                      func,
+                                  const Archetype&           archetype,
+                                  uint32_t                   chunk_index,
+                                  const int*                 columns,
+                                  std::index_sequence<Is...>)
+        {
+            uint32_t count = archetype.GetRowCount(chunk_index);
+            func(std::span<TComponents>(
+                reinterpret_cast<TComponents*>(archetype.GetColumnData(chunk_index, columns[Is])), count)...);
+        }
+
+        Archetype* GetArchetypeWith(Archetype* archetype, const ComponentTypeInfo* type_info);
+        Archetype* GetArchetypeWithout(Archetype* archetype, const ComponentTypeInfo* type_info);
+        Archetype* GetOrCreateArchetype(std::vector<const ComponentTypeInfo*> types);
+
+        /**
+         * @brief Archetype with the types of archetype plus type_infos, which must not be part of archetype.
+         */
+        Archetype* GetOrCreateArchetype(Archetype* archetype, std::span<const ComponentTypeInfo* const> type_infos);
+
+        /**
+         * @brief Move all components shared by the old and the new archetype of gameobject, destroy the rest and
+         * release the old row.
+         */
+        void MoveObject(GameObject& gameobject, Archetype* new_archetype);
+
+        void ReleaseRow(const EntityLocation& location);
+
+        void TickBatch(uint32_t batch_index, float dt);
+
+        std::vector<std::unique_ptr<Archetype>>           m_archetypes;
+        std::unordered_map<ComponentSignature, Archetype*> m_archetype_map;
+
+        bool m_is_ticking = false;
+
+        struct ChunkBatch
+        {
+            Archetype* archetype;
+            uint32_t   chunk_index;
+        };
+
+        std::vector<ChunkBatch>                         m_tick_batches;
+        std::vector<std::vector<std::function<void()>>> m_deferred_writes;
+    };
+} // namespace Meow
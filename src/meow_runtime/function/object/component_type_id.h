@@ -0,0 +1,27 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+
+namespace Meow
+{
+    inline constexpr uint32_t k_max_component_types      = 64;
+    inline constexpr uint32_t k_invalid_component_type_id = ~0u;
+
+    /**
+     * @brief Bit i is set if an object or archetype contains the component with type id i.
+     */
+    using ComponentSignature = std::bitset<k_max_component_types>;
+
+    /**
+     * @brief Dense compile-time type id of a component.
+     *
+     * Components parsed by the code generator get a specialization in generated/component_type_id.gen.h. Other
+     * component types are assigned an id at runtime, the first time they are registered.
+     */
+    template<typename TComponent>
+    struct GeneratedComponentTypeID
+    {
+        static constexpr uint32_t value = k_invalid_component_type_id;
+    };
+} // namespace Meow
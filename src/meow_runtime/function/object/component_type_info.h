@@ -0,0 +1,155 @@
+#pragma once
+
+#include "generated/component_type_id.gen.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace Meow
+{
+    class Component;
+
+    /**
+     * @brief Type-erased description of a component type.
+     *
+     * Archetype chunks store components by value, so they need to know how to move, destroy and tick a component
+     * without knowing its static type.
+     */
+    struct ComponentTypeInfo
+    {
+        std::string type_name;
+        uint32_t    type_id   = k_invalid_component_type_id;
+        std::size_t size      = 0;
+        std::size_t alignment = 0;
+
+        void (*move_construct)(void* dst, void* src)           = nullptr;
+        void (*destruct)(void* ptr)                            = nullptr;
+        Component* (*as_component)(void* ptr)                  = nullptr;
+        void (*tick)(void* begin, std::size_t count, float dt) = nullptr;
+
+        template<typename TComponent>
+        static ComponentTypeInfo Create(const std::string& type_name, uint32_t type_id)
+        {
+            static_assert(std::is_base_of_v<Component, TComponent>, "TComponent must derive from Component");
+            static_assert(std::is_move_constructible_v<TComponent>, "TComponent must be move constructible");
+
+            ComponentTypeInfo info;
+            info.type_name      = type_name;
+            info.type_id        = type_id;
+            info.size           = sizeof(TComponent);
+            info.alignment      = alignof(TComponent);
+            info.move_construct = [](void* dst, void* src) {
+                new (dst) TComponent(std::move(*static_cast<TComponent*>(src)));
+            };
+            info.destruct     = [](void* ptr) { static_cast<TComponent*>(ptr)->~TComponent(); };
+            info.as_component = [](void* ptr) -> Component* { return static_cast<TComponent*>(ptr); };
+            info.tick         = [](void* begin, std::size_t count, float dt) {
+                TComponent* components = static_cast<TComponent*>(begin);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    // qualified call, the dynamic type of a column element is always TComponent
+                    components[i].TComponent::Tick(dt);
+                }
+            };
+
+            return info;
+        }
+    };
+
+    /**
+     * @brief Owns one ComponentTypeInfo per component type and hands out dense type ids.
+     *
+     * Ids of generated components are compile-time constants, RegisterAll registers them at startup. Infos are never
+     * freed, so pointers to them are stable and can be used as keys.
+     */
+    class ComponentTypeRegistry
+    {
+    public:
+        static ComponentTypeRegistry& instance()
+        {
+            static ComponentTypeRegistry registry;
+            return registry;
+        }
+
+        template<typename TComponent>
+        const ComponentTypeInfo& Register(const std::string& type_name)
+        {
+            if (const ComponentTypeInfo* type_info = Find<TComponent>())
+                return *type_info;
+
+            if (Find(type_name))
+                throw std::runtime_error("Component type name is registered by another type: " + type_name);
+
+            uint32_t type_id = GeneratedComponentTypeID<TComponent>::value;
+            if (type_id == k_invalid_component_type_id)
+                type_id = m_next_runtime_type_id++;
+
+            if (type_id >= k_max_component_types)
+                throw std::runtime_error("Too many component types, increase k_max_component_types.");
+
+            m_infos[type_id] =
+                std::make_unique<ComponentTypeInfo>(ComponentTypeInfo::Create<TComponent>(type_name, type_id));
+            m_infos_by_name[type_name] = m_infos[type_id].get();
+            RuntimeTypeID<TComponent>() = type_id;
+
+            return *m_infos[type_id];
+        }
+
+        /**
+         * @brief Dense type id of TComponent, k_invalid_component_type_id if it has never been registered.
+         *
+         * Constant for generated components, a single static load otherwise.
+         */
+        template<typename TComponent>
+        static uint32_t GetTypeID()
+        {
+            if constexpr (GeneratedComponentTypeID<TComponent>::value != k_invalid_component_type_id)
+                return GeneratedComponentTypeID<TComponent>::value;
+            else
+                return RuntimeTypeID<TComponent>();
+        }
+
+        /**
+         * @brief Get info of a registered type, nullptr if the type has not been registered.
+         */
+        template<typename TComponent>
+        const ComponentTypeInfo* Find() const
+        {
+            return Find(GetTypeID<TComponent>());
+        }
+
+        const ComponentTypeInfo* Find(uint32_t type_id) const
+        {
+            return type_id < k_max_component_types ? m_infos[type_id].get() : nullptr;
+        }
+
+        const ComponentTypeInfo* Find(const std::string& type_name) const
+        {
+            auto iter = m_infos_by_name.find(type_name);
+            return iter != m_infos_by_name.end() ? iter->second : nullptr;
+        }
+
+    private:
+        ComponentTypeRegistry() = default;
+
+        template<typename TComponent>
+        static uint32_t& RuntimeTypeID()
+        {
+            static uint32_t type_id = k_invalid_component_type_id;
+            return type_id;
+        }
+
+        std::array<std::unique_ptr<ComponentTypeInfo>, k_max_component_types> m_infos;
+        std::unordered_map<std::string, const ComponentTypeInfo*>             m_infos_by_name;
+
+        uint32_t m_next_runtime_type_id = k_generated_component_type_count;
+    };
+} // namespace Meow
@@ -2,22 +2,55 @@
 
 namespace Meow
 {
+    GameObject::~GameObject()
+    {
+        if (m_storage)
+            m_storage->RemoveObject(*this);
+    }
+
     void GameObject::Tick(float dt)
     {
-        for (auto& refl_component : m_refl_components)
+        Archetype* archetype = m_location.archetype;
+        if (!archetype)
+            return;
+
+        const std::vector<const ComponentTypeInfo*>& types = archetype->GetTypes();
+        for (uint32_t column = 0; column < types.size(); ++column)
         {
-            refl_component.shared_ptr->Tick(dt);
+            types[column]
+                ->as_component(archetype->GetComponent(m_location.chunk_index, m_location.row, column))
+                ->Tick(dt);
         }
     }
 
     bool GameObject::HasComponent(const std::string& compenent_type_name) const
     {
-        for (const auto& refl_component : m_refl_components)
+        const ComponentTypeInfo* type_info = ComponentTypeRegistry::instance().Find(compenent_type_name);
+        if (!type_info)
+            return false;
+
+        return m_signature.test(type_info->type_id);
+    }
+
+    std::vector<reflect::refl_shared_ptr<Component>> GameObject::GetComponents()
+    {
+        std::vector<reflect::refl_shared_ptr<Component>> refl_components;
+
+        Archetype* archetype = m_location.archetype;
+        if (!archetype)
+            return refl_components;
+
+        std::shared_ptr<GameObject> self = shared_from_this();
+
+        const std::vector<const ComponentTypeInfo*>& types = archetype->GetTypes();
+        refl_components.reserve(types.size());
+        for (uint32_t column = 0; column < types.size(); ++column)
         {
-            if (refl_component.type_name == compenent_type_name)
-                return true;
+            Component* component =
+                types[column]->as_component(archetype->GetComponent(m_location.chunk_index, m_location.row, column));
+            refl_components.emplace_back(types[column]->type_name, std::shared_ptr<Component>(self, component));
         }
 
-        return false;
+        return refl_components;
     }
 } // namespace Meow
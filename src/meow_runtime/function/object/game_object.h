@@ -4,10 +4,13 @@
 
 #include "core/reflect/reflect_pointer.hpp"
 #include "core/uuid/uuid.h"
+#include "function/object/component_storage.h"
+#include "function/object/game_object_handle.h"
 
 namespace Meow
 {
     class GameObject;
+    class Level;
 
     class Component
     {
@@ -18,94 +21,178 @@ namespace Meow
         virtual void Tick(float dt) {};
     };
 
-    class GameObject
+    /**
+     * @brief A game object is an id and a name. Its components live by value in the ComponentStorage of its level.
+     *
+     * Shared pointers returned by TryAddComponent, TryGetComponent and GetComponents keep the game object alive, but
+     * components may be relocated by any later structural change of the object (adding or removing components), so
+     * they should not be cached across frames.
+     */
+    class GameObject : public std::enable_shared_from_this<GameObject>
     {
     public:
-        GameObject(UUID id)
+        GameObject(UUID id, ComponentStorage* storage)
             : m_id {id}
+            , m_storage {storage}
         {}
 
-        virtual ~GameObject() { m_refl_components.clear(); }
+        virtual ~GameObject();
 
         virtual void Tick(float dt);
 
         UUID GetID() const { return m_id; }
 
+        /**
+         * @brief Handle of this object in its level, invalid for objects not created by a level.
+         */
+        GameObjectHandle GetHandle() const { return m_handle; }
+
+        /**
+         * @brief Level owning this object, nullptr for objects not created by a level.
+         */
+        Level* GetLevel() const { return m_level; }
+
         void               SetName(std::string name) { m_name = name; }
         const std::string& GetName() const { return m_name; }
 
         bool HasComponent(const std::string& compenent_type_name) const;
 
-        std::vector<reflect::refl_shared_ptr<Component>> GetComponents() { return m_refl_components; }
+        template<typename TComponent>
+        bool HasComponent() const
+        {
+            uint32_t type_id = ComponentTypeRegistry::GetTypeID<TComponent>();
+            return type_id < k_max_component_types && m_signature.test(type_id);
+        }
+
+        const ComponentSignature& GetSignature() const { return m_signature; }
+
+        std::vector<reflect::refl_shared_ptr<Component>> GetComponents();
+
+        /**
+         * @brief O(1) lookup by dense type id, without string compares, RTTI or reference counting.
+         *
+         * @return Pointer to the component, valid until the next structural change of this object. nullptr if there
+         * is no such component.
+         */
+        template<typename TComponent>
+        TComponent* GetComponent() const
+        {
+            return static_cast<TComponent*>(GetComponentByTypeID(ComponentTypeRegistry::GetTypeID<TComponent>()));
+        }
+
+        void* GetComponentByTypeID(uint32_t type_id) const
+        {
+            if (type_id >= k_max_component_types || !m_signature.test(type_id))
+                return nullptr;
+
+            const int column = m_location.archetype->FindColumn(type_id);
+            return m_location.archetype->GetComponent(m_location.chunk_index, m_location.row, static_cast<uint32_t>(column));
+        }
 
         template<typename TComponent>
         std::shared_ptr<TComponent> TryGetComponent(const std::string& component_type_name)
         {
-            FUNCTION_TIMER();
+            TComponent* component = nullptr;
 
-            for (auto& refl_component : m_refl_components)
+            if (ComponentTypeRegistry::GetTypeID<TComponent>() != k_invalid_component_type_id)
+            {
+                // TComponent is a registered component type, the name is redundant
+                component = GetComponent<TComponent>();
+            }
+            else if (const ComponentTypeInfo* type_info = ComponentTypeRegistry::instance().Find(component_type_name))
             {
-                if (refl_component.type_name == component_type_name)
-                {
-                    return std::dynamic_pointer_cast<TComponent>(refl_component.shared_ptr);
-                }
+                // TComponent is a base class of the stored component
+                if (void* stored_component = GetComponentByTypeID(type_info->type_id))
+                    component = dynamic_cast<TComponent*>(type_info->as_component(stored_component));
             }
 
-            return std::shared_ptr<TComponent>(nullptr);
+            if (!component)
+                return std::shared_ptr<TComponent>(nullptr);
+
+            // aliasing constructor, the component is owned by the storage and kept alive by its game object
+            return std::shared_ptr<TComponent>(shared_from_this(), component);
         }
 
         template<typename TComponent>
+            requires std::is_base_of_v<Component, TComponent>
         friend std::shared_ptr<TComponent> TryAddComponent(std::shared_ptr<GameObject> gameobject,
                                                            const std::string&          component_type_name,
-                                                           std::shared_ptr<TComponent> component_ptr);
+                                                           TComponent                  component);
+
+        friend class ComponentStorage;
+        friend class Level;
 
     protected:
-        UUID                                             m_id;
-        std::string                                      m_name = "Default Object";
-        std::vector<reflect::refl_shared_ptr<Component>> m_refl_components;
+        UUID               m_id;
+        GameObjectHandle   m_handle;
+        Level*             m_level = nullptr;
+        std::string        m_name = "Default Object";
+        ComponentStorage*  m_storage;
+        EntityLocation     m_location;
+        ComponentSignature m_signature;
     };
 
+    /**
+     * @brief Move the component into the storage of gameobject. Components live by value in archetype chunks, so
+     * passing the component by value avoids a heap allocation per component.
+     *
+     * @return Pointer to the stored component, keeping gameobject alive.
+     */
     template<typename TComponent>
+        requires std::is_base_of_v<Component, TComponent>
     std::shared_ptr<TComponent> TryAddComponent(std::shared_ptr<GameObject> gameobject,
                                                 const std::string&          component_type_name,
-                                                std::shared_ptr<TComponent> component_ptr)
+                                                TComponent                  component)
     {
         FUNCTION_TIMER();
 
 #ifdef MEOW_DEBUG
-        if (!component_ptr)
+        if (!gameobject->m_storage)
         {
-            MEOW_ERROR("shared ptr is invalid!");
+            MEOW_ERROR("GameObject {} has no component storage!", gameobject->m_name);
             return std::shared_ptr<TComponent>(nullptr);
         }
 #endif
 
-        // Check if a component of the same type already exists
-        for (const auto& refl_component : gameobject->m_refl_components)
+        const ComponentTypeInfo& type_info =
+            ComponentTypeRegistry::instance().Register<TComponent>(component_type_name);
+
+        // Add the component to the storage, fails if a component of the same type already exists
+        void* stored_component = gameobject->m_storage->AddComponent(*gameobject, type_info, &component);
+        if (!stored_component)
         {
-            if (refl_component.type_name == component_type_name)
-            {
-                MEOW_ERROR("Component already exists: {}", component_type_name);
-                return std::shared_ptr<TComponent>(nullptr);
-            }
+            MEOW_ERROR("Component already exists: {}", component_type_name);
+            return std::shared_ptr<TComponent>(nullptr);
         }
 
-        // Add the component to the container
-        gameobject->m_refl_components.emplace_back(component_type_name, component_ptr);
+        // set parent gameobject
+
+        TComponent* stored_ptr      = static_cast<TComponent*>(stored_component);
+        stored_ptr->m_parent_object = gameobject;
+        stored_ptr->Start();
+
+        // Start may add other components, which relocates this one
+        return gameobject->TryGetComponent<TComponent>(component_type_name);
+    }
 
+    /**
+     * @brief Move the component into the storage of gameobject.
+     *
+     * @return Pointer to the stored component, component_ptr itself is left in a moved-from state.
+     */
+    template<typename TComponent>
+    std::shared_ptr<TComponent> TryAddComponent(std::shared_ptr<GameObject> gameobject,
+                                                const std::string&          component_type_name,
+                                                std::shared_ptr<TComponent> component_ptr)
+    {
 #ifdef MEOW_DEBUG
-        if (gameobject->m_refl_components.size() < 1)
+        if (!component_ptr)
         {
-            MEOW_ERROR("m_refl_components is empty!");
+            MEOW_ERROR("shared ptr is invalid!");
             return std::shared_ptr<TComponent>(nullptr);
         }
 #endif
 
-        // set parent gameobject
-
-        component_ptr->m_parent_object = gameobject;
-        component_ptr->Start();
-
-        return component_ptr;
+        return TryAddComponent<TComponent>(std::move(gameobject), component_type_name, std::move(*component_ptr));
     }
 } // namespace Meow
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace Meow
+{
+    /**
+     * @brief Index of a game object slot in its level plus the generation of the slot.
+     *
+     * Destroying a game object bumps the generation of its slot, so stale handles resolve to nullptr instead of a
+     * newer object reusing the slot. Handles are only meaningful within their level and within one run, use the UUID
+     * of a game object as persistent identity.
+     */
+    struct GameObjectHandle
+    {
+        static constexpr uint32_t k_invalid_index = ~0u;
+
+        uint32_t index      = k_invalid_index;
+        uint32_t generation = 0;
+
+        bool IsValid() const { return index != k_invalid_index; }
+
+        bool operator==(const GameObjectHandle& rhs) const = default;
+    };
+} // namespace Meow
+
+namespace std
+{
+    template<>
+    struct hash<Meow::GameObjectHandle>
+    {
+        std::size_t operator()(const Meow::GameObjectHandle& handle) const
+        {
+            return (static_cast<uint64_t>(handle.generation) << 32) | handle.index;
+        }
+    };
+} // namespace std
@@ -74,22 +74,40 @@ namespace Meow
             m_LightInfos.speed[i]     = 1.0f + glm::linearRand<float>(1.0f, 2.0f);
         }
 
-        m_per_scene_uniform_buffer =
-            std::make_shared<UniformBuffer>(physical_device, logical_device, sizeof(PerSceneData));
-        m_dynamic_uniform_buffer = std::make_shared<UniformBuffer>(physical_device, logical_device, 32 * 1024);
-        m_light_data_uniform_buffer =
-            std::make_shared<UniformBuffer>(physical_device, logical_device, sizeof(m_LightDatas));
-
-        m_obj2attachment_mat.GetShader()->BindBufferToDescriptor(
-            logical_device, "sceneData", m_per_scene_uniform_buffer->buffer);
-        m_obj2attachment_mat.GetShader()->BindBufferToDescriptor(
-            logical_device, "objData", m_dynamic_uniform_buffer->buffer);
-        m_quad_mat.GetShader()->BindBufferToDescriptor(
-            logical_device, "lightDatas", m_light_data_uniform_buffer->buffer);
-
-        OneTimeSubmit(logical_device, command_pool, queue, [&](const vk::raii::CommandBuffer& command_buffer) {
-            m_obj2attachment_mat.GetShader()->BindPerSceneDescriptorSetToPipeline(command_buffer);
-        });
+        m_per_scene_uniform_buffers.clear();
+        m_light_data_uniform_buffers.clear();
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            m_per_scene_uniform_buffers.push_back(
+                std::make_shared<UniformBuffer>(physical_device, logical_device, sizeof(PerSceneData)));
+            m_light_data_uniform_buffers.push_back(
+                std::make_shared<UniformBuffer>(physical_device, logical_device, sizeof(m_LightDatas)));
+
+            m_obj2attachment_mat.GetShader()->BindBufferToDescriptor(
+                logical_device, i, "sceneData", m_per_scene_uniform_buffers[i]->buffer);
+            m_quad_mat.GetShader()->BindBufferToDescriptor(
+                logical_device, i, "lightDatas", m_light_data_uniform_buffers[i]->buffer);
+        }
+
+        if (m_obj2attachment_mat.GetShader()->dynamic_uniform_buffer_count > 0)
+        {
+            m_dynamic_uniform_allocator = FrameUniformAllocator(logical_device, m_obj2attachment_mat.GetShader(), 3);
+        }
+
+        // instanced shaders read the world matrix per instance instead of from the per object uniforms
+        m_is_instanced = m_obj2attachment_mat.GetShader()->IsInstanced();
+        if (m_is_instanced && m_obj2attachment_mat.GetShader()->instance_stride != sizeof(glm::mat4))
+        {
+            MEOW_ERROR("Per instance inputs of the shader are not a world matrix.");
+            m_is_instanced = false;
+        }
+        m_instance_buffer = m_is_instanced ? InstanceBuffer(sizeof(glm::mat4)) : InstanceBuffer(nullptr);
+
+        m_is_gpu_culled = m_is_instanced && GpuCulling::IsSupported();
+        if (m_is_gpu_culled)
+        {
+            m_gpu_culling = GpuCulling(physical_device, logical_device, m_descriptor_allocator);
+        }
     }
 
     void DeferredPass::RefreshFrameBuffers(const vk::raii::PhysicalDevice&   physical_device,
@@ -200,11 +218,10 @@ namespace Meow
             MEOW_ERROR("shared ptr is invalid!");
 #endif
 
-        std::shared_ptr<GameObject> camera_go_ptr = level_ptr->GetGameObjectByID(level_ptr->GetMainCameraID()).lock();
-        std::shared_ptr<Transform3DComponent> transfrom_comp_ptr =
-            camera_go_ptr->TryGetComponent<Transform3DComponent>("Transform3DComponent");
-        std::shared_ptr<Camera3DComponent> camera_comp_ptr =
-            camera_go_ptr->TryGetComponent<Camera3DComponent>("Camera3DComponent");
+        GameObject* camera_go_ptr = level_ptr->GetGameObject(level_ptr->GetMainCamera());
+
+        Transform3DComponent* transfrom_comp_ptr = camera_go_ptr->GetComponent<Transform3DComponent>();
+        Camera3DComponent*    camera_comp_ptr    = camera_go_ptr->GetComponent<Camera3DComponent>();
 
 #ifdef MEOW_DEBUG
         if (!camera_go_ptr)
@@ -229,45 +246,51 @@ namespace Meow
                                  camera_comp_ptr->near_plane,
                                  camera_comp_ptr->far_plane);
 
-        m_per_scene_uniform_buffer->Reset();
-        m_per_scene_uniform_buffer->Populate(&per_scene_data, sizeof(PerSceneData));
+        // the buffers of this frame are no longer read by the GPU, those of the other frames in flight may be
+        const std::shared_ptr<UniformBuffer>& per_scene_uniform_buffer  = m_per_scene_uniform_buffers[m_frame_index];
+        const std::shared_ptr<UniformBuffer>& light_data_uniform_buffer = m_light_data_uniform_buffers[m_frame_index];
 
-        // Update mesh uniform
-
-        m_dynamic_uniform_buffer->Reset();
-        m_obj2attachment_mat.BeginPopulatingDynamicUniformBufferPerFrame();
-        const auto& all_gameobjects_map = level_ptr->GetAllVisibles();
-        for (const auto& kv : all_gameobjects_map)
-        {
-            std::shared_ptr<GameObject>           model_go_ptr = kv.second.lock();
-            std::shared_ptr<Transform3DComponent> transfrom_comp_ptr2 =
-                model_go_ptr->TryGetComponent<Transform3DComponent>("Transform3DComponent");
-            std::shared_ptr<ModelComponent> model_comp_ptr =
-                model_go_ptr->TryGetComponent<ModelComponent>("ModelComponent");
+        per_scene_uniform_buffer->Reset();
+        per_scene_uniform_buffer->Populate(&per_scene_data, sizeof(PerSceneData));
 
-            if (!transfrom_comp_ptr2 || !model_comp_ptr)
-                continue;
+        // Update mesh uniform
 
-#ifdef MEOW_DEBUG
-            if (!model_go_ptr)
-                MEOW_ERROR("shared ptr is invalid!");
-            if (!transfrom_comp_ptr2)
-                MEOW_ERROR("shared ptr is invalid!");
-            if (!model_comp_ptr)
-                MEOW_ERROR("shared ptr is invalid!");
-#endif
+        m_dynamic_uniform_allocator.BeginFrame(m_frame_index);
 
-            auto model = transfrom_comp_ptr2->GetTransform();
+        // culling on the GPU only reads the bounds changes of the level, from the next tick on
+        level_ptr->SetCpuCulling(!m_is_gpu_culled);
+        if (m_is_gpu_culled)
+        {
+            m_gpu_culling.Update(m_frame_index, *level_ptr);
+        }
+        else if (m_is_instanced)
+        {
+            // world matrices in the order of the instance batches, one instanced draw of DrawObjOnly each
+            std::span<const VisibleMesh> visible_meshes = level_ptr->GetVisibleMeshes();
 
-            for (int32_t i = 0; i < model_comp_ptr->model_ptr.lock()->meshes.size(); ++i)
+            m_instance_data.clear();
+            for (uint32_t visible_index : level_ptr->GetInstancedMeshes())
+            {
+                m_instance_data.push_back(level_ptr->GetMeshMatrix(visible_meshes[visible_index]));
+            }
+            m_instance_buffer.Populate(
+                m_frame_index, m_instance_data.data(), static_cast<uint32_t>(m_instance_data.size()));
+        }
+        else
+        {
+            m_obj2attachment_mat.BeginPopulatingDynamicUniformBufferPerFrame();
+            // one entry per draw of DrawObjOnly, in the same order
+            for (const VisibleMesh& visible_mesh : level_ptr->GetVisibleMeshes())
             {
+                glm::mat4 model = level_ptr->GetMeshMatrix(visible_mesh);
+
                 m_obj2attachment_mat.BeginPopulatingDynamicUniformBufferPerObject();
                 m_obj2attachment_mat.PopulateDynamicUniformBuffer(
-                    m_dynamic_uniform_buffer, "objData", &model, sizeof(model));
+                    m_dynamic_uniform_allocator, "objData", &model, sizeof(model));
                 m_obj2attachment_mat.EndPopulatingDynamicUniformBufferPerObject();
             }
+            m_obj2attachment_mat.EndPopulatingDynamicUniformBufferPerFrame();
         }
-        m_obj2attachment_mat.EndPopulatingDynamicUniformBufferPerFrame();
 
         // update light
 
@@ -279,8 +302,8 @@ namespace Meow
             m_LightDatas.lights[i].position.z = m_LightInfos.position[i].z + bias * m_LightInfos.direction[i].z;
         }
 
-        m_light_data_uniform_buffer->Reset();
-        m_light_data_uniform_buffer->Populate(&m_LightDatas, sizeof(m_LightDatas));
+        light_data_uniform_buffer->Reset();
+        light_data_uniform_buffer->Populate(&m_LightDatas, sizeof(m_LightDatas));
     }
 
     void DeferredPass::Start(const vk::raii::CommandBuffer& command_buffer,
@@ -292,6 +315,12 @@ namespace Meow
             draw_call[i] = 0;
         }
 
+        // compute work can not be recorded inside the render pass
+        if (m_is_gpu_culled)
+        {
+            m_gpu_culling.Dispatch(command_buffer, m_frame_index);
+        }
+
         RenderPass::Start(command_buffer, extent, current_image_index);
     }
 
@@ -299,32 +328,41 @@ namespace Meow
     {
         FUNCTION_TIMER();
 
-        std::shared_ptr<Level> level_ptr           = g_runtime_context.level_system->GetCurrentActiveLevel().lock();
-        const auto&            all_gameobjects_map = level_ptr->GetAllVisibles();
-        for (const auto& kv : all_gameobjects_map)
+        m_obj2attachment_mat.GetShader()->BindPerSceneDescriptorSetToPipeline(command_buffer, m_frame_index);
+
+        if (m_is_gpu_culled)
         {
-            std::shared_ptr<GameObject>     model_go_ptr = kv.second.lock();
-            std::shared_ptr<ModelComponent> model_comp_ptr =
-                model_go_ptr->TryGetComponent<ModelComponent>("ModelComponent");
+            draw_call[0] += m_gpu_culling.Draw(command_buffer, m_frame_index);
+            return;
+        }
 
-            if (!model_comp_ptr)
-                continue;
+        std::shared_ptr<Level> level_ptr = g_runtime_context.level_system->GetCurrentActiveLevel().lock();
 
-            for (int32_t i = 0; i < model_comp_ptr->model_ptr.lock()->meshes.size(); ++i)
-            {
-                m_obj2attachment_mat.UpdateDynamicUniformPerObject(command_buffer, draw_call[0]);
-                model_comp_ptr->model_ptr.lock()->meshes[i]->BindDrawCmd(command_buffer);
+        // the caller bound the pipeline, nothing else of this command buffer is known
+        m_state_cache.Reset();
+        m_state_cache.SetBoundPipeline(*m_obj2attachment_mat.graphics_pipeline);
 
-                ++draw_call[0];
-            }
+        // sorted to bind each mesh once and draw front to back
+        m_render_queue.Clear();
+        if (m_is_instanced)
+        {
+            m_instance_buffer.Bind(command_buffer, m_frame_index, m_state_cache);
+            m_render_queue.PushInstanceBatches(*level_ptr, 0, m_obj2attachment_mat);
+        }
+        else
+        {
+            m_render_queue.PushVisibleMeshes(*level_ptr, 0, m_obj2attachment_mat, true);
         }
+        m_render_queue.Sort();
+
+        draw_call[0] += m_render_queue.Submit(command_buffer, m_state_cache, m_dynamic_uniform_allocator);
     }
 
     void DeferredPass::DrawQuadOnly(const vk::raii::CommandBuffer& command_buffer)
     {
         FUNCTION_TIMER();
 
-        m_quad_mat.GetShader()->BindPerShaderDescriptorSetToPipeline(command_buffer);
+        m_quad_mat.GetShader()->BindPerShaderDescriptorSetToPipeline(command_buffer, m_frame_index);
 
         for (int32_t i = 0; i < m_quad_model.meshes.size(); ++i)
         {
@@ -351,9 +389,16 @@ namespace Meow
         swap(lhs.m_LightDatas, rhs.m_LightDatas);
         swap(lhs.m_LightInfos, rhs.m_LightInfos);
 
-        swap(lhs.m_per_scene_uniform_buffer, rhs.m_per_scene_uniform_buffer);
-        swap(lhs.m_dynamic_uniform_buffer, rhs.m_dynamic_uniform_buffer);
-        swap(lhs.m_light_data_uniform_buffer, rhs.m_light_data_uniform_buffer);
+        swap(lhs.m_per_scene_uniform_buffers, rhs.m_per_scene_uniform_buffers);
+        swap(lhs.m_dynamic_uniform_allocator, rhs.m_dynamic_uniform_allocator);
+        swap(lhs.m_instance_buffer, rhs.m_instance_buffer);
+        swap(lhs.m_instance_data, rhs.m_instance_data);
+        swap(lhs.m_is_instanced, rhs.m_is_instanced);
+        swap(lhs.m_gpu_culling, rhs.m_gpu_culling);
+        swap(lhs.m_is_gpu_culled, rhs.m_is_gpu_culled);
+        swap(lhs.m_render_queue, rhs.m_render_queue);
+        swap(lhs.m_state_cache, rhs.m_state_cache);
+        swap(lhs.m_light_data_uniform_buffers, rhs.m_light_data_uniform_buffers);
 
         swap(lhs.m_pass_names, rhs.m_pass_names);
         swap(lhs.draw_call, rhs.draw_call);
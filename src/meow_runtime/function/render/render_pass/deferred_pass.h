@@ -1,8 +1,13 @@
 #pragma once
 
 #include "function/render/render_pass/render_pass.h"
+#include "function/render/structs/frame_uniform_allocator.h"
+#include "function/render/structs/gpu_culling.h"
+#include "function/render/structs/instance_buffer.h"
 #include "function/render/structs/material.h"
 #include "function/render/structs/model.h"
+#include "function/render/structs/render_queue.h"
+#include "function/render/structs/render_state_cache.h"
 #include "function/render/structs/shader.h"
 
 namespace Meow
@@ -97,9 +102,25 @@ namespace Meow
         LightDataBlock  m_LightDatas;
         LightSpawnBlock m_LightInfos;
 
-        std::shared_ptr<UniformBuffer> m_per_scene_uniform_buffer;
-        std::shared_ptr<UniformBuffer> m_dynamic_uniform_buffer;
-        std::shared_ptr<UniformBuffer> m_light_data_uniform_buffer;
+        // one per frame in flight
+        std::vector<std::shared_ptr<UniformBuffer>> m_per_scene_uniform_buffers;
+        std::vector<std::shared_ptr<UniformBuffer>> m_light_data_uniform_buffers;
+
+        // pages of the per object uniforms, grown to the number of visible meshes
+        FrameUniformAllocator m_dynamic_uniform_allocator = nullptr;
+
+        // world matrices of the instance batches of the level, when the shader has per instance inputs
+        InstanceBuffer         m_instance_buffer = nullptr;
+        std::vector<glm::mat4> m_instance_data;
+        bool                   m_is_instanced = false;
+
+        // replaces the instance batches when the device can cull and count draws on the GPU
+        GpuCulling m_gpu_culling   = nullptr;
+        bool       m_is_gpu_culled = false;
+
+        // draws of DrawObjOnly, recorded in sort key order through the cache
+        RenderQueue      m_render_queue;
+        RenderStateCache m_state_cache;
 
         std::string m_pass_names[2];
         int         draw_call[2] = {0, 0};
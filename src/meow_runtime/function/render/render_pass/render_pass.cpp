@@ -41,5 +41,7 @@ namespace Meow
         swap(lhs.m_depth_format, rhs.m_depth_format);
         swap(lhs.m_sample_count, rhs.m_sample_count);
         swap(lhs.m_depth_attachment, rhs.m_depth_attachment);
+
+        swap(lhs.m_frame_index, rhs.m_frame_index);
     }
 } // namespace Meow
\ No newline at end of file
@@ -37,6 +37,12 @@ namespace Meow
                                          const vk::Extent2D&               extent)
         {}
 
+        /**
+         * @brief Select the per frame resources that the following UpdateUniformBuffer and Draw use. Set before
+         * updating, once the GPU has finished the previous frame with this index.
+         */
+        void SetFrameIndex(uint32_t frame_index) { m_frame_index = frame_index; }
+
         virtual void UpdateUniformBuffer() {}
 
         virtual void
@@ -61,5 +67,7 @@ namespace Meow
         vk::Format                 m_depth_format     = vk::Format::eD16Unorm;
         vk::SampleCountFlagBits    m_sample_count     = vk::SampleCountFlagBits::e1;
         std::shared_ptr<ImageData> m_depth_attachment = nullptr;
+
+        uint32_t m_frame_index = 0;
     };
 } // namespace Meow
\ No newline at end of file
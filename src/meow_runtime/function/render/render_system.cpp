@@ -130,11 +130,42 @@ namespace Meow
         vk::PhysicalDeviceFeatures physical_device_feature;
         physical_device_feature.pipelineStatisticsQuery = vk::True;
 
+        // timeline semaphores and indirect draw counts are core since Vulkan 1.2, both the instance and the device
+        // have to support it
+        using Vulkan12Features = vk::PhysicalDeviceVulkan12Features;
+
+        const uint32_t   vulkan_1_2 = VK_API_VERSION_1_2;
+        Vulkan12Features vulkan_1_2_features;
+        if (m_vulkan_context.enumerateInstanceVersion() >= vulkan_1_2 &&
+            m_physical_device.getProperties().apiVersion >= vulkan_1_2)
+        {
+            auto features = m_physical_device.getFeatures2<vk::PhysicalDeviceFeatures2, Vulkan12Features>();
+            const vk::PhysicalDeviceFeatures& supported_features =
+                features.get<vk::PhysicalDeviceFeatures2>().features;
+            const Vulkan12Features& supported_1_2_features = features.get<Vulkan12Features>();
+
+            m_is_timeline_semaphore_enabled = supported_1_2_features.timelineSemaphore == vk::True;
+
+            // GPU driven draws write several commands with their own first instance
+            m_is_draw_indirect_count_enabled = supported_1_2_features.drawIndirectCount == vk::True &&
+                                               supported_features.multiDrawIndirect == vk::True &&
+                                               supported_features.drawIndirectFirstInstance == vk::True;
+        }
+        vulkan_1_2_features.timelineSemaphore = m_is_timeline_semaphore_enabled;
+        vulkan_1_2_features.drawIndirectCount = m_is_draw_indirect_count_enabled;
+        if (m_is_draw_indirect_count_enabled)
+        {
+            physical_device_feature.multiDrawIndirect         = vk::True;
+            physical_device_feature.drawIndirectFirstInstance = vk::True;
+        }
+
         vk::DeviceCreateInfo device_info({},                           /* flags */
                                          queue_info,                   /* queueCreateInfoCount */
                                          {},                           /* ppEnabledLayerNames */
                                          k_required_device_extensions, /* ppEnabledExtensionNames */
                                          &physical_device_feature);    /* pEnabledFeatures */
+        if (m_is_timeline_semaphore_enabled || m_is_draw_indirect_count_enabled)
+            device_info.pNext = &vulkan_1_2_features;
         m_logical_device = vk::raii::Device(m_physical_device, device_info);
 
 #if defined(VK_USE_PLATFORM_DISPLAY_KHR)
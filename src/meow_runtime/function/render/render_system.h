@@ -25,6 +25,10 @@ namespace Meow
 
         void Tick(float dt) override;
 
+        SystemResources GetWriteResources() const override { return SystemResourceBit::Device; }
+
+        bool IsMainThreadOnly() const override { return true; }
+
         const vk::raii::Instance&       GetInstance() const { return m_vulkan_instance; };
         const vk::raii::PhysicalDevice& GetPhysicalDevice() const { return m_physical_device; }
         const vk::raii::Device&         GetLogicalDevice() const { return m_logical_device; }
@@ -34,6 +38,18 @@ namespace Meow
         const vk::raii::Queue&          GetGraphicsQueue() const { return m_graphics_queue; }
         const vk::raii::Queue&          GetPresentQueue() const { return m_present_queue; }
 
+        /**
+         * @brief Whether the device was created with timeline semaphores, which windows use to track their frames in
+         * flight instead of one fence per frame.
+         */
+        bool IsTimelineSemaphoreEnabled() const { return m_is_timeline_semaphore_enabled; }
+
+        /**
+         * @brief Whether the device was created with drawIndexedIndirectCount, multi draw indirect and a first instance
+         * in indirect commands, which GPU driven rendering needs.
+         */
+        bool IsDrawIndirectCountEnabled() const { return m_is_draw_indirect_count_enabled; }
+
     private:
         void CreateVulkanInstance();
 #if defined(VKB_DEBUG) || defined(VKB_VALIDATION_LAYERS)
@@ -42,8 +58,10 @@ namespace Meow
         void CreatePhysicalDevice();
         void CreateLogicalDevice();
 
-        bool                           m_is_validation_layer_found  = false;
-        const std::vector<const char*> k_required_device_extensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+        bool                           m_is_validation_layer_found     = false;
+        bool                           m_is_timeline_semaphore_enabled  = false;
+        bool                           m_is_draw_indirect_count_enabled = false;
+        const std::vector<const char*> k_required_device_extensions     = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 
         uint32_t m_graphics_queue_family_index = 0;
         uint32_t m_present_queue_family_index  = 0;
@@ -0,0 +1,192 @@
+#include "frame_uniform_allocator.h"
+
+#include "pch.h"
+
+#include "function/global/runtime_context.h"
+
+#include <algorithm>
+
+namespace Meow
+{
+    FrameUniformAllocator::FrameUniformAllocator(const vk::raii::Device& logical_device,
+                                                 std::shared_ptr<Shader> shader_ptr,
+                                                 uint32_t                set,
+                                                 vk::DeviceSize          page_size)
+        : m_shader_ptr(shader_ptr)
+        , m_set(set)
+        , m_page_size(page_size)
+    {
+        m_min_alignment = g_runtime_context.render_system->GetPhysicalDevice()
+                              .getProperties()
+                              .limits.minUniformBufferOffsetAlignment;
+
+        // the sets of the pages only hold the bindings of one set of the shader
+        std::vector<vk::DescriptorPoolSize> pool_sizes;
+        for (const DescriptorSetLayoutMeta& meta : m_shader_ptr->set_layout_metas.metas)
+        {
+            if (meta.set != m_set)
+                continue;
+
+            for (const vk::DescriptorSetLayoutBinding& binding : meta.bindings)
+            {
+                pool_sizes.emplace_back(binding.descriptorType, binding.descriptorCount * 16);
+            }
+        }
+
+        if (pool_sizes.empty())
+        {
+            MEOW_ERROR("Shader has no descriptor set {} to allocate uniforms for.", m_set);
+            return;
+        }
+
+        m_descriptor_allocator = DescriptorAllocatorGrowable(logical_device, 16, pool_sizes);
+    }
+
+    void FrameUniformAllocator::BeginFrame(uint32_t frame_index)
+    {
+        FUNCTION_TIMER();
+
+        m_frame_index = frame_index;
+
+        std::vector<uint32_t>& frame_pages = m_frame_pages[m_frame_index];
+        for (uint32_t page : frame_pages)
+        {
+            m_pages[page].buffer->Reset();
+        }
+
+        // reversed, so that the pages are popped in the order this frame used them last time
+        m_free_pages.insert(m_free_pages.end(), frame_pages.rbegin(), frame_pages.rend());
+        frame_pages.clear();
+
+        m_used_bytes = 0;
+    }
+
+    FrameUniformAllocation FrameUniformAllocator::Allocate(uint32_t size)
+    {
+        FUNCTION_TIMER();
+
+        if (size > m_page_size)
+        {
+            MEOW_ERROR("Uniforms of {} bytes do not fit a page of {} bytes.", size, m_page_size);
+            return {};
+        }
+
+        std::vector<uint32_t>& frame_pages = m_frame_pages[m_frame_index];
+        if (frame_pages.empty() || !m_pages[frame_pages.back()].buffer->HasSpace(size))
+        {
+            uint32_t page;
+            if (m_free_pages.empty())
+            {
+                page = CreatePage();
+            }
+            else
+            {
+                page = m_free_pages.back();
+                m_free_pages.pop_back();
+            }
+
+            frame_pages.push_back(page);
+            m_peak_page_count = std::max(m_peak_page_count, static_cast<uint32_t>(frame_pages.size()));
+        }
+
+        UniformBuffer& buffer = *m_pages[frame_pages.back()].buffer;
+
+        uint64_t used_before = buffer.allocated_memory;
+        uint64_t offset      = buffer.AllocateMemory(size);
+
+        m_used_bytes += buffer.allocated_memory - used_before;
+        m_peak_bytes = std::max(m_peak_bytes, m_used_bytes);
+
+        return {frame_pages.back(), static_cast<uint32_t>(offset)};
+    }
+
+    FrameUniformAllocation FrameUniformAllocator::Allocate(const void* data, uint32_t size)
+    {
+        FUNCTION_TIMER();
+
+        FrameUniformAllocation allocation = Allocate(size);
+        Write(allocation, data, size);
+
+        return allocation;
+    }
+
+    void FrameUniformAllocator::Write(const FrameUniformAllocation& allocation, const void* data, uint32_t size)
+    {
+        FUNCTION_TIMER();
+
+        if (allocation.page >= m_pages.size() ||
+            allocation.offset + size > m_pages[allocation.page].buffer->allocated_memory)
+        {
+            MEOW_ERROR("Write of {} bytes at offset {} is out of the allocated memory.", size, allocation.offset);
+            return;
+        }
+
+        memcpy(m_pages[allocation.page].buffer->mapped_data_ptr + allocation.offset, data, size);
+    }
+
+    FrameUniformAllocatorStat FrameUniformAllocator::GetStat() const
+    {
+        FrameUniformAllocatorStat stat;
+        stat.page_size       = m_page_size;
+        stat.page_count      = static_cast<uint32_t>(m_pages.size());
+        stat.used_bytes      = m_used_bytes;
+        stat.peak_bytes      = m_peak_bytes;
+        stat.peak_page_count = m_peak_page_count;
+        return stat;
+    }
+
+    uint32_t FrameUniformAllocator::CreatePage()
+    {
+        FUNCTION_TIMER();
+
+        const vk::raii::PhysicalDevice& physical_device = g_runtime_context.render_system->GetPhysicalDevice();
+        const vk::raii::Device&         logical_device  = g_runtime_context.render_system->GetLogicalDevice();
+
+        Page page;
+        page.buffer = std::make_shared<UniformBuffer>(physical_device, logical_device, m_page_size);
+        page.descriptor_set =
+            m_descriptor_allocator.Allocate(logical_device, {m_shader_ptr->descriptor_set_layouts[m_set]});
+
+        // every dynamic uniform buffer of the set reads from the page, at the offsets given when binding
+        for (const auto& [name, meta] : m_shader_ptr->buffer_meta_map)
+        {
+            if (meta.set != m_set || meta.descriptorType != vk::DescriptorType::eUniformBufferDynamic)
+                continue;
+
+            vk::DescriptorBufferInfo descriptor_buffer_info(*page.buffer->buffer, 0, meta.size);
+            vk::WriteDescriptorSet   write_descriptor_set(*page.descriptor_set[0],
+                                                        meta.binding,
+                                                        0,
+                                                        1,
+                                                        vk::DescriptorType::eUniformBufferDynamic,
+                                                        nullptr,
+                                                        &descriptor_buffer_info,
+                                                        nullptr);
+            logical_device.updateDescriptorSets(write_descriptor_set, nullptr);
+        }
+
+        m_pages.push_back(std::move(page));
+
+        return static_cast<uint32_t>(m_pages.size() - 1);
+    }
+
+    void swap(FrameUniformAllocator& lhs, FrameUniformAllocator& rhs)
+    {
+        using std::swap;
+
+        swap(lhs.m_shader_ptr, rhs.m_shader_ptr);
+        swap(lhs.m_set, rhs.m_set);
+        swap(lhs.m_page_size, rhs.m_page_size);
+        swap(lhs.m_min_alignment, rhs.m_min_alignment);
+        swap(lhs.m_descriptor_allocator, rhs.m_descriptor_allocator);
+
+        swap(lhs.m_pages, rhs.m_pages);
+        swap(lhs.m_free_pages, rhs.m_free_pages);
+        swap(lhs.m_frame_pages, rhs.m_frame_pages);
+        swap(lhs.m_frame_index, rhs.m_frame_index);
+
+        swap(lhs.m_used_bytes, rhs.m_used_bytes);
+        swap(lhs.m_peak_bytes, rhs.m_peak_bytes);
+        swap(lhs.m_peak_page_count, rhs.m_peak_page_count);
+    }
+} // namespace Meow
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "core/base/non_copyable.h"
+#include "descriptor_allocator_growable.h"
+#include "per_frame_data.h"
+#include "shader.h"
+#include "uniform_buffer.h"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Usage of a FrameUniformAllocator, reported to the profiler.
+     */
+    struct FrameUniformAllocatorStat
+    {
+        uint64_t page_size       = 0;
+        uint32_t page_count      = 0; // pages of all frames in flight and free ones
+        uint64_t used_bytes      = 0; // by the current frame
+        uint64_t peak_bytes      = 0; // by any frame so far
+        uint32_t peak_page_count = 0; // used by any frame so far
+    };
+
+    /**
+     * @brief Where a FrameUniformAllocator placed some data: the page to bind and the dynamic offset in it.
+     */
+    struct FrameUniformAllocation
+    {
+        uint32_t page   = 0;
+        uint32_t offset = 0;
+    };
+
+    /**
+     * @brief Linear allocator for uniform data written every frame, like the dynamic uniform buffers per object.
+     *
+     * Memory comes from a chain of persistently mapped pages that grows on demand, so the number of objects is not
+     * bounded by one buffer. Each frame in flight owns the pages it allocated from and gives them back when it begins
+     * again, at which point the GPU has finished with it. Pages are kept for later frames, never released.
+     *
+     * Each page has its own descriptor set for one set of the shader, with every dynamic uniform buffer of that set
+     * pointing to the page. Objects are drawn by binding the set of their page with their offsets.
+     */
+    class FrameUniformAllocator : public NonCopyable
+    {
+    public:
+        static constexpr vk::DeviceSize k_default_page_size = 256 * 1024;
+
+        FrameUniformAllocator(std::nullptr_t) {}
+
+        FrameUniformAllocator(const vk::raii::Device& logical_device,
+                              std::shared_ptr<Shader> shader_ptr,
+                              uint32_t                set,
+                              vk::DeviceSize          page_size = k_default_page_size);
+
+        FrameUniformAllocator(FrameUniformAllocator&& rhs) noexcept { swap(*this, rhs); }
+
+        FrameUniformAllocator& operator=(FrameUniformAllocator&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                swap(*this, rhs);
+            }
+            return *this;
+        }
+
+        ~FrameUniformAllocator() override = default;
+
+        /**
+         * @brief Recycle the pages of the frame with this index, the GPU must have finished it.
+         */
+        void BeginFrame(uint32_t frame_index);
+
+        /**
+         * @brief Reserve size contiguous bytes in one page of the current frame, written later with Write.
+         */
+        FrameUniformAllocation Allocate(uint32_t size);
+
+        /**
+         * @brief Copy size bytes of data into the pages of the current frame.
+         */
+        FrameUniformAllocation Allocate(const void* data, uint32_t size);
+
+        /**
+         * @brief Copy size bytes of data to an allocation, or to an offset inside of it.
+         */
+        void Write(const FrameUniformAllocation& allocation, const void* data, uint32_t size);
+
+        /**
+         * @brief Alignment of the offsets of the allocations, offsets inside of an allocation must keep it too.
+         */
+        uint32_t GetMinAlignment() const { return m_min_alignment; }
+
+        const vk::raii::DescriptorSet& GetDescriptorSet(uint32_t page) const { return m_pages[page].descriptor_set[0]; }
+
+        FrameUniformAllocatorStat GetStat() const;
+
+        friend void swap(FrameUniformAllocator& lhs, FrameUniformAllocator& rhs);
+
+    private:
+        struct Page
+        {
+            std::shared_ptr<UniformBuffer> buffer;
+            vk::raii::DescriptorSets       descriptor_set = nullptr;
+        };
+
+        uint32_t CreatePage();
+
+        std::shared_ptr<Shader>     m_shader_ptr    = nullptr;
+        uint32_t                    m_set           = 0;
+        vk::DeviceSize              m_page_size     = 0;
+        uint32_t                    m_min_alignment = 0;
+        DescriptorAllocatorGrowable m_descriptor_allocator = nullptr;
+
+        std::vector<Page>     m_pages;
+        std::vector<uint32_t> m_free_pages;
+        std::vector<uint32_t> m_frame_pages[k_max_frames_in_flight];
+        uint32_t              m_frame_index = 0;
+
+        uint64_t m_used_bytes      = 0;
+        uint64_t m_peak_bytes      = 0;
+        uint32_t m_peak_page_count = 0;
+    };
+} // namespace Meow
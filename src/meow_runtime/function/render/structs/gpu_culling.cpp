@@ -0,0 +1,554 @@
+#include "gpu_culling.h"
+
+#include "pch.h"
+
+#include "function/components/camera/camera_3d_component.hpp"
+#include "function/components/model/model_component.h"
+#include "function/components/transform/transform_3d_component.hpp"
+#include "function/global/runtime_context.h"
+#include "function/level/level.h"
+
+#include <algorithm>
+
+namespace Meow
+{
+    GpuCulling::GpuCulling(const vk::raii::PhysicalDevice& physical_device,
+                           const vk::raii::Device&         logical_device,
+                           DescriptorAllocatorGrowable&    descriptor_allocator)
+    {
+        auto cull_shader_ptr = std::make_shared<Shader>(
+            physical_device, logical_device, descriptor_allocator, "", "", "", "builtin/shaders/cull.comp.spv");
+
+        m_cull_mat = Material(physical_device, logical_device, cull_shader_ptr);
+        m_cull_mat.CreateComputePipeline(logical_device);
+
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            m_frames[i].cull_data_buffer =
+                std::make_shared<UniformBuffer>(physical_device, logical_device, sizeof(CullData));
+
+            m_cull_mat.GetShader()->BindBufferToDescriptor(
+                logical_device, i, "cullData", m_frames[i].cull_data_buffer->buffer);
+        }
+    }
+
+    GpuCulling::~GpuCulling()
+    {
+        for (FrameData& frame : m_frames)
+        {
+            for (MappedBuffer* mapped_buffer :
+                 {&frame.objects, &frame.groups, &frame.commands, &frame.counts, &frame.transforms})
+            {
+                if (mapped_buffer->mapped_data_ptr)
+                {
+                    mapped_buffer->mapped_data_ptr = nullptr;
+                    mapped_buffer->buffer->device_memory.unmapMemory();
+                }
+            }
+        }
+    }
+
+    bool GpuCulling::IsSupported()
+    {
+        return g_runtime_context.render_system->IsDrawIndirectCountEnabled() &&
+               g_runtime_context.file_system->Exists("builtin/shaders/cull.comp.spv");
+    }
+
+    void GpuCulling::Update(uint32_t frame_index, const Level& level)
+    {
+        FUNCTION_TIMER();
+
+        ReadBack(frame_index);
+
+        // missed ticks lost their bounds changes, including removals of meshes that may have been freed since
+        const uint64_t tick_count = level.GetTickCount();
+        if (!m_has_level || level.GetID() != m_level_id || tick_count > m_tick_count + 1)
+        {
+            Reset(level);
+        }
+        else if (tick_count == m_tick_count + 1)
+        {
+            // removed ids may have been reused by changed ones
+            for (uint32_t id : level.GetRemovedBoundsIds())
+            {
+                RemoveObject(id);
+            }
+            for (uint32_t id : level.GetChangedBoundsIds())
+            {
+                UpdateObject(level, id);
+            }
+        }
+
+        m_tick_count = tick_count;
+
+        if (m_is_group_layout_dirty)
+        {
+            UpdateGroupLayout();
+        }
+
+        FrameData& frame = m_frames[frame_index];
+
+        const uint32_t slot_count  = static_cast<uint32_t>(m_cull_objects.size());
+        const uint32_t group_count = static_cast<uint32_t>(m_draw_groups.size());
+
+        frame.slot_count   = slot_count;
+        frame.object_count = m_object_count;
+        frame.group_count  = group_count;
+
+        using Usage = vk::BufferUsageFlagBits;
+        bool is_objects_new =
+            Reserve(frame_index, frame.objects, slot_count, sizeof(CullObject), Usage::eStorageBuffer, "cullObjects");
+        bool is_transforms_new = Reserve(frame_index,
+                                         frame.transforms,
+                                         slot_count,
+                                         sizeof(glm::mat4),
+                                         Usage::eStorageBuffer | Usage::eVertexBuffer,
+                                         "transforms");
+        if (Reserve(frame_index, frame.groups, group_count, sizeof(DrawGroup), Usage::eStorageBuffer, "drawGroups"))
+        {
+            frame.is_groups_dirty = true;
+        }
+        Reserve(frame_index,
+                frame.commands,
+                m_object_count,
+                sizeof(vk::DrawIndexedIndirectCommand),
+                Usage::eStorageBuffer | Usage::eIndirectBuffer,
+                "drawCommands");
+        Reserve(frame_index,
+                frame.counts,
+                group_count,
+                sizeof(uint32_t),
+                Usage::eStorageBuffer | Usage::eIndirectBuffer | Usage::eTransferDst,
+                "drawCounts");
+
+        // only the slots changed since the last update of this frame, unless its buffers are new
+        auto* cull_objects = static_cast<CullObject*>(frame.objects.mapped_data_ptr);
+        auto* transforms   = static_cast<glm::mat4*>(frame.transforms.mapped_data_ptr);
+        if (is_objects_new || is_transforms_new)
+        {
+            std::copy(m_cull_objects.begin(), m_cull_objects.end(), cull_objects);
+            std::copy(m_transforms.begin(), m_transforms.end(), transforms);
+        }
+        else
+        {
+            for (uint32_t slot : frame.dirty_slots)
+            {
+                cull_objects[slot] = m_cull_objects[slot];
+                transforms[slot]   = m_transforms[slot];
+            }
+        }
+        frame.dirty_slots.clear();
+
+        if (frame.is_groups_dirty)
+        {
+            auto* groups = static_cast<DrawGroup*>(frame.groups.mapped_data_ptr);
+            std::copy(m_draw_groups.begin(), m_draw_groups.end(), groups);
+            frame.is_groups_dirty = false;
+        }
+
+        if (m_object_count == 0)
+            return;
+
+        GameObject*    camera_go_ptr = level.GetGameObject(level.GetMainCamera());
+        const Frustum& frustum       = camera_go_ptr->GetComponent<Camera3DComponent>()->GetFrustum();
+
+        CullData cull_data     = {};
+        cull_data.object_count = slot_count;
+        for (uint32_t i = 0; i < 6; ++i)
+        {
+            cull_data.planes[i] = frustum.GetPlane(i);
+        }
+
+        frame.cull_data_buffer->Reset();
+        frame.cull_data_buffer->Populate(&cull_data, sizeof(CullData));
+
+#ifdef MEOW_DEBUG
+        // reference for the readback, the same p-vertex test as cull.comp
+        frame.cpu_counts.assign(group_count, 0);
+        for (uint32_t slot = 0; slot < slot_count; ++slot)
+        {
+            const CullObject& object = m_cull_objects[slot];
+            if (object.group == k_invalid_group)
+                continue;
+
+            BoundingBox bounds = BoundingBox(object.bounds_min, object.bounds_max).Transformed(m_transforms[slot]);
+
+            bool is_visible = true;
+            for (uint32_t i = 0; i < 6 && is_visible; ++i)
+            {
+                glm::vec3 normal   = glm::vec3(cull_data.planes[i]);
+                glm::vec3 p_vertex = glm::mix(bounds.min, bounds.max, glm::greaterThanEqual(normal, glm::vec3(0.0f)));
+                is_visible         = glm::dot(normal, p_vertex) + cull_data.planes[i].w >= 0.0f;
+            }
+
+            frame.cpu_counts[object.group] += is_visible;
+        }
+#endif
+    }
+
+    void GpuCulling::Dispatch(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index)
+    {
+        FUNCTION_TIMER();
+
+        const FrameData& frame = m_frames[frame_index];
+        if (frame.object_count == 0)
+            return;
+
+        // the compute pass appends to the counts, which start at zero every frame
+        command_buffer.fillBuffer(*frame.counts.buffer->buffer, 0, frame.group_count * sizeof(uint32_t), 0);
+
+        vk::MemoryBarrier clear_barrier(vk::AccessFlagBits::eTransferWrite,
+                                        vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,      /* srcStageMask */
+                                       vk::PipelineStageFlagBits::eComputeShader, /* dstStageMask */
+                                       {},                                        /* dependencyFlags */
+                                       clear_barrier,                             /* pMemoryBarriers */
+                                       nullptr,                                   /* pBufferMemoryBarriers */
+                                       nullptr);                                  /* pImageMemoryBarriers */
+
+        // free slots are dispatched too, the shader skips them
+        m_cull_mat.BindComputePipeline(command_buffer);
+        m_cull_mat.GetShader()->BindDescriptorSetsToComputePipeline(command_buffer, frame_index);
+        command_buffer.dispatch((frame.slot_count + k_group_size - 1) / k_group_size, 1, 1);
+
+        // the draws read the commands and counts, the host reads the counts back once the frame is finished
+        vk::MemoryBarrier cull_barrier(vk::AccessFlagBits::eShaderWrite,
+                                       vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eHostRead);
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, /* srcStageMask */
+                                       vk::PipelineStageFlagBits::eDrawIndirect |
+                                           vk::PipelineStageFlagBits::eHost,      /* dstStageMask */
+                                       {},                                        /* dependencyFlags */
+                                       cull_barrier,                              /* pMemoryBarriers */
+                                       nullptr,                                   /* pBufferMemoryBarriers */
+                                       nullptr);                                  /* pImageMemoryBarriers */
+    }
+
+    uint32_t GpuCulling::Draw(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) const
+    {
+        FUNCTION_TIMER();
+
+        const FrameData& frame = m_frames[frame_index];
+        if (frame.object_count == 0)
+            return 0;
+
+        // the groups are as of the update of this frame, which the draw follows
+        uint32_t draw_count = 0;
+        for (uint32_t group = 0; group < frame.group_count; ++group)
+        {
+            if (m_group_sizes[group] == 0)
+                continue;
+
+            // the transforms replace any per instance data of the mesh at binding 1
+            m_group_meshes[group]->BindOnly(command_buffer);
+            command_buffer.bindVertexBuffers(1, {*frame.transforms.buffer->buffer}, {0});
+
+            command_buffer.drawIndexedIndirectCount(*frame.commands.buffer->buffer,
+                                                    m_draw_groups[group].first_command *
+                                                        sizeof(vk::DrawIndexedIndirectCommand),
+                                                    *frame.counts.buffer->buffer,
+                                                    group * sizeof(uint32_t),
+                                                    m_group_sizes[group],
+                                                    sizeof(vk::DrawIndexedIndirectCommand));
+            ++draw_count;
+        }
+
+        return draw_count;
+    }
+
+    void GpuCulling::UpdateObject(const Level& level, uint32_t id)
+    {
+        const TransformHierarchy& hierarchy = level.GetTransformHierarchy();
+
+        // meshes of the model of the owner, none if the node lost its bounds
+        m_meshes.clear();
+        BoundingBox bounds;
+        if (hierarchy.Contains(id) && hierarchy.GetWorldBounds(id, bounds))
+        {
+            GameObject*            gameobject     = level.GetGameObject(hierarchy.GetOwner(id));
+            ModelComponent*        model_comp_ptr = gameobject ? gameobject->GetComponent<ModelComponent>() : nullptr;
+            std::shared_ptr<Model> model          = model_comp_ptr ? model_comp_ptr->model_ptr.lock() : nullptr;
+            if (model)
+            {
+                for (ModelMesh* mesh : model->meshes)
+                {
+                    if (mesh->vertex_buffer_ptr && mesh->index_buffer_ptr)
+                        m_meshes.push_back(mesh);
+                }
+            }
+        }
+
+        if (id >= m_slots_by_id.size())
+            m_slots_by_id.resize(id + 1);
+
+        // a node whose model changed gets new slots
+        std::vector<uint32_t>& slots         = m_slots_by_id[id];
+        bool                   is_same_model = slots.size() == m_meshes.size();
+        for (uint32_t i = 0; i < slots.size() && is_same_model; ++i)
+        {
+            is_same_model = m_group_meshes[m_cull_objects[slots[i]].group] == m_meshes[i];
+        }
+
+        if (!is_same_model)
+        {
+            RemoveObject(id);
+            for (ModelMesh* mesh : m_meshes)
+            {
+                slots.push_back(AddSlot(mesh));
+            }
+        }
+
+        if (slots.empty())
+            return;
+
+        const glm::mat4& world_matrix = hierarchy.GetWorldMatrix(id);
+        for (uint32_t i = 0; i < slots.size(); ++i)
+        {
+            const ModelMesh* mesh = m_meshes[i];
+
+            m_transforms[slots[i]] = mesh->link_node ? world_matrix * mesh->link_node->global_matrix : world_matrix;
+            MarkSlotDirty(slots[i]);
+        }
+    }
+
+    void GpuCulling::RemoveObject(uint32_t id)
+    {
+        if (id >= m_slots_by_id.size())
+            return;
+
+        for (uint32_t slot : m_slots_by_id[id])
+        {
+            ReleaseSlot(slot);
+        }
+        m_slots_by_id[id].clear();
+    }
+
+    void GpuCulling::Reset(const Level& level)
+    {
+        FUNCTION_TIMER();
+
+        m_has_level = true;
+        m_level_id  = level.GetID();
+
+        m_cull_objects.clear();
+        m_transforms.clear();
+        m_free_slots.clear();
+        m_slots_by_id.clear();
+
+        m_draw_groups.clear();
+        m_group_meshes.clear();
+        m_group_sizes.clear();
+        m_free_groups.clear();
+        m_group_by_mesh.clear();
+        m_is_group_layout_dirty = true;
+
+        m_object_count = 0;
+
+        // the slots are numbered anew, the buffers of the frames only hold what is below the slot count
+        for (FrameData& frame : m_frames)
+        {
+            frame.dirty_slots.clear();
+        }
+
+        for (const std::shared_ptr<GameObject>& go_ptr : level.GetAllGameObjects())
+        {
+            Transform3DComponent* transform_comp_ptr = go_ptr->GetComponent<Transform3DComponent>();
+            if (transform_comp_ptr && transform_comp_ptr->GetHierarchyId() != TransformHierarchy::k_invalid_id)
+                UpdateObject(level, transform_comp_ptr->GetHierarchyId());
+        }
+    }
+
+    uint32_t GpuCulling::AddSlot(ModelMesh* mesh)
+    {
+        auto [it, is_new] = m_group_by_mesh.emplace(mesh, 0);
+        if (is_new)
+        {
+            if (m_free_groups.empty())
+            {
+                it->second = static_cast<uint32_t>(m_draw_groups.size());
+                m_draw_groups.emplace_back();
+                m_group_meshes.push_back(nullptr);
+                m_group_sizes.push_back(0);
+            }
+            else
+            {
+                it->second = m_free_groups.back();
+                m_free_groups.pop_back();
+            }
+
+            m_group_meshes[it->second] = mesh;
+
+            // the full resolution mesh, levels of detail are not selected on the GPU
+            DrawGroup& draw_group    = m_draw_groups[it->second];
+            draw_group.first_command = 0;
+            draw_group.index_count   = static_cast<uint32_t>(mesh->index_buffer_ptr->index_count);
+            draw_group.first_index   = 0;
+            draw_group.padding       = 0;
+            if (!mesh->lods.empty())
+            {
+                draw_group.index_count = mesh->lods[0].index_count;
+                draw_group.first_index = mesh->lods[0].first_index;
+            }
+        }
+
+        const uint32_t group = it->second;
+        ++m_group_sizes[group];
+        ++m_object_count;
+        m_is_group_layout_dirty = true;
+
+        uint32_t slot;
+        if (m_free_slots.empty())
+        {
+            slot = static_cast<uint32_t>(m_cull_objects.size());
+            m_cull_objects.emplace_back();
+            m_transforms.emplace_back(1.0f);
+        }
+        else
+        {
+            slot = m_free_slots.back();
+            m_free_slots.pop_back();
+        }
+
+        CullObject& cull_object = m_cull_objects[slot];
+        cull_object.bounds_min  = mesh->bounding.min;
+        cull_object.group       = group;
+        cull_object.bounds_max  = mesh->bounding.max;
+        cull_object.padding     = 0;
+
+        return slot;
+    }
+
+    void GpuCulling::ReleaseSlot(uint32_t slot)
+    {
+        const uint32_t group = m_cull_objects[slot].group;
+        if (--m_group_sizes[group] == 0)
+        {
+            m_group_by_mesh.erase(m_group_meshes[group]);
+            m_group_meshes[group] = nullptr;
+            m_free_groups.push_back(group);
+        }
+        --m_object_count;
+        m_is_group_layout_dirty = true;
+
+        m_cull_objects[slot].group = k_invalid_group;
+        m_free_slots.push_back(slot);
+        MarkSlotDirty(slot);
+    }
+
+    void GpuCulling::MarkSlotDirty(uint32_t slot)
+    {
+        for (FrameData& frame : m_frames)
+        {
+            frame.dirty_slots.push_back(slot);
+        }
+    }
+
+    void GpuCulling::UpdateGroupLayout()
+    {
+        // each group owns a range of commands as large as its number of objects, free groups an empty one
+        uint32_t first_command = 0;
+        for (uint32_t group = 0; group < m_draw_groups.size(); ++group)
+        {
+            m_draw_groups[group].first_command = first_command;
+            first_command += m_group_sizes[group];
+        }
+
+        for (FrameData& frame : m_frames)
+        {
+            frame.is_groups_dirty = true;
+        }
+        m_is_group_layout_dirty = false;
+    }
+
+    bool GpuCulling::Reserve(uint32_t             frame_index,
+                             MappedBuffer&        mapped_buffer,
+                             uint32_t             count,
+                             uint32_t             element_size,
+                             vk::BufferUsageFlags usage,
+                             const std::string&   name)
+    {
+        if (count <= mapped_buffer.capacity)
+            return false;
+
+        const vk::raii::PhysicalDevice& physical_device = g_runtime_context.render_system->GetPhysicalDevice();
+        const vk::raii::Device&         logical_device  = g_runtime_context.render_system->GetLogicalDevice();
+
+        uint32_t capacity = std::max({count, mapped_buffer.capacity * 2, k_min_capacity});
+
+        if (mapped_buffer.mapped_data_ptr)
+        {
+            mapped_buffer.buffer->device_memory.unmapMemory();
+        }
+
+        // the GPU has finished the frame, so its old buffer can be released
+        mapped_buffer.buffer =
+            std::make_shared<BufferData>(physical_device, logical_device, capacity * element_size, usage);
+        mapped_buffer.mapped_data_ptr = mapped_buffer.buffer->device_memory.mapMemory(0, VK_WHOLE_SIZE);
+        mapped_buffer.capacity        = capacity;
+
+        m_cull_mat.GetShader()->BindBufferToDescriptor(logical_device, frame_index, name, mapped_buffer.buffer->buffer);
+
+        return true;
+    }
+
+    void GpuCulling::ReadBack(uint32_t frame_index)
+    {
+        const FrameData& frame = m_frames[frame_index];
+        if (frame.object_count == 0)
+            return;
+
+        const uint32_t  group_count = frame.group_count;
+        const uint32_t* counts      = static_cast<const uint32_t*>(frame.counts.mapped_data_ptr);
+
+        m_stat              = {};
+        m_stat.object_count = frame.object_count;
+        m_stat.group_count  = group_count;
+        for (uint32_t group = 0; group < group_count; ++group)
+        {
+            m_stat.gpu_visible_count += counts[group];
+        }
+
+#ifdef MEOW_DEBUG
+        for (uint32_t group = 0; group < group_count; ++group)
+        {
+            m_stat.cpu_visible_count += frame.cpu_counts[group];
+            m_stat.mismatch_count += counts[group] != frame.cpu_counts[group];
+        }
+
+        if (m_stat.mismatch_count > 0)
+        {
+            MEOW_WARN("GPU culling kept {} objects, CPU culling {}, {} of {} meshes differ.",
+                      m_stat.gpu_visible_count,
+                      m_stat.cpu_visible_count,
+                      m_stat.mismatch_count,
+                      group_count);
+        }
+#endif
+    }
+
+    void swap(GpuCulling& lhs, GpuCulling& rhs)
+    {
+        using std::swap;
+
+        swap(lhs.m_cull_mat, rhs.m_cull_mat);
+        swap(lhs.m_frames, rhs.m_frames);
+        swap(lhs.m_has_level, rhs.m_has_level);
+        swap(lhs.m_level_id, rhs.m_level_id);
+        swap(lhs.m_tick_count, rhs.m_tick_count);
+
+        swap(lhs.m_cull_objects, rhs.m_cull_objects);
+        swap(lhs.m_transforms, rhs.m_transforms);
+        swap(lhs.m_free_slots, rhs.m_free_slots);
+        swap(lhs.m_slots_by_id, rhs.m_slots_by_id);
+
+        swap(lhs.m_draw_groups, rhs.m_draw_groups);
+        swap(lhs.m_group_meshes, rhs.m_group_meshes);
+        swap(lhs.m_group_sizes, rhs.m_group_sizes);
+        swap(lhs.m_free_groups, rhs.m_free_groups);
+        swap(lhs.m_group_by_mesh, rhs.m_group_by_mesh);
+        swap(lhs.m_is_group_layout_dirty, rhs.m_is_group_layout_dirty);
+
+        swap(lhs.m_object_count, rhs.m_object_count);
+        swap(lhs.m_meshes, rhs.m_meshes);
+        swap(lhs.m_stat, rhs.m_stat);
+    }
+} // namespace Meow
@@ -0,0 +1,236 @@
+#pragma once
+
+#include "buffer_data.h"
+#include "core/base/non_copyable.h"
+#include "material.h"
+#include "per_frame_data.h"
+#include "uniform_buffer.h"
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Meow
+{
+    class Level;
+    struct ModelMesh;
+
+    /**
+     * @brief Counts of the last frame of a GpuCulling whose draw counts were read back.
+     */
+    struct GpuCullingStat
+    {
+        uint32_t object_count      = 0;
+        uint32_t group_count       = 0;
+        uint32_t gpu_visible_count = 0;
+        uint32_t cpu_visible_count = 0; // same test on the CPU, only computed in debug builds
+        uint32_t mismatch_count    = 0; // groups whose GPU and CPU counts differ, only in debug builds
+    };
+
+    /**
+     * @brief Frustum culling on the GPU, drawing the visible meshes with indirect draws whose count the GPU decides.
+     *
+     * Every mesh of every model of the level is an object with its bounds and world matrix in storage buffers. A
+     * compute pass tests the objects against the frustum of the main camera and appends one indexed draw command per
+     * visible object to the range of its mesh, counting the commands of each mesh. Draw then issues one
+     * drawIndexedIndirectCount per mesh, so the CPU never learns which objects are visible.
+     *
+     * Each draw command draws one instance whose first instance is the slot of its object. The matrices are bound as
+     * the per instance vertex input at binding 1, so the pass shader must read a world matrix per instance.
+     *
+     * Objects keep their slot in the buffers while they exist. Update only rewrites the slots of the transforms whose
+     * bounds changed or were removed in the last tick of the level, so the level does not need to cull on the CPU. If
+     * the level ticked more than once since the last update, the changes of the ticks in between are lost, so all
+     * objects are added again.
+     * Each frame in flight has its own copy of the buffers, which catches up with the changes of the frames in
+     * between when the frame is updated again. Draw counts are read back there too: in debug builds they are
+     * compared with the same test on the CPU and mismatches are reported.
+     */
+    class GpuCulling : public NonCopyable
+    {
+    public:
+        GpuCulling(std::nullptr_t) {}
+
+        GpuCulling(const vk::raii::PhysicalDevice& physical_device,
+                   const vk::raii::Device&         logical_device,
+                   DescriptorAllocatorGrowable&    descriptor_allocator);
+
+        GpuCulling(GpuCulling&& rhs) noexcept { swap(*this, rhs); }
+
+        GpuCulling& operator=(GpuCulling&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                swap(*this, rhs);
+            }
+            return *this;
+        }
+
+        ~GpuCulling() override;
+
+        /**
+         * @brief Whether the device and the builtin shaders support culling on the GPU.
+         */
+        static bool IsSupported();
+
+        /**
+         * @brief Read back the counts of the last use of this frame, then apply the bounds changes of the last tick of
+         * the level to the objects and write the changed slots into the buffers of this frame. The GPU must have
+         * finished the frame. A level other than the one of the last update, or one that ticked more than once since,
+         * is added as a whole.
+         */
+        void Update(uint32_t frame_index, const Level& level);
+
+        /**
+         * @brief Record the culling pass, outside of a render pass and before Draw.
+         */
+        void Dispatch(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index);
+
+        /**
+         * @brief Draw the visible objects with the pipeline and descriptor sets bound by the caller.
+         *
+         * @return Number of indirect draws recorded, one per mesh.
+         */
+        uint32_t Draw(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) const;
+
+        const GpuCullingStat& GetStat() const { return m_stat; }
+
+        friend void swap(GpuCulling& lhs, GpuCulling& rhs);
+
+    private:
+        // group of the free slots, skipped by cull.comp
+        static constexpr uint32_t k_invalid_group = ~0u;
+
+        // std140 layout of cullData in cull.comp
+        struct CullData
+        {
+            glm::vec4 planes[6];
+            uint32_t  object_count;
+            uint32_t  padding[3];
+        };
+
+        // std430 layout of the objects in cull.comp
+        struct CullObject
+        {
+            glm::vec3 bounds_min;
+            uint32_t  group;
+            glm::vec3 bounds_max;
+            uint32_t  padding;
+        };
+
+        // std430 layout of the groups in cull.comp, one per mesh
+        struct DrawGroup
+        {
+            uint32_t first_command;
+            uint32_t index_count;
+            uint32_t first_index;
+            uint32_t padding;
+        };
+
+        struct MappedBuffer
+        {
+            std::shared_ptr<BufferData> buffer;
+            void*                       mapped_data_ptr = nullptr;
+            uint32_t                    capacity        = 0;
+        };
+
+        struct FrameData
+        {
+            std::shared_ptr<UniformBuffer> cull_data_buffer;
+
+            MappedBuffer objects;
+            MappedBuffer groups;
+            MappedBuffer commands;
+            MappedBuffer counts;
+            MappedBuffer transforms;
+
+            // slots changed since this frame was updated last, may repeat
+            std::vector<uint32_t> dirty_slots;
+            bool                  is_groups_dirty = false;
+
+            // as of the last update of this frame, for the readback
+            uint32_t              slot_count   = 0;
+            uint32_t              object_count = 0;
+            uint32_t              group_count  = 0;
+            std::vector<uint32_t> cpu_counts; // debug builds only
+        };
+
+        static constexpr uint32_t k_min_capacity = 256;
+        static constexpr uint32_t k_group_size   = 64; // local_size_x of cull.comp
+
+        /**
+         * @brief Give the transform hierarchy node id one slot per mesh of the model of its owner, or update the
+         * matrices of its slots. A node without bounds or model loses its slots.
+         */
+        void UpdateObject(const Level& level, uint32_t id);
+
+        void RemoveObject(uint32_t id);
+
+        /**
+         * @brief Drop all objects and add those of level.
+         */
+        void Reset(const Level& level);
+
+        uint32_t AddSlot(ModelMesh* mesh);
+
+        void ReleaseSlot(uint32_t slot);
+
+        void MarkSlotDirty(uint32_t slot);
+
+        /**
+         * @brief Give each group a range of commands as large as its number of objects.
+         */
+        void UpdateGroupLayout();
+
+        /**
+         * @brief Grow a buffer of a frame to hold count elements, binding the new buffer to name in the cull shader.
+         *
+         * @return Whether a new buffer was created, with undefined content.
+         */
+        bool Reserve(uint32_t             frame_index,
+                     MappedBuffer&        mapped_buffer,
+                     uint32_t             count,
+                     uint32_t             element_size,
+                     vk::BufferUsageFlags usage,
+                     const std::string&   name);
+
+        void ReadBack(uint32_t frame_index);
+
+        Material m_cull_mat = nullptr;
+
+        FrameData m_frames[k_max_frames_in_flight];
+
+        // the level the objects belong to and its tick whose bounds changes they include
+        bool     m_has_level  = false;
+        uint64_t m_level_id   = 0;
+        uint64_t m_tick_count = 0;
+
+        // by slot, copied to the buffers of each frame
+        std::vector<CullObject> m_cull_objects;
+        std::vector<glm::mat4>  m_transforms;
+        std::vector<uint32_t>   m_free_slots;
+
+        // by transform hierarchy id, one slot per mesh of the model
+        std::vector<std::vector<uint32_t>> m_slots_by_id;
+
+        // by group, a group whose mesh is nullptr is free
+        std::vector<DrawGroup>                   m_draw_groups;
+        std::vector<ModelMesh*>                  m_group_meshes;
+        std::vector<uint32_t>                    m_group_sizes;
+        std::vector<uint32_t>                    m_free_groups;
+        std::unordered_map<ModelMesh*, uint32_t> m_group_by_mesh;
+        bool                                     m_is_group_layout_dirty = false;
+
+        uint32_t m_object_count = 0;
+
+        // kept to avoid allocating every update
+        std::vector<ModelMesh*> m_meshes;
+
+        GpuCullingStat m_stat;
+    };
+} // namespace Meow
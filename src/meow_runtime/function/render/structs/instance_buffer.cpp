@@ -0,0 +1,79 @@
+#include "instance_buffer.h"
+
+#include "pch.h"
+
+#include "function/global/runtime_context.h"
+
+#include <algorithm>
+
+namespace Meow
+{
+    InstanceBuffer::~InstanceBuffer()
+    {
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            if (m_mapped_data_ptrs[i])
+            {
+                m_mapped_data_ptrs[i] = nullptr;
+                m_buffers[i]->device_memory.unmapMemory();
+            }
+        }
+    }
+
+    void InstanceBuffer::Populate(uint32_t frame_index, const void* data, uint32_t instance_count)
+    {
+        FUNCTION_TIMER();
+
+        if (instance_count == 0)
+            return;
+
+        if (instance_count > m_capacities[frame_index])
+        {
+            const vk::raii::PhysicalDevice& physical_device = g_runtime_context.render_system->GetPhysicalDevice();
+            const vk::raii::Device&         logical_device  = g_runtime_context.render_system->GetLogicalDevice();
+
+            uint32_t capacity = std::max({instance_count, m_capacities[frame_index] * 2, k_min_capacity});
+
+            if (m_mapped_data_ptrs[frame_index])
+            {
+                m_buffers[frame_index]->device_memory.unmapMemory();
+            }
+
+            m_buffers[frame_index] = std::make_shared<BufferData>(
+                physical_device, logical_device, capacity * m_stride, vk::BufferUsageFlagBits::eVertexBuffer);
+            m_mapped_data_ptrs[frame_index] =
+                static_cast<uint8_t*>(m_buffers[frame_index]->device_memory.mapMemory(0, VK_WHOLE_SIZE));
+            m_capacities[frame_index] = capacity;
+        }
+
+        memcpy(m_mapped_data_ptrs[frame_index], data, static_cast<size_t>(instance_count) * m_stride);
+    }
+
+    void InstanceBuffer::Bind(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) const
+    {
+        if (!m_buffers[frame_index])
+            return;
+
+        command_buffer.bindVertexBuffers(1, {*m_buffers[frame_index]->buffer}, {0});
+    }
+
+    void InstanceBuffer::Bind(const vk::raii::CommandBuffer& command_buffer,
+                              uint32_t                       frame_index,
+                              RenderStateCache&              state_cache) const
+    {
+        if (!m_buffers[frame_index])
+            return;
+
+        state_cache.BindVertexBuffer(command_buffer, 1, *m_buffers[frame_index]->buffer, 0);
+    }
+
+    void swap(InstanceBuffer& lhs, InstanceBuffer& rhs)
+    {
+        using std::swap;
+
+        swap(lhs.m_stride, rhs.m_stride);
+        swap(lhs.m_buffers, rhs.m_buffers);
+        swap(lhs.m_mapped_data_ptrs, rhs.m_mapped_data_ptrs);
+        swap(lhs.m_capacities, rhs.m_capacities);
+    }
+} // namespace Meow
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "buffer_data.h"
+#include "core/base/non_copyable.h"
+#include "per_frame_data.h"
+#include "render_state_cache.h"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <memory>
+
+namespace Meow
+{
+    /**
+     * @brief Per instance vertex data written every frame, like the world matrices of instanced draws.
+     *
+     * Each frame in flight has its own persistently mapped buffer, so a frame can be written while the GPU still reads
+     * the others. A buffer too small for a frame is replaced by one at least twice as large, which is safe because the
+     * GPU has finished a frame when it begins again.
+     */
+    class InstanceBuffer : public NonCopyable
+    {
+    public:
+        InstanceBuffer(std::nullptr_t) {}
+
+        InstanceBuffer(uint32_t stride)
+            : m_stride(stride)
+        {}
+
+        InstanceBuffer(InstanceBuffer&& rhs) noexcept { swap(*this, rhs); }
+
+        InstanceBuffer& operator=(InstanceBuffer&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                swap(*this, rhs);
+            }
+            return *this;
+        }
+
+        ~InstanceBuffer() override;
+
+        /**
+         * @brief Copy the data of instance_count instances of stride bytes each into the buffer of a frame.
+         */
+        void Populate(uint32_t frame_index, const void* data, uint32_t instance_count);
+
+        /**
+         * @brief Bind the buffer of a frame to binding 1, where instanced pipelines read their per instance inputs.
+         */
+        void Bind(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index) const;
+
+        void Bind(const vk::raii::CommandBuffer& command_buffer,
+                  uint32_t                       frame_index,
+                  RenderStateCache&              state_cache) const;
+
+        uint32_t GetStride() const { return m_stride; }
+
+        friend void swap(InstanceBuffer& lhs, InstanceBuffer& rhs);
+
+    private:
+        static constexpr uint32_t k_min_capacity = 256;
+
+        uint32_t m_stride = 0;
+
+        std::shared_ptr<BufferData> m_buffers[k_max_frames_in_flight];
+        uint8_t*                    m_mapped_data_ptrs[k_max_frames_in_flight] = {};
+        uint32_t                    m_capacities[k_max_frames_in_flight]       = {};
+    };
+} // namespace Meow
@@ -73,8 +73,8 @@ namespace Meow
         uint32_t vertex_stride = VertexAttributesToSize(shader_ptr->per_vertex_attributes);
 
         std::vector<vk::VertexInputAttributeDescription> vertex_input_attribute_descriptions;
+        std::vector<vk::VertexInputBindingDescription>   vertex_input_binding_descriptions;
         vk::PipelineVertexInputStateCreateInfo           pipeline_vertex_input_state_create_info;
-        vk::VertexInputBindingDescription                vertex_input_binding_description(0, vertex_stride);
 
         if (0 < vertex_stride)
         {
@@ -87,10 +87,26 @@ namespace Meow
                     i, 0, VertexAttributeToVkFormat(attributes[i]), curr_offset);
                 curr_offset += VertexAttributeToSize(attributes[i]);
             }
-            pipeline_vertex_input_state_create_info.setVertexBindingDescriptions(vertex_input_binding_description);
-            pipeline_vertex_input_state_create_info.setVertexAttributeDescriptions(vertex_input_attribute_descriptions);
+            vertex_input_binding_descriptions.emplace_back(0, vertex_stride, vk::VertexInputRate::eVertex);
         }
 
+        // per instance inputs come from a second buffer, advanced once per instance
+        if (shader_ptr->IsInstanced())
+        {
+            uint32_t curr_offset = 0;
+            for (const VertexAttributeMeta& meta : shader_ptr->instance_attribute_metas)
+            {
+                vertex_input_attribute_descriptions.emplace_back(
+                    meta.location, 1, VertexAttributeToVkFormat(meta.attribute), curr_offset);
+                curr_offset += VertexAttributeToSize(meta.attribute);
+            }
+            vertex_input_binding_descriptions.emplace_back(
+                1, shader_ptr->instance_stride, vk::VertexInputRate::eInstance);
+        }
+
+        pipeline_vertex_input_state_create_info.setVertexBindingDescriptions(vertex_input_binding_descriptions);
+        pipeline_vertex_input_state_create_info.setVertexAttributeDescriptions(vertex_input_attribute_descriptions);
+
         vk::PipelineInputAssemblyStateCreateInfo pipeline_input_assembly_state_create_info(
             vk::PipelineInputAssemblyStateCreateFlags(), vk::PrimitiveTopology::eTriangleList);
 
@@ -172,6 +188,30 @@ namespace Meow
         graphics_pipeline = vk::raii::Pipeline(logical_device, pipeline_cache, graphics_pipeline_create_info);
     }
 
+    void Material::CreateComputePipeline(const vk::raii::Device& logical_device)
+    {
+        FUNCTION_TIMER();
+
+        if (!shader_ptr->is_comp_shader_valid)
+        {
+            MEOW_ERROR("Shader has no compute stage.");
+            return;
+        }
+
+        vk::PipelineShaderStageCreateInfo pipeline_shader_stage_create_info(vk::PipelineShaderStageCreateFlags {},
+                                                                            vk::ShaderStageFlagBits::eCompute,
+                                                                            *shader_ptr->comp_shader_module,
+                                                                            "main",
+                                                                            nullptr);
+
+        vk::raii::PipelineCache       pipeline_cache(logical_device, vk::PipelineCacheCreateInfo());
+        vk::ComputePipelineCreateInfo compute_pipeline_create_info(vk::PipelineCreateFlags(),          /* flags */
+                                                                   pipeline_shader_stage_create_info,  /* stage */
+                                                                   *shader_ptr->pipeline_layout);      /* layout */
+
+        compute_pipeline = vk::raii::Pipeline(logical_device, pipeline_cache, compute_pipeline_create_info);
+    }
+
     void Material::BeginPopulatingDynamicUniformBufferPerFrame()
     {
         FUNCTION_TIMER();
@@ -186,6 +226,7 @@ namespace Meow
 
         obj_count = 0;
         per_obj_dynamic_offsets.clear();
+        per_obj_allocations.clear();
     }
 
     void Material::EndPopulatingDynamicUniformBufferPerFrame()
@@ -201,6 +242,7 @@ namespace Meow
 
         per_obj_dynamic_offsets.push_back(
             std::vector<uint32_t>(shader_ptr->dynamic_uniform_buffer_count, std::numeric_limits<uint32_t>::max()));
+        per_obj_allocations.push_back({std::numeric_limits<uint32_t>::max(), 0});
     }
 
     void Material::EndPopulatingDynamicUniformBufferPerObject()
@@ -225,10 +267,10 @@ namespace Meow
         ++obj_count;
     }
 
-    void Material::PopulateDynamicUniformBuffer(std::shared_ptr<UniformBuffer> buffer,
-                                                const std::string&             name,
-                                                void*                          dataPtr,
-                                                uint32_t                       size)
+    void Material::PopulateDynamicUniformBuffer(FrameUniformAllocator& allocator,
+                                                const std::string&     name,
+                                                void*                  dataPtr,
+                                                uint32_t               size)
     {
         FUNCTION_TIMER();
 
@@ -252,8 +294,36 @@ namespace Meow
             return;
         }
 
-        per_obj_dynamic_offsets[obj_count][it->second.dynamic_seq] =
-            static_cast<uint32_t>(buffer->Populate(dataPtr, it->second.size));
+        // lay out the dynamic uniform buffers of an object once, each at an aligned offset after the previous one
+        if (dynamic_uniform_sub_offsets.size() != shader_ptr->dynamic_uniform_buffer_count)
+        {
+            std::vector<uint32_t> sizes(shader_ptr->dynamic_uniform_buffer_count, 0);
+            for (const auto& [buffer_name, meta] : shader_ptr->buffer_meta_map)
+            {
+                if (meta.descriptorType == vk::DescriptorType::eUniformBufferDynamic)
+                    sizes[meta.dynamic_seq] = meta.size;
+            }
+
+            dynamic_uniform_sub_offsets.resize(sizes.size());
+            dynamic_uniform_object_size = 0;
+            for (size_t i = 0; i < sizes.size(); ++i)
+            {
+                dynamic_uniform_sub_offsets[i] =
+                    Align<uint32_t>(dynamic_uniform_object_size, allocator.GetMinAlignment());
+                dynamic_uniform_object_size = dynamic_uniform_sub_offsets[i] + sizes[i];
+            }
+        }
+
+        FrameUniformAllocation& object_allocation = per_obj_allocations[obj_count];
+        if (object_allocation.page == std::numeric_limits<uint32_t>::max())
+        {
+            object_allocation = allocator.Allocate(dynamic_uniform_object_size);
+        }
+
+        uint32_t offset = object_allocation.offset + dynamic_uniform_sub_offsets[it->second.dynamic_seq];
+        allocator.Write({object_allocation.page, offset}, dataPtr, std::min(size, it->second.size));
+
+        per_obj_dynamic_offsets[obj_count][it->second.dynamic_seq] = offset;
     }
 
     void Material::BindPipeline(const vk::raii::CommandBuffer& command_buffer)
@@ -263,7 +333,33 @@ namespace Meow
         command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *graphics_pipeline);
     }
 
-    void Material::UpdateDynamicUniformPerObject(const vk::raii::CommandBuffer& command_buffer, int32_t obj_index)
+    void Material::BindComputePipeline(const vk::raii::CommandBuffer& command_buffer)
+    {
+        FUNCTION_TIMER();
+
+        command_buffer.bindPipeline(vk::PipelineBindPoint::eCompute, *compute_pipeline);
+    }
+
+    void Material::UpdateDynamicUniformPerObject(const vk::raii::CommandBuffer& command_buffer,
+                                                 const FrameUniformAllocator&   allocator,
+                                                 int32_t                        obj_index)
+    {
+        FUNCTION_TIMER();
+
+        if (obj_index >= per_obj_dynamic_offsets.size())
+        {
+            return;
+        }
+
+        const vk::raii::DescriptorSet& descriptor_set = allocator.GetDescriptorSet(per_obj_allocations[obj_index].page);
+        shader_ptr->BindPerObjectDescriptorSetToPipeline(
+            command_buffer, descriptor_set, per_obj_dynamic_offsets[obj_index]);
+    }
+
+    void Material::UpdateDynamicUniformPerObject(const vk::raii::CommandBuffer& command_buffer,
+                                                 RenderStateCache&              state_cache,
+                                                 const FrameUniformAllocator&   allocator,
+                                                 int32_t                        obj_index)
     {
         FUNCTION_TIMER();
 
@@ -272,6 +368,10 @@ namespace Meow
             return;
         }
 
-        shader_ptr->BindPerObjectDescriptorSetToPipeline(command_buffer, per_obj_dynamic_offsets[obj_index]);
+        state_cache.BindDescriptorSet(command_buffer,
+                                      *shader_ptr->pipeline_layout,
+                                      3,
+                                      *allocator.GetDescriptorSet(per_obj_allocations[obj_index].page),
+                                      per_obj_dynamic_offsets[obj_index]);
     }
 } // namespace Meow
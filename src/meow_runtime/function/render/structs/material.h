@@ -2,6 +2,8 @@
 
 #include "buffer_data.h"
 #include "core/base/non_copyable.h"
+#include "frame_uniform_allocator.h"
+#include "render_state_cache.h"
 #include "shader.h"
 #include "uniform_buffer.h"
 
@@ -26,9 +28,13 @@ namespace Meow
             this->color_attachment_count = rhs.color_attachment_count;
             this->subpass                = rhs.subpass;
             std::swap(graphics_pipeline, rhs.graphics_pipeline);
+            std::swap(compute_pipeline, rhs.compute_pipeline);
             this->actived   = rhs.actived;
             this->obj_count = rhs.obj_count;
             std::swap(per_obj_dynamic_offsets, rhs.per_obj_dynamic_offsets);
+            std::swap(per_obj_allocations, rhs.per_obj_allocations);
+            std::swap(dynamic_uniform_sub_offsets, rhs.dynamic_uniform_sub_offsets);
+            this->dynamic_uniform_object_size = rhs.dynamic_uniform_object_size;
             std::swap(descriptor_sets, rhs.descriptor_sets);
         }
 
@@ -40,9 +46,13 @@ namespace Meow
                 this->color_attachment_count = rhs.color_attachment_count;
                 this->subpass                = rhs.subpass;
                 std::swap(graphics_pipeline, rhs.graphics_pipeline);
+                std::swap(compute_pipeline, rhs.compute_pipeline);
                 this->actived   = rhs.actived;
                 this->obj_count = rhs.obj_count;
                 std::swap(per_obj_dynamic_offsets, rhs.per_obj_dynamic_offsets);
+                std::swap(per_obj_allocations, rhs.per_obj_allocations);
+                std::swap(dynamic_uniform_sub_offsets, rhs.dynamic_uniform_sub_offsets);
+                this->dynamic_uniform_object_size = rhs.dynamic_uniform_object_size;
                 std::swap(descriptor_sets, rhs.descriptor_sets);
             }
 
@@ -54,6 +64,11 @@ namespace Meow
                             vk::FrontFace               front_face,
                             bool                        depth_buffered);
 
+        /**
+         * @brief Create the pipeline of the compute stage of the shader, bound with BindComputePipeline.
+         */
+        void CreateComputePipeline(const vk::raii::Device& logical_device);
+
         std::shared_ptr<Shader> GetShader() { return shader_ptr; }
 
         void BeginPopulatingDynamicUniformBufferPerFrame();
@@ -64,14 +79,32 @@ namespace Meow
 
         void EndPopulatingDynamicUniformBufferPerObject();
 
-        void PopulateDynamicUniformBuffer(std::shared_ptr<UniformBuffer> buffer,
-                                          const std::string&             name,
-                                          void*                          dataPtr,
-                                          uint32_t                       size);
+        /**
+         * @brief Write the dynamic uniform buffer of the current object to the allocator.
+         *
+         * The first uniform of an object reserves the aligned size of all of its dynamic uniform buffers at once, so
+         * that they are in the same page, bound with one descriptor set.
+         */
+        void PopulateDynamicUniformBuffer(FrameUniformAllocator& allocator,
+                                          const std::string&     name,
+                                          void*                  dataPtr,
+                                          uint32_t               size);
 
         void BindPipeline(const vk::raii::CommandBuffer& command_buffer);
 
-        void UpdateDynamicUniformPerObject(const vk::raii::CommandBuffer& command_buffer, int32_t obj_index);
+        void BindComputePipeline(const vk::raii::CommandBuffer& command_buffer);
+
+        void UpdateDynamicUniformPerObject(const vk::raii::CommandBuffer& command_buffer,
+                                           const FrameUniformAllocator&   allocator,
+                                           int32_t                        obj_index);
+
+        /**
+         * @brief Bind the per object set through a cache, skipped if the object uses the same page and offsets.
+         */
+        void UpdateDynamicUniformPerObject(const vk::raii::CommandBuffer& command_buffer,
+                                           RenderStateCache&              state_cache,
+                                           const FrameUniformAllocator&   allocator,
+                                           int32_t                        obj_index);
 
         std::shared_ptr<Shader> shader_ptr             = nullptr;
         int                     color_attachment_count = 1;
@@ -79,12 +112,18 @@ namespace Meow
 
     private:
         vk::raii::Pipeline graphics_pipeline = nullptr;
+        vk::raii::Pipeline compute_pipeline  = nullptr;
 
         // stored for binding descriptor set
 
-        bool                               actived   = false;
-        int32_t                            obj_count = 0;
-        std::vector<std::vector<uint32_t>> per_obj_dynamic_offsets;
-        std::vector<vk::DescriptorSet>     descriptor_sets;
+        bool                                actived   = false;
+        int32_t                             obj_count = 0;
+        std::vector<std::vector<uint32_t>>  per_obj_dynamic_offsets;
+        std::vector<FrameUniformAllocation> per_obj_allocations;
+        std::vector<vk::DescriptorSet>      descriptor_sets;
+
+        // offsets of the dynamic uniform buffers in the allocation of an object, by dynamic sequence
+        std::vector<uint32_t> dynamic_uniform_sub_offsets;
+        uint32_t              dynamic_uniform_object_size = 0;
     };
 } // namespace Meow
@@ -2,6 +2,7 @@
 
 #include "pch.h"
 
+#include "core/jobs/job_system.h"
 #include "core/math/assimp_glm_helper.h"
 #include "function/global/runtime_context.h"
 
@@ -27,6 +28,7 @@ namespace Meow
         auto     index_type = vk::IndexType::eUint32;
         uint32_t stride     = VertexAttributesToSize(attributes);
         auto     mesh       = new ModelMesh();
+        this->attributes    = attributes;
         mesh->vertices      = std::move(vertices);
         mesh->indices       = std::move(indices);
         mesh->vertex_count  = mesh->vertices.size() / stride * 4;
@@ -45,6 +47,9 @@ namespace Meow
         mesh->bounding.min = glm::vec3(-1.0f, -1.0f, 0.0f);
         mesh->bounding.max = glm::vec3(1.0f, 1.0f, 0.0f);
 
+        if (attributes & VertexAttributeBit::Position)
+            mesh->BuildBVH(stride / sizeof(float));
+
         root_node       = new ModelNode();
         root_node->name = "RootNode";
         root_node->meshes.push_back(mesh);
@@ -52,6 +57,9 @@ namespace Meow
         mesh->link_node         = root_node;
 
         meshes.push_back(mesh);
+        linear_nodes.push_back(root_node);
+
+        UpdateBounding();
     }
 
     Model::Model(const vk::raii::PhysicalDevice& physical_device,
@@ -105,6 +113,14 @@ namespace Meow
         LoadBones(scene);
         LoadNode(physical_device, device, command_pool, queue, scene->mRootNode, scene);
         LoadAnim(scene);
+
+        UpdateBounding();
+
+        BuildLods();
+        for (ModelMesh* mesh : meshes)
+        {
+            mesh->CreateIndexBuffer(physical_device, device, command_pool, queue);
+        }
     }
 
     void Model::Update(float time, float delta)
@@ -125,16 +141,84 @@ namespace Meow
         GotoAnimation(animation.time);
     }
 
-    BoundingBox Model::GetBounding()
+    void Model::UpdateBounding()
+    {
+        bool is_empty = true;
+
+        // linear nodes are in depth first order, so the global matrix of a parent is computed before its children
+        for (ModelNode* node : linear_nodes)
+        {
+            node->global_matrix =
+                node->parent ? node->parent->global_matrix * node->local_matrix : node->local_matrix;
+
+            for (ModelMesh* mesh : node->meshes)
+            {
+                BoundingBox mesh_bounding = mesh->bounding.Transformed(node->global_matrix);
+                if (is_empty)
+                    bounding = mesh_bounding;
+                else
+                    bounding.Merge(mesh_bounding);
+                is_empty = false;
+            }
+        }
+
+        if (is_empty)
+            bounding = BoundingBox();
+
+        bounding.UpdateCorners();
+    }
+
+    void Model::BuildLods()
     {
-        BoundingBox bounding;
+        FUNCTION_TIMER();
+
+        lod_errors.clear();
+        if (!(attributes & VertexAttributeBit::Position))
+            return;
 
-        for (const auto& node : linear_nodes)
+        uint32_t stride = VertexAttributesToSize(attributes) / sizeof(float);
+
+        // meshes are simplified independently, one job each
+        auto build = [this, stride](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                meshes[i]->BuildLods(stride);
+            }
+        };
+
+        const uint32_t mesh_count = static_cast<uint32_t>(meshes.size());
+        if (JobSystem* job_system = g_runtime_context.job_system.get())
+            job_system->ParallelFor(0, mesh_count, 1, build);
+        else
+            build(0, mesh_count);
+
+        // the global matrices are up to date after UpdateBounding, mesh errors are scaled by the largest axis scale
+        lod_errors.push_back(0.0f);
+        for (const ModelMesh* mesh : meshes)
         {
-            bounding.Merge(node->GetBounds());
+            float scale = 1.0f;
+            if (mesh->link_node)
+            {
+                const glm::mat4& matrix = mesh->link_node->global_matrix;
+                scale = std::max({glm::length(glm::vec3(matrix[0])),
+                                  glm::length(glm::vec3(matrix[1])),
+                                  glm::length(glm::vec3(matrix[2]))});
+            }
+
+            for (uint32_t i = 1; i < mesh->lods.size(); ++i)
+            {
+                if (i >= lod_errors.size())
+                    lod_errors.push_back(0.0f);
+
+                lod_errors[i] = std::max(lod_errors[i], mesh->lods[i].error * scale);
+            }
         }
 
-        return bounding;
+        // a mesh with fewer levels keeps drawing its last one at the coarser levels of the model
+        for (uint32_t i = 1; i < lod_errors.size(); ++i)
+        {
+            lod_errors[i] = std::max(lod_errors[i], lod_errors[i - 1]);
+        }
     }
 
     void Model::SetAnimation(size_t index)
@@ -355,13 +439,19 @@ namespace Meow
         // load indices
         LoadIndices(mesh->indices, ai_mesh, ai_scene);
 
+        // the index buffer is created with the levels of detail, once all meshes are loaded
         mesh->vertex_buffer_ptr = std::make_shared<VertexBuffer>(
             physical_device, device, command_pool, queue, vk::MemoryPropertyFlagBits::eDeviceLocal, mesh->vertices);
-        mesh->index_buffer_ptr = std::make_shared<IndexBuffer>(
-            physical_device, device, command_pool, queue, vk::MemoryPropertyFlagBits::eDeviceLocal, mesh->indices);
         mesh->vertex_count   = ai_mesh->mNumVertices;
         mesh->triangle_count = (size_t)mesh->indices.size() / 3;
 
+        if (attributes & VertexAttributeBit::Position)
+        {
+            uint32_t stride = VertexAttributesToSize(attributes) / sizeof(float);
+            mesh->BuildMeshlets(stride);
+            mesh->BuildBVH(stride);
+        }
+
         return mesh;
     }
 
@@ -739,10 +829,14 @@ namespace Meow
             }
         }
 
+        if (attributes & VertexAttributeBit::Position)
+        {
+            new_mesh->BuildMeshlets(stride);
+            new_mesh->BuildBVH(stride);
+        }
+
         new_mesh->vertex_buffer_ptr = std::make_shared<VertexBuffer>(
             physical_device, device, command_pool, queue, vk::MemoryPropertyFlagBits::eDeviceLocal, new_mesh->vertices);
-        new_mesh->index_buffer_ptr = std::make_shared<IndexBuffer>(
-            physical_device, device, command_pool, queue, vk::MemoryPropertyFlagBits::eDeviceLocal, new_mesh->indices);
 
         delete root_node;
         root_node       = new_node;
@@ -753,6 +847,9 @@ namespace Meow
         linear_nodes.clear();
         linear_nodes.push_back(new_node);
 
+        BuildLods();
+        new_mesh->CreateIndexBuffer(physical_device, device, command_pool, queue);
+
         for (size_t i = 0; i < bones.size(); ++i)
         {
             delete bones[i];
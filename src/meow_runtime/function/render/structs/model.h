@@ -13,6 +13,7 @@
 #include <assimp/scene.h>
 #include <glm/glm.hpp>
 
+#include <algorithm>
 #include <filesystem>
 
 namespace Meow
@@ -40,6 +41,12 @@ namespace Meow
 
         bool loadSkin = false;
 
+        // bounds of all meshes in model space, computed once at load
+        BoundingBox bounding;
+
+        // largest error of the meshes per level of detail, in model space, empty if no levels were built
+        std::vector<float> lod_errors;
+
         Model(std::nullptr_t) {};
 
         Model(Model&& rhs) noexcept
@@ -52,8 +59,10 @@ namespace Meow
             std::swap(bones_map, rhs.bones_map);
             std::swap(attributes, rhs.attributes);
             std::swap(animations, rhs.animations);
+            std::swap(lod_errors, rhs.lod_errors);
             animIndex = rhs.animIndex;
             loadSkin  = rhs.loadSkin;
+            bounding  = rhs.bounding;
         }
 
         Model& operator=(Model&& rhs) noexcept
@@ -68,8 +77,10 @@ namespace Meow
                 std::swap(bones_map, rhs.bones_map);
                 std::swap(attributes, rhs.attributes);
                 std::swap(animations, rhs.animations);
+                std::swap(lod_errors, rhs.lod_errors);
                 animIndex = rhs.animIndex;
                 loadSkin  = rhs.loadSkin;
+                bounding  = rhs.bounding;
             }
             return *this;
         }
@@ -114,7 +125,26 @@ namespace Meow
 
         void Update(float time, float delta);
 
-        BoundingBox GetBounding();
+        /**
+         * @brief Bounds of all meshes in model space, in the node pose the model was loaded with.
+         */
+        const BoundingBox& GetBounding() const { return bounding; }
+
+        /**
+         * @brief Recompute the bounds from the mesh bounds and the node matrices.
+         */
+        void UpdateBounding();
+
+        uint32_t GetLodCount() const { return lod_errors.empty() ? 1 : static_cast<uint32_t>(lod_errors.size()); }
+
+        /**
+         * @brief Largest distance in model space between a level of detail and the full resolution model. Levels past
+         * the last one have the error of the last one.
+         */
+        float GetLodError(uint32_t lod_index) const
+        {
+            return lod_errors.empty() ? 0.0f : lod_errors[std::min(lod_index, GetLodCount() - 1)];
+        }
 
         void SetAnimation(size_t index);
 
@@ -158,6 +188,11 @@ namespace Meow
 
         void LoadAnim(const aiScene* ai_scene);
 
+        /**
+         * @brief Build the levels of detail of all meshes in parallel and the errors of the levels of the model.
+         */
+        void BuildLods();
+
         void MergeAllMeshes(const vk::raii::PhysicalDevice& physical_device,
                             const vk::raii::Device&         device,
                             const vk::raii::CommandPool&    command_pool,
@@ -2,8 +2,78 @@
 
 #include "pch.h"
 
+#include "core/math/mesh_simplifier.h"
+#include "function/global/runtime_context.h"
+
+#include <algorithm>
+#include <limits>
+
 namespace Meow
 {
+    void ModelMesh::BuildBVH(uint32_t stride)
+    {
+        FUNCTION_TIMER();
+
+        bvh.Build(vertices, stride, indices, g_runtime_context.job_system.get());
+    }
+
+    void ModelMesh::BuildMeshlets(uint32_t stride)
+    {
+        FUNCTION_TIMER();
+
+        meshlets = Meow::BuildMeshlets(vertices, stride, indices);
+    }
+
+    void ModelMesh::BuildLods(uint32_t stride)
+    {
+        FUNCTION_TIMER();
+
+        // meshes this small are cheaper to draw than to switch
+        constexpr uint32_t k_min_lod_triangle_count = 64;
+
+        lods.clear();
+        lod_indices.clear();
+        lods.push_back({0, static_cast<uint32_t>(indices.size()), 0.0f});
+
+        std::vector<uint32_t> level_indices = indices;
+        while (lods.size() < k_max_lod_count && level_indices.size() / 3 >= k_min_lod_triangle_count * 2)
+        {
+            // each level is simplified from the one before, so its error adds to theirs
+            float                 error;
+            std::vector<uint32_t> simplified = SimplifyMesh(vertices,
+                                                            stride,
+                                                            level_indices,
+                                                            static_cast<uint32_t>(level_indices.size() / 6 * 3),
+                                                            std::numeric_limits<float>::max(),
+                                                            &error);
+
+            // mostly borders and seams are left, which are never collapsed
+            if (simplified.size() * 4 > level_indices.size() * 3)
+                break;
+
+            lods.push_back({static_cast<uint32_t>(indices.size() + lod_indices.size()),
+                            static_cast<uint32_t>(simplified.size()),
+                            lods.back().error + error});
+            lod_indices.insert(lod_indices.end(), simplified.begin(), simplified.end());
+            level_indices = std::move(simplified);
+        }
+    }
+
+    void ModelMesh::CreateIndexBuffer(const vk::raii::PhysicalDevice& physical_device,
+                                      const vk::raii::Device&         device,
+                                      const vk::raii::CommandPool&    command_pool,
+                                      const vk::raii::Queue&          queue)
+    {
+        if (indices.empty())
+            return;
+
+        std::vector<uint32_t> buffer_indices = indices;
+        buffer_indices.insert(buffer_indices.end(), lod_indices.begin(), lod_indices.end());
+
+        index_buffer_ptr = std::make_shared<IndexBuffer>(
+            physical_device, device, command_pool, queue, vk::MemoryPropertyFlagBits::eDeviceLocal, buffer_indices);
+    }
+
     void ModelMesh::BindOnly(const vk::raii::CommandBuffer& cmd_buffer)
     {
         FUNCTION_TIMER();
@@ -16,7 +86,7 @@ namespace Meow
         if (instance_buffer_ptr)
         {
             cmd_buffer.bindVertexBuffers(
-                0, {*instance_buffer_ptr->buffer_data_ptr->buffer}, {instance_buffer_ptr->offset});
+                1, {*instance_buffer_ptr->buffer_data_ptr->buffer}, {instance_buffer_ptr->offset});
         }
 
         if (index_buffer_ptr)
@@ -25,21 +95,64 @@ namespace Meow
         }
     }
 
-    void ModelMesh::DrawOnly(const vk::raii::CommandBuffer& cmd_buffer)
+    void ModelMesh::BindOnly(const vk::raii::CommandBuffer& cmd_buffer, RenderStateCache& state_cache)
+    {
+        FUNCTION_TIMER();
+
+        if (vertex_buffer_ptr)
+        {
+            state_cache.BindVertexBuffer(
+                cmd_buffer, 0, *vertex_buffer_ptr->buffer_data_ptr->buffer, vertex_buffer_ptr->offset);
+        }
+
+        if (instance_buffer_ptr)
+        {
+            state_cache.BindVertexBuffer(
+                cmd_buffer, 1, *instance_buffer_ptr->buffer_data_ptr->buffer, instance_buffer_ptr->offset);
+        }
+
+        if (index_buffer_ptr)
+        {
+            state_cache.BindIndexBuffer(
+                cmd_buffer, *index_buffer_ptr->buffer_data_ptr->buffer, 0, index_buffer_ptr->index_type);
+        }
+    }
+
+    void ModelMesh::DrawOnly(const vk::raii::CommandBuffer& cmd_buffer,
+                             uint32_t                       lod_index,
+                             std::span<const IndexRange>    ranges,
+                             uint32_t                       instance_count,
+                             uint32_t                       first_instance)
     {
         FUNCTION_TIMER();
 
-        if (vertex_buffer_ptr && index_buffer_ptr)
+        if (vertex_buffer_ptr && index_buffer_ptr && !ranges.empty())
+        {
+            for (const IndexRange& range : ranges)
+            {
+                cmd_buffer.drawIndexed(range.index_count, instance_count, range.first_index, 0, first_instance);
+            }
+        }
+        else if (vertex_buffer_ptr && index_buffer_ptr && !lods.empty())
+        {
+            const ModelMeshLod& lod = lods[std::min(lod_index, static_cast<uint32_t>(lods.size()) - 1)];
+            cmd_buffer.drawIndexed(lod.index_count, instance_count, lod.first_index, 0, first_instance);
+        }
+        else if (vertex_buffer_ptr && index_buffer_ptr)
         {
-            cmd_buffer.drawIndexed(index_buffer_ptr->index_count, 1, 0, 0, 0);
+            cmd_buffer.drawIndexed(index_buffer_ptr->index_count, instance_count, 0, 0, first_instance);
         }
         else if (vertex_buffer_ptr)
         {
-            cmd_buffer.draw(vertex_count, 1, 0, 0);
+            cmd_buffer.draw(vertex_count, instance_count, 0, first_instance);
         }
     }
 
-    void ModelMesh::BindDrawCmd(const vk::raii::CommandBuffer& cmd_buffer)
+    void ModelMesh::BindDrawCmd(const vk::raii::CommandBuffer& cmd_buffer,
+                                uint32_t                       lod_index,
+                                std::span<const IndexRange>    ranges,
+                                uint32_t                       instance_count,
+                                uint32_t                       first_instance)
     {
         FUNCTION_TIMER();
 
@@ -50,6 +163,6 @@ namespace Meow
         }
 
         BindOnly(cmd_buffer);
-        DrawOnly(cmd_buffer);
+        DrawOnly(cmd_buffer, lod_index, ranges, instance_count, first_instance);
     }
 }; // namespace Meow
\ No newline at end of file
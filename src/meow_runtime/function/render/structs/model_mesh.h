@@ -1,11 +1,15 @@
 #pragma once
 
 #include "core/math/bounding_box.h"
+#include "core/math/meshlet.h"
+#include "core/math/triangle_bvh.h"
 #include "image_data.h"
 #include "index_buffer.h"
+#include "render_state_cache.h"
 #include "vertex_buffer.h"
 
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -24,19 +28,37 @@ namespace Meow
         std::shared_ptr<ImageData> specular_texture;
     };
 
+    /**
+     * @brief Level of detail of a mesh, a range of its index buffer over the same vertices.
+     */
+    struct ModelMeshLod
+    {
+        uint32_t first_index = 0;
+        uint32_t index_count = 0;
+        float    error       = 0.0f; // largest distance to the full resolution surface, in the space of the mesh
+    };
+
     struct ModelMesh
     {
+        static constexpr uint32_t k_max_lod_count = 4;
+
         std::shared_ptr<IndexBuffer>  index_buffer_ptr    = nullptr;
         std::shared_ptr<VertexBuffer> vertex_buffer_ptr   = nullptr;
-        std::shared_ptr<VertexBuffer> instance_buffer_ptr = nullptr;
+        std::shared_ptr<VertexBuffer> instance_buffer_ptr = nullptr; // static per instance data, bound at binding 1
 
         std::vector<float>    vertices;
         std::vector<uint32_t> indices;
+        std::vector<uint32_t> lod_indices; // levels after the first, placed after indices in the index buffer
+
+        std::vector<ModelMeshLod> lods; // lods[0] is the full resolution mesh, empty if no levels were built
+
+        std::vector<Meshlet> meshlets; // clusters of the full resolution mesh, each a range of indices
 
         size_t vertex_count   = 0;
         size_t triangle_count = 0;
 
         BoundingBox bounding;
+        TriangleBVH bvh; // over vertices and indices, in the space of the mesh
         ModelNode*  link_node = nullptr;
 
         std::vector<size_t> bones;
@@ -44,11 +66,56 @@ namespace Meow
 
         TextureInfo texture_info;
 
-        void BindOnly(const vk::raii::CommandBuffer& cmd_buffer);
+        /**
+         * @brief Split indices into meshlets, reordering their triangles so that each meshlet is a range of them.
+         * Triangle indices of the bvh refer to that order, so build it afterwards.
+         */
+        void BuildMeshlets(uint32_t stride);
+
+        /**
+         * @brief Build bvh from vertices and indices. Stride is the number of floats per vertex, positions first.
+         */
+        void BuildBVH(uint32_t stride);
+
+        /**
+         * @brief Simplify indices into up to k_max_lod_count levels, each with about half the triangles of the one
+         * before. Stops early once a mesh can not be simplified further. Stride is the number of floats per vertex.
+         */
+        void BuildLods(uint32_t stride);
+
+        /**
+         * @brief Upload indices followed by lod_indices as the index buffer.
+         */
+        void CreateIndexBuffer(const vk::raii::PhysicalDevice& physical_device,
+                               const vk::raii::Device&         device,
+                               const vk::raii::CommandPool&    command_pool,
+                               const vk::raii::Queue&          queue);
+
+        uint32_t GetLodCount() const { return lods.empty() ? 1 : static_cast<uint32_t>(lods.size()); }
 
-        void DrawOnly(const vk::raii::CommandBuffer& cmd_buffer);
+        void BindOnly(const vk::raii::CommandBuffer& cmd_buffer);
 
-        void BindDrawCmd(const vk::raii::CommandBuffer& cmd_buffer);
+        /**
+         * @brief Bind the buffers through a cache, skipping those still bound by the previous draw.
+         */
+        void BindOnly(const vk::raii::CommandBuffer& cmd_buffer, RenderStateCache& state_cache);
+
+        /**
+         * @brief Draw a level of detail, levels past the last one draw the last one. Non-empty ranges of the index
+         * buffer, such as the visible meshlets, are drawn instead. Instances read the per instance vertex buffer
+         * from first_instance on.
+         */
+        void DrawOnly(const vk::raii::CommandBuffer& cmd_buffer,
+                      uint32_t                       lod_index      = 0,
+                      std::span<const IndexRange>    ranges         = {},
+                      uint32_t                       instance_count = 1,
+                      uint32_t                       first_instance = 0);
+
+        void BindDrawCmd(const vk::raii::CommandBuffer& cmd_buffer,
+                         uint32_t                       lod_index      = 0,
+                         std::span<const IndexRange>    ranges         = {},
+                         uint32_t                       instance_count = 1,
+                         uint32_t                       first_instance = 0);
 
         ~ModelMesh() { link_node = nullptr; }
     };
@@ -2,8 +2,16 @@
 
 #include <vulkan/vulkan_raii.hpp>
 
+#include <cstdint>
+
 namespace Meow
 {
+    /**
+     * @brief Number of frames the CPU may record ahead of the GPU. Everything a frame writes on the CPU side, such as
+     * command buffers and uniform buffers, has one copy per frame in flight.
+     */
+    constexpr uint32_t k_max_frames_in_flight = 2;
+
     struct PerFrameData
     {
         vk::raii::CommandPool   command_pool   = nullptr;
@@ -11,7 +19,10 @@ namespace Meow
 
         vk::raii::Semaphore image_acquired_semaphore  = nullptr;
         vk::raii::Semaphore render_finished_semaphore = nullptr;
-        vk::raii::Fence     in_flight_fence           = nullptr;
+        vk::raii::Fence     in_flight_fence           = nullptr; // only when timeline semaphores are not supported
+
+        // value the frame timeline semaphore reaches when the last submission of this frame is finished
+        uint64_t timeline_value = 0;
 
         PerFrameData() {}
 
@@ -0,0 +1,192 @@
+#include "render_queue.h"
+
+#include "pch.h"
+
+#include "core/algorithm/radix_sort.h"
+#include "function/components/camera/camera_3d_component.hpp"
+#include "function/components/model/model_component.h"
+#include "function/components/transform/transform_3d_component.hpp"
+#include "function/level/level.h"
+#include "model_mesh.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Meow
+{
+    namespace
+    {
+        struct DepthView
+        {
+            glm::vec3 position;
+            glm::vec3 forward;
+            float     near_plane;
+            float     far_plane;
+        };
+
+        DepthView GetDepthView(const Level& level)
+        {
+            GameObject*           camera_go_ptr      = level.GetGameObject(level.GetMainCamera());
+            Transform3DComponent* transform_comp_ptr = camera_go_ptr->GetComponent<Transform3DComponent>();
+            Camera3DComponent*    camera_comp_ptr    = camera_go_ptr->GetComponent<Camera3DComponent>();
+
+            return {transform_comp_ptr->position,
+                    transform_comp_ptr->rotation * glm::vec3(0.0f, 0.0f, 1.0f),
+                    camera_comp_ptr->near_plane,
+                    camera_comp_ptr->far_plane};
+        }
+
+        ModelMesh* GetMesh(const Level& level, const VisibleMesh& visible_mesh)
+        {
+            ModelComponent* model_comp_ptr = level.GetGameObject(visible_mesh.object)->GetComponent<ModelComponent>();
+            return model_comp_ptr->model_ptr.lock()->meshes[visible_mesh.mesh_index];
+        }
+
+        // distance along the view direction to the center of the bounds of a mesh
+        float
+        GetDepth(const DepthView& view, const Level& level, const VisibleMesh& visible_mesh, const ModelMesh& mesh)
+        {
+            glm::mat4 world_matrix = level.GetTransformHierarchy().GetWorldMatrix(visible_mesh.world_matrix_index);
+            if (mesh.link_node)
+                world_matrix = world_matrix * mesh.link_node->global_matrix;
+
+            glm::vec3 local_center = (mesh.bounding.min + mesh.bounding.max) * 0.5f;
+            glm::vec3 center       = glm::vec3(world_matrix * glm::vec4(local_center, 1.0f));
+            return glm::dot(center - view.position, view.forward);
+        }
+    } // namespace
+
+    uint64_t
+    RenderQueue::MakeSortKey(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, uint32_t depth)
+    {
+        auto field = [](uint32_t value, uint32_t bits) { return static_cast<uint64_t>(value) & ((1ull << bits) - 1); };
+
+        uint64_t key = field(pass, k_pass_bits);
+        key          = key << k_pipeline_bits | field(pipeline, k_pipeline_bits);
+        key          = key << k_material_bits | field(material, k_material_bits);
+        key          = key << k_mesh_bits | field(mesh, k_mesh_bits);
+        key          = key << k_depth_bits | field(depth, k_depth_bits);
+        return key;
+    }
+
+    uint32_t RenderQueue::QuantizeDepth(float depth, float near_plane, float far_plane)
+    {
+        constexpr uint32_t k_max_depth = (1u << k_depth_bits) - 1;
+
+        float normalized = std::clamp((depth - near_plane) / (far_plane - near_plane), 0.0f, 1.0f);
+        return static_cast<uint32_t>(normalized * static_cast<float>(k_max_depth));
+    }
+
+    uint32_t RenderQueue::GetStateId(const void* state)
+    {
+        return m_state_ids.emplace(state, static_cast<uint32_t>(m_state_ids.size())).first->second;
+    }
+
+    void RenderQueue::Clear()
+    {
+        m_packets.clear();
+        m_keys.clear();
+        m_order.clear();
+        m_state_ids.clear();
+    }
+
+    void RenderQueue::Push(uint64_t sort_key, const DrawPacket& packet)
+    {
+        m_keys.push_back(sort_key);
+        m_order.push_back(static_cast<uint32_t>(m_packets.size()));
+        m_packets.push_back(packet);
+    }
+
+    void RenderQueue::PushVisibleMeshes(const Level& level, uint32_t pass, Material& material, bool per_object_uniforms)
+    {
+        FUNCTION_TIMER();
+
+        const DepthView view        = GetDepthView(level);
+        const uint32_t  pipeline_id = GetStateId(&material.graphics_pipeline);
+        const uint32_t  material_id = GetStateId(&material);
+
+        std::span<const VisibleMesh> visible_meshes = level.GetVisibleMeshes();
+        for (uint32_t i = 0; i < visible_meshes.size(); ++i)
+        {
+            const VisibleMesh& visible_mesh = visible_meshes[i];
+            ModelMesh*         mesh         = GetMesh(level, visible_mesh);
+
+            DrawPacket packet;
+            packet.material      = &material;
+            packet.mesh          = mesh;
+            packet.lod_index     = visible_mesh.lod_index;
+            packet.ranges        = level.GetIndexRanges(visible_mesh);
+            packet.uniform_index = per_object_uniforms ? static_cast<int32_t>(i) : -1;
+
+            uint32_t depth = QuantizeDepth(GetDepth(view, level, visible_mesh, *mesh), view.near_plane, view.far_plane);
+            Push(MakeSortKey(pass, pipeline_id, material_id, GetStateId(mesh), depth), packet);
+        }
+    }
+
+    void RenderQueue::PushInstanceBatches(const Level& level, uint32_t pass, Material& material)
+    {
+        FUNCTION_TIMER();
+
+        const DepthView view        = GetDepthView(level);
+        const uint32_t  pipeline_id = GetStateId(&material.graphics_pipeline);
+        const uint32_t  material_id = GetStateId(&material);
+
+        std::span<const VisibleMesh> visible_meshes   = level.GetVisibleMeshes();
+        std::span<const uint32_t>    instanced_meshes = level.GetInstancedMeshes();
+        for (const InstanceBatch& batch : level.GetInstanceBatches())
+        {
+            const VisibleMesh& first_mesh = visible_meshes[instanced_meshes[batch.first_instance]];
+            ModelMesh*         mesh       = GetMesh(level, first_mesh);
+
+            float nearest_depth = std::numeric_limits<float>::max();
+            for (uint32_t i = batch.first_instance; i < batch.first_instance + batch.instance_count; ++i)
+            {
+                float depth   = GetDepth(view, level, visible_meshes[instanced_meshes[i]], *mesh);
+                nearest_depth = std::min(nearest_depth, depth);
+            }
+
+            DrawPacket packet;
+            packet.material       = &material;
+            packet.mesh           = mesh;
+            packet.lod_index      = first_mesh.lod_index;
+            packet.ranges         = level.GetIndexRanges(first_mesh);
+            packet.instance_count = batch.instance_count;
+            packet.first_instance = batch.first_instance;
+
+            uint32_t depth = QuantizeDepth(nearest_depth, view.near_plane, view.far_plane);
+            Push(MakeSortKey(pass, pipeline_id, material_id, GetStateId(mesh), depth), packet);
+        }
+    }
+
+    void RenderQueue::Sort()
+    {
+        FUNCTION_TIMER();
+
+        RadixSort(m_keys, m_order, m_scratch_keys, m_scratch_order);
+    }
+
+    uint32_t RenderQueue::Submit(const vk::raii::CommandBuffer& command_buffer,
+                                 RenderStateCache&              state_cache,
+                                 const FrameUniformAllocator&   allocator) const
+    {
+        FUNCTION_TIMER();
+
+        for (uint32_t packet_index : m_order)
+        {
+            const DrawPacket& packet = m_packets[packet_index];
+
+            state_cache.BindPipeline(command_buffer, *packet.material->graphics_pipeline);
+            if (packet.uniform_index >= 0)
+            {
+                packet.material->UpdateDynamicUniformPerObject(
+                    command_buffer, state_cache, allocator, packet.uniform_index);
+            }
+
+            packet.mesh->BindOnly(command_buffer, state_cache);
+            packet.mesh->DrawOnly(
+                command_buffer, packet.lod_index, packet.ranges, packet.instance_count, packet.first_instance);
+        }
+
+        return static_cast<uint32_t>(m_order.size());
+    }
+} // namespace Meow
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "core/math/meshlet.h"
+#include "frame_uniform_allocator.h"
+#include "material.h"
+#include "render_state_cache.h"
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Meow
+{
+    class Level;
+    struct ModelMesh;
+
+    /**
+     * @brief One draw of a RenderQueue, everything needed to record it.
+     */
+    struct DrawPacket
+    {
+        Material*                   material       = nullptr;
+        ModelMesh*                  mesh           = nullptr;
+        uint32_t                    lod_index      = 0;
+        std::span<const IndexRange> ranges; // see ModelMesh::DrawOnly
+        uint32_t                    instance_count = 1;
+        uint32_t                    first_instance = 0;
+        int32_t                     uniform_index  = -1; // per object uniforms of the material, -1 if none
+    };
+
+    /**
+     * @brief Draws of a pass collected for a frame, then sorted by key and recorded with as few binds as possible.
+     *
+     * A sort key holds, from the highest bits, the pass, pipeline, material and mesh of a draw and its quantized depth.
+     * Sorting the keys puts draws sharing state next to each other, so the RenderStateCache skips most binds when
+     * recording, and within one mesh orders opaque draws front to back to reduce overdraw. Fields wider than their
+     * bits are truncated, which only makes the grouping less perfect.
+     */
+    class RenderQueue
+    {
+    public:
+        static constexpr uint32_t k_pass_bits     = 4;
+        static constexpr uint32_t k_pipeline_bits = 8;
+        static constexpr uint32_t k_material_bits = 12;
+        static constexpr uint32_t k_mesh_bits     = 16;
+        static constexpr uint32_t k_depth_bits    = 24;
+
+        static uint64_t MakeSortKey(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, uint32_t depth);
+
+        /**
+         * @brief Depth as the lowest field of a sort key, increasing from near to far so that draws go front to back.
+         */
+        static uint32_t QuantizeDepth(float depth, float near_plane, float far_plane);
+
+        /**
+         * @brief Small id of some state, like a pipeline or a mesh, in the order of first use since Clear.
+         */
+        uint32_t GetStateId(const void* state);
+
+        void Clear();
+
+        void Push(uint64_t sort_key, const DrawPacket& packet);
+
+        /**
+         * @brief Push one packet per visible mesh of the level, at the depth of the center of its bounds seen from
+         * the main camera. With per_object_uniforms, the packet of visible mesh i reads the uniforms of object i.
+         */
+        void PushVisibleMeshes(const Level& level, uint32_t pass, Material& material, bool per_object_uniforms);
+
+        /**
+         * @brief Push one instanced packet per instance batch of the level, at the depth of its nearest instance.
+         */
+        void PushInstanceBatches(const Level& level, uint32_t pass, Material& material);
+
+        void Sort();
+
+        /**
+         * @brief Record the sorted draws. The per object uniforms of packets are read from allocator.
+         *
+         * @return Number of draws recorded.
+         */
+        uint32_t Submit(const vk::raii::CommandBuffer& command_buffer,
+                        RenderStateCache&              state_cache,
+                        const FrameUniformAllocator&   allocator) const;
+
+        uint32_t GetPacketCount() const { return static_cast<uint32_t>(m_packets.size()); }
+
+    private:
+        std::vector<DrawPacket> m_packets;
+
+        // keys and packet indices, in sorted order after Sort
+        std::vector<uint64_t> m_keys;
+        std::vector<uint32_t> m_order;
+        std::vector<uint64_t> m_scratch_keys;
+        std::vector<uint32_t> m_scratch_order;
+
+        std::unordered_map<const void*, uint32_t> m_state_ids;
+    };
+} // namespace Meow
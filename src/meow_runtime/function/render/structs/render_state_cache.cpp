@@ -0,0 +1,123 @@
+#include "render_state_cache.h"
+
+#include "pch.h"
+
+#include <algorithm>
+
+namespace Meow
+{
+    void RenderStateCache::Reset()
+    {
+        m_pipeline = nullptr;
+
+        for (VertexBufferState& vertex_buffer : m_vertex_buffers)
+        {
+            vertex_buffer = {};
+        }
+
+        m_index_buffer = nullptr;
+        m_index_offset = 0;
+
+        m_layout = nullptr;
+        for (DescriptorSetState& descriptor_set : m_descriptor_sets)
+        {
+            descriptor_set.descriptor_set = nullptr;
+            descriptor_set.dynamic_offsets.clear();
+        }
+
+        m_stat = {};
+    }
+
+    void RenderStateCache::BindPipeline(const vk::raii::CommandBuffer& command_buffer, vk::Pipeline pipeline)
+    {
+        if (pipeline == m_pipeline)
+        {
+            ++m_stat.skipped_count;
+            return;
+        }
+
+        command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+        m_pipeline = pipeline;
+        ++m_stat.bind_count;
+    }
+
+    void RenderStateCache::BindVertexBuffer(const vk::raii::CommandBuffer& command_buffer,
+                                            uint32_t                       binding,
+                                            vk::Buffer                     buffer,
+                                            vk::DeviceSize                 offset)
+    {
+        if (binding < k_max_vertex_bindings && m_vertex_buffers[binding].buffer == buffer &&
+            m_vertex_buffers[binding].offset == offset)
+        {
+            ++m_stat.skipped_count;
+            return;
+        }
+
+        command_buffer.bindVertexBuffers(binding, buffer, offset);
+        if (binding < k_max_vertex_bindings)
+        {
+            m_vertex_buffers[binding] = {buffer, offset};
+        }
+        ++m_stat.bind_count;
+    }
+
+    void RenderStateCache::BindIndexBuffer(const vk::raii::CommandBuffer& command_buffer,
+                                           vk::Buffer                     buffer,
+                                           vk::DeviceSize                 offset,
+                                           vk::IndexType                  index_type)
+    {
+        if (buffer == m_index_buffer && offset == m_index_offset && index_type == m_index_type)
+        {
+            ++m_stat.skipped_count;
+            return;
+        }
+
+        command_buffer.bindIndexBuffer(buffer, offset, index_type);
+        m_index_buffer = buffer;
+        m_index_offset = offset;
+        m_index_type   = index_type;
+        ++m_stat.bind_count;
+    }
+
+    void RenderStateCache::BindDescriptorSet(const vk::raii::CommandBuffer& command_buffer,
+                                             vk::PipelineLayout             layout,
+                                             uint32_t                       set,
+                                             vk::DescriptorSet              descriptor_set,
+                                             std::span<const uint32_t>      dynamic_offsets)
+    {
+        if (layout != m_layout)
+        {
+            m_layout = layout;
+            for (DescriptorSetState& state : m_descriptor_sets)
+            {
+                state.descriptor_set = nullptr;
+                state.dynamic_offsets.clear();
+            }
+        }
+
+        if (set < k_max_sets)
+        {
+            DescriptorSetState& state = m_descriptor_sets[set];
+            if (state.descriptor_set == descriptor_set &&
+                std::equal(dynamic_offsets.begin(),
+                           dynamic_offsets.end(),
+                           state.dynamic_offsets.begin(),
+                           state.dynamic_offsets.end()))
+            {
+                ++m_stat.skipped_count;
+                return;
+            }
+
+            state.descriptor_set = descriptor_set;
+            state.dynamic_offsets.assign(dynamic_offsets.begin(), dynamic_offsets.end());
+        }
+
+        command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
+                                          layout,
+                                          set,
+                                          descriptor_set,
+                                          vk::ArrayProxy<const uint32_t>(static_cast<uint32_t>(dynamic_offsets.size()),
+                                                                         dynamic_offsets.data()));
+        ++m_stat.bind_count;
+    }
+} // namespace Meow
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Meow
+{
+    /**
+     * @brief Binds recorded and skipped by a RenderStateCache, reported to the profiler.
+     */
+    struct RenderStateStat
+    {
+        uint32_t bind_count    = 0;
+        uint32_t skipped_count = 0; // binds of what was already bound
+    };
+
+    /**
+     * @brief What is bound on a command buffer, so that binding the same pipeline, buffers or descriptor sets again is
+     * skipped.
+     *
+     * The cache only knows about binds that go through it. Call Reset when the command buffer may have been changed
+     * behind its back, like at the start of a render pass.
+     */
+    class RenderStateCache
+    {
+    public:
+        void Reset();
+
+        /**
+         * @brief Tell the cache about a pipeline the caller bound itself.
+         */
+        void SetBoundPipeline(vk::Pipeline pipeline) { m_pipeline = pipeline; }
+
+        void BindPipeline(const vk::raii::CommandBuffer& command_buffer, vk::Pipeline pipeline);
+
+        void BindVertexBuffer(const vk::raii::CommandBuffer& command_buffer,
+                              uint32_t                       binding,
+                              vk::Buffer                     buffer,
+                              vk::DeviceSize                 offset);
+
+        void BindIndexBuffer(const vk::raii::CommandBuffer& command_buffer,
+                             vk::Buffer                     buffer,
+                             vk::DeviceSize                 offset,
+                             vk::IndexType                  index_type);
+
+        /**
+         * @brief Bind one descriptor set for graphics. Sets bound with another layout are forgotten, as binding with
+         * an incompatible layout may disturb them.
+         */
+        void BindDescriptorSet(const vk::raii::CommandBuffer& command_buffer,
+                               vk::PipelineLayout             layout,
+                               uint32_t                       set,
+                               vk::DescriptorSet              descriptor_set,
+                               std::span<const uint32_t>      dynamic_offsets = {});
+
+        const RenderStateStat& GetStat() const { return m_stat; }
+
+    private:
+        static constexpr uint32_t k_max_vertex_bindings = 2;
+        static constexpr uint32_t k_max_sets            = 4;
+
+        struct VertexBufferState
+        {
+            vk::Buffer     buffer;
+            vk::DeviceSize offset = 0;
+        };
+
+        struct DescriptorSetState
+        {
+            vk::DescriptorSet     descriptor_set;
+            std::vector<uint32_t> dynamic_offsets;
+        };
+
+        vk::Pipeline m_pipeline;
+
+        VertexBufferState m_vertex_buffers[k_max_vertex_bindings];
+
+        vk::Buffer     m_index_buffer;
+        vk::DeviceSize m_index_offset = 0;
+        vk::IndexType  m_index_type   = vk::IndexType::eUint32;
+
+        vk::PipelineLayout m_layout;
+        DescriptorSetState m_descriptor_sets[k_max_sets];
+
+        RenderStateStat m_stat;
+    };
+} // namespace Meow
@@ -265,8 +265,13 @@ namespace Meow
             if (pos == std::string::npos)
                 continue;
 
+            // per instance inputs are named inInstance..., or have a name that is no vertex attribute
             std::string        vat_name_substr = var_name.substr(pos + 2);
-            VertexAttributeBit attribute       = to_enum(vat_name_substr);
+            VertexAttributeBit attribute       = VertexAttributeBit::None;
+            if (vat_name_substr.rfind("Instance", 0) != 0)
+            {
+                attribute = to_enum(vat_name_substr);
+            }
             if (attribute == VertexAttributeBit::None)
             {
                 if (input_attribute_size == 1)
@@ -291,11 +296,15 @@ namespace Meow
 
             // store tuple of input attribute and its location
             // location must be continous
-            int32_t             location              = compiler.get_decoration(res.id, spv::DecorationLocation);
-            VertexAttributeMeta vertex_attribute_meta = {};
-            vertex_attribute_meta.location            = location;
-            vertex_attribute_meta.attribute           = attribute;
-            vertex_attribute_metas.push_back(vertex_attribute_meta);
+            // a matrix takes one location per column, like the world matrix of an instance
+            int32_t location = compiler.get_decoration(res.id, spv::DecorationLocation);
+            for (uint32_t column = 0; column < type.columns; ++column)
+            {
+                VertexAttributeMeta vertex_attribute_meta = {};
+                vertex_attribute_meta.location            = location + column;
+                vertex_attribute_meta.attribute           = attribute;
+                vertex_attribute_metas.push_back(vertex_attribute_meta);
+            }
         }
     }
 
@@ -390,6 +399,8 @@ namespace Meow
                 attribute == VertexAttributeBit::InstanceFloat3 || attribute == VertexAttributeBit::InstanceFloat4)
             {
                 instance_attributes |= attribute;
+                instance_attribute_metas.push_back(vertex_attribute_metas[i]);
+                instance_stride += VertexAttributeToSize(attribute);
             }
             else
             {
@@ -408,10 +419,9 @@ namespace Meow
             input_bindings.push_back(per_vertex_input_binding);
         }
 
-        if (instance_attributes.count() > 0)
+        if (instance_stride > 0)
         {
-            uint32_t                          stride = VertexAttributesToSize(instance_attributes);
-            vk::VertexInputBindingDescription instanceInputBinding {1, stride, vk::VertexInputRate::eInstance};
+            vk::VertexInputBindingDescription instanceInputBinding {1, instance_stride, vk::VertexInputRate::eInstance};
             input_bindings.push_back(instanceInputBinding);
         }
 
@@ -434,15 +444,15 @@ namespace Meow
             }
         }
 
-        if (instance_attributes.count() > 0)
+        // the same instance attribute may repeat, so they are taken from the metas rather than the bit mask
+        if (instance_stride > 0)
         {
-            uint32_t offset     = 0;
-            auto     attributes = instance_attributes.split();
-            for (int32_t i = 0; i < attributes.size(); ++i)
+            uint32_t offset = 0;
+            for (const VertexAttributeMeta& meta : instance_attribute_metas)
             {
                 vk::VertexInputAttributeDescription input_attribute {
-                    1, location, VertexAttributeToVkFormat(attributes[i]), offset};
-                offset += VertexAttributeToSize(attributes[i]);
+                    1, location, VertexAttributeToVkFormat(meta.attribute), offset};
+                offset += VertexAttributeToSize(meta.attribute);
                 input_attributes.push_back(input_attribute);
 
                 location += 1;
@@ -561,10 +571,27 @@ namespace Meow
     void Shader::AllocateDescriptorSet(const vk::raii::Device&      logical_device,
                                        DescriptorAllocatorGrowable& descriptor_allocator)
     {
-        descriptor_sets = descriptor_allocator.Allocate(logical_device, descriptor_set_layouts);
+        descriptor_sets.clear();
+        for (uint32_t i = 0; i < k_max_frames_in_flight; ++i)
+        {
+            descriptor_sets.push_back(descriptor_allocator.Allocate(logical_device, descriptor_set_layouts));
+        }
+    }
+
+    void Shader::BindBufferToDescriptor(const vk::raii::Device&     logical_device,
+                                        const std::string&          name,
+                                        const vk::raii::Buffer&     buffer,
+                                        vk::DeviceSize              range,
+                                        const vk::raii::BufferView* raii_buffer_view)
+    {
+        for (uint32_t i = 0; i < descriptor_sets.size(); ++i)
+        {
+            BindBufferToDescriptor(logical_device, i, name, buffer, range, raii_buffer_view);
+        }
     }
 
     void Shader::BindBufferToDescriptor(const vk::raii::Device&     logical_device,
+                                        uint32_t                    frame_index,
                                         const std::string&          name,
                                         const vk::raii::Buffer&     buffer,
                                         vk::DeviceSize              range,
@@ -587,6 +614,11 @@ namespace Meow
                     range = meta->size;
                     break;
                 }
+                else if (it->second.descriptorType == vk::DescriptorType::eStorageBuffer)
+                {
+                    meta = &it->second;
+                    break;
+                }
             }
         }
 
@@ -606,7 +638,7 @@ namespace Meow
         }
 
         vk::WriteDescriptorSet write_descriptor_set(
-            *descriptor_sets[meta->set],                                  // dstSet
+            *descriptor_sets[frame_index][meta->set],                     // dstSet
             meta->binding,                                                // dstBinding
             0,                                                            // dstArrayElement
             1,                                                            // descriptorCount
@@ -635,42 +667,71 @@ namespace Meow
         vk::DescriptorImageInfo descriptor_image_info(
             *image_data.sampler, *image_data.image_view, vk::ImageLayout::eShaderReadOnlyOptimal);
 
-        vk::WriteDescriptorSet write_descriptor_set(
-            *descriptor_sets[bindInfo.set],                                     // dstSet
-            bindInfo.binding,                                                   // dstBinding
-            0,                                                                  // dstArrayElement
-            1,                                                                  // descriptorCount
-            set_layout_metas.GetDescriptorType(bindInfo.set, bindInfo.binding), // descriptorType
-            &descriptor_image_info,                                             // pImageInfo
-            nullptr,                                                            // pBufferInfo
-            nullptr                                                             // pTexelBufferView
-        );
+        // images are shared by all frames in flight
+        for (vk::raii::DescriptorSets& frame_descriptor_sets : descriptor_sets)
+        {
+            vk::WriteDescriptorSet write_descriptor_set(
+                *frame_descriptor_sets[bindInfo.set],                               // dstSet
+                bindInfo.binding,                                                   // dstBinding
+                0,                                                                  // dstArrayElement
+                1,                                                                  // descriptorCount
+                set_layout_metas.GetDescriptorType(bindInfo.set, bindInfo.binding), // descriptorType
+                &descriptor_image_info,                                             // pImageInfo
+                nullptr,                                                            // pBufferInfo
+                nullptr                                                             // pTexelBufferView
+            );
+
+            logical_device.updateDescriptorSets(write_descriptor_set, nullptr);
+        }
+    }
 
-        logical_device.updateDescriptorSets(write_descriptor_set, nullptr);
+    void Shader::BindDescriptorSetsToComputePipeline(const vk::raii::CommandBuffer& command_buffer,
+                                                     uint32_t                       frame_index)
+    {
+        std::vector<vk::DescriptorSet> frame_descriptor_sets;
+        for (const vk::raii::DescriptorSet& descriptor_set : descriptor_sets[frame_index])
+        {
+            frame_descriptor_sets.push_back(*descriptor_set);
+        }
+
+        command_buffer.bindDescriptorSets(
+            vk::PipelineBindPoint::eCompute, *pipeline_layout, 0, frame_descriptor_sets, {});
+    }
+
+    void Shader::BindPerSceneDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer,
+                                                     uint32_t                       frame_index)
+    {
+        command_buffer.bindDescriptorSets(
+            vk::PipelineBindPoint::eGraphics, *pipeline_layout, 0, *descriptor_sets[frame_index][0], {});
     }
 
-    void Shader::BindPerSceneDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer)
+    void Shader::BindPerShaderDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer,
+                                                      uint32_t                       frame_index)
     {
         command_buffer.bindDescriptorSets(
-            vk::PipelineBindPoint::eGraphics, *pipeline_layout, 0, *descriptor_sets[0], {});
+            vk::PipelineBindPoint::eGraphics, *pipeline_layout, 1, *descriptor_sets[frame_index][1], {});
     }
 
-    void Shader::BindPerShaderDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer)
+    void Shader::BindPerMaterialDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer,
+                                                        uint32_t                       frame_index)
     {
         command_buffer.bindDescriptorSets(
-            vk::PipelineBindPoint::eGraphics, *pipeline_layout, 1, *descriptor_sets[1], {});
+            vk::PipelineBindPoint::eGraphics, *pipeline_layout, 2, *descriptor_sets[frame_index][2], {});
     }
 
-    void Shader::BindPerMaterialDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer)
+    void Shader::BindPerObjectDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer,
+                                                      uint32_t                       frame_index,
+                                                      const std::vector<uint32_t>&   dynamic_offsets)
     {
         command_buffer.bindDescriptorSets(
-            vk::PipelineBindPoint::eGraphics, *pipeline_layout, 2, *descriptor_sets[2], {});
+            vk::PipelineBindPoint::eGraphics, *pipeline_layout, 3, *descriptor_sets[frame_index][3], dynamic_offsets);
     }
 
     void Shader::BindPerObjectDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer,
+                                                      const vk::raii::DescriptorSet& descriptor_set,
                                                       const std::vector<uint32_t>&   dynamic_offsets)
     {
         command_buffer.bindDescriptorSets(
-            vk::PipelineBindPoint::eGraphics, *pipeline_layout, 3, *descriptor_sets[3], dynamic_offsets);
+            vk::PipelineBindPoint::eGraphics, *pipeline_layout, 3, *descriptor_set, dynamic_offsets);
     }
 } // namespace Meow
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "core/base/bitmask.hpp"
 #include "descriptor_allocator_growable.h"
 #include "image_data.h"
+#include "per_frame_data.h"
 #include "ubo_data.h"
 #include "vertex_attribute.h"
 
@@ -192,6 +193,10 @@ namespace Meow
         BitMask<VertexAttributeBit> per_vertex_attributes;
         BitMask<VertexAttributeBit> instance_attributes;
 
+        // per instance inputs in the order of their locations, a matrix has one per column
+        std::vector<VertexAttributeMeta> instance_attribute_metas;
+        uint32_t                         instance_stride = 0;
+
         InputBindingsVector   input_bindings;
         InputAttributesVector input_attributes;
 
@@ -200,7 +205,9 @@ namespace Meow
 
         vk::raii::PipelineLayout pipeline_layout = nullptr;
 
-        vk::raii::DescriptorSets descriptor_sets = nullptr;
+        // one group of sets per frame in flight, so that a frame can be recorded with its own buffers while the
+        // previous frames still read theirs
+        std::vector<vk::raii::DescriptorSets> descriptor_sets;
 
     private:
         vk::Device                        m_device     = {};
@@ -230,7 +237,25 @@ namespace Meow
             }
         }
 
+        /**
+         * @brief Whether the vertex shader has per instance inputs, read from the vertex buffer at binding 1.
+         */
+        bool IsInstanced() const { return instance_stride > 0; }
+
+        /**
+         * @brief Bind a buffer shared by all frames in flight.
+         */
+        void BindBufferToDescriptor(const vk::raii::Device&     logical_device,
+                                    const std::string&          name,
+                                    const vk::raii::Buffer&     buffer,
+                                    vk::DeviceSize              range            = VK_WHOLE_SIZE,
+                                    const vk::raii::BufferView* raii_buffer_view = nullptr);
+
+        /**
+         * @brief Bind a buffer to the descriptor sets of one frame in flight only, for data written every frame.
+         */
         void BindBufferToDescriptor(const vk::raii::Device&     logical_device,
+                                    uint32_t                    frame_index,
                                     const std::string&          name,
                                     const vk::raii::Buffer&     buffer,
                                     vk::DeviceSize              range            = VK_WHOLE_SIZE,
@@ -239,10 +264,24 @@ namespace Meow
         void
         BindImageToDescriptor(const vk::raii::Device& logical_device, const std::string& name, ImageData& image_data);
 
-        void BindPerSceneDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer);
-        void BindPerShaderDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer);
-        void BindPerMaterialDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer);
+        /**
+         * @brief Bind all sets of a frame in flight for dispatches of the compute stage.
+         */
+        void BindDescriptorSetsToComputePipeline(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index);
+
+        void BindPerSceneDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index);
+        void BindPerShaderDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer, uint32_t frame_index);
+        void BindPerMaterialDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer,
+                                                    uint32_t                       frame_index);
+        void BindPerObjectDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer,
+                                                  uint32_t                       frame_index,
+                                                  const std::vector<uint32_t>&   dynamic_offsets);
+
+        /**
+         * @brief Bind a per object set allocated outside of the shader, like the pages of a FrameUniformAllocator.
+         */
         void BindPerObjectDescriptorSetToPipeline(const vk::raii::CommandBuffer& command_buffer,
+                                                  const vk::raii::DescriptorSet& descriptor_set,
                                                   const std::vector<uint32_t>&   dynamic_offsets);
 
     private:
@@ -290,7 +329,7 @@ namespace Meow
          * layout (set = 0, binding = 0) ...
          * layout (set = 1, binding = 0) ...
          *
-         * It will result in two descriptor sets allocated.
+         * It will result in two descriptor sets allocated, for each frame in flight.
          *
          * @param logical_device logical device
          * @param descriptor_allocator descriptor allocator
@@ -6,32 +6,33 @@ namespace Meow
 {
     void UniformBuffer::Reset() { allocated_memory = 0; }
 
-    uint64_t UniformBuffer::AllocateMemory(uint64_t size)
+    bool UniformBuffer::HasSpace(uint64_t size) const
     {
-        uint64_t new_memory_start = Align<uint64_t>(allocated_memory, min_alignment);
+        return Align<uint64_t>(allocated_memory, min_alignment) + size <= device_size;
+    }
 
-        if (new_memory_start + size <= device_size)
+    uint64_t UniformBuffer::AllocateMemory(uint64_t size)
+    {
+        // data of objects allocated before must not be overwritten, bigger or growing data goes through a
+        // FrameUniformAllocator
+        if (!HasSpace(size))
         {
-            allocated_memory = new_memory_start + size;
-
-            return new_memory_start;
+            MEOW_ERROR("Uniform buffer of {} bytes is full.", device_size);
+            return k_invalid_offset;
         }
 
-        // TODO: Scalable buffer size
-        // When the memory is running out, allocation return to the begin of memory
-        // It means overriding the old buffer data
-        // If the object number is very large, it definitely break the uniform data at this frame
-        // Here we push the problem aside
+        uint64_t new_memory_start = Align<uint64_t>(allocated_memory, min_alignment);
+        allocated_memory          = new_memory_start + size;
 
-        allocated_memory = size;
-        return 0;
+        return new_memory_start;
     }
 
-    uint64_t UniformBuffer::Populate(void* src, uint64_t size)
+    uint64_t UniformBuffer::Populate(const void* src, uint64_t size)
     {
         uint64_t new_memory_start = AllocateMemory(size);
 
-        memcpy(mapped_data_ptr + new_memory_start, src, size);
+        if (new_memory_start != k_invalid_offset)
+            memcpy(mapped_data_ptr + new_memory_start, src, size);
 
         return new_memory_start;
     }
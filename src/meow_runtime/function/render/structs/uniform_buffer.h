@@ -4,10 +4,15 @@
 #include "core/base/alignment.h"
 #include "core/base/non_copyable.h"
 
+#include <cstdint>
+#include <limits>
+
 namespace Meow
 {
     struct UniformBuffer : BufferData
     {
+        static constexpr uint64_t k_invalid_offset = std::numeric_limits<uint64_t>::max();
+
         uint8_t* mapped_data_ptr = nullptr;
 
         uint64_t allocated_memory = 0;
@@ -26,6 +31,7 @@ namespace Meow
                          vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eTransferDst,
                          vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent)
         {
+            device_size     = size;
             min_alignment   = physical_device.getProperties().limits.minUniformBufferOffsetAlignment;
             mapped_data_ptr = (uint8_t*)device_memory.mapMemory(0, VK_WHOLE_SIZE);
         }
@@ -38,8 +44,13 @@ namespace Meow
 
         void Reset();
 
+        bool HasSpace(uint64_t size) const;
+
+        /**
+         * @return Offset of the allocation, k_invalid_offset if the buffer is full.
+         */
         uint64_t AllocateMemory(uint64_t size);
 
-        uint64_t Populate(void* src, uint64_t size);
+        uint64_t Populate(const void* src, uint64_t size);
     };
 } // namespace Meow
\ No newline at end of file
@@ -41,6 +41,10 @@ namespace Meow
 
         void Tick(float dt) override;
 
+        SystemResources GetReadResources() const override { return SystemResourceBit::Device; }
+
+        SystemResources GetWriteResources() const override { return SystemResourceBit::Resources; }
+
         std::tuple<bool, UUID> LoadTexture(const std::string& file_path);
 
         std::shared_ptr<ImageData> GetTexture(const UUID& uuid);
@@ -1,12 +1,42 @@
 #pragma once
 
+#include "core/base/bitmask.hpp"
+
+#include <cstdint>
+
 namespace Meow
 {
+    /**
+     * @brief Engine state a system touches while ticking. The system scheduler derives the execution order from these.
+     */
+    enum class SystemResourceBit : uint32_t {
+        None      = 0x00000000,
+        Time      = 0x00000001,
+        Input     = 0x00000002,
+        Window    = 0x00000004,
+        Device    = 0x00000008,
+        Resources = 0x00000010,
+        Level     = 0x00000020,
+        Transform = 0x00000040,
+        ALL       = 0x0000007F,
+    };
+
+    using SystemResources = BitMask<SystemResourceBit>;
+
     class System
     {
     public:
         virtual void Start() {};
 
         virtual void Tick(float dt) {};
+
+        virtual SystemResources GetReadResources() const { return {}; }
+
+        virtual SystemResources GetWriteResources() const { return {}; }
+
+        /**
+         * @brief Systems calling into glfw or submitting to vulkan queues must tick on the main thread.
+         */
+        virtual bool IsMainThreadOnly() const { return false; }
     };
 } // namespace Meow
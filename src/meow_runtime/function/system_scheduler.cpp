@@ -0,0 +1,171 @@
+#include "system_scheduler.h"
+
+#include "pch.h"
+
+#include "core/jobs/job_system.h"
+
+#include <stdexcept>
+#include <thread>
+
+namespace Meow
+{
+    void SystemScheduler::AddSystemNode(const std::string&      name,
+                                        std::shared_ptr<System> system,
+                                        std::function<void()>   release)
+    {
+        if (m_is_built)
+            throw std::runtime_error("Can not add system " + name + " after the system graph has been built.");
+
+        SystemNode node;
+        node.name             = name;
+        node.system           = std::move(system);
+        node.release          = std::move(release);
+        node.main_thread_only = node.system->IsMainThreadOnly();
+
+        m_nodes.push_back(std::move(node));
+    }
+
+    void SystemScheduler::Build()
+    {
+        for (uint32_t i = 0; i < m_nodes.size(); ++i)
+        {
+            SystemResources reads_i  = m_nodes[i].system->GetReadResources();
+            SystemResources writes_i = m_nodes[i].system->GetWriteResources();
+
+            for (uint32_t j = i + 1; j < m_nodes.size(); ++j)
+            {
+                SystemResources reads_j  = m_nodes[j].system->GetReadResources();
+                SystemResources writes_j = m_nodes[j].system->GetWriteResources();
+
+                if (writes_i & (reads_j | writes_j) || writes_j & reads_i)
+                {
+                    m_nodes[i].dependents.push_back(j);
+                    m_nodes[j].dependency_count++;
+                }
+            }
+        }
+
+        m_remaining_dependencies = std::make_unique<std::atomic<uint32_t>[]>(m_nodes.size());
+        m_is_built               = true;
+
+        for (const SystemNode& node : m_nodes)
+        {
+            std::string dependency_names;
+            for (const std::string& dependency_name : GetDependencyNames(node.name))
+            {
+                dependency_names += " " + dependency_name;
+            }
+            MEOW_INFO("System {} waits for:{}", node.name, dependency_names.empty() ? " none" : dependency_names);
+        }
+    }
+
+    void SystemScheduler::Start()
+    {
+        for (SystemNode& node : m_nodes)
+        {
+            node.system->Start();
+        }
+    }
+
+    void SystemScheduler::Tick(float dt, JobSystem* job_system)
+    {
+        FUNCTION_TIMER();
+
+        if (!job_system || job_system->GetWorkerCount() == 0)
+        {
+            for (SystemNode& node : m_nodes)
+            {
+                node.system->Tick(dt);
+            }
+            return;
+        }
+
+        m_dt = dt;
+        m_finished_count.store(0);
+        for (uint32_t i = 0; i < m_nodes.size(); ++i)
+        {
+            m_remaining_dependencies[i].store(m_nodes[i].dependency_count, std::memory_order_relaxed);
+        }
+
+        for (uint32_t i = 0; i < m_nodes.size(); ++i)
+        {
+            if (m_nodes[i].dependency_count == 0)
+                Dispatch(i, job_system);
+        }
+
+        while (m_finished_count.load(std::memory_order_acquire) < m_nodes.size())
+        {
+            uint32_t index = 0;
+            if (PopMainThreadSystem(index))
+                Run(index, job_system);
+            else if (!job_system->RunPendingJob())
+                std::this_thread::yield();
+        }
+    }
+
+    void SystemScheduler::ShutDown()
+    {
+        for (auto iter = m_nodes.rbegin(); iter != m_nodes.rend(); ++iter)
+        {
+            iter->system = nullptr;
+            iter->release();
+        }
+
+        m_nodes.clear();
+        m_remaining_dependencies = nullptr;
+        m_is_built               = false;
+    }
+
+    std::vector<std::string> SystemScheduler::GetDependencyNames(const std::string& name) const
+    {
+        std::vector<std::string> names;
+        for (const SystemNode& node : m_nodes)
+        {
+            for (uint32_t dependent : node.dependents)
+            {
+                if (m_nodes[dependent].name == name)
+                    names.push_back(node.name);
+            }
+        }
+
+        return names;
+    }
+
+    void SystemScheduler::Dispatch(uint32_t index, JobSystem* job_system)
+    {
+        if (m_nodes[index].main_thread_only)
+        {
+            std::lock_guard<std::mutex> lock(m_main_thread_mutex);
+            m_main_thread_ready.push_back(index);
+            return;
+        }
+
+        job_system->Schedule([this, index, job_system]() { Run(index, job_system); });
+    }
+
+    void SystemScheduler::Run(uint32_t index, JobSystem* job_system)
+    {
+        m_nodes[index].system->Tick(m_dt);
+
+        for (uint32_t dependent : m_nodes[index].dependents)
+        {
+            if (m_remaining_dependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                Dispatch(dependent, job_system);
+        }
+
+        // last access of the scheduler from this job, Tick may return right after
+        m_finished_count.fetch_add(1, std::memory_order_release);
+    }
+
+    bool SystemScheduler::PopMainThreadSystem(uint32_t& index)
+    {
+        std::lock_guard<std::mutex> lock(m_main_thread_mutex);
+        if (m_main_thread_ready.empty())
+            return false;
+
+        // keep the add order among systems that became ready together
+        index = m_main_thread_ready.front();
+        m_main_thread_ready.erase(m_main_thread_ready.begin());
+        return true;
+    }
+} // namespace Meow
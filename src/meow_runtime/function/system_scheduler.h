@@ -0,0 +1,92 @@
+#pragma once
+
+#include "core/base/non_copyable.h"
+#include "function/system.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Meow
+{
+    class JobSystem;
+
+    /**
+     * @brief Runs systems by the dependency graph of their declared resources.
+     *
+     * Two systems depend on each other if one writes a resource the other reads or writes. The edge always points
+     * from the earlier added system to the later one, so the add order is a topological order and a frame produces
+     * the same result as ticking all systems one after another, while systems without a path between them tick
+     * concurrently on the job system.
+     */
+    class SystemScheduler : public NonCopyable
+    {
+    public:
+        /**
+         * @brief Add a system kept in system_slot. The slot is reset on shutdown, so that the system is destroyed in
+         * reverse topological order while the systems it uses are still reachable.
+         */
+        template<typename TSystem>
+        void AddSystem(const std::string& name, std::shared_ptr<TSystem>& system_slot)
+        {
+            AddSystemNode(name, system_slot, [&system_slot]() { system_slot = nullptr; });
+        }
+
+        /**
+         * @brief Build the dependency graph once all systems have been added.
+         */
+        void Build();
+
+        /**
+         * @brief Start all systems on the calling thread in topological order.
+         */
+        void Start();
+
+        /**
+         * @brief Tick all systems. Must be called from the thread owning the job system, which ticks main thread only
+         * systems and helps with the other jobs while waiting.
+         */
+        void Tick(float dt, JobSystem* job_system);
+
+        /**
+         * @brief Release all systems in reverse topological order.
+         */
+        void ShutDown();
+
+        /**
+         * @brief Names of the systems a system waits for, for debugging the graph.
+         */
+        std::vector<std::string> GetDependencyNames(const std::string& name) const;
+
+    private:
+        struct SystemNode
+        {
+            std::string             name;
+            std::shared_ptr<System> system;
+            std::function<void()>   release;
+            std::vector<uint32_t>   dependents;
+            uint32_t                dependency_count = 0;
+            bool                    main_thread_only = false;
+        };
+
+        void AddSystemNode(const std::string& name, std::shared_ptr<System> system, std::function<void()> release);
+
+        void Dispatch(uint32_t index, JobSystem* job_system);
+        void Run(uint32_t index, JobSystem* job_system);
+        bool PopMainThreadSystem(uint32_t& index);
+
+        std::vector<SystemNode> m_nodes;
+        bool                    m_is_built = false;
+
+        // state of the running tick
+        float                                    m_dt = 0.0f;
+        std::unique_ptr<std::atomic<uint32_t>[]> m_remaining_dependencies;
+        std::atomic<uint32_t>                    m_finished_count {0};
+        std::mutex                               m_main_thread_mutex;
+        std::vector<uint32_t>                    m_main_thread_ready;
+    };
+} // namespace Meow
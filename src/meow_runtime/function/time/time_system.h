@@ -13,6 +13,8 @@ namespace Meow
 
         void Tick(float dt) override;
 
+        SystemResources GetWriteResources() const override { return SystemResourceBit::Time; }
+
         float GetTime() const { return m_elapsed_time; }
         float GetDeltaTime() const { return m_dt; }
 
@@ -17,6 +17,22 @@ namespace Meow
 
         void Tick(float dt) override;
 
+        /**
+         * @brief Ticking the window renders the current level and polls events into input.
+         */
+        SystemResources GetReadResources() const override
+        {
+            return SystemResources(SystemResourceBit::Time) | SystemResourceBit::Device | SystemResourceBit::Resources |
+                   SystemResourceBit::Level | SystemResourceBit::Transform;
+        }
+
+        SystemResources GetWriteResources() const override
+        {
+            return SystemResources(SystemResourceBit::Window) | SystemResourceBit::Input;
+        }
+
+        bool IsMainThreadOnly() const override { return true; }
+
         void AddWindow(std::shared_ptr<Window> window)
         {
             m_current_window      = window;
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "function/object/component_type_id.h"
+
+#include <cstdint>
+
+namespace Meow
+{
+    class Transform3DComponent;
+    class Camera3DComponent;
+    class ModelComponent;
+
+    template<>
+    struct GeneratedComponentTypeID<Transform3DComponent>
+    {
+        static constexpr uint32_t value = 0;
+    };
+
+    template<>
+    struct GeneratedComponentTypeID<Camera3DComponent>
+    {
+        static constexpr uint32_t value = 1;
+    };
+
+    template<>
+    struct GeneratedComponentTypeID<ModelComponent>
+    {
+        static constexpr uint32_t value = 2;
+    };
+
+    inline constexpr uint32_t k_generated_component_type_count = 3;
+} // namespace Meow
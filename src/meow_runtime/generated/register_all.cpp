@@ -1,6 +1,7 @@
 #include "register_all.h"
 
 #include "core/reflect/type_descriptor_builder.hpp"
+#include "function/object/component_type_info.h"
 #include "function/components/camera/camera_3d_component.hpp"
 #include "function/components/model/model_component.h"
 
@@ -22,6 +23,10 @@ namespace Meow
 
 		reflect::AddClass<ModelComponent>("ModelComponent")
 			.AddArray("m_image_paths", "std::vector<std::string>", "std::string", &ModelComponent::m_image_paths);
+
+		ComponentTypeRegistry::instance().Register<Transform3DComponent>("Transform3DComponent");
+		ComponentTypeRegistry::instance().Register<Camera3DComponent>("Camera3DComponent");
+		ComponentTypeRegistry::instance().Register<ModelComponent>("ModelComponent");
 	}
 
 	VertexAttributeBit to_enum(const std::string& str)
@@ -15,7 +15,7 @@ namespace Meow
     {
         RegisterAll();
 
-        // TODO: Init Dependencies graph
+        g_runtime_context.job_system      = std::make_shared<JobSystem>();
         g_runtime_context.time_system     = std::make_shared<TimeSystem>();
         g_runtime_context.file_system     = std::make_shared<FileSystem>();
         g_runtime_context.resource_system = std::make_shared<ResourceSystem>();
@@ -24,44 +24,38 @@ namespace Meow
         g_runtime_context.input_system    = std::make_shared<InputSystem>();
         g_runtime_context.level_system    = std::make_shared<LevelSystem>();
 
+        // add order breaks ties between conflicting systems and its reverse is the shutdown order, so systems go
+        // after the systems they use
+        m_system_scheduler.AddSystem("TimeSystem", g_runtime_context.time_system);
+        m_system_scheduler.AddSystem("FileSystem", g_runtime_context.file_system);
+        m_system_scheduler.AddSystem("RenderSystem", g_runtime_context.render_system);
+        m_system_scheduler.AddSystem("ResourceSystem", g_runtime_context.resource_system);
+        m_system_scheduler.AddSystem("WindowSystem", g_runtime_context.window_system);
+        m_system_scheduler.AddSystem("InputSystem", g_runtime_context.input_system);
+        m_system_scheduler.AddSystem("LevelSystem", g_runtime_context.level_system);
+        m_system_scheduler.Build();
+
         return true;
     }
 
     bool MeowRuntime::Start()
     {
-        g_runtime_context.time_system->Start();
-        g_runtime_context.level_system->Start();
-        g_runtime_context.file_system->Start();
-        g_runtime_context.resource_system->Start();
-        g_runtime_context.render_system->Start();
-        g_runtime_context.window_system->Start();
-        g_runtime_context.input_system->Start();
+        m_system_scheduler.Start();
 
         return true;
     }
 
     void MeowRuntime::Tick(float dt)
     {
-        // TODO: Update Dependencies graph
-        g_runtime_context.time_system->Tick(dt);
-        g_runtime_context.resource_system->Tick(dt);
-        g_runtime_context.window_system->Tick(dt);
-        g_runtime_context.input_system->Tick(dt);
-        g_runtime_context.render_system->Tick(dt);
-        g_runtime_context.level_system->Tick(dt);
+        m_system_scheduler.Tick(dt, g_runtime_context.job_system.get());
 
         TimerSingleton::Get().Clear();
     }
 
     void MeowRuntime::ShutDown()
     {
-        // TODO: ShutDown Dependencies graph
-        g_runtime_context.level_system    = nullptr;
-        g_runtime_context.resource_system = nullptr;
-        g_runtime_context.input_system    = nullptr;
-        g_runtime_context.window_system   = nullptr;
-        g_runtime_context.render_system   = nullptr;
-        g_runtime_context.file_system     = nullptr;
-        g_runtime_context.time_system     = nullptr;
+        m_system_scheduler.ShutDown();
+
+        g_runtime_context.job_system = nullptr;
     }
 } // namespace Meow
\ No newline at end of file
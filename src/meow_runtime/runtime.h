@@ -2,6 +2,7 @@
 
 #include "core/base/non_copyable.h"
 #include "function/system.h"
+#include "function/system_scheduler.h"
 
 #include <memory>
 #include <vector>
@@ -30,5 +31,7 @@ namespace Meow
 
     private:
         bool m_running = true;
+
+        SystemScheduler m_system_scheduler;
     };
 } // namespace Meow
\ No newline at end of file